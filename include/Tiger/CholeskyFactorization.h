@@ -0,0 +1,159 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/Matrix.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Cholesky factorization of a symmetric positive-definite matrix:
+//     A = ~U * U
+//
+// where U is upper triangular with a positive diagonal. The factor is
+// computed once and can then be used to solve simultaneous equations for
+// any number of right-hand sides, the inverse, the determinant, etc.
+// It is about half the work of the LU factorization and needs no
+// pivoting.
+//
+// A is checked for symmetry once, before any work is done. Only its
+// upper triangle is read after that.
+//
+// It is a blocked right-looking factorization. A diagonal block is
+// factored, the block row to its right is found by a triangular solve and
+// the trailing matrix is updated by a symmetric rank-k update (see
+// MatrixKernels.h), which does most of the work and is multithreaded
+// the same way as matrix multiplication (see set_num_threads()).
+//
+template<class MAT>
+class   CholeskyFactorization  {
+
+public:
+
+    using MatrixType = MAT;
+    using size_type = typename MatrixType::size_type;
+    using value_type = typename MatrixType::value_type;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+
+    CholeskyFactorization () = default;
+    explicit CholeskyFactorization (const MatrixType &mat);
+
+   // It throws NotSolvable if mat is not square, not symmetric or not
+   // positive-definite
+   //
+    void factorize (const MatrixType &mat); // throw (NotSolvable)
+
+    inline size_type rows () const noexcept  { return (u_.rows ()); }
+    inline size_type columns () const noexcept  { return (u_.columns ()); }
+
+   // U. The part below the diagonal is all zeros.
+   //
+    inline const DenseMatrix &
+    get_factor () const noexcept  { return (u_); }
+
+   // A = ~U * U = L * ~L
+   //
+    template<class MAT2>
+    inline void get_upper (MAT2 &U) const;
+    template<class MAT2>
+    inline void get_lower (MAT2 &L) const;
+
+    inline value_type determinant () const noexcept;
+
+   // Solve A * X = rhs and return X. rhs can have any number of columns.
+   // X is found by two triangular solves over the whole rhs panel.
+   //
+    template<class MAT2>
+    inline MAT2
+    cholesky_solve (const MAT2 &rhs) const; // throw (NotSolvable)
+
+   // Same as above, but X overwrites rhs. If rhs is a dense matrix,
+   // nothing is allocated.
+   //
+    template<class MAT2>
+    inline MAT2 &
+    cholesky_solve_in_place (MAT2 &rhs) const; // throw (NotSolvable)
+
+   // Inverse(A) = Inverse(U) * ~Inverse(U)
+   //
+   // The triangular inverse of U is multiplied by its own transpose, so
+   // only one triangle of the (symmetric) result is computed.
+   //
+    template<class MAT2>
+    inline MAT2 &cholesky_inverse (MAT2 &that) const;
+    inline DenseMatrix cholesky_inverse () const;
+
+private:
+
+   // Width of the blocks of columns of the inverse
+   //
+    static constexpr size_type  BLOCK_ = 128;
+
+    static inline void
+    potrf_ (size_type n, value_type *a, size_type lda);
+
+    inline void inverse_dense_ (DenseMatrix &inv) const;
+
+    template<class MAT2>
+    inline void solve_in_place_ (MAT2 &rhs) const;
+    inline void solve_in_place_ (DenseMatrix &rhs) const;
+
+    template<class MAT2>
+    static inline void copy_upper_ (const MAT2 &from, DenseMatrix &to);
+    static inline void
+    copy_upper_ (const DenseMatrix &from, DenseMatrix &to);
+    template<class MAT2>
+    static inline void copy_ (const MAT2 &from, DenseMatrix &to);
+    static inline void copy_ (const DenseMatrix &from, DenseMatrix &to);
+    template<class MAT2>
+    static inline void move_ (DenseMatrix &from, MAT2 &to);
+    static inline void move_ (DenseMatrix &from, DenseMatrix &to) noexcept;
+
+    DenseMatrix u_ { };
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/CholeskyFactorization.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
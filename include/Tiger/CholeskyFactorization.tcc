@@ -0,0 +1,356 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/CholeskyFactorization.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class MAT>
+constexpr typename CholeskyFactorization<MAT>::size_type
+CholeskyFactorization<MAT>::BLOCK_;
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+CholeskyFactorization<MAT>::CholeskyFactorization (const MatrixType &mat)  {
+
+    factorize (mat);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+void CholeskyFactorization<MAT>::factorize (const MatrixType &mat)  {
+
+   // Check everything up front, so the factorization loops don't have to
+   //
+    if (mat.rows () != mat.columns () || ! mat.is_symmetric ())
+        throw NotSolvable ();
+
+    DenseMatrix u;
+
+    copy_upper_ (mat, u);
+
+    const size_type n = u.rows ();
+
+    if (n > 0)  {
+        potrf_ (n, &(*u.col_begin ()), n);
+        for (size_type c = 0; c < n; ++c)
+            for (size_type r = c + 1; r < n; ++r)
+                u (r, c) = value_type(0.0);
+    }
+
+   // Only a successful factorization replaces the old one
+   //
+    u_.swap (u);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void CholeskyFactorization<MAT>::get_upper (MAT2 &U) const  {
+
+    const size_type n = u_.rows ();
+
+    U.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = 0; r <= c; ++r)
+            U (r, c) = u_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void CholeskyFactorization<MAT>::get_lower (MAT2 &L) const  {
+
+    const size_type n = u_.rows ();
+
+    L.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = 0; r <= c; ++r)
+            L (c, r) = u_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline typename CholeskyFactorization<MAT>::value_type
+CholeskyFactorization<MAT>::determinant () const noexcept  {
+
+    value_type  result (1.0);
+
+    for (size_type i = 0; i < u_.rows (); ++i)
+        result *= u_ (i, i) * u_ (i, i);
+
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2
+CholeskyFactorization<MAT>::cholesky_solve (const MAT2 &rhs) const  {
+
+    MAT2    sol = rhs;
+
+    return (cholesky_solve_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2 &
+CholeskyFactorization<MAT>::cholesky_solve_in_place (MAT2 &rhs) const  {
+
+    if (rhs.rows () != u_.rows ())
+        throw NotSolvable ();
+
+    solve_in_place_ (rhs);
+    return (rhs);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2 &CholeskyFactorization<MAT>::cholesky_inverse (MAT2 &that) const {
+
+    DenseMatrix inv;
+
+    inverse_dense_ (inv);
+    move_ (inv, that);
+    return (that);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline typename CholeskyFactorization<MAT>::DenseMatrix
+CholeskyFactorization<MAT>::cholesky_inverse () const  {
+
+    DenseMatrix inv;
+
+    inverse_dense_ (inv);
+    return (inv);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+CholeskyFactorization<MAT>::potrf_ (size_type n,
+                                    value_type *a, size_type lda)  {
+
+    if (! potrf (true, n, a, lda))  // Not positive definite
+        throw NotSolvable ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+CholeskyFactorization<MAT>::inverse_dense_ (DenseMatrix &inv) const  {
+
+    const size_type n = u_.rows ();
+
+    inv.resize (n, n);
+    if (n == 0)  return;
+
+    const value_type    *u = &(*u_.col_begin ());
+    DenseMatrix         u_inv (n, n);
+    value_type          *ui = &(*u_inv.col_begin ());
+    value_type          *v = &(*inv.col_begin ());
+
+   // Inverse(U) is upper triangular, so block column j of it only needs
+   // the leading j + jb rows of U
+   //
+    for (size_type i = 0; i < n; ++i)
+        u_inv (i, i) = value_type(1.0);
+    for (size_type j = 0; j < n; j += BLOCK_)  {
+        const size_type jb = std::min (BLOCK_, n - j);
+
+        trsm (true, false, false, j + jb, jb, u, n, ui + j * n, n);
+    }
+
+   // Inverse(U) * ~Inverse(U), one block column of the upper triangle at a
+   // time. Columns of Inverse(U) to the left of j don't contribute to it.
+   //
+    for (size_type j = 0; j < n; j += BLOCK_)  {
+        const size_type jb = std::min (BLOCK_, n - j);
+        const size_type k = n - j;
+
+        syrk (true, false, jb, k,
+              value_type(1.0), ui + j + j * n, n,
+              value_type(0.0), v + j + j * n, n);
+        if (j > 0)
+            gemm (false, true, j, jb, k,
+                  value_type(1.0), ui + j * n, n, ui + j + j * n, n,
+                  value_type(0.0), v + j * n, n);
+    }
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = c + 1; r < n; ++r)
+            inv (r, c) = inv (c, r);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Not a dense matrix, so it goes through a dense copy
+//
+template<class MAT>
+template<class MAT2>
+inline void CholeskyFactorization<MAT>::solve_in_place_ (MAT2 &rhs) const  {
+
+    DenseMatrix sol;
+
+    copy_ (rhs, sol);
+    solve_in_place_ (sol);
+    move_ (sol, rhs);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+CholeskyFactorization<MAT>::solve_in_place_ (DenseMatrix &rhs) const  {
+
+    const size_type n = u_.rows ();
+
+    if (n == 0 || rhs.columns () == 0)  return;
+
+    const value_type    *u = &(*u_.col_begin ());
+    value_type          *b = &(*rhs.col_begin ());
+
+   // ~U * U * X = rhs
+   //
+    trsm (true, true, false, n, rhs.columns (), u, n, b, n);
+    trsm (true, false, false, n, rhs.columns (), u, n, b, n);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void
+CholeskyFactorization<MAT>::copy_upper_ (const MAT2 &from, DenseMatrix &to) {
+
+    to.resize (from.rows (), from.columns ());
+    for (size_type c = 0; c < from.columns (); ++c)
+        for (size_type r = 0; r <= c; ++r)
+            to (r, c) = from (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The lower triangle is copied too, but it is never read
+//
+template<class MAT>
+inline void CholeskyFactorization<MAT>::
+copy_upper_ (const DenseMatrix &from, DenseMatrix &to)  {
+
+    to = from;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void
+CholeskyFactorization<MAT>::copy_ (const MAT2 &from, DenseMatrix &to)  {
+
+    to.resize (from.rows (), from.columns ());
+    for (size_type c = 0; c < from.columns (); ++c)
+        for (size_type r = 0; r < from.rows (); ++r)
+            to (r, c) = from (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+CholeskyFactorization<MAT>::copy_ (const DenseMatrix &from, DenseMatrix &to)  {
+
+    to = from;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void
+CholeskyFactorization<MAT>::move_ (DenseMatrix &from, MAT2 &to)  {
+
+    to.resize (from.rows (), from.columns ());
+    for (size_type c = 0; c < from.columns (); ++c)
+        for (size_type r = 0; r < from.rows (); ++r)
+            to (r, c) = from (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+CholeskyFactorization<MAT>::move_ (DenseMatrix &from,
+                                   DenseMatrix &to) noexcept  {
+
+    to.swap (from);
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
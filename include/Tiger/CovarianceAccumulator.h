@@ -0,0 +1,169 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/Matrix.h>
+
+#include <cstddef>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Running mean and covariance of observations that arrive one row (or one
+// mini-batch of rows) at a time. Each observation is a row of
+// dimension () values, the same as a row of the matrix Matrix::covariance()
+// is called on.
+//
+// It keeps the mean vector and the co-moment matrix
+//     M = Sum((x - mean) * ~(x - mean))
+//
+// in packed symmetric storage. So the memory is O(n^2) no matter how many
+// observations have been seen.
+//  -- A single row is a Welford rank-1 update:
+//         delta = x - mean,  mean += delta / count,
+//         M += (count - 1) / count * delta * ~delta
+//  -- A mini-batch is centered on its own mean and its co-moment is
+//     computed by syrk(). It is then combined with the running one, the
+//     same way two accumulators are merged:
+//         M = Ma + Mb + na * nb / n * delta * ~delta
+//     where delta is the difference of the two means.
+//
+// merge() makes it possible to accumulate parts of the data in parallel and
+// reduce them at the end.
+//
+template<class T>
+class   CovarianceAccumulator  {
+
+public:
+
+    using value_type = T;
+    using SymmMatrix = Matrix<SymmMatrixBase, value_type>;
+    using size_type = typename SymmMatrix::size_type;
+    using MeanVector = std::vector<value_type>;
+
+    CovarianceAccumulator () = default;
+    explicit CovarianceAccumulator (size_type dimension);
+
+   // Forget all observations and start over with the given dimension
+   //
+    void reset (size_type dimension);
+
+    inline size_type dimension () const noexcept  { return (mean_.size ()); }
+    inline std::size_t count () const noexcept  { return (count_); }
+
+    inline const MeanVector &get_mean () const noexcept  { return (mean_); }
+    inline const SymmMatrix &
+    get_comoment () const noexcept  { return (comoment_); }
+
+   // Add one observation. first must point to dimension () values.
+   //
+    template<class ITER>
+    void add (ITER first);
+
+   // Add the given row of mat as one observation
+   //
+    template<class MAT>
+    void add_row (const MAT &mat,
+                  size_type row); // throw (NotSolvable)
+
+   // Add every row of batch as an observation, in one shot
+   //
+    template<class MAT>
+    void add_rows (const MAT &batch); // throw (NotSolvable)
+
+   // Take out one observation that was added before. first must point to
+   // dimension () values. This is the rank-1 downdate:
+   //     M -= count / (count - 1) * (x - mean) * ~(x - mean)
+   // It throws NotSolvable if there is nothing to remove.
+   //
+    template<class ITER>
+    void remove (ITER first); // throw (NotSolvable)
+
+   // Add all the observations of that to this
+   //
+    void merge (const CovarianceAccumulator &that); // throw (NotSolvable)
+
+   // Snapshots of what has been accumulated so far.
+   // The same as calling Matrix::covariance() and Matrix::correlation() on
+   // all the observations.
+   //
+    SymmMatrix
+    covariance (bool is_unbiased = true) const; // throw (NotSolvable)
+    SymmMatrix correlation () const; // throw (NotSolvable)
+
+private:
+
+   // Welford update with the observation in delta_
+   //
+    inline void update_ () noexcept;
+
+   // Combine with nb observations, whose mean is mean_b and whose
+   // co-moment's lower triangle is column j of comoment_b (rows j ... n-1),
+   // for every j
+   //
+    template<class COLUMN>
+    inline void
+    combine_ (std::size_t nb, const value_type *mean_b, COLUMN comoment_b);
+
+    inline value_type *packed_data_ () noexcept;
+    inline void rank_one_ (value_type alpha, const value_type *x) noexcept;
+
+    std::size_t count_ { 0 };
+    MeanVector  mean_ { };
+    SymmMatrix  comoment_ { };
+    MeanVector  delta_ { };  // Scratch
+};
+
+// ----------------------------------------------------------------------------
+
+// Turn a covariance matrix into the correlation matrix, in place
+//
+template<class T>
+inline void covariance_to_correlation__ (Matrix<SymmMatrixBase, T> &cov);
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/CovarianceAccumulator.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
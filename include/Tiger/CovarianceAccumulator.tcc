@@ -0,0 +1,322 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/CovarianceAccumulator.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <cmath>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+CovarianceAccumulator<T>::CovarianceAccumulator (size_type dimension)  {
+
+    reset (dimension);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void CovarianceAccumulator<T>::reset (size_type dimension)  {
+
+    count_ = 0;
+    mean_.assign (dimension, value_type(0));
+    delta_.assign (dimension, value_type(0));
+    comoment_.resize (dimension, dimension);  // It zero fills
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class ITER>
+void CovarianceAccumulator<T>::add (ITER first)  {
+
+    for (size_type i = 0; i < dimension (); ++i, ++first)
+        delta_[i] = *first;
+    update_ ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT>
+void CovarianceAccumulator<T>::add_row (const MAT &mat, size_type row)  {
+
+    if (mat.columns () != dimension () || row >= mat.rows ())
+        throw NotSolvable ();
+
+    for (size_type c = 0; c < dimension (); ++c)
+        delta_[c] = mat (row, c);
+    update_ ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT>
+void CovarianceAccumulator<T>::add_rows (const MAT &batch)  {
+
+    const size_type d = dimension ();
+    const size_type k = batch.rows ();
+
+    if (batch.columns () != d)
+        throw NotSolvable ();
+    if (k == 0)  return;
+    if (k == 1)  {
+        add_row (batch, 0);
+        return;
+    }
+
+   // Center the batch on its own mean, into a column-major array
+   //
+    MeanVector  batch_mean (d);
+    MeanVector  centered (std::size_t(k) * d);
+
+    for (size_type c = 0; c < d; ++c)  {
+        value_type  *col = centered.data () + std::size_t(c) * k;
+        value_type  sum (0);
+
+        for (size_type r = 0; r < k; ++r)
+            sum += col[r] = batch (r, c);
+        batch_mean[c] = sum / value_type(k);
+        for (size_type r = 0; r < k; ++r)
+            col[r] -= batch_mean[c];
+    }
+
+   // Lower triangle of the batch co-moment
+   //
+    MeanVector  batch_comoment (std::size_t(d) * d);
+
+    if (d != 0)
+        syrk (false, true, d, k, value_type(1), centered.data (), k,
+              value_type(0), batch_comoment.data (), d);
+    combine_ (k, batch_mean.data (),
+              [&batch_comoment, d](std::size_t j) -> const value_type *  {
+                  return (batch_comoment.data () + j * d);
+              });
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class ITER>
+void CovarianceAccumulator<T>::remove (ITER first)  {
+
+    if (count_ == 0)
+        throw NotSolvable ();
+    if (count_ == 1)  {
+        reset (dimension ());
+        return;
+    }
+
+    const value_type    n = value_type(count_);
+
+    for (size_type i = 0; i < dimension (); ++i, ++first)  {
+        delta_[i] = value_type(*first) - mean_[i];
+        mean_[i] -= delta_[i] / (n - value_type(1));
+    }
+    rank_one_ (-n / (n - value_type(1)), delta_.data ());
+    count_ -= 1;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void CovarianceAccumulator<T>::merge (const CovarianceAccumulator &that)  {
+
+    if (that.dimension () != dimension ())
+        throw NotSolvable ();
+    if (that.count_ == 0)  return;
+
+    const size_type     d = dimension ();
+    const value_type    *that_m =
+        d != 0 ? &(*that.comoment_.col_begin ()) : nullptr;
+
+    combine_ (that.count_, that.mean_.data (),
+              [that_m, d](std::size_t j) -> const value_type *  {
+                  return (packed_column__ (that_m, d, j));
+              });
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+typename CovarianceAccumulator<T>::SymmMatrix
+CovarianceAccumulator<T>::covariance (bool is_unbiased) const  {
+
+    const value_type    denom =
+        is_unbiased ? value_type(count_) - 1 : value_type(count_);
+
+    if (denom <= value_type(0))
+        throw NotSolvable ();
+
+    SymmMatrix          result = comoment_;
+    const std::size_t   d = dimension ();
+
+    if (d != 0)  {
+        value_type  *ap = &(*result.col_begin ());
+
+        for (std::size_t i = 0; i < d * (d + 1) / 2; ++i)
+            ap[i] /= denom;
+    }
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+typename CovarianceAccumulator<T>::SymmMatrix
+CovarianceAccumulator<T>::correlation () const  {
+
+    SymmMatrix  result = covariance ();
+
+    covariance_to_correlation__ (result);
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline void CovarianceAccumulator<T>::update_ () noexcept  {
+
+    const size_type d = dimension ();
+
+    count_ += 1;
+
+    const value_type    n = value_type(count_);
+
+    for (size_type i = 0; i < d; ++i)  {
+        delta_[i] -= mean_[i];
+        mean_[i] += delta_[i] / n;
+    }
+    if (count_ > 1)
+        rank_one_ ((n - value_type(1)) / n, delta_.data ());
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline void
+CovarianceAccumulator<T>::rank_one_ (value_type alpha,
+                                     const value_type *x) noexcept  {
+
+    if (dimension () != 0)
+        packed_rank_one__ (packed_data_ (), dimension (),
+                           value_type(1), alpha, x);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class COLUMN>
+inline void
+CovarianceAccumulator<T>::combine_ (std::size_t nb,
+                                    const value_type *mean_b,
+                                    COLUMN comoment_b)  {
+
+    const size_type     d = dimension ();
+    const std::size_t   na = count_;
+    const value_type    n = value_type(na + nb);
+
+    for (size_type i = 0; i < d; ++i)  {
+        delta_[i] = mean_b[i] - mean_[i];
+        mean_[i] += delta_[i] * (value_type(nb) / n);
+    }
+    if (d != 0)  {
+        value_type  *ap = packed_data_ ();
+
+        for (size_type j = 0; j < d; ++j)  {
+            value_type          *col = packed_column__ (ap, d, j);
+            const value_type    *col_b = comoment_b (j);
+
+            for (size_type i = j; i < d; ++i)
+                col[i] += col_b[i];
+        }
+    }
+    if (na != 0)
+        rank_one_ (value_type(na) * value_type(nb) / n, delta_.data ());
+    count_ = na + nb;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename CovarianceAccumulator<T>::value_type *
+CovarianceAccumulator<T>::packed_data_ () noexcept  {
+
+    return (&(*comoment_.col_begin ()));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline void covariance_to_correlation__ (Matrix<SymmMatrixBase, T> &cov)  {
+
+    using size_type = typename Matrix<SymmMatrixBase, T>::size_type;
+
+    const size_type n = cov.columns ();
+
+    if (n == 0)  return;
+
+    std::vector<T>  std_dev (n);
+    T               *ap = &(*cov.col_begin ());
+
+    for (size_type i = 0; i < n; ++i)
+        std_dev[i] = std::sqrt (cov (i, i));
+    for (size_type j = 0; j < n; ++j)  {
+        T   *col = packed_column__ (ap, n, j);
+
+        for (size_type i = j; i < n; ++i)
+            col[i] /= std_dev[i] * std_dev[j];
+    }
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -35,19 +35,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Tiger/StepVectorRange.h>
 
 #include <Tiger/MatrixBase.h>
+#include <Tiger/MemoryArena.h>
 
 // ----------------------------------------------------------------------------
 
 namespace hmma
 {
 
-template<class T>
-class   DenseMatrixBase : public DenseMatrixStorage<T>  {
+template<class T, class S>
+class   BasicDenseMatrixBase : public DenseMatrixStorage<T, S>  {
 
 
 public:
 
-    using BaseClass = DenseMatrixStorage<T>;
+    using BaseClass = DenseMatrixStorage<T, S>;
     using size_type = typename BaseClass::size_type;
     using value_type = typename BaseClass::value_type;
     using reference = typename BaseClass::reference;
@@ -58,16 +59,16 @@ public:
     using ColumnVector = VectorRange<value_type>;
     using RowVector = StepVectorRange<value_type>;
 
-    using SelfType = DenseMatrixBase<value_type>;
+    using SelfType = BasicDenseMatrixBase<value_type, S>;
 
 protected:
 
     using DataVector = typename BaseClass::DataVector;
 
-    inline DenseMatrixBase () noexcept  {   }
+    inline BasicDenseMatrixBase () noexcept  {   }
 
     inline
-    DenseMatrixBase (size_type row,
+    BasicDenseMatrixBase (size_type row,
                      size_type col,
                      const_reference def_value = value_type ())
         noexcept
@@ -75,6 +76,12 @@ protected:
 
     static inline bool _is_symmetric_matrix () noexcept { return (false); }
 
+   // In-place transpose. Square matrices swap blocks across the diagonal.
+   // Small rectangular ones go through a scratch copy and large ones
+   // follow the cycles of the permutation (see GEMMBlocking).
+   //
+    void _transpose ();
+
 public:
 
     void resize (size_type in_row,
@@ -133,13 +140,22 @@ public:
     using col_iterator = typename DataVector::iterator;
     using col_const_iterator = typename DataVector::const_iterator;
 
-   // It goes through the matrix row-by-row starting at [0, 0]
+   // It goes through the matrix row-by-row starting at [0, 0].
+   // It is a pointer into the column-major data, plus the row and column
+   // it is on. Moving along a row adds the number of rows to the pointer
+   // and at the end of a row it wraps to the start of the next one. So
+   // there is no divide or modulo per element. Random access and distance
+   // are computed from the row and column.
    //
     class   row_iterator  {
 
     public:
 
         using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename SelfType::value_type;
+        using difference_type = long;
+        using pointer = typename SelfType::pointer;
+        using reference = typename SelfType::reference;
 
     public:
 
@@ -149,102 +165,160 @@ public:
         inline row_iterator () = default;
 
         inline row_iterator (SelfType *m, size_type idx = 0) noexcept
-            : matx_ (m), idx_ (idx)  {   }
+            : base_ (m->_get_data ().data ()),
+              rows_ (m->rows ()),
+              cols_ (m->columns ())  {
 
-        inline bool operator == (const row_iterator &rhs) const  {
+            seek_ (idx);
+        }
 
-            return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+       // The pointer alone doesn't tell the end from [0, 1]
+       //
+        inline bool operator == (const row_iterator &rhs) const noexcept  {
+
+            return (ptr_ == rhs.ptr_ && col_ == rhs.col_);
         }
-        inline bool operator != (const row_iterator &rhs) const  {
+        inline bool operator != (const row_iterator &rhs) const noexcept  {
 
-            return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+            return (ptr_ != rhs.ptr_ || col_ != rhs.col_);
         }
+        inline bool operator < (const row_iterator &rhs) const noexcept  {
 
-       // Following STL style, this iterator appears as a pointer
-       // to value_type.
-       //
-        inline pointer operator -> () const noexcept  {
+            return (index_ () < rhs.index_ ());
+        }
+        inline bool operator > (const row_iterator &rhs) const noexcept  {
 
-            return (&(matx_->at (idx_ / matx_->columns (),
-                                 idx_ % matx_->columns ())));
+            return (index_ () > rhs.index_ ());
         }
-        inline reference operator * () const noexcept  {
+        inline bool operator <= (const row_iterator &rhs) const noexcept  {
 
-            return (matx_->at (idx_ / matx_->columns (),
-                               idx_ % matx_->columns ()));
+            return (index_ () <= rhs.index_ ());
         }
-        inline operator pointer () const noexcept  {
+        inline bool operator >= (const row_iterator &rhs) const noexcept  {
+
+            return (index_ () >= rhs.index_ ());
+        }
+
+       // Following STL style, this iterator appears as a pointer
+       // to value_type.
+       //
+        inline pointer operator -> () const noexcept  { return (ptr_); }
+        inline reference operator * () const noexcept  { return (*ptr_); }
+        inline operator pointer () const noexcept  { return (ptr_); }
 
-            return (&(matx_->at (idx_ / matx_->columns (),
-                                 idx_ % matx_->columns ())));
+        inline reference operator [] (long i) const noexcept  {
+
+            return (*(*this + i));
         }
 
        // We are following STL style iterator interface.
        //
         inline row_iterator &operator ++ () noexcept  {    // ++Prefix
 
-            idx_ += 1;
+            if (++col_ == cols_)  {
+                col_ = 0;
+                ptr_ = base_ + ++row_;
+            }
+            else
+                ptr_ += rows_;
             return (*this);
         }
         inline row_iterator operator ++ (int) noexcept  {  // Postfix++
 
-            const size_type ret_idx = idx_;
+            const row_iterator    ret = *this;
 
-            idx_ += 1;
-            return (row_iterator (matx_, ret_idx));
+            ++(*this);
+            return (ret);
         }
 
         inline row_iterator &operator += (long i) noexcept  {
 
-            idx_ += i;
+            seek_ (index_ () + i);
             return (*this);
         }
 
         inline row_iterator &operator -- () noexcept  {    // --Prefix
 
-            idx_ -= 1;
+            if (col_ == 0)  {
+                col_ = cols_ - 1;
+                ptr_ = base_ + col_ * rows_ + --row_;
+            }
+            else  {
+                col_ -= 1;
+                ptr_ -= rows_;
+            }
             return (*this);
         }
         inline row_iterator operator -- (int) noexcept  {  // Postfix--
 
-            const size_type ret_idx = idx_;
+            const row_iterator    ret = *this;
 
-            idx_ -= 1;
-            return (row_iterator (matx_, ret_idx));
+            --(*this);
+            return (ret);
         }
 
         inline row_iterator &operator -= (int i) noexcept  {
 
-            idx_ -= i;
+            seek_ (index_ () - i);
             return (*this);
         }
 
-        inline row_iterator operator + (int i) noexcept  {
+        inline row_iterator operator + (int i) const noexcept  {
 
-            return (row_iterator (matx_, idx_ + i));
+            return (row_iterator (*this) += i);
         }
 
-        inline row_iterator operator - (int i) noexcept  {
+        inline row_iterator operator - (int i) const noexcept  {
 
-            return (row_iterator (matx_, idx_ - i));
+            return (row_iterator (*this) -= i);
         }
 
-        inline row_iterator operator + (long i) noexcept  {
+        inline row_iterator operator + (long i) const noexcept  {
 
-            return (row_iterator (matx_, idx_ + i));
+            return (row_iterator (*this) += i);
         }
 
-        inline row_iterator operator - (long i) noexcept  {
+        inline row_iterator operator - (long i) const noexcept  {
 
-            return (row_iterator (matx_, idx_ - i));
+            return (row_iterator (*this) += -i);
+        }
+
+        inline difference_type
+        operator - (const row_iterator &rhs) const noexcept  {
+
+            return (index_ () - rhs.index_ ());
         }
 
     private:
 
-        SelfType    *matx_ { nullptr };
-        size_type   idx_ { 0 };
+        inline long index_ () const noexcept  {
+
+            return (long(row_) * cols_ + col_);
+        }
 
-        friend  class   DenseMatrixBase::row_const_iterator;
+       // Random access is the only place that divides. The two ends, which
+       // loops construct all the time (e.g. row_end()), don't.
+       //
+        inline void seek_ (long idx) noexcept  {
+
+            if (idx == 0 || idx == long(rows_) * cols_)  {
+                row_ = idx == 0 ? 0 : rows_;
+                col_ = 0;
+            }
+            else  {
+                row_ = size_type(idx / cols_);
+                col_ = size_type(idx % cols_);
+            }
+            ptr_ = base_ + std::size_t(col_) * rows_ + row_;
+        }
+
+        pointer     base_ { nullptr };  // Element [0, 0]
+        pointer     ptr_ { nullptr };
+        size_type   rows_ { 0 };  // Distance between two columns
+        size_type   cols_ { 0 };
+        size_type   row_ { 0 };
+        size_type   col_ { 0 };
+        friend  class   BasicDenseMatrixBase::row_const_iterator;
     };
 
     class   row_const_iterator  {
@@ -252,132 +326,196 @@ public:
     public:
 
         using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename SelfType::value_type;
+        using difference_type = long;
+        using pointer = typename SelfType::const_pointer;
+        using reference = typename SelfType::const_reference;
 
     public:
 
        // NOTE: The constructor with no argument initializes
-       //       the row_const_iterator to be an "undefined"
-       //       row_const_iterator
+       //       the row_const_iterator to be an "undefined" row_const_iterator
        //
-        inline row_const_iterator() = default;
+        inline row_const_iterator () = default;
 
         inline row_const_iterator (const SelfType *m,
                                    size_type idx = 0) noexcept
-            : matx_ (m), idx_ (idx)  {   }
+            : base_ (m->_get_data ().data ()),
+              rows_ (m->rows ()),
+              cols_ (m->columns ())  {
+
+            seek_ (idx);
+        }
 
-        inline row_const_iterator (const row_iterator &that)  {
+        inline row_const_iterator (const row_iterator &that) noexcept  {
 
             *this = that;
         }
 
         inline row_const_iterator &
-        operator = (const row_iterator &rhs)  {
-
-            matx_ = rhs.matx_;
-            idx_ = rhs.idx_;
+        operator = (const row_iterator &rhs) noexcept  {
+
+            base_ = rhs.base_;
+            ptr_ = rhs.ptr_;
+            rows_ = rhs.rows_;
+            cols_ = rhs.cols_;
+            row_ = rhs.row_;
+            col_ = rhs.col_;
             return (*this);
         }
 
-        inline bool operator == (const row_const_iterator &rhs) const {
+       // The pointer alone doesn't tell the end from [0, 1]
+       //
+        inline bool
+        operator == (const row_const_iterator &rhs) const noexcept  {
 
-            return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+            return (ptr_ == rhs.ptr_ && col_ == rhs.col_);
         }
-        inline bool operator != (const row_const_iterator &rhs) const {
+        inline bool
+        operator != (const row_const_iterator &rhs) const noexcept  {
 
-            return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+            return (ptr_ != rhs.ptr_ || col_ != rhs.col_);
         }
+        inline bool
+        operator < (const row_const_iterator &rhs) const noexcept  {
 
-       // Following STL style, this iterator appears as a pointer
-       // to value_type.
-       //
-        inline const_pointer operator -> () const noexcept  {
+            return (index_ () < rhs.index_ ());
+        }
+        inline bool
+        operator > (const row_const_iterator &rhs) const noexcept  {
 
-            return (&(matx_->at (idx_ / matx_->columns (),
-                                 idx_ % matx_->columns ())));
+            return (index_ () > rhs.index_ ());
         }
-        inline const_reference operator * () const noexcept  {
+        inline bool
+        operator <= (const row_const_iterator &rhs) const noexcept  {
 
-            return (matx_->at (idx_ / matx_->columns (),
-                               idx_ % matx_->columns ()));
+            return (index_ () <= rhs.index_ ());
         }
-        inline operator const_pointer () const noexcept  {
+        inline bool
+        operator >= (const row_const_iterator &rhs) const noexcept  {
 
-            return (&(matx_->at (idx_ / matx_->columns (),
-                                 idx_ % matx_->columns ())));
+            return (index_ () >= rhs.index_ ());
         }
 
-       // ++Prefix
+       // Following STL style, this iterator appears as a pointer
+       // to value_type.
        //
-        inline row_const_iterator &operator ++ () noexcept  {
+        inline pointer operator -> () const noexcept  { return (ptr_); }
+        inline reference operator * () const noexcept  { return (*ptr_); }
+        inline operator pointer () const noexcept  { return (ptr_); }
 
-            idx_ += 1;
-            return (*this);
+        inline reference operator [] (long i) const noexcept  {
+
+            return (*(*this + i));
         }
 
-       // Postfix++
+       // We are following STL style iterator interface.
        //
-        inline row_const_iterator operator ++ (int) noexcept  {
+        inline row_const_iterator &operator ++ () noexcept  {    // ++Prefix
+
+            if (++col_ == cols_)  {
+                col_ = 0;
+                ptr_ = base_ + ++row_;
+            }
+            else
+                ptr_ += rows_;
+            return (*this);
+        }
+        inline row_const_iterator operator ++ (int) noexcept  {  // Postfix++
 
-            const size_type ret_idx = idx_;
+            const row_const_iterator    ret = *this;
 
-            idx_ += 1;
-            return (row_const_iterator (matx_, ret_idx));
+            ++(*this);
+            return (ret);
         }
 
         inline row_const_iterator &operator += (long i) noexcept  {
 
-            idx_ += i;
+            seek_ (index_ () + i);
             return (*this);
         }
 
-       // --Prefix
-       //
-        inline row_const_iterator &operator -- () noexcept  {
+        inline row_const_iterator &operator -- () noexcept  {    // --Prefix
 
-            idx_ -= 1;
+            if (col_ == 0)  {
+                col_ = cols_ - 1;
+                ptr_ = base_ + col_ * rows_ + --row_;
+            }
+            else  {
+                col_ -= 1;
+                ptr_ -= rows_;
+            }
             return (*this);
         }
+        inline row_const_iterator operator -- (int) noexcept  {  // Postfix--
 
-       // Postfix--
-       //
-        inline row_const_iterator operator -- (int) noexcept  {
-
-            const size_type ret_idx = idx_;
+            const row_const_iterator    ret = *this;
 
-            idx_ -= 1;
-            return (row_const_iterator (matx_, ret_idx));
+            --(*this);
+            return (ret);
         }
 
         inline row_const_iterator &operator -= (int i) noexcept  {
 
-            idx_ -= i;
+            seek_ (index_ () - i);
             return (*this);
         }
 
-        inline row_const_iterator operator + (int i) noexcept  {
+        inline row_const_iterator operator + (int i) const noexcept  {
+
+            return (row_const_iterator (*this) += i);
+        }
+
+        inline row_const_iterator operator - (int i) const noexcept  {
 
-            return (row_const_iterator (matx_, idx_ + i));
+            return (row_const_iterator (*this) -= i);
         }
 
-        inline row_const_iterator operator - (int i) noexcept  {
+        inline row_const_iterator operator + (long i) const noexcept  {
 
-            return (row_const_iterator (matx_, idx_ - i));
+            return (row_const_iterator (*this) += i);
         }
 
-        inline row_const_iterator operator + (long i) noexcept  {
+        inline row_const_iterator operator - (long i) const noexcept  {
 
-            return (row_const_iterator (matx_, idx_ + i));
+            return (row_const_iterator (*this) += -i);
         }
 
-        inline row_const_iterator operator - (long i) noexcept  {
+        inline difference_type
+        operator - (const row_const_iterator &rhs) const noexcept  {
 
-            return (row_const_iterator (matx_, idx_ - i));
+            return (index_ () - rhs.index_ ());
         }
 
     private:
 
-        const SelfType  *matx_ { nullptr };
-        size_type       idx_ { 0 };
+        inline long index_ () const noexcept  {
+
+            return (long(row_) * cols_ + col_);
+        }
+
+       // Random access is the only place that divides. The two ends, which
+       // loops construct all the time (e.g. row_end()), don't.
+       //
+        inline void seek_ (long idx) noexcept  {
+
+            if (idx == 0 || idx == long(rows_) * cols_)  {
+                row_ = idx == 0 ? 0 : rows_;
+                col_ = 0;
+            }
+            else  {
+                row_ = size_type(idx / cols_);
+                col_ = size_type(idx % cols_);
+            }
+            ptr_ = base_ + std::size_t(col_) * rows_ + row_;
+        }
+
+        pointer     base_ { nullptr };  // Element [0, 0]
+        pointer     ptr_ { nullptr };
+        size_type   rows_ { 0 };  // Distance between two columns
+        size_type   cols_ { 0 };
+        size_type   row_ { 0 };
+        size_type   col_ { 0 };
     };
 
     inline col_iterator col_begin () noexcept  {
@@ -415,6 +553,24 @@ public:
     }
 };
 
+// ----------------------------------------------------------------------------
+
+// The data vector is a std::vector
+//
+template<class T>
+using DenseMatrixBase = BasicDenseMatrixBase<T, std::vector<T> >;
+
+// The data vector is a memory-mapped file (see MMapVector.h)
+//
+template<class T>
+using MMapDenseMatrixBase = BasicDenseMatrixBase<T, MMapVector<T> >;
+
+// The data vector is on the current MemoryArena of the thread (see
+// MemoryArena.h)
+//
+template<class T>
+using ArenaDenseMatrixBase = BasicDenseMatrixBase<T, ArenaVector<T> >;
+
 } // namespace hmma
 
 // ----------------------------------------------------------------------------
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <Tiger/DenseMatrixBase.h>
+#include <Tiger/MatrixKernels.h>
 
 // ----------------------------------------------------------------------------
 
@@ -37,18 +38,18 @@ namespace hmma
 // This is a column major matrix. if it were row major, we would have
 // return (*(data_.begin () + (r * columns () + c)));
 //
-template<class T>
-inline typename DenseMatrixBase<T>::reference
-DenseMatrixBase<T>::at (size_type r, size_type c) noexcept  {
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::reference
+BasicDenseMatrixBase<T, S>::at (size_type r, size_type c) noexcept  {
 
     return (BaseClass::_get_data () [c * BaseClass::rows () + r]);
 }
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename DenseMatrixBase<T>::const_reference
-DenseMatrixBase<T>::
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::const_reference
+BasicDenseMatrixBase<T, S>::
 at (size_type r, size_type c) const noexcept  {
 
     return (BaseClass::_get_data () [c * BaseClass::rows () + r]);
@@ -56,9 +57,9 @@ at (size_type r, size_type c) const noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename DenseMatrixBase<T>::ColumnVector
-DenseMatrixBase<T>::get_column (size_type c) noexcept  {
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::ColumnVector
+BasicDenseMatrixBase<T, S>::get_column (size_type c) noexcept  {
 
     return (
         ColumnVector (
@@ -68,9 +69,9 @@ DenseMatrixBase<T>::get_column (size_type c) noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename DenseMatrixBase<T>::ColumnVector
-DenseMatrixBase<T>::get_column (size_type c) const noexcept  {
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::ColumnVector
+BasicDenseMatrixBase<T, S>::get_column (size_type c) const noexcept  {
 
     return (
         ColumnVector (
@@ -82,9 +83,9 @@ DenseMatrixBase<T>::get_column (size_type c) const noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename DenseMatrixBase<T>::RowVector
-DenseMatrixBase<T>::get_row (size_type r) noexcept  {
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::RowVector
+BasicDenseMatrixBase<T, S>::get_row (size_type r) noexcept  {
 
     return (
         RowVector (
@@ -95,9 +96,9 @@ DenseMatrixBase<T>::get_row (size_type r) noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename DenseMatrixBase<T>::RowVector
-DenseMatrixBase<T>::get_row (size_type r) const noexcept  {
+template<class T, class S>
+inline typename BasicDenseMatrixBase<T, S>::RowVector
+BasicDenseMatrixBase<T, S>::get_row (size_type r) const noexcept  {
 
     return (
         RowVector (
@@ -110,9 +111,9 @@ DenseMatrixBase<T>::get_row (size_type r) const noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class ITER>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 set_column (ITER col_data, size_type col)  {
 
     for (size_type r = 0; r < BaseClass::rows (); ++r)
@@ -123,9 +124,9 @@ set_column (ITER col_data, size_type col)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class ITER>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 set_row (ITER row_data, size_type row)  {
 
     for (size_type c = 0; c < BaseClass::columns (); ++c)
@@ -136,9 +137,9 @@ set_row (ITER row_data, size_type row)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class OPT, class ITER>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 column_operation (OPT opt, ITER col_data, size_type col)  {
 
     for (size_type r = 0; r < BaseClass::rows (); ++r)  {
@@ -152,9 +153,9 @@ column_operation (OPT opt, ITER col_data, size_type col)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class OPT, class ITER>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 row_operation (OPT opt, ITER row_data, size_type row)  {
 
     for (size_type c = 0; c < BaseClass::columns (); ++c)  {
@@ -168,9 +169,9 @@ row_operation (OPT opt, ITER row_data, size_type row)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class OPT, class EXPR>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 scale_column (OPT opt, const EXPR &e, size_type col)  {
 
     for (size_type r = 0; r < BaseClass::rows (); ++r)  {
@@ -184,9 +185,9 @@ scale_column (OPT opt, const EXPR &e, size_type col)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class OPT, class EXPR>
-inline void DenseMatrixBase<T>::
+inline void BasicDenseMatrixBase<T, S>::
 scale_row (OPT opt, const EXPR &e, size_type row)  {
 
     for (size_type c = 0; c < BaseClass::columns (); ++c)  {
@@ -200,10 +201,10 @@ scale_row (OPT opt, const EXPR &e, size_type row)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
+template<class T, class S>
 template<class OPT, class EXPR>
 inline void
-DenseMatrixBase<T>::
+BasicDenseMatrixBase<T, S>::
 scale (OPT opt, const EXPR &e) noexcept  {
 
     for (col_iterator iter = col_begin (); iter != col_end (); ++iter)
@@ -214,8 +215,8 @@ scale (OPT opt, const EXPR &e) noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-void DenseMatrixBase<T>::
+template<class T, class S>
+void BasicDenseMatrixBase<T, S>::
 resize (size_type in_row, size_type in_col, const_reference def_value)  {
 
     BaseClass::_resize (in_row, in_col, in_row * in_col, true, def_value);
@@ -224,8 +225,38 @@ resize (size_type in_row, size_type in_col, const_reference def_value)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-std::ostream &DenseMatrixBase<T>::
+template<class T, class S>
+void BasicDenseMatrixBase<T, S>::_transpose ()  {
+
+    const size_type rows = BaseClass::rows ();
+    const size_type cols = BaseClass::columns ();
+
+    if (rows > 1 && cols > 1)  {
+        pointer data = &(*col_begin ());
+
+        if (rows == cols)
+            transpose_square (rows, data, rows);
+        else if (std::size_t(rows) * cols <
+                     GEMMBlocking<value_type>::TRANSPOSE_SCRATCH)  {
+            const typename BaseClass::ScratchVector scratch (col_begin (),
+                                                             col_end ());
+
+            transpose (rows, cols, &(scratch[0]), rows, data, cols);
+        }
+        else
+            transpose_cycles (rows, cols, data);
+    }
+
+   // The data has the same size. Only the dimensions swap.
+   //
+    BaseClass::_resize (cols, rows, rows * cols, false);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T, class S>
+std::ostream &BasicDenseMatrixBase<T, S>::
 dump (std::ostream &out_stream) const  {
 
     // const   size_type           old_precision = out_stream.precision (2);
@@ -0,0 +1,177 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <Tiger/Matrix.h>
+
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// LU decomposition with partial pivoting:
+//     P * A = L * U
+//
+// where P is a permutation matrix, L is unit lower triangular and U is
+// upper triangular. The factors are computed once and can then be used
+// for the determinant, solving simultaneous equations for any number of
+// right-hand sides, the inverse, etc. without eliminating A again.
+//
+// L and U are packed into one dense matrix (the unit diagonal of L is not
+// stored). P is kept as a vector of row interchanges: at step i, row i was
+// swapped with row pivots[i] (pivots[i] >= i). Rows are never physically
+// moved through the whole matrix one step at a time.
+//
+// It is a blocked right-looking factorization. A narrow panel of columns
+// is factored, then the trailing matrix is updated by a triangular solve
+// and a matrix multiply (see MatrixKernels.h), which does most of the
+// work.
+//
+// A may be rectangular. But determinant(), solve() and inverse() need a
+// square matrix.
+//
+template<class MAT>
+class   LUFactorization  {
+
+public:
+
+    using MatrixType = MAT;
+    using size_type = typename MatrixType::size_type;
+    using value_type = typename MatrixType::value_type;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+    using PivotVector = std::vector<size_type>;
+
+    LUFactorization () = default;
+    explicit LUFactorization (const MatrixType &mat);
+
+    void factorize (const MatrixType &mat);
+
+    inline size_type rows () const noexcept  { return (lu_.rows ()); }
+    inline size_type columns () const noexcept  { return (lu_.columns ()); }
+
+    inline const DenseMatrix &get_lu () const noexcept  { return (lu_); }
+    inline const PivotVector &
+    get_pivots () const noexcept  { return (pivots_); }
+
+   // L is rows X rows and U is rows X columns
+   //
+    template<class MAT2>
+    inline void get_lower (MAT2 &L) const;
+    template<class MAT2>
+    inline void get_upper (MAT2 &U) const;
+
+   // Square and at least one of the U diagonal values is zero
+   //
+    inline bool is_singular () const noexcept;
+
+   // Number of linearly independent rows (or columns) of A. It is found
+   // by reducing U to row echelon form. Pivots not bigger than
+   // max(rows, columns) * epsilon * max|U| are taken as zero.
+   //
+    inline size_type rank () const noexcept;
+
+    inline value_type determinant () const; // throw (NotSquare)
+
+   // Solve A * X = rhs and return X. rhs can have any number of columns.
+   // X is found by forward and backward triangular solves over the whole
+   // rhs panel, blocked so most of the work is matrix multiplication.
+   //
+    template<class MAT2>
+    inline MAT2
+    solve (const MAT2 &rhs) const; // throw (NotSolvable, Singular)
+
+   // Same as above, but X overwrites rhs. If rhs is a dense matrix,
+   // nothing is allocated.
+   //
+    template<class MAT2>
+    inline MAT2 &
+    solve_in_place (MAT2 &rhs) const; // throw (NotSolvable, Singular)
+
+    template<class MAT2>
+    inline MAT2 &inverse (MAT2 &that) const; // throw (NotSquare, Singular)
+
+private:
+
+   // Width of the panels
+   //
+    static constexpr size_type  BLOCK_ = 64;
+
+    static inline void
+    getf2_ (size_type m, size_type n,
+            value_type *a, size_type lda,
+            size_type *pivots) noexcept;
+    static inline void
+    laswp_ (size_type n,
+            value_type *a, size_type lda,
+            size_type k1, size_type k2,
+            const size_type *pivots) noexcept;
+    static inline void
+    getrf_ (size_type m, size_type n,
+            value_type *a, size_type lda,
+            size_type *pivots);
+
+   // Overwrites the n X k rhs with the solution
+   //
+    inline void solve_dense_ (DenseMatrix &rhs) const;
+
+    inline void check_solvable_ (size_type rhs_rows) const;
+
+    template<class MAT2>
+    inline void solve_in_place_ (MAT2 &rhs) const;
+    inline void solve_in_place_ (DenseMatrix &rhs) const;
+
+    template<class MAT2>
+    static inline void copy_ (const MAT2 &from, DenseMatrix &to);
+    static inline void copy_ (const DenseMatrix &from, DenseMatrix &to);
+    template<class MAT2>
+    static inline void move_ (DenseMatrix &from, MAT2 &to);
+    static inline void move_ (DenseMatrix &from, DenseMatrix &to) noexcept;
+
+    DenseMatrix lu_ { };
+    PivotVector pivots_ { };
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/LUFactorization.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,460 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Tiger/LUFactorization.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+#include <limits>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class MAT>
+constexpr typename LUFactorization<MAT>::size_type
+LUFactorization<MAT>::BLOCK_;
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+LUFactorization<MAT>::LUFactorization (const MatrixType &mat)  {
+
+    factorize (mat);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+void LUFactorization<MAT>::factorize (const MatrixType &mat)  {
+
+    copy_ (mat, lu_);
+    pivots_.resize (std::min (lu_.rows (), lu_.columns ()));
+    if (! pivots_.empty ())
+        getrf_ (lu_.rows (), lu_.columns (),
+                &(*lu_.col_begin ()), lu_.rows (), pivots_.data ());
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void LUFactorization<MAT>::get_lower (MAT2 &L) const  {
+
+    const size_type m = lu_.rows ();
+
+    L.resize (m, m);
+    for (size_type c = 0; c < m; ++c)  {
+        L (c, c) = value_type(1.0);
+        if (c < lu_.columns ())
+            for (size_type r = c + 1; r < m; ++r)
+                L (r, c) = lu_ (r, c);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void LUFactorization<MAT>::get_upper (MAT2 &U) const  {
+
+    U.resize (lu_.rows (), lu_.columns ());
+    for (size_type c = 0; c < lu_.columns (); ++c)
+        for (size_type r = 0; r <= c && r < lu_.rows (); ++r)
+            U (r, c) = lu_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline bool LUFactorization<MAT>::is_singular () const noexcept  {
+
+    if (lu_.rows () != lu_.columns ())
+        return (false);
+
+    for (size_type i = 0; i < lu_.rows (); ++i)
+        if (lu_ (i, i) == value_type(0.0))
+            return (true);
+
+    return (false);
+}
+
+// ----------------------------------------------------------------------------
+
+// Since L is invertible, A has the rank of U. But U is not in echelon
+// form, if some columns had no pivot (e.g. a zero leading column). So its
+// non-zero rows are eliminated again, skipping the columns that have no
+// pivot, and the pivots found are counted.
+//
+template<class MAT>
+inline typename LUFactorization<MAT>::size_type
+LUFactorization<MAT>::rank () const noexcept  {
+
+    const size_type m = lu_.rows ();
+    const size_type n = lu_.columns ();
+    const size_type mn = std::min (m, n);
+    DenseMatrix     u (mn, n, value_type(0.0));
+    value_type      max_abs (0.0);
+
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = 0; r <= c && r < mn; ++r)  {
+            u (r, c) = lu_ (r, c);
+            max_abs = std::max (max_abs, abs__ (u (r, c)));
+        }
+
+    const value_type    tolerance =
+        value_type(std::max (m, n)) *
+        std::numeric_limits<value_type>::epsilon () * max_abs;
+    size_type           rank = 0;
+
+    for (size_type c = 0; c < n && rank < mn; ++c)  {
+        size_type   p = rank;
+
+        for (size_type r = rank + 1; r < mn; ++r)
+            if (abs__ (u (r, c)) > abs__ (u (p, c)))
+                p = r;
+        if (abs__ (u (p, c)) <= tolerance)
+            continue;
+
+        if (p != rank)
+            for (size_type cc = c; cc < n; ++cc)
+                std::swap (u (rank, cc), u (p, cc));
+        for (size_type r = rank + 1; r < mn; ++r)  {
+            const value_type    factor = u (r, c) / u (rank, c);
+
+            for (size_type cc = c; cc < n; ++cc)
+                u (r, cc) -= factor * u (rank, cc);
+        }
+        rank += 1;
+    }
+
+    return (rank);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline typename LUFactorization<MAT>::value_type
+LUFactorization<MAT>::determinant () const  {
+
+    if (lu_.rows () != lu_.columns ())
+        throw NotSquare ();
+
+    value_type  result (1.0);
+
+    for (size_type i = 0; i < lu_.rows (); ++i)  {
+        const value_type    diag = lu_ (i, i);
+
+        if (diag == value_type(0.0))
+            return (value_type(0.0));
+
+        if (pivots_[i] != i)
+            result = -result;
+        result *= diag;
+    }
+
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2 LUFactorization<MAT>::solve (const MAT2 &rhs) const  {
+
+    MAT2    sol = rhs;
+
+    return (solve_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2 &LUFactorization<MAT>::solve_in_place (MAT2 &rhs) const  {
+
+    check_solvable_ (rhs.rows ());
+    solve_in_place_ (rhs);
+    return (rhs);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline MAT2 &LUFactorization<MAT>::inverse (MAT2 &that) const  {
+
+    if (lu_.rows () != lu_.columns ())
+        throw NotSquare ();
+    if (is_singular ())
+        throw Singular ();
+
+    DenseMatrix inv (lu_.rows (), lu_.columns ());
+
+    for (size_type i = 0; i < inv.rows (); ++i)
+        inv (i, i) = value_type(1.0);
+    solve_dense_ (inv);
+    move_ (inv, that);
+    return (that);
+}
+
+// ----------------------------------------------------------------------------
+
+// Unblocked factorization of an m X n panel. It is the classic column by
+// column Gaussian elimination, but the row interchanges and the updates
+// stay within the panel.
+//
+template<class MAT>
+inline void
+LUFactorization<MAT>::getf2_ (size_type m, size_type n,
+                              value_type *a, size_type lda,
+                              size_type *pivots) noexcept  {
+
+    const size_type mn = std::min (m, n);
+
+    for (size_type k = 0; k < mn; ++k)  {
+        value_type  *acol = a + k * lda;
+
+       // Find pivot.
+       //
+        size_type   p = k;
+
+        for (size_type r = k + 1; r < m; ++r)
+            if (abs__ (acol[r]) > abs__ (acol[p]))
+                p = r;
+        pivots[k] = p;
+
+       // If the whole column is zero, there is nothing to eliminate
+       //
+        if (acol[p] == value_type(0.0))
+            continue;
+
+        if (p != k)
+            for (size_type c = 0; c < n; ++c)
+                std::swap (a[k + c * lda], a[p + c * lda]);
+
+       // Compute multipliers and eliminate k-th column.
+       //
+        for (size_type r = k + 1; r < m; ++r)
+            acol[r] /= acol[k];
+        for (size_type c = k + 1; c < n; ++c)  {
+            value_type          *ccol = a + c * lda;
+            const value_type    u = ccol[k];
+
+            for (size_type r = k + 1; r < m; ++r)
+                ccol[r] -= acol[r] * u;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Apply the row interchanges k1 ... k2 - 1 to n columns of a
+//
+template<class MAT>
+inline void
+LUFactorization<MAT>::laswp_ (size_type n,
+                              value_type *a, size_type lda,
+                              size_type k1, size_type k2,
+                              const size_type *pivots) noexcept  {
+
+    for (size_type c = 0; c < n; ++c)  {
+        value_type  *col = a + c * lda;
+
+        for (size_type i = k1; i < k2; ++i)
+            if (pivots[i] != i)
+                std::swap (col[i], col[pivots[i]]);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+LUFactorization<MAT>::getrf_ (size_type m, size_type n,
+                              value_type *a, size_type lda,
+                              size_type *pivots)  {
+
+    const size_type mn = std::min (m, n);
+
+    for (size_type j = 0; j < mn; j += BLOCK_)  {
+        const size_type jb = std::min (BLOCK_, mn - j);
+        value_type      *a_jj = a + j + j * lda;
+
+       // Factor the panel of columns j ... j + jb - 1, from row j down
+       //
+        getf2_ (m - j, jb, a_jj, lda, pivots + j);
+        for (size_type i = j; i < j + jb; ++i)
+            pivots[i] += j;
+
+       // Apply the interchanges to the columns on the left and right
+       //
+        laswp_ (j, a, lda, j, j + jb, pivots);
+        if (j + jb < n)  {
+            const size_type nr = n - j - jb;
+            value_type      *a_right = a + (j + jb) * lda;
+
+            laswp_ (nr, a_right, lda, j, j + jb, pivots);
+
+           // U12 = Inverse(L11) * A12
+           //
+            trsm (false, false, true, jb, nr, a_jj, lda, a_right + j, lda);
+
+           // A22 = A22 - L21 * U12
+           //
+            if (j + jb < m)
+                gemm (false, false, m - j - jb, nr, jb,
+                      value_type(-1.0), a_jj + jb, lda,
+                      a_right + j, lda,
+                      value_type(1.0), a_right + j + jb, lda);
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+LUFactorization<MAT>::check_solvable_ (size_type rhs_rows) const  {
+
+    if (lu_.rows () != lu_.columns () || lu_.rows () != rhs_rows)
+        throw NotSolvable ();
+    if (is_singular ())
+        throw Singular ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Not a dense matrix, so it goes through a dense copy
+//
+template<class MAT>
+template<class MAT2>
+inline void LUFactorization<MAT>::solve_in_place_ (MAT2 &rhs) const  {
+
+    DenseMatrix sol;
+
+    copy_ (rhs, sol);
+    solve_dense_ (sol);
+    move_ (sol, rhs);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+LUFactorization<MAT>::solve_in_place_ (DenseMatrix &rhs) const  {
+
+    solve_dense_ (rhs);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void LUFactorization<MAT>::solve_dense_ (DenseMatrix &rhs) const  {
+
+    const size_type n = lu_.rows ();
+
+    if (n == 0 || rhs.columns () == 0)  return;
+
+    const value_type    *lu = &(*lu_.col_begin ());
+    value_type          *b = &(*rhs.col_begin ());
+
+   // P * A * X = L * U * X = P * rhs
+   //
+    laswp_ (rhs.columns (), b, n, 0, n, pivots_.data ());
+    trsm (false, false, true, n, rhs.columns (), lu, n, b, n);
+    trsm (true, false, false, n, rhs.columns (), lu, n, b, n);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void LUFactorization<MAT>::copy_ (const MAT2 &from, DenseMatrix &to)  {
+
+    to.resize (from.rows (), from.columns ());
+    for (size_type c = 0; c < from.columns (); ++c)
+        for (size_type r = 0; r < from.rows (); ++r)
+            to (r, c) = from (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+LUFactorization<MAT>::copy_ (const DenseMatrix &from, DenseMatrix &to)  {
+
+    to = from;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+template<class MAT2>
+inline void LUFactorization<MAT>::move_ (DenseMatrix &from, MAT2 &to)  {
+
+    to.resize (from.rows (), from.columns ());
+    for (size_type c = 0; c < from.columns (); ++c)
+        for (size_type r = 0; r < from.rows (); ++r)
+            to (r, c) = from (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+LUFactorization<MAT>::move_ (DenseMatrix &from, DenseMatrix &to) noexcept  {
+
+    to.swap (from);
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
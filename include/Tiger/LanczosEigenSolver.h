@@ -0,0 +1,180 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/Matrix.h>
+
+#include <functional>
+#include <random>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// A few eigenvalues at one end of the spectrum of a symmetric n X n matrix
+// A, and their eigenvectors, by the thick-restart Lanczos method (Wu and
+// Simon, SIAM J. Matrix Anal. Appl. 22, 2000).
+//
+// The solver never reads A. It only applies it to vectors through an
+// Operator. So the same solver works for a Matrix (see
+// Matrix::partial_eigen_space()) or for any user-supplied linear operator,
+// e.g. a factor model kept as B * ~B + D or a sparse matrix.
+//
+// The basis V has m > k orthonormal columns. It is extended by one
+// Lanczos vector, i.e. one product with A, at a time and each new vector
+// is orthogonalized against all the others twice by gemm(). When V is
+// full, the Ritz values and vectors are found from the m X m ~V * A * V.
+// If the k wanted ones have converged, they are the answer. Otherwise V
+// is restarted with the p Ritz vectors at the wanted end, k < p < m, and
+// the last Lanczos vector. That keeps a Krylov basis, so what was already
+// found is not thrown away.
+//
+// A Ritz pair (theta, u) has converged when the norm of its residual
+// A * u - theta * u, which Lanczos gives for free, is at most
+// tolerance * Max(|theta|).
+//
+// Warm start: The columns of the given block are orthonormalized and A is
+// applied to all of them in one block product. If k of its Ritz pairs
+// have converged already (e.g. A hasn't changed since the block was
+// computed), they are returned. Otherwise Lanczos starts from the sum of
+// the wanted Ritz vectors. That saves little if the wanted end of the
+// spectrum is clustered, since then most of the work is separating the
+// eigenvectors in the cluster, wherever the start is.
+//
+// MAT is the dense matrix type of the vectors. It must be column-major
+// and contiguous (e.g. DDMatrix).
+//
+template<class MAT>
+class   LanczosEigenSolver  {
+
+public:
+
+    using MatrixType = MAT;
+    using size_type = typename MatrixType::size_type;
+    using value_type = typename MatrixType::value_type;
+
+   // y = A * x. x and y are n X b, b >= 1. y is already sized.
+   //
+    using Operator =
+        std::function<void (const MatrixType &x, MatrixType &y)>;
+
+   // k is the number of eigenpairs wanted. If basis_size is 0, it is
+   // Max(2 * k, k + 20). It is never more than n.
+   //
+    explicit
+    LanczosEigenSolver (size_type k,
+                        eigen_part which = eigen_part::largest,
+                        value_type tolerance = value_type(1e-10),
+                        size_type max_restarts = 1000,
+                        size_type basis_size = 0);
+
+   // A is n X n. eigenvalues is 1 X k and eigenvectors is n X k. The
+   // largest values come back in descending order and the smallest in
+   // ascending order.
+   // They throw NotSolvable if n < 2, k is not in [1, n] or the
+   // eigenpairs don't converge in max_restarts restarts.
+   //
+    void solve (const Operator &op,
+                size_type n,
+                MatrixType &eigenvalues,
+                MatrixType &eigenvectors); // throw (NotSolvable)
+
+   // warm_start is n X b, usually the eigenvectors of a previous solve()
+   //
+    void solve (const Operator &op,
+                size_type n,
+                MatrixType &eigenvalues,
+                MatrixType &eigenvectors,
+                const MatrixType &warm_start); // throw (NotSolvable)
+
+   // Of the last solve(). The products count every column of a block.
+   //
+    inline size_type get_restarts () const noexcept  { return (restarts_); }
+    inline size_type get_products () const noexcept  { return (products_); }
+
+private:
+
+    inline void start_ (size_type n);
+    inline void apply_ (const Operator &op, size_type first, size_type b);
+    inline value_type orthogonalize_ (size_type j, value_type *w);
+    inline void random_column_ (size_type j);
+    inline bool
+    warm_start_ (const Operator &op,
+                 const MatrixType &warm_start,
+                 MatrixType &eigenvalues,
+                 MatrixType &eigenvectors);
+    inline void
+    iterate_ (const Operator &op,
+              MatrixType &eigenvalues,
+              MatrixType &eigenvectors); // throw (NotSolvable)
+    inline void
+    extract_ (size_type m,
+              size_type first,
+              MatrixType &eigenvalues,
+              MatrixType &eigenvectors) const;
+
+    size_type   k_;
+    eigen_part  which_;
+    value_type  tolerance_;
+    size_type   max_restarts_;
+    size_type   basis_size_;
+
+    size_type   n_ { 0 };
+    size_type   m_ { 0 };
+    size_type   restarts_ { 0 };
+    size_type   products_ { 0 };
+
+    MatrixType      basis_ { };     // n X (m + 1), V
+    MatrixType      projection_ { }; // m X m, ~V * A * V
+    MatrixType      ritz_values_ { };
+    MatrixType      ritz_vectors_ { };
+    MatrixType      x_ { };         // Operator arguments
+    MatrixType      y_ { };
+    MatrixType      coeffs_ { };    // Orthogonalization coefficients
+    std::mt19937    generator_ { };
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/LanczosEigenSolver.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,427 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/LanczosEigenSolver.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class MAT>
+LanczosEigenSolver<MAT>::LanczosEigenSolver (size_type k,
+                                             eigen_part which,
+                                             value_type tolerance,
+                                             size_type max_restarts,
+                                             size_type basis_size)
+    : k_ (k),
+      which_ (which),
+      tolerance_ (tolerance),
+      max_restarts_ (max_restarts),
+      basis_size_ (basis_size)  {   }
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+void LanczosEigenSolver<MAT>::solve (const Operator &op,
+                                     size_type n,
+                                     MatrixType &eigenvalues,
+                                     MatrixType &eigenvectors)  {
+
+    start_ (n);
+    random_column_ (0);
+    iterate_ (op, eigenvalues, eigenvectors);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+void LanczosEigenSolver<MAT>::solve (const Operator &op,
+                                     size_type n,
+                                     MatrixType &eigenvalues,
+                                     MatrixType &eigenvectors,
+                                     const MatrixType &warm_start)  {
+
+    if (warm_start.rows () != n)
+        throw NotSolvable ();
+
+    start_ (n);
+    if (! warm_start_ (op, warm_start, eigenvalues, eigenvectors))
+        iterate_ (op, eigenvalues, eigenvectors);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The generator is reseeded, so the same problem always takes the same
+// steps
+//
+template<class MAT>
+inline void LanczosEigenSolver<MAT>::start_ (size_type n)  {
+
+    if (n < 2 || k_ < 1 || k_ > n)
+        throw NotSolvable ();
+
+    n_ = n;
+    m_ = basis_size_ > 0
+             ? basis_size_
+             : std::max (size_type(2 * k_), size_type(k_ + 20));
+    m_ = std::min (std::max (m_, size_type(k_ + 1)), n);
+    restarts_ = 0;
+    products_ = 0;
+
+    basis_.resize (n_, m_ + 1);
+    coeffs_.resize (m_ + 1, 2);
+    generator_.seed (std::mt19937::default_seed);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// y_ = A * (b columns of the basis from first on)
+//
+template<class MAT>
+inline void LanczosEigenSolver<MAT>::
+apply_ (const Operator &op, size_type first, size_type b)  {
+
+    const value_type    *v = &(basis_ (0, first));
+
+    if (x_.rows () != n_ || x_.columns () != b)  {
+        x_.resize (n_, b);
+        y_.resize (n_, b);
+    }
+    std::copy (v, v + std::size_t(n_) * b, &(x_ (0, 0)));
+    op (x_, y_);
+    products_ += b;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Removes from w its components along the first j columns of the basis
+// and returns its norm. The coefficients are left in the first column of
+// coeffs_. Classical Gram-Schmidt is done twice, which is enough to keep
+// the basis orthogonal to working precision.
+//
+template<class MAT>
+inline typename LanczosEigenSolver<MAT>::value_type
+LanczosEigenSolver<MAT>::orthogonalize_ (size_type j, value_type *w)  {
+
+    if (j > 0)  {
+        const value_type    *v = &(basis_ (0, 0));
+        value_type          *h = &(coeffs_ (0, 0));
+        value_type          *dh = &(coeffs_ (0, 1));
+
+        gemm (true, false, j, 1, n_,
+              value_type(1), v, n_, w, n_, value_type(0), h, j);
+        gemm (false, false, n_, 1, j,
+              value_type(-1), v, n_, h, j, value_type(1), w, n_);
+        gemm (true, false, j, 1, n_,
+              value_type(1), v, n_, w, n_, value_type(0), dh, j);
+        gemm (false, false, n_, 1, j,
+              value_type(-1), v, n_, dh, j, value_type(1), w, n_);
+        for (size_type i = 0; i < j; ++i)
+            h[i] += dh[i];
+    }
+
+    value_type  norm (0);
+
+    for (size_type i = 0; i < n_; ++i)
+        norm += w[i] * w[i];
+    return (std::sqrt (norm));
+}
+
+// ----------------------------------------------------------------------------
+
+// A random unit vector in column j of the basis, orthogonal to the ones
+// before it. j must be less than n.
+//
+template<class MAT>
+inline void LanczosEigenSolver<MAT>::random_column_ (size_type j)  {
+
+    std::uniform_real_distribution<value_type>  dist (-1, 1);
+    value_type                                  *w = &(basis_ (0, j));
+    value_type                                  norm (0);
+
+    while (norm == value_type(0))  {
+        for (size_type i = 0; i < n_; ++i)
+            w[i] = dist (generator_);
+        norm = orthogonalize_ (j, w);
+    }
+    for (size_type i = 0; i < n_; ++i)
+        w[i] /= norm;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Rayleigh-Ritz on the warm start block. If it is good enough, the
+// answer is in eigenvalues and eigenvectors and it returns true.
+// Otherwise the first column of the basis is the starting vector.
+//
+template<class MAT>
+inline bool LanczosEigenSolver<MAT>::
+warm_start_ (const Operator &op,
+             const MatrixType &warm_start,
+             MatrixType &eigenvalues,
+             MatrixType &eigenvectors)  {
+
+    const size_type cols = std::min (warm_start.columns (), m_);
+    value_type      *v = &(basis_ (0, 0));
+    size_type       b = 0;
+
+   // Orthonormalize the block. Columns that depend on the ones before
+   // them are dropped.
+   //
+    for (size_type c = 0; c < cols; ++c)  {
+        value_type  *w = v + std::size_t(b) * n_;
+        value_type  norm0 (0);
+
+        for (size_type r = 0; r < n_; ++r)  {
+            w[r] = warm_start (r, c);
+            norm0 += w[r] * w[r];
+        }
+
+        const value_type    norm = orthogonalize_ (b, w);
+
+        if (norm > std::sqrt (std::numeric_limits<value_type>::epsilon () *
+                              norm0))  {
+            for (size_type r = 0; r < n_; ++r)
+                w[r] /= norm;
+            b += 1;
+        }
+    }
+    if (b == 0)  {
+        random_column_ (0);
+        return (false);
+    }
+
+    apply_ (op, 0, b);
+
+    value_type  *s = &(coeffs_ (0, 0));
+
+    if (b >= k_ && b >= 2)  {
+       // G = ~V * A * V and the residuals A * V - V * G
+       //
+        projection_.resize (b, b);
+        gemm (true, false, b, b, n_, value_type(1), v, n_,
+              &(y_ (0, 0)), n_, value_type(0), &(projection_ (0, 0)), b);
+        for (size_type c = 0; c < b; ++c)
+            for (size_type r = 0; r < c; ++r)
+                projection_ (r, c) = projection_ (c, r) =
+                    (projection_ (r, c) + projection_ (c, r)) / 2;
+        gemm (false, false, n_, b, b, value_type(-1), v, n_,
+              &(projection_ (0, 0)), b, value_type(1), &(y_ (0, 0)), n_);
+        projection_.eigen_space (ritz_values_, ritz_vectors_, true);
+
+       // Residuals of the Ritz pairs
+       //
+        gemm (false, false, n_, b, b, value_type(1), &(y_ (0, 0)), n_,
+              &(ritz_vectors_ (0, 0)), b, value_type(0), &(x_ (0, 0)), n_);
+
+        const value_type    anorm =
+            std::max (std::fabs (ritz_values_ (0, 0)),
+                      std::fabs (ritz_values_ (0, b - 1)));
+        const size_type     first =
+            which_ == eigen_part::largest ? b - k_ : 0;
+        bool                converged = true;
+
+        for (size_type i = first; i < first + k_ && converged; ++i)  {
+            const value_type    *ri = &(x_ (0, i));
+            value_type          norm (0);
+
+            for (size_type r = 0; r < n_; ++r)
+                norm += ri[r] * ri[r];
+            converged = std::sqrt (norm) <= tolerance_ * anorm;
+        }
+        if (converged)  {
+            extract_ (b, first, eigenvalues, eigenvectors);
+            return (true);
+        }
+
+       // Start from the sum of the wanted Ritz vectors
+       //
+        for (size_type r = 0; r < b; ++r)  {
+            s[r] = value_type(0);
+            for (size_type c = first; c < first + k_; ++c)
+                s[r] += ritz_vectors_ (r, c);
+        }
+    }
+    else
+        std::fill (s, s + b, value_type(1));
+
+    gemm (false, false, n_, 1, b, value_type(1), v, n_, s, b,
+          value_type(0), &(x_ (0, 0)), n_);
+    std::copy (&(x_ (0, 0)), &(x_ (0, 0)) + n_, v);
+
+    const value_type    norm = orthogonalize_ (0, v);
+
+    for (size_type r = 0; r < n_; ++r)
+        v[r] /= norm;
+    return (false);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void LanczosEigenSolver<MAT>::
+iterate_ (const Operator &op,
+          MatrixType &eigenvalues,
+          MatrixType &eigenvectors)  {
+
+    const size_type     n = n_;
+    const size_type     m = m_;
+    const size_type     p = k_ + (m - k_) / 2;  // Kept at a restart
+    const value_type    breakdown =
+        std::numeric_limits<value_type>::epsilon () *
+        std::sqrt (value_type(n));
+    value_type          *v = &(basis_ (0, 0));
+    value_type          anorm (0);
+    size_type           kept = 0;
+
+    projection_.resize (m, m);
+    for ( ; ; ++restarts_)  {
+        value_type  beta (0);
+
+       // Extend the basis to m vectors. The column of ~V * A * V for the
+       // new vector is what the orthogonalization removes from A * v.
+       //
+        for (size_type j = kept; j < m; ++j)  {
+            apply_ (op, j, 1);
+
+            value_type  *w = &(y_ (0, 0));
+
+            beta = orthogonalize_ (j + 1, w);
+            for (size_type i = 0; i <= j; ++i)
+                projection_ (i, j) = projection_ (j, i) = coeffs_ (i, 0);
+            anorm = std::max (anorm, std::fabs (coeffs_ (j, 0)) + beta);
+
+           // If A * v is in the span of the basis, it is an invariant
+           // subspace. The search goes on along a random direction.
+           //
+            if (j + 1 == n || beta <= breakdown * anorm)  {
+                beta = value_type(0);
+                if (j + 1 < n)
+                    random_column_ (j + 1);
+            }
+            else  {
+                value_type  *next = v + std::size_t(j + 1) * n;
+
+                for (size_type i = 0; i < n; ++i)
+                    next[i] = w[i] / beta;
+            }
+        }
+
+       // The residual of Ritz pair i is beta * |S(m - 1, i)|
+       //
+        projection_.eigen_space (ritz_values_, ritz_vectors_, true);
+        anorm = std::max (std::fabs (ritz_values_ (0, 0)),
+                          std::fabs (ritz_values_ (0, m - 1)));
+
+        const size_type first = which_ == eigen_part::largest ? m - k_ : 0;
+        bool            converged = true;
+
+        for (size_type i = first; i < first + k_ && converged; ++i)
+            converged = std::fabs (beta * ritz_vectors_ (m - 1, i)) <=
+                            tolerance_ * anorm;
+        if (converged)  {
+            extract_ (m, first, eigenvalues, eigenvectors);
+            return;
+        }
+        if (restarts_ == max_restarts_)
+            throw NotSolvable ();
+
+       // Thick restart: the p Ritz vectors at the wanted end and the last
+       // Lanczos vector. ~V * A * V is diagonal on the Ritz vectors and
+       // its next column is filled by the next orthogonalization.
+       //
+        const size_type keep = which_ == eigen_part::largest ? m - p : 0;
+
+        x_.resize (n, p);
+        gemm (false, false, n, p, m, value_type(1), v, n,
+              &(ritz_vectors_ (0, keep)), m,
+              value_type(0), &(x_ (0, 0)), n);
+        std::copy (&(x_ (0, 0)), &(x_ (0, 0)) + std::size_t(n) * p, v);
+        std::copy (v + std::size_t(m) * n, v + std::size_t(m + 1) * n,
+                   v + std::size_t(p) * n);
+
+        projection_.resize (m, m);
+        for (size_type i = 0; i < p; ++i)
+            projection_ (i, i) = ritz_values_ (0, keep + i);
+        kept = p;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// The k Ritz pairs from first on, of the first m columns of the basis
+//
+template<class MAT>
+inline void LanczosEigenSolver<MAT>::
+extract_ (size_type m,
+          size_type first,
+          MatrixType &eigenvalues,
+          MatrixType &eigenvectors) const  {
+
+    eigenvalues.resize (1, k_);
+    eigenvectors.resize (n_, k_);
+    gemm (false, false, n_, k_, m, value_type(1), &(basis_ (0, 0)), n_,
+          &(ritz_vectors_ (0, first)), m,
+          value_type(0), &(eigenvectors (0, 0)), n_);
+    for (size_type i = 0; i < k_; ++i)
+        eigenvalues (0, i) = ritz_values_ (0, first + i);
+
+   // The largest in descending order
+   //
+    if (which_ == eigen_part::largest)
+        for (size_type i = 0, j = k_ - 1; i < j; ++i, --j)  {
+            std::swap (eigenvalues (0, i), eigenvalues (0, j));
+            std::swap_ranges (&(eigenvectors (0, i)),
+                              &(eigenvectors (0, i)) + n_,
+                              &(eigenvectors (0, j)));
+        }
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,187 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/MatrixBase.h>
+
+#include <cstddef>
+#include <type_traits>
+
+// ----------------------------------------------------------------------------
+
+//
+// File-backed data vector
+//
+// MMapVector keeps its elements in a memory-mapped file instead of the
+// heap, so a matrix can be larger than RAM and the OS page cache decides
+// what stays in memory. It has the part of the std::vector interface that
+// DenseMatrixStorage uses, so it can be the storage of a matrix (see
+// MMapDenseMatrixBase and MMapSymmMatrixBase).
+//
+// The file is always an io_format::binary file: a BinaryMatrixHeader
+// followed by the elements. Unless it is given a file, MMapVector uses an
+// anonymous temporary file in $TMPDIR (or /tmp) that is unlinked as soon
+// as it is created.
+//
+// It needs POSIX mmap(). There is no WIN32 implementation.
+//
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+class   MMapVector  {
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MMapVector elements must be trivially copyable");
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+
+    MMapVector () = default;
+    explicit MMapVector (size_type n, const_reference value = value_type ());
+    MMapVector (const MMapVector &that);
+    MMapVector (MMapVector &&that) noexcept;
+    ~MMapVector ();
+
+   // Copying into a vector that is mapped to a file, writes the file
+   //
+    MMapVector &operator = (const MMapVector &rhs);
+    MMapVector &operator = (MMapVector &&rhs) noexcept;
+
+    inline size_type size () const noexcept  { return (size_); }
+    inline bool empty () const noexcept  { return (size_ == 0); }
+
+    inline pointer data () noexcept  { return (data_); }
+    inline const_pointer data () const noexcept  { return (data_); }
+
+    inline iterator begin () noexcept  { return (data_); }
+    inline const_iterator begin () const noexcept  { return (data_); }
+    inline iterator end () noexcept  { return (data_ + size_); }
+    inline const_iterator end () const noexcept  { return (data_ + size_); }
+
+    inline reference operator [] (size_type i) noexcept  {
+
+        return (data_[i]);
+    }
+    inline const_reference operator [] (size_type i) const noexcept  {
+
+        return (data_[i]);
+    }
+
+   // The file is extended (or shrunk) with ftruncate() and remapped. New
+   // elements are set to value.
+   // If the mapping is private (see map_file()), the data first moves to
+   // a temporary file.
+   //
+    void resize (size_type n, const_reference value = value_type ());
+    void clear ();
+    void swap (MMapVector &rhs) noexcept;
+
+   // Maps an existing io_format::binary file. check(header, file_size)
+   // validates a copy of its header and puts it in the native byte order.
+   // It throws, if the file is not usable, and it returns true, if the
+   // file is in the other byte order.
+   // If shared is true, changes are written through to the file and the
+   // file must be in the native byte order. Otherwise the mapping is
+   // private and copy-on-write, so the file is never changed.
+   //
+    template<typename F>
+    void map_file (const char *file_name, bool shared, F &&check);
+
+   // Moves the data to file_name, which is created or truncated. From then
+   // on changes are written through to it.
+   //
+    void move_to_file (const char *file_name);
+
+   // The header at the start of the file. The vector keeps byte_order,
+   // data_size and the element fields up to date. The rest is up to the
+   // owner.
+   //
+    inline BinaryMatrixHeader *header () noexcept  {
+
+        return (reinterpret_cast<BinaryMatrixHeader *>(base_));
+    }
+    inline const BinaryMatrixHeader *header () const noexcept  {
+
+        return (reinterpret_cast<const BinaryMatrixHeader *>(base_));
+    }
+
+   // True, if the vector has a file of its own (maybe a temporary one)
+   //
+    inline bool is_shared () const noexcept  { return (fd_ >= 0); }
+
+   // Writes the dirty pages of a shared mapping back to the file
+   //
+    void sync () const;
+
+private:
+
+    static int create_temp_file_ ();
+    void map_fd_ (int fd, std::size_t bytes, bool shared);
+    void unmap_ () noexcept;
+    void remap_ (size_type n);  // Elements are left as they are
+    void init_header_ () noexcept;
+
+    char            *base_ { nullptr };  // Start of the mapping
+    std::size_t     mapped_ { 0 };       // Bytes mapped
+    pointer         data_ { nullptr };
+    size_type       size_ { 0 };
+    std::size_t     offset_ { sizeof(BinaryMatrixHeader) };
+    int             fd_ { -1 };          // Only kept for shared mappings
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/MMapVector.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,365 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/MMapVector.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+MMapVector<T>::MMapVector (size_type n, const_reference value)  {
+
+    resize (n, value);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+MMapVector<T>::MMapVector (const MMapVector &that)  { *this = that; }
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+MMapVector<T>::MMapVector (MMapVector &&that) noexcept  { swap (that); }
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+MMapVector<T>::~MMapVector ()  {
+
+    unmap_ ();
+    if (fd_ >= 0)  ::close (fd_);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+MMapVector<T> &MMapVector<T>::operator = (const MMapVector &rhs)  {
+
+    if (this != &rhs)  {
+        remap_ (rhs.size_);
+        if (size_ != 0)
+            std::memcpy (data_, rhs.data_, size_ * sizeof(value_type));
+
+        const BinaryMatrixHeader    *rhs_header = rhs.header ();
+
+        if (rhs_header != nullptr && base_ != nullptr)  {
+            header ()->rows = rhs_header->rows;
+            header ()->columns = rhs_header->columns;
+            header ()->layout = rhs_header->layout;
+        }
+    }
+    return (*this);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+MMapVector<T> &MMapVector<T>::operator = (MMapVector &&rhs) noexcept  {
+
+    MMapVector  tmp (std::move (rhs));
+
+    swap (tmp);
+    return (*this);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::resize (size_type n, const_reference value)  {
+
+    if (n == size_)  return;
+
+    const size_type old_size = size_;
+
+    remap_ (n);
+
+   // Extending a file fills it with zeros. So if value is all zero bytes,
+   // the new pages are not touched.
+   //
+    if (n > old_size)  {
+        char    zeros[sizeof(value_type)] = { };
+
+        if (std::memcmp (&value, zeros, sizeof(value_type)))
+            std::fill (data_ + old_size, data_ + n, value);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::clear ()  { resize (0); }
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::swap (MMapVector &rhs) noexcept  {
+
+    std::swap (base_, rhs.base_);
+    std::swap (mapped_, rhs.mapped_);
+    std::swap (data_, rhs.data_);
+    std::swap (size_, rhs.size_);
+    std::swap (offset_, rhs.offset_);
+    std::swap (fd_, rhs.fd_);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<typename F>
+void MMapVector<T>::map_file (const char *file_name, bool shared, F &&check) {
+
+    const int   fd = ::open (file_name, shared ? O_RDWR : O_RDONLY);
+    struct stat st;
+
+    if (fd < 0 || ::fstat (fd, &st) != 0)  {
+        if (fd >= 0)  ::close (fd);
+        throw std::runtime_error ("MMapVector::map_file(): Cannot open "
+                                  "file");
+    }
+
+    MMapVector          tmp;
+    BinaryMatrixHeader  hdr;
+
+    tmp.fd_ = fd;  // So it is closed, if anything throws
+    std::memset (&hdr, 0, sizeof(hdr));
+    if (st.st_size != 0)  {
+        tmp.map_fd_ (fd, st.st_size, shared);
+        std::memcpy (&hdr, tmp.base_,
+                     std::min<std::size_t> (st.st_size, sizeof(hdr)));
+    }
+
+    const bool  swapped = check (hdr, std::uint64_t (st.st_size));
+
+    if (hdr.data_offset % alignof(value_type) != 0)
+        throw std::runtime_error ("MMapVector::map_file(): Data is not "
+                                  "aligned");
+    if (swapped && shared)
+        throw std::runtime_error ("MMapVector::map_file(): File is in the "
+                                  "other byte order");
+
+    tmp.offset_ = hdr.data_offset;
+    tmp.size_ = hdr.data_size;
+    tmp.data_ = reinterpret_cast<pointer>(tmp.base_ + tmp.offset_);
+    if (! shared)  {
+        ::close (fd);
+        tmp.fd_ = -1;
+    }
+
+   // Pages of a private mapping are copied on write. So the data can be
+   // put in the native byte order without touching the file.
+   //
+    if (swapped)  {
+        byte_swap__ (tmp.data_, sizeof(value_type), tmp.size_);
+        *tmp.header () = hdr;
+    }
+    swap (tmp);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::move_to_file (const char *file_name)  {
+
+    const int   fd = ::open (file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        throw std::runtime_error ("MMapVector::move_to_file(): Cannot "
+                                  "create file");
+
+    MMapVector  tmp;
+    const auto  bytes = sizeof(BinaryMatrixHeader) + size_ * sizeof(T);
+
+    tmp.fd_ = fd;
+    if (::ftruncate (fd, bytes) != 0)
+        throw std::runtime_error ("MMapVector::move_to_file(): Cannot "
+                                  "extend file");
+    tmp.map_fd_ (fd, bytes, true);
+    tmp.size_ = size_;
+    tmp.data_ = reinterpret_cast<pointer>(tmp.base_ + tmp.offset_);
+    tmp.init_header_ ();
+    if (base_ != nullptr)  {
+        tmp.header ()->rows = header ()->rows;
+        tmp.header ()->columns = header ()->columns;
+        tmp.header ()->layout = header ()->layout;
+    }
+    if (size_ != 0)
+        std::memcpy (tmp.data_, data_, size_ * sizeof(value_type));
+    swap (tmp);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::sync () const  {
+
+    if (base_ != nullptr && fd_ >= 0 &&
+        ::msync (base_, mapped_, MS_SYNC) != 0)
+        throw std::runtime_error ("MMapVector::sync(): msync() failed");
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+int MMapVector<T>::create_temp_file_ ()  {
+
+    const char  *dir = std::getenv ("TMPDIR");
+    std::string path (dir != nullptr && *dir != 0 ? dir : "/tmp");
+
+    path += "/tiger_mmap_XXXXXX";
+
+    const int   fd = ::mkstemp (&(path[0]));
+
+    if (fd < 0)
+        throw std::runtime_error ("MMapVector: Cannot create a temporary "
+                                  "file");
+    ::unlink (path.c_str ());
+    return (fd);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::map_fd_ (int fd, std::size_t bytes, bool shared)  {
+
+    void    *map = ::mmap (nullptr, bytes, PROT_READ | PROT_WRITE,
+                           shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+
+    if (map == MAP_FAILED)
+        throw std::runtime_error ("MMapVector: Cannot map file");
+    base_ = static_cast<char *>(map);
+    mapped_ = bytes;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::unmap_ () noexcept  {
+
+    if (base_ != nullptr)  ::munmap (base_, mapped_);
+    base_ = nullptr;
+    mapped_ = 0;
+    data_ = nullptr;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::remap_ (size_type n)  {
+
+    if (base_ == nullptr ? n == 0 : (fd_ >= 0 && n == size_))  return;
+
+    const std::size_t   bytes = offset_ + n * sizeof(value_type);
+
+   // Without a file of its own (a fresh vector or a private mapping), the
+   // data moves to a temporary file first.
+   //
+    if (fd_ < 0)  {
+        MMapVector  tmp;
+        const auto  tmp_bytes = sizeof(BinaryMatrixHeader) +
+                                n * sizeof(value_type);
+
+        tmp.fd_ = create_temp_file_ ();
+        if (::ftruncate (tmp.fd_, tmp_bytes) != 0)
+            throw std::runtime_error ("MMapVector: Cannot extend file");
+        tmp.map_fd_ (tmp.fd_, tmp_bytes, true);
+        tmp.size_ = n;
+        tmp.data_ = reinterpret_cast<pointer>(tmp.base_ + tmp.offset_);
+        tmp.init_header_ ();
+        if (base_ != nullptr)  {
+            *tmp.header () = *header ();
+            tmp.header ()->data_size = n;
+            tmp.header ()->data_offset = tmp.offset_;
+            std::memcpy (tmp.data_, data_,
+                         std::min (n, size_) * sizeof(value_type));
+        }
+        swap (tmp);
+        return;
+    }
+
+    unmap_ ();
+    size_ = 0;
+    if (::ftruncate (fd_, bytes) != 0)
+        throw std::runtime_error ("MMapVector: Cannot resize file");
+    map_fd_ (fd_, bytes, true);
+    size_ = n;
+    data_ = reinterpret_cast<pointer>(base_ + offset_);
+    header ()->data_size = n;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void MMapVector<T>::init_header_ () noexcept  {
+
+    BinaryMatrixHeader  &hdr = *header ();
+
+    std::memset (&hdr, 0, sizeof(hdr));
+    std::memcpy (hdr.magic, "TIGERMAT", sizeof(hdr.magic));
+    hdr.byte_order = BinaryMatrixHeader::ORDER_MARK;
+    hdr.version = BinaryMatrixHeader::VERSION;
+    hdr.elem_type = binary_type_code__<value_type> ();
+    hdr.elem_size = sizeof(value_type);
+    hdr.layout = static_cast<std::uint8_t>(matrix_layout::dense);
+    hdr.data_size = size_;
+    hdr.data_offset = offset_;
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -30,10 +30,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _INCLUDED_MathOperators_h
 #define _INCLUDED_MathOperators_h 0
 
+#include <algorithm>
+#include <deque>
 #include <stdexcept>
 #include <iterator>
+#include <vector>
 
 #include <Tiger/Matrix.h>
+#include <Tiger/MatrixKernels.h>
 
 // ----------------------------------------------------------------------------
 
@@ -286,9 +290,12 @@ class   MatUnaExprOpt  {
         inline void
         rhs_col_decrement (size_type i) noexcept  { rhs_citer_ -= i; }
 
+       // Stepping by one is cheaper than += 1 for some iterators (e.g. the
+       // row iterators, which would have to seek)
+       //
         inline MatUnaExprOpt &operator ++ () noexcept  {    // ++Prefix
 
-            rhs_col_increment (1);
+            ++rhs_citer_;
             return (*this);
         }
         inline MatUnaExprOpt &operator += (size_type i) noexcept  {
@@ -299,7 +306,7 @@ class   MatUnaExprOpt  {
 
         inline MatUnaExprOpt &operator -- () noexcept  {    // --Prefix
 
-            rhs_col_decrement (1);
+            --rhs_citer_;
             return (*this);
         }
         inline MatUnaExprOpt &operator -= (size_type i) noexcept  {
@@ -308,6 +315,9 @@ class   MatUnaExprOpt  {
             return (*this);
         }
 
+        inline const ITER &
+        get_rhs_iter () const noexcept  { return (rhs_citer_); }
+
         inline size_type
         lhs_row_size () const noexcept  { return (opt_.lhs_row_size ()); }
         inline size_type rhs_row_size () const noexcept  {
@@ -342,6 +352,7 @@ class   MatBinExprOpt  {
         ITER1               lhs_citer_;
         ITER2               rhs_citer_;
         const   size_type   lhs_row_size_;
+        const   size_type   lhs_col_size_;
         const   size_type   rhs_row_size_;
         const   size_type   rhs_col_size_;
         const   OPT         opt_;
@@ -351,11 +362,13 @@ class   MatBinExprOpt  {
         inline MatBinExprOpt (const ITER1 &it1,
                               const ITER2 &it2,
                               size_type lhs_row_size,
+                              size_type lhs_col_size,
                               size_type rhs_row_size,
                               size_type rhs_col_size) noexcept
             : lhs_citer_ (it1),
               rhs_citer_ (it2),
               lhs_row_size_ (lhs_row_size),
+              lhs_col_size_ (lhs_col_size),
               rhs_row_size_ (rhs_row_size),
               rhs_col_size_ (rhs_col_size),
               opt_ (rhs_col_size)  {   }
@@ -369,10 +382,12 @@ class   MatBinExprOpt  {
         inline void
         rhs_col_decrement (size_type i) noexcept  { rhs_citer_ -= i; }
 
+       // See MatUnaExprOpt
+       //
         inline MatBinExprOpt &operator ++ () noexcept  {  // ++Prefix
 
-            lhs_col_increment (1);
-            rhs_col_increment (1);
+            ++lhs_citer_;
+            ++rhs_citer_;
             return (*this);
         }
         inline MatBinExprOpt &operator += (size_type i) noexcept  {
@@ -384,8 +399,8 @@ class   MatBinExprOpt  {
 
         inline MatBinExprOpt &operator -- () noexcept  {  // --Prefix
 
-            lhs_col_decrement (1);
-            rhs_col_decrement (1);
+            --lhs_citer_;
+            --rhs_citer_;
             return (*this);
         }
         inline MatBinExprOpt &operator -= (size_type i) noexcept  {
@@ -398,10 +413,17 @@ class   MatBinExprOpt  {
         inline size_type
         lhs_row_size () const noexcept  { return (lhs_row_size_); }
         inline size_type
+        lhs_col_size () const noexcept  { return (lhs_col_size_); }
+        inline size_type
         rhs_row_size () const noexcept  { return (rhs_row_size_); }
         inline size_type
         rhs_col_size () const noexcept  { return (rhs_col_size_); }
 
+        inline const ITER1 &
+        get_lhs_iter () const noexcept  { return (lhs_citer_); }
+        inline const ITER2 &
+        get_rhs_iter () const noexcept  { return (rhs_citer_); }
+
         inline value_type operator * () const noexcept  {
 
             return (opt_ (lhs_citer_,
@@ -413,6 +435,17 @@ class   MatBinExprOpt  {
 
 // ----------------------------------------------------------------------------
 
+template<template<class T> class BASE, class TYPE>
+struct  MatProductEngine;
+
+template<template<class T> class BASE, class TYPE>
+struct  MatElementwiseEngine;
+
+template<template<class T> class BASE, class TYPE>
+struct  MatTransposeEngine;
+
+// ----------------------------------------------------------------------------
+
 // Matrix-based Expression
 //
 template<class ITER, template<class T> class BASE, class TYPE>
@@ -533,6 +566,28 @@ class   MatrixExpr  {
 
         void assign (MatrixType &lhs) const  {
 
+           // Products are not evaluated one dot product at a time, if
+           // there is a dedicated engine for this matrix type
+           //
+            if (opt_type_ == static_cast<unsigned char>
+                                 (MatrixOptBase::_multiply_) &&
+                MatProductEngine<BASE, TYPE>::assign (lhs, expr_opt_))
+                return;
+
+           // The same goes for chains of additions and subtractions
+           //
+            if (opt_type_ == static_cast<unsigned char>
+                                 (MatrixOptBase::_plus_) &&
+                MatElementwiseEngine<BASE, TYPE>::assign (lhs, *this))
+                return;
+
+           // And transposes
+           //
+            if (opt_type_ == static_cast<unsigned char>
+                                 (MatrixOptBase::_transpose_) &&
+                MatTransposeEngine<BASE, TYPE>::assign (lhs, expr_opt_))
+                return;
+
             const_iterator  rhs_citer = begin ();
 
             lhs.resize (result_row_size (), result_col_size ());
@@ -625,6 +680,607 @@ class   MatrixExpr  {
 
 // ----------------------------------------------------------------------------
 
+// Matrix products are too expensive to be evaluated element by element
+// through the expression iterators. MatProductEngine evaluates the top
+// level product of an expression in one shot. By default there is no
+// engine and the generic expression evaluation is used.
+//
+template<template<class T> class BASE, class TYPE>
+struct  MatProductEngine  {
+
+    typedef Matrix<BASE, TYPE>  MatrixType;
+
+    template<class EXPR_OPT>
+    static inline bool
+    assign (MatrixType &, const EXPR_OPT &) noexcept  { return (false); }
+
+    static inline bool
+    multiply (MatrixType &, const MatrixType &) noexcept  { return (false); }
+};
+
+// ----------------------------------------------------------------------------
+
+// Dense matrices are contiguous column-major arrays. So the operands are
+// handed to the blocked gemm() kernel. Operands that are expressions
+// themselves are materialized once, instead of being re-evaluated for
+// every dot product.
+//
+template<template<class T> class BASE, class TYPE>
+struct  DenseMatProductEngine  {
+
+    typedef Matrix<BASE, TYPE>              MatrixType;
+    typedef typename MatrixType::size_type  size_type;
+
+    template<class EXPR_OPT>
+    static inline bool
+    assign (MatrixType &, const EXPR_OPT &) noexcept  { return (false); }
+
+    template<class ITER1, class ITER2>
+    static inline bool
+    assign (MatrixType &lhs,
+            const MatBinExprOpt<ITER1,
+                                ITER2,
+                                MatMultiplies<TYPE>,
+                                TYPE> &expr_opt)  {
+
+        MatrixType  lhs_holder;
+        MatrixType  rhs_holder;
+        size_type   m, lhs_k, rhs_k, n;
+        const TYPE  *a = operand_ (expr_opt.get_lhs_iter (),
+                                   expr_opt.lhs_row_size (),
+                                   expr_opt.lhs_col_size (),
+                                   m, lhs_k, lhs_holder);
+        const TYPE  *b = operand_ (expr_opt.get_rhs_iter (),
+                                   expr_opt.rhs_row_size (),
+                                   expr_opt.rhs_col_size (),
+                                   rhs_k, n, rhs_holder);
+
+       // If the inner dimensions don't agree, the missing rows/columns
+       // are treated as zeros.
+       //
+        product_ (lhs, m, n, std::min (lhs_k, rhs_k), a, m, b, rhs_k);
+        return (true);
+    }
+
+    static inline bool multiply (MatrixType &lhs, const MatrixType &rhs)  {
+
+        product_ (lhs,
+                  lhs.rows (),
+                  rhs.columns (),
+                  std::min (lhs.columns (), rhs.rows ()),
+                  data_ (lhs),
+                  lhs.rows (),
+                  data_ (rhs),
+                  rhs.rows ());
+        return (true);
+    }
+
+private:
+
+    static inline const TYPE *data_ (const MatrixType &mat) noexcept  {
+
+        return (mat.empty () ? nullptr : &(*mat.col_begin ()));
+    }
+
+    static inline const TYPE *
+    operand_ (const typename MatrixType::col_const_iterator &citer,
+              size_type rows,
+              size_type cols,
+              size_type &rows_out,
+              size_type &cols_out,
+              MatrixType &) noexcept  {
+
+        rows_out = rows;
+        cols_out = cols;
+        return (rows != 0 && cols != 0 ? &(*citer) : nullptr);
+    }
+
+    template<class ITER>
+    static inline const TYPE *
+    operand_ (const MatrixExpr<ITER, BASE, TYPE> &expr,
+              size_type,
+              size_type,
+              size_type &rows_out,
+              size_type &cols_out,
+              MatrixType &holder)  {
+
+        holder = expr;
+        rows_out = holder.rows ();
+        cols_out = holder.columns ();
+        return (data_ (holder));
+    }
+
+   // The result is computed into a new matrix and swapped in, so it is
+   // fine for lhs to be one of the operands.
+   //
+    static inline void product_ (MatrixType &lhs,
+                                 size_type m,
+                                 size_type n,
+                                 size_type k,
+                                 const TYPE *a,
+                                 size_type lda,
+                                 const TYPE *b,
+                                 size_type ldb)  {
+
+        MatrixType  result (m, n);
+
+        if (m != 0 && n != 0)
+            gemm (false, false, m, n, k,
+                  TYPE(1), a, lda, b, ldb,
+                  TYPE(0), &(*result.col_begin ()), m);
+        lhs.swap (result);
+        return;
+    }
+};
+
+// The dense storages that are in memory
+//
+template<class TYPE>
+struct  MatProductEngine<DenseMatrixBase, TYPE>
+    : public DenseMatProductEngine<DenseMatrixBase, TYPE>  {   };
+
+template<class TYPE>
+struct  MatProductEngine<ArenaDenseMatrixBase, TYPE>
+    : public DenseMatProductEngine<ArenaDenseMatrixBase, TYPE>  {   };
+
+// ----------------------------------------------------------------------------
+
+// The RFP array of a symmetric matrix is three ordinary column-major blocks
+// (see SymmRFPMatrixBase). The product is computed a panel of columns at a
+// time. The panel of B is expanded into a dense scratch array and the
+// blocks of A are handed to symm() and gemm() as they are stored.
+// Like all symmetric matrices, only the lower triangle of the product is
+// kept. So it is meaningful only when the product is symmetric (e.g. A * A).
+//
+template<class TYPE>
+struct  MatProductEngine<SymmRFPMatrixBase, TYPE>  {
+
+    typedef Matrix<SymmRFPMatrixBase, TYPE> MatrixType;
+    typedef typename MatrixType::size_type  size_type;
+    typedef typename MatrixType::Layout     Layout;
+
+    template<class EXPR_OPT>
+    static inline bool
+    assign (MatrixType &, const EXPR_OPT &) noexcept  { return (false); }
+
+    template<class ITER1, class ITER2>
+    static inline bool
+    assign (MatrixType &lhs,
+            const MatBinExprOpt<ITER1,
+                                ITER2,
+                                MatMultiplies<TYPE>,
+                                TYPE> &expr_opt)  {
+
+        MatrixType  lhs_holder;
+        MatrixType  rhs_holder;
+        size_type   lhs_n, rhs_n;
+        const TYPE  *a = operand_ (expr_opt.get_lhs_iter (),
+                                   expr_opt.lhs_row_size (),
+                                   lhs_n, lhs_holder);
+        const TYPE  *b = operand_ (expr_opt.get_rhs_iter (),
+                                   expr_opt.rhs_row_size (),
+                                   rhs_n, rhs_holder);
+
+        if (lhs_n != rhs_n)  return (false);
+        product_ (lhs, lhs_n, a, b);
+        return (true);
+    }
+
+    static inline bool multiply (MatrixType &lhs, const MatrixType &rhs)  {
+
+        if (lhs.columns () != rhs.columns ())  return (false);
+        product_ (lhs, lhs.columns (), lhs.rfp_data (), rhs.rfp_data ());
+        return (true);
+    }
+
+private:
+
+   // The iterator of an operand points to element (0, 0), which is not
+   // necessarily the beginning of the RFP array.
+   //
+    static inline const TYPE *
+    operand_ (const typename MatrixType::col_const_iterator &citer,
+              size_type n,
+              size_type &n_out,
+              MatrixType &) noexcept  {
+
+        n_out = n;
+        return (n != 0 ? &(*citer) - Layout (n).a11 : nullptr);
+    }
+
+    template<class ITER>
+    static inline const TYPE *
+    operand_ (const MatrixExpr<ITER, SymmRFPMatrixBase, TYPE> &expr,
+              size_type,
+              size_type &n_out,
+              MatrixType &holder)  {
+
+        holder = expr;
+        n_out = holder.columns ();
+        return (holder.rfp_data ());
+    }
+
+    static inline void product_ (MatrixType &lhs,
+                                 size_type n,
+                                 const TYPE *a,
+                                 const TYPE *b)  {
+
+        constexpr std::size_t   NB = GEMMBlocking<TYPE>::MAX_TILE;
+        MatrixType              result (n, n);
+
+        if (n != 0)  {
+            const Layout        lay (n);
+            const std::size_t   ld = lay.ld;
+            const std::size_t   n1 = lay.n1;
+            const std::size_t   n2 = lay.n2;
+            const std::size_t   nb = std::min<std::size_t> (NB, n);
+            std::vector<TYPE>   b_panel (n * nb);
+            std::vector<TYPE>   c_panel (n * nb);
+            TYPE                *bp = b_panel.data ();
+            TYPE                *cp = c_panel.data ();
+
+            for (std::size_t j = 0; j < n; j += nb)  {
+                const std::size_t   jb = std::min (nb, n - j);
+
+                MatrixType::unpack_columns (b, n, j, j + jb, bp, n);
+
+               // | C1 |   | A11  ~A21 |   | B1 |
+               // |    | = |           | * |    |
+               // | C2 |   | A21   A22 |   | B2 |
+               //
+                symm (false, n1, jb, TYPE(1), a + lay.a11, ld, bp, n,
+                      TYPE(0), cp, n);
+                if (n2 != 0)  {
+                    gemm (true, false, n1, jb, n2,
+                          TYPE(1), a + lay.a21, ld, bp + n1, n,
+                          TYPE(1), cp, n);
+                    gemm (false, false, n2, jb, n1,
+                          TYPE(1), a + lay.a21, ld, bp, n,
+                          TYPE(0), cp + n1, n);
+                    symm (true, n2, jb, TYPE(1), a + lay.a22, ld, bp + n1, n,
+                          TYPE(1), cp + n1, n);
+                }
+                MatrixType::pack_columns (result.rfp_data (), n, j, j + jb,
+                                          cp, n);
+            }
+        }
+        lhs.swap (result);
+        return;
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+// Evaluating a chain of additions and subtractions (e.g. A + B - C) through
+// the expression iterators costs a few branches and indirections for every
+// element. MatElementwiseEngine evaluates such a chain in one shot.
+// By default there is no engine and the generic expression evaluation is
+// used.
+//
+template<template<class T> class BASE, class TYPE>
+struct  MatElementwiseEngine  {
+
+    typedef Matrix<BASE, TYPE>  MatrixType;
+
+    template<class EXPR>
+    static inline bool
+    assign (MatrixType &, const EXPR &) noexcept  { return (false); }
+
+    static inline bool
+    plus_equal (MatrixType &, const MatrixType &, bool) noexcept  {
+
+        return (false);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+// Dense matrices are contiguous column-major arrays. So the expression
+// tree is flattened into a postfix program of operands and +/- steps.
+// The program runs over the whole data one chunk at a time, with the
+// vectorized vector_plus()/vector_minus() kernels. Intermediate results
+// live in chunk sized buffers that stay in L1. The order of operations is
+// the same as the expression, so the results are identical to the
+// element by element evaluation.
+// Subexpressions that are not additions or subtractions (e.g. products)
+// are materialized once.
+//
+template<template<class T> class BASE, class TYPE>
+struct  DenseMatElementwiseEngine  {
+
+    typedef Matrix<BASE, TYPE>              MatrixType;
+    typedef typename MatrixType::size_type  size_type;
+
+   // Number of elements evaluated at a time
+   //
+    static constexpr size_type  CHUNK = 1024;
+
+    template<class ITER>
+    static inline bool
+    assign (MatrixType &lhs,
+            const MatrixExpr<ITER, BASE, TYPE> &expr)  {
+
+        Program_    prog;
+
+        prog.rows = expr.result_row_size ();
+        prog.cols = expr.result_col_size ();
+        if (! flatten_ (expr, prog.rows, prog.cols, prog))
+            return (false);
+
+       // Resizing would reset the data and lhs may be one of the operands.
+       // Every element is written anyway.
+       //
+        if (lhs.rows () != prog.rows || lhs.columns () != prog.cols)
+            lhs.resize (prog.rows, prog.cols);
+        if (! lhs.empty ())
+            run_ (prog, &(*lhs.col_begin ()));
+        return (true);
+    }
+
+    static inline bool
+    plus_equal (MatrixType &lhs, const MatrixType &rhs, bool minus)  {
+
+        if (lhs.rows () != rhs.rows () || lhs.columns () != rhs.columns ())
+            return (false);
+
+        if (! lhs.empty ())  {
+            TYPE            *l = &(*lhs.col_begin ());
+            const size_type n = lhs.rows () * lhs.columns ();
+
+            if (minus)
+                vector_minus<TYPE> (n, l, &(*rhs.col_begin ()), l);
+            else
+                vector_plus<TYPE> (n, l, &(*rhs.col_begin ()), l);
+        }
+        return (true);
+    }
+
+private:
+
+    struct  Step_  {
+
+        const TYPE          *operand;  // nullptr for +/- steps
+        MatrixOptBase::TYPE opt;
+    };
+
+    struct  Program_  {
+
+        size_type               rows { 0 };
+        size_type               cols { 0 };
+        std::vector<Step_>      steps { };
+        std::deque<MatrixType>  holders { };  // Materialized subexpressions
+    };
+
+    static inline bool
+    push_operand_ (const TYPE *operand,
+                   size_type rows,
+                   size_type cols,
+                   Program_ &prog)  {
+
+        if (rows != prog.rows || cols != prog.cols)
+            return (false);
+
+        prog.steps.push_back ({ operand, MatrixOptBase::_plus_ });
+        return (true);
+    }
+
+    static inline bool
+    flatten_ (const typename MatrixType::col_const_iterator &citer,
+              size_type rows,
+              size_type cols,
+              Program_ &prog)  {
+
+        return (push_operand_ (rows != 0 && cols != 0 ? &(*citer) : nullptr,
+                               rows, cols, prog));
+    }
+
+    template<class ITER>
+    static inline bool
+    flatten_ (const MatrixExpr<ITER, BASE, TYPE> &expr,
+              size_type,
+              size_type,
+              Program_ &prog)  {
+
+        return (flatten_expr_ (expr.get_expr_opt (), expr, prog));
+    }
+
+    template<class ITER1, class ITER2>
+    static inline bool
+    flatten_expr_ (const MatBinExprOpt<ITER1, ITER2, MatPlus<TYPE>, TYPE> &eo,
+                   const MatrixExpr<MatBinExprOpt<ITER1,
+                                                  ITER2,
+                                                  MatPlus<TYPE>,
+                                                  TYPE>,
+                                    BASE,
+                                    TYPE> &,
+                   Program_ &prog)  {
+
+        if (! flatten_ (eo.get_lhs_iter (),
+                        eo.lhs_row_size (), eo.lhs_col_size (), prog) ||
+            ! flatten_ (eo.get_rhs_iter (),
+                        eo.rhs_row_size (), eo.rhs_col_size (), prog))
+            return (false);
+
+        prog.steps.push_back ({ nullptr, MatrixOptBase::_plus_ });
+        return (true);
+    }
+
+    template<class ITER1, class ITER2>
+    static inline bool
+    flatten_expr_ (const MatBinExprOpt<ITER1, ITER2, MatMinus<TYPE>, TYPE> &eo,
+                   const MatrixExpr<MatBinExprOpt<ITER1,
+                                                  ITER2,
+                                                  MatMinus<TYPE>,
+                                                  TYPE>,
+                                    BASE,
+                                    TYPE> &,
+                   Program_ &prog)  {
+
+        if (! flatten_ (eo.get_lhs_iter (),
+                        eo.lhs_row_size (), eo.lhs_col_size (), prog) ||
+            ! flatten_ (eo.get_rhs_iter (),
+                        eo.rhs_row_size (), eo.rhs_col_size (), prog))
+            return (false);
+
+        prog.steps.push_back ({ nullptr, MatrixOptBase::_minus_ });
+        return (true);
+    }
+
+   // Anything else is evaluated on its own and becomes an operand
+   //
+    template<class EXPR_OPT, class EXPR>
+    static inline bool
+    flatten_expr_ (const EXPR_OPT &, const EXPR &expr, Program_ &prog)  {
+
+        prog.holders.emplace_back ();
+
+        MatrixType  &holder = prog.holders.back ();
+
+        holder = expr;
+        return (push_operand_ (holder.empty () ? nullptr
+                                               : &(*holder.col_begin ()),
+                               holder.rows (), holder.columns (), prog));
+    }
+
+    static inline void run_ (const Program_ &prog, TYPE *dst)  {
+
+        const std::size_t   n = std::size_t(prog.rows) * prog.cols;
+        const std::size_t   chunk = std::min (std::size_t(CHUNK), n);
+        std::size_t         depth = 0;
+        std::size_t         max_depth = 0;
+
+        for (const auto &step : prog.steps)  {
+            depth = step.operand ? depth + 1 : depth - 1;
+            max_depth = std::max (max_depth, depth);
+        }
+
+       // The result of a step at stack position i goes to buffer i. The
+       // last step writes straight into dst.
+       //
+        std::vector<TYPE>           buffers (max_depth * chunk);
+        std::vector<const TYPE *>   stack;
+
+        stack.reserve (max_depth);
+        for (std::size_t begin = 0; begin < n; begin += chunk)  {
+            const std::size_t   len = std::min (chunk, n - begin);
+
+            stack.clear ();
+            for (std::size_t s = 0; s < prog.steps.size (); ++s)  {
+                const Step_ &step = prog.steps[s];
+
+                if (step.operand)  {
+                    stack.push_back (step.operand + begin);
+                    continue;
+                }
+
+                const TYPE  *b = stack.back ();
+
+                stack.pop_back ();
+
+                const TYPE  *a = stack.back ();
+                TYPE        *out = s + 1 == prog.steps.size ()
+                                       ? dst + begin
+                                       : &buffers[(stack.size () - 1) * chunk];
+
+                if (step.opt == MatrixOptBase::_minus_)
+                    vector_minus<TYPE> (len, a, b, out);
+                else
+                    vector_plus<TYPE> (len, a, b, out);
+                stack.back () = out;
+            }
+        }
+        return;
+    }
+};
+
+// The dense storages that are in memory
+//
+template<class TYPE>
+struct  MatElementwiseEngine<DenseMatrixBase, TYPE>
+    : public DenseMatElementwiseEngine<DenseMatrixBase, TYPE>  {   };
+
+template<class TYPE>
+struct  MatElementwiseEngine<ArenaDenseMatrixBase, TYPE>
+    : public DenseMatElementwiseEngine<ArenaDenseMatrixBase, TYPE>  {   };
+
+// ----------------------------------------------------------------------------
+
+// Going through the row iterator of a matrix costs a divide and a modulo
+// for every element. MatTransposeEngine transposes a matrix in one shot.
+// By default there is no engine and the generic expression evaluation is
+// used.
+//
+template<template<class T> class BASE, class TYPE>
+struct  MatTransposeEngine  {
+
+    typedef Matrix<BASE, TYPE>  MatrixType;
+
+    template<class EXPR_OPT>
+    static inline bool
+    assign (MatrixType &, const EXPR_OPT &) noexcept  { return (false); }
+};
+
+// ----------------------------------------------------------------------------
+
+// Dense matrices are contiguous column-major arrays. So the cache-oblivious
+// transpose() kernel moves the data. A = ~A is done in place.
+// The transpose of an expression is left to the generic evaluation.
+//
+template<template<class T> class BASE, class TYPE>
+struct  DenseMatTransposeEngine  {
+
+    typedef Matrix<BASE, TYPE>              MatrixType;
+    typedef typename MatrixType::size_type  size_type;
+
+    template<class EXPR_OPT>
+    static inline bool
+    assign (MatrixType &, const EXPR_OPT &) noexcept  { return (false); }
+
+    static inline bool
+    assign (MatrixType &lhs,
+            const MatUnaExprOpt<typename MatrixType::row_const_iterator,
+                                MatTranspose<TYPE>,
+                                TYPE> &expr_opt)  {
+
+       // Dimensions of the operand
+       //
+        const size_type rows = expr_opt.rhs_col_size ();
+        const size_type cols = expr_opt.rhs_row_size ();
+
+        if (rows == 0 || cols == 0)  {
+            lhs.resize (cols, rows);
+            return (true);
+        }
+
+        const TYPE  *a = &(*expr_opt.get_rhs_iter ());
+
+        if (! lhs.empty () && a == &(*lhs.col_begin ()))  {
+            lhs.transpose ();
+            return (true);
+        }
+
+       // Every element is written. So there is no need to reset the data,
+       // if it already has the right shape.
+       //
+        if (lhs.rows () != cols || lhs.columns () != rows)
+            lhs.resize (cols, rows);
+        transpose (rows, cols, a, rows, &(*lhs.col_begin ()), cols);
+        return (true);
+    }
+};
+
+// The dense storages that are in memory
+//
+template<class TYPE>
+struct  MatTransposeEngine<DenseMatrixBase, TYPE>
+    : public DenseMatTransposeEngine<DenseMatrixBase, TYPE>  {   };
+
+template<class TYPE>
+struct  MatTransposeEngine<ArenaDenseMatrixBase, TYPE>
+    : public DenseMatTransposeEngine<ArenaDenseMatrixBase, TYPE>  {   };
+
+// ----------------------------------------------------------------------------
+
 //
 // Matrix-based global math operators
 //
@@ -779,6 +1435,7 @@ operator + (const Matrix<BASE, TYPE> &lhs,
                 (expr_type (lhs.col_begin (),
                             rhs.col_begin (),
                             lhs.rows (),
+                            lhs.columns (),
                             rhs.rows (),
                             rhs.columns ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
@@ -809,6 +1466,7 @@ operator - (const Matrix<BASE, TYPE> &lhs,
                 (expr_type (lhs.col_begin (),
                             rhs.col_begin (),
                             lhs.rows (),
+                            lhs.columns (),
                             rhs.rows (),
                             rhs.columns ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
@@ -839,6 +1497,7 @@ operator * (const Matrix<BASE, TYPE> &lhs,
                (expr_type (lhs.col_begin (),
                            rhs.col_begin (),
                            lhs.rows (),
+                           lhs.columns (),
                            rhs.rows (),
                            rhs.columns ()),
                 static_cast<unsigned char>(MatrixOptBase::_multiply_)));
@@ -894,6 +1553,7 @@ operator + (const MatrixExpr<ITER, BASE, TYPE> &lhs,
                 (expr_type (lhs,
                             rhs.col_begin (),
                             lhs.lhs_row_size (),
+                            lhs.result_col_size (),
                             rhs.rows (),
                             rhs.columns ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
@@ -926,6 +1586,7 @@ operator - (const MatrixExpr<ITER, BASE, TYPE> &lhs,
                 (expr_type (lhs,
                             rhs.col_begin (),
                             lhs.lhs_row_size (),
+                            lhs.result_col_size (),
                             rhs.rows (),
                             rhs.columns ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
@@ -958,6 +1619,7 @@ operator * (const MatrixExpr<ITER, BASE, TYPE> &lhs,
                (expr_type (lhs,
                            rhs.col_begin (),
                            lhs.lhs_row_size (),
+                           lhs.result_col_size (),
                            rhs.rows (),
                            rhs.columns ()),
                 static_cast<unsigned char>(MatrixOptBase::_multiply_)));
@@ -1014,7 +1676,8 @@ operator + (const Matrix<BASE, TYPE> &lhs,
                 (expr_type (lhs.col_begin (),
                             rhs,
                             lhs.rows (),
-                            rhs.rhs_row_size (),
+                            lhs.columns (),
+                            rhs.result_row_size (),
                             rhs.rhs_col_size ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
 }
@@ -1047,7 +1710,8 @@ operator - (const Matrix<BASE, TYPE> &lhs,
                 (expr_type (lhs.col_begin (),
                             rhs,
                             lhs.rows (),
-                            rhs.rhs_row_size (),
+                            lhs.columns (),
+                            rhs.result_row_size (),
                             rhs.rhs_col_size ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
 }
@@ -1080,7 +1744,8 @@ operator * (const Matrix<BASE, TYPE> &lhs,
                 (expr_type (lhs.col_begin (),
                             rhs,
                             lhs.rows (),
-                            rhs.rhs_row_size (),
+                            lhs.columns (),
+                            rhs.result_row_size (),
                             rhs.rhs_col_size ()),
                 static_cast<unsigned char>(MatrixOptBase::_multiply_)));
 }
@@ -1141,7 +1806,8 @@ operator + (const MatrixExpr<ITER1, BASE, TYPE> &lhs,
                 (expr_type (lhs,
                             rhs,
                             lhs.lhs_row_size (),
-                            rhs.rhs_row_size (),
+                            lhs.result_col_size (),
+                            rhs.result_row_size (),
                             rhs.rhs_col_size ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
 }
@@ -1177,7 +1843,8 @@ operator - (const MatrixExpr<ITER1, BASE, TYPE> &lhs,
                 (expr_type (lhs,
                             rhs,
                             lhs.lhs_row_size (),
-                            rhs.rhs_row_size (),
+                            lhs.result_col_size (),
+                            rhs.result_row_size (),
                             rhs.rhs_col_size ()),
                  static_cast<unsigned char>(MatrixOptBase::_plus_)));
 }
@@ -1213,7 +1880,8 @@ operator * (const MatrixExpr<ITER1, BASE, TYPE> &lhs,
                (expr_type (lhs,
                            rhs,
                            lhs.lhs_row_size (),
-                           rhs.rhs_row_size (),
+                           lhs.result_col_size (),
+                           rhs.result_row_size (),
                            rhs.rhs_col_size ()),
                 static_cast<unsigned char>(MatrixOptBase::_multiply_)));
 }
@@ -1261,6 +1929,9 @@ operator += (Matrix<BASE, TYPE> &lhs,
 
     typedef Matrix<BASE, TYPE>   MatrixType;
 
+    if (MatElementwiseEngine<BASE, TYPE>::plus_equal (lhs, rhs, false))
+        return (lhs);
+
     typename MatrixType::col_const_iterator rhs_citer = rhs.col_begin ();
 
     for (typename MatrixType::col_iterator lhs_iter = lhs.col_begin ();
@@ -1279,6 +1950,9 @@ operator -= (Matrix<BASE, TYPE> &lhs,
 
     typedef Matrix<BASE, TYPE>   MatrixType;
 
+    if (MatElementwiseEngine<BASE, TYPE>::plus_equal (lhs, rhs, true))
+        return (lhs);
+
     typename MatrixType::col_const_iterator rhs_citer = rhs.col_begin ();
 
     for (typename MatrixType::col_iterator lhs_iter = lhs.col_begin ();
@@ -1297,6 +1971,9 @@ operator *= (Matrix<BASE, TYPE> &lhs,
 
     typedef Matrix<BASE, TYPE>   MatrixType;
 
+    if (MatProductEngine<BASE, TYPE>::multiply (lhs, rhs))
+        return (lhs);
+
     const   MatrixType  tmp_lhs = lhs;
 
     lhs.resize (lhs.rows (), rhs.columns ());
@@ -1381,7 +2058,7 @@ operator *= (Matrix<BASE, TYPE> &lhs,
 
     const   MatrixType  tmp_rhs = rhs;
 
-    return (lhs *= rhs);
+    return (lhs *= tmp_rhs);
 }
 
 // ----------------------------------------------------------------------------
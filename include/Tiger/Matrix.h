@@ -33,12 +33,37 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Tiger/DenseMatrixBase.h>
 #include <Tiger/SymmMatrixBase.h>
+#include <Tiger/SymmRFPMatrixBase.h>
+#include <Tiger/ThreadPool.h>
+
+#ifndef WIN32
+#  include <Tiger/MMapVector.h>
+#  include <Tiger/OutOfCore.h>
+#endif // WIN32
 
 // ----------------------------------------------------------------------------
 
 namespace hmma
 {
 
+template<class MAT>
+class   LUFactorization;
+template<class MAT>
+class   CholeskyFactorization;
+template<class MAT>
+class   MatrixWorkspace;
+template<class MAT>
+class   LanczosEigenSolver;
+
+// Which end of the spectrum a partial eigendecomposition is after
+//
+enum class eigen_part : unsigned char  {
+    largest = 1,
+    smallest = 2
+};
+
+// ----------------------------------------------------------------------------
+
 template<template<class T> class BASE, class TYPE = double>
 class   Matrix : public BASE<TYPE>  {
 
@@ -103,8 +128,12 @@ public:
    // simply called the rank of the matrix;
    // for the proofs, see,  Murase (1960), Andrea & Wong (1960),
    // Williams & Cater (1968), Mackiw (1995).
+   // It is computed from the LU decomposition, by counting the pivots of
+   // the row echelon form of U (see LUFactorization::rank()).
    //
     inline size_type rank () const noexcept;
+    inline size_type
+    rank (MatrixWorkspace<Matrix> &workspace) const noexcept;
 
    // This is the best determinant definition I could find:
    //
@@ -140,15 +169,21 @@ public:
    // For Laplace Expension
    //     see: http://en.wikipedia.org/wiki/Cofactor_expansion
    //
-   // NOTE: This is a relatively _expensive_ calculation. Its complexity
-   //       is O(n!), where n is the number of rows or columns.
+   // It is the product of the diagonal of U in the LU decomposition,
+   // with the sign of the row interchanges (see LUFactorization.h).
+   // If you also need to solve equations with the same matrix, use an
+   // LUFactorization object directly, so it is factored only once.
    //
     inline value_type determinant () const; // throw (NotSquare);
+    inline value_type determinant (MatrixWorkspace<Matrix> &workspace)
+        const; // throw (NotSquare);
 
     inline std::future<value_type>
     determinant_async () const  {
 
-        return (std::async(std::launch::async, &Matrix::determinant, this));
+        value_type  (Matrix::*func) () const = &Matrix::determinant;
+
+        return (std::async(std::launch::async, func, this));
    }
 
    // Minor of a matrix is the same matrix with the specified row
@@ -189,10 +224,25 @@ public:
    // observations are equally distant from the mean.
    //
    // For a nXm matrix, you will get a mXm covariance matrix
+   //
+   // The columns are centered once and only one triangle of
+   // ~centered * centered is computed, by the blocked (and multithreaded)
+   // syrk() kernel.
    //
     inline Matrix
     covariance (bool is_unbiased = true) const; // throw (NotSolvable);
 
+   // Same as above, but the result can be any kind of matrix. Since the
+   // covariance matrix is symmetric, a SymmMatrixBase (or
+   // SymmRFPMatrixBase) result holds it in half the memory. A packed
+   // SymmMatrixBase result is filled a panel of columns at a time, without
+   // an mXm scratch.
+   //
+    template<template<class T> class BASE2>
+    inline Matrix<BASE2, TYPE> &
+    covariance (Matrix<BASE2, TYPE> &result,
+                bool is_unbiased = true) const; // throw (NotSolvable);
+
    // The Pearson product-moment correlation coefficient:
    //
    //           Cov(x, y)
@@ -203,12 +253,45 @@ public:
    //
     inline Matrix correlation () const; // throw (NotSolvable);
 
-   // Solve the simultaneous equation Ax = rhs by Gaussian elimination.
+   // Solve the simultaneous equation Ax = rhs by LU decomposition with
+   // partial pivoting, followed by forward and backward triangular
+   // solves. rhs may have any number of columns.
    // It returns the x vector.
    //
     inline Matrix
     solve_se (const Matrix &rhs) const; // throw(NotSolvable, Singular);
 
+   // Same as above, but the solution overwrites rhs instead of being
+   // allocated. It returns rhs.
+   //
+    inline Matrix &
+    solve_se_in_place (Matrix &rhs) const; // throw(NotSolvable, Singular);
+
+   // Solve the simultaneous equation Ax = rhs, where A is symmetric
+   // positive-definite, by Cholesky factorization followed by two
+   // triangular solves. It is about twice as fast as solve_se().
+   // rhs may have any number of columns.
+   // It returns the x vector.
+   //
+   // NOTE: If you solve many systems with the same A, use a
+   //       CholeskyFactorization object directly, so it is factored only
+   //       once.
+   //
+    inline Matrix
+    cholesky_solve (const Matrix &rhs) const; // throw(NotSolvable);
+
+   // Same as above, but the solution overwrites rhs instead of being
+   // allocated. It returns rhs.
+   //
+    inline Matrix &
+    cholesky_solve_in_place (Matrix &rhs) const; // throw(NotSolvable);
+
+   // Inverse of a symmetric positive-definite matrix by Cholesky
+   // factorization. It returns that.
+   //
+    inline Matrix &
+    cholesky_inverse (Matrix &that) const; // throw(NotSolvable);
+
    // Frobenius Norm:
    // The Frobenius norm of a matrix is the square root of the sum of
    // the squares of the values of the elements of the matrix.
@@ -323,15 +406,75 @@ public:
    //
    // This method finds all the eigenvalues and eigenvectors.
    // If matrix is symmetric:
-   //     first tridiagonalize, then diagonalize.
+   //     first tridiagonalize, then diagonalize. Large matrices (see
+   //     GEMMBlocking::STEDC_MIN) are tridiagonalized by the blocked
+   //     sytrd() and diagonalized by divide-and-conquer (see stedc() in
+   //     MatrixKernels.h). Their values come back in ascending order.
    // else:
    //     reduce to Hessenberg form, then reduce to real Schur form.
+   // MAT must be a dense (column-major) matrix. The kernels work on its
+   // data through raw pointers.
    //
     template<class MAT>
     inline void
     eigen_space (MAT &eigenvalues,
                  MAT &eigenvectors,
                  bool sort_values = false) const; // throw (NotSolvable);
+    template<class MAT>
+    inline void
+    eigen_space (MAT &eigenvalues,
+                 MAT &eigenvectors,
+                 MatrixWorkspace<MAT> &workspace,
+                 bool sort_values = false) const; // throw (NotSolvable);
+
+   // Same as above but only the eigenvalues are computed. Since no
+   // transformation is accumulated, it costs a fraction of eigen_space().
+   // If matrix is symmetric:
+   //     tridiagonalize, then use the root-free rational QL. The values
+   //     always come back in ascending order.
+   // else:
+   //     reduce to Hessenberg form, then to real Schur form, only
+   //     transforming the active block.
+   // Like eigen_space(), only the real parts are returned and MAT must be
+   // dense.
+   //
+    template<class MAT>
+    inline void
+    eigenvalues (MAT &values,
+                 bool sort_values = false) const; // throw (NotSolvable);
+    template<class MAT>
+    inline void
+    eigenvalues (MAT &values,
+                 MatrixWorkspace<MAT> &workspace,
+                 bool sort_values = false) const; // throw (NotSolvable);
+
+   // Only the k largest (or smallest) eigenvalues of a symmetric matrix
+   // and their eigenvectors. eigenvalues is 1 X k, eigenvectors is n X k.
+   // The largest come back in descending order and the smallest in
+   // ascending order.
+   // It is a thick-restart Lanczos iteration (see LanczosEigenSolver.h)
+   // that reads the matrix only through products with n X 1 vectors. So
+   // for k << n it costs a small multiple of k products, O(n^2) each,
+   // instead of the O(n^3) of eigen_space(). The packed SymmMatrixBase is
+   // multiplied in place.
+   // The second form is warm-started from the columns of warm_start,
+   // e.g. the eigenvectors of yesterday's matrix.
+   // They throw NotSolvable if the matrix is not symmetric, k is not in
+   // [1, n] or the iteration doesn't converge.
+   //
+    template<class MAT>
+    inline void
+    partial_eigen_space (size_type k,
+                         MAT &eigenvalues,
+                         MAT &eigenvectors,
+                         eigen_part which = eigen_part::largest) const;
+    template<class MAT>
+    inline void
+    partial_eigen_space (size_type k,
+                         MAT &eigenvalues,
+                         MAT &eigenvectors,
+                         const MAT &warm_start,
+                         eigen_part which = eigen_part::largest) const;
 
     template<class MAT>
     inline std::future<void>
@@ -339,8 +482,11 @@ public:
                        MAT &eigenvectors,
                        bool sort_values = false) const  {
 
+        void    (Matrix::*func) (MAT &, MAT &, bool) const =
+            &Matrix::eigen_space<MAT>;
+
         return (std::async(std::launch::async,
-                           &Matrix::eigen_space<MAT>,
+                           func,
                            this,
                            std::ref(eigenvalues),
                            std::ref(eigenvectors),
@@ -395,6 +541,39 @@ public:
                      Matrix &S,
                      Matrix &V,
                      bool full_size_S = true) const; // throw (NotSolvable);
+    inline void svd (Matrix &U,
+                     Matrix &S,
+                     Matrix &V,
+                     MatrixWorkspace<Matrix> &workspace,
+                     bool full_size_S = true) const; // throw (NotSolvable);
+
+   // Rank-k approximation by the randomized range finder of Halko,
+   // Martinsson and Tropp:
+   //     M ≈ U*Σ*~V
+   //
+   // U is mXk and V is nXk, both with orthonormal columns, and S is the
+   // kX1 column of the k largest singular values in descending order.
+   // M is multiplied by a random nX(k + oversample) matrix and the
+   // product is orthonormalized (blocked QR). Each of the n_iter power
+   // iterations multiplies by ~M and M again, which sharpens the result
+   // when the singular values decay slowly. The rest is the SVD of the
+   // small projection of M on that basis.
+   // M is read in 2 * n_iter + 2 products with thin matrices, so for
+   // k << min(m, n) it costs a small multiple of m*n*k instead of the
+   // full svd(). The random matrix always comes from the same seed, so
+   // the result is reproducible.
+   // MAT must be a dense (column-major) matrix, because U, S, V and the
+   // temporaries go to the kernels as raw pointers.
+   // It throws NotSolvable if k is not in [1, min(m, n)].
+   //
+    template<class MAT>
+    inline void
+    randomized_svd (size_type k,
+                    MAT &U,
+                    MAT &S,
+                    MAT &V,
+                    size_type oversample = 10,
+                    size_type n_iter = 2) const; // throw (NotSolvable);
 
    // In linear algebra, the QR decomposition (also called the QR
    // factorization) of a matrix is a decomposition of the matrix into an
@@ -412,6 +591,9 @@ public:
    // (with L being a left triangular matrix in this case).
    //
     inline void qrd (Matrix &Q, Matrix &R) const noexcept;
+    inline void
+    qrd (Matrix &Q, Matrix &R, MatrixWorkspace<Matrix> &workspace)
+        const noexcept;
 
    // In linear algebra, the LU decomposition is a matrix decomposition
    // which writes a matrix as the product of a lower and upper triangular
@@ -434,6 +616,18 @@ public:
    //
     inline void
     lud (Matrix &L, Matrix &U) const; // throw (NotSquare);
+    inline void
+    lud (Matrix &L,
+         Matrix &U,
+         MatrixWorkspace<Matrix> &workspace) const; // throw (NotSquare);
+
+   // NOTE: The decompositions above (and rank(), determinant() and
+   //       eigen_space()) take their temporaries from a MatrixWorkspace
+   //       (see MatrixWorkspace.h) and copy the results into the given
+   //       matrices. So results that already have the right size are
+   //       not allocated again. Without a workspace argument, they use
+   //       the workspace of the calling thread.
+   //
 
    // Cholesky decomposition:
    //
@@ -454,6 +648,9 @@ public:
    // linear equations. When it is applicable, the Cholesky decomposition
    // is twice as efficient as the LU decomposition.
    //
+   // It is a blocked factorization (see CholeskyFactorization.h). The
+   // matrix is checked for symmetry once, before it is factored.
+   //
    // NOTE: if right == true it is a right Cholesky decomposition, meaning
    //       for a symmetric positive-definite matrix A, you get
    //           A = ~R * R
@@ -503,6 +700,10 @@ public:
 
 private:
 
+   // For the temporaries of the algorithms. It allocates like the matrix.
+   //
+    using ScratchVector = typename BaseClass::ScratchVector;
+
    // For Eigen-space calculations
    //
     static const value_type EPSILON_;
@@ -525,10 +726,16 @@ private:
    // This is derived from the Algol procedures tred2 by Bowdler, Martin,
    // Reinsch, and Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear
    // Algebra, and the corresponding Fortran subroutine in EISPACK.
+   //
+   // If with_vectors is false, the transformations are not accumulated
+   // and e_vals is left holding the diagonal of the tridiagonal form.
    //
     template<class MAT>
     static inline void
-    tridiagonalize_ (MAT &e_vecs, MAT &e_vals, MAT &imagi) noexcept;
+    tridiagonalize_ (MAT &e_vecs,
+                     MAT &e_vals,
+                     MAT &imagi,
+                     bool with_vectors) noexcept;
 
    // Symmetric tridiagonal QL algorithm.
    //
@@ -540,27 +747,46 @@ private:
     static inline void
     diagonalize_ (MAT &e_vecs, MAT &e_vals, MAT &imagi) noexcept;
 
+   // Symmetric tridiagonal rational QL algorithm (eigenvalues only).
+   //
+   // This is derived from the Fortran subroutine tqlrat in EISPACK, the
+   // square-root free variant by Reinsch. It expects the output of
+   // tridiagonalize_() without vectors and leaves the eigenvalues in
+   // ascending order.
+   //
+    template<class MAT>
+    static inline void
+    tridiagonal_values_ (MAT &e_vals, MAT &imagi); // throw (NotSolvable);
+
    // Nonsymmetric reduction to Hessenberg form.
    //
    // This is derived from the Algol procedures orthes and ortran, by
    // Martin and Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear
    // Algebra, and the corresponding Fortran subroutines in EISPACK.
+   //
+   // If with_vectors is false, e_vecs is not touched.
    //
     template<class MAT>
     static inline void
-    red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form) noexcept;
+    red_to_hessenberg_ (MAT &e_vecs,
+                        MAT &hess_form,
+                        bool with_vectors) noexcept;
 
    // Nonsymmetric reduction from Hessenberg to real Schur form.
    //
    // This is derived from the Algol procedure hqr2, by Martin and
    // Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear Algebra, and the
    // corresponding Fortran subroutines in EISPACK.
+   //
+   // If with_vectors is false, e_vecs is not touched and only the
+   // unreduced block of hess_form is transformed.
    //
     template<class MAT>
     static inline void hessenberg_to_schur_ (MAT &e_vecs,
                                              MAT &e_vals,
                                              MAT &imagi,
-                                             MAT &hess_form) noexcept;
+                                             MAT &hess_form,
+                                             bool with_vectors) noexcept;
 
     // It returns the quotient of two complex numbers:
     // (a + ib) / (c + id)
@@ -591,10 +817,20 @@ public:
 
 // ----------------------------------------------------------------------------
 
-typedef Matrix<DenseMatrixBase, double>       DDMatrix;
-typedef Matrix<DenseMatrixBase, long double>  DLDMatrix;
-typedef Matrix<SymmMatrixBase, double>        SDMatrix;
-typedef Matrix<SymmMatrixBase, long double>   SLDMatrix;
+typedef Matrix<DenseMatrixBase, double>         DDMatrix;
+typedef Matrix<DenseMatrixBase, long double>    DLDMatrix;
+typedef Matrix<SymmMatrixBase, double>          SDMatrix;
+typedef Matrix<SymmMatrixBase, long double>     SLDMatrix;
+typedef Matrix<SymmRFPMatrixBase, double>       RFPDMatrix;
+typedef Matrix<SymmRFPMatrixBase, long double>  RFPLDMatrix;
+
+#ifndef WIN32
+typedef Matrix<MMapDenseMatrixBase, double>     MMapDDMatrix;
+typedef Matrix<MMapSymmMatrixBase, double>      MMapSDMatrix;
+#endif // WIN32
+
+typedef Matrix<ArenaDenseMatrixBase, double>    ArenaDDMatrix;
+typedef Matrix<ArenaSymmMatrixBase, double>     ArenaSDMatrix;
 
 } // namespace hmma
 
@@ -602,6 +838,10 @@ typedef Matrix<SymmMatrixBase, long double>   SLDMatrix;
 
 #  ifdef DMS_INCLUDE_SOURCE
 #    include <Tiger/Matrix.tcc>
+#    include <Tiger/LUFactorization.h>
+#    include <Tiger/CholeskyFactorization.h>
+#    include <Tiger/MatrixWorkspace.h>
+#    include <Tiger/LanczosEigenSolver.h>
 #  endif // DMS_INCLUDE_SOURCE
 
 // ----------------------------------------------------------------------------
@@ -29,9 +29,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <math.h>
 #include <algorithm>    // std::max and min
+#include <random>
+#include <vector>
 
 #include <Tiger/MathOperators.h>
 #include <Tiger/Matrix.h>
+#include <Tiger/MatrixKernels.h>
 
 // ----------------------------------------------------------------------------
 
@@ -95,6 +98,21 @@ pow__<long double> (long double x, long double y) noexcept  {
 
 // ----------------------------------------------------------------------------
 
+// Matrices that store all their elements column by column in one
+// contiguous vector. Only they can be handed to the kernels as a raw
+// pointer and a leading dimension. It is decided by the storage overload
+// picked for a MAT pointer, the same way as in gram_matrix__().
+//
+template<class TYPE, class S>
+std::true_type dense_storage__ (const BasicDenseMatrixBase<TYPE, S> *);
+std::false_type dense_storage__ (const void *);
+
+template<class MAT>
+using is_dense_matrix__ =
+    decltype (dense_storage__ (static_cast<const MAT *>(nullptr)));
+
+// ----------------------------------------------------------------------------
+
 template<typename T>
 inline T hypot__ (T x, T y) noexcept;
 
@@ -159,15 +177,13 @@ template<template<class T> class BASE, class TYPE>
 inline Matrix<BASE, TYPE> &
 Matrix<BASE, TYPE>::transpose (Matrix &that) const noexcept  {
 
-    // Matrix      tmp = *this;
-    // size_type   count = 0;
-
-    // for (col_const_iterator cciter = col_begin ();
-    //      cciter != col_end (); ++cciter, ++count)
-    //     tmp (count / rows (), count % rows ()) = *cciter;
-    // that.swap (tmp);
+    if (&that == this)
+        return (that.transpose ());
 
-    that = ~ *this;
+    if (BaseClass::_is_symmetric_matrix ())
+        that = *this;
+    else
+        that = ~ *this;
     return (that);
 }
 
@@ -176,10 +192,7 @@ Matrix<BASE, TYPE>::transpose (Matrix &that) const noexcept  {
 template<template<class T> class BASE, class TYPE>
 inline Matrix<BASE, TYPE> &Matrix<BASE, TYPE>::transpose () noexcept  {
 
-    Matrix   tmp;
-
-    transpose (tmp);
-    BaseClass::swap (tmp);
+    BaseClass::_transpose ();
     return (*this);
 }
 
@@ -191,38 +204,9 @@ inline Matrix<BASE, TYPE> &Matrix<BASE, TYPE>::invert ()  {
     if (! is_square ())
         throw NotSquare ();
 
-    Matrix   tmp (BaseClass::rows (), BaseClass::columns ());
-
-    tmp.identity ();
-    for (size_type r = 0; r < BaseClass::rows (); ++r)  {
-        const size_type indx = ppivot_ (r);
-
-        if (indx == BaseClass::_NOPOS)
-            throw Singular ();
-
-        if (indx != 0)
-            for (size_type c = 0; c < BaseClass::columns (); ++c)
-                std::swap (tmp (r, c), tmp (indx, c));
-
-        const value_type    diag = BaseClass::at (r, r);
-
-        for (size_type c = 0; c < BaseClass::columns (); ++c)  {
-            BaseClass::at (r, c) /= diag;
-            tmp (r, c) /= diag;
-        }
-
-        for (size_type rr = 0; rr < BaseClass::rows (); ++rr)
-            if (rr != r)  {
-                const value_type    off_diag = BaseClass::at (rr, r);
-
-                for (size_type c = 0; c < BaseClass::columns (); ++c)  {
-                    BaseClass::at (rr, c) -= off_diag * BaseClass::at (r, c);
-                    tmp (rr, c) -= off_diag * tmp (r, c);
-                }
-            }
-    }
+    const LUFactorization<Matrix>   lu (*this);
 
-    BaseClass::swap (tmp);
+    lu.inverse (*this);
     return (*this);
 }
 
@@ -310,11 +294,23 @@ template<template<class T> class BASE, class TYPE>
 inline typename Matrix<BASE, TYPE>::size_type
 Matrix<BASE, TYPE>::rank () const noexcept  {
 
-    Matrix      tmp (*this);
-    size_type   r;
+    return (rank (MatrixWorkspace<Matrix>::local ()));
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+inline typename Matrix<BASE, TYPE>::size_type
+Matrix<BASE, TYPE>::rank (MatrixWorkspace<Matrix> &workspace) const noexcept {
 
-    tmp.rref (r);
-    return (r);
+    LUFactorization<Matrix> &lu = workspace.lu ();
+
+    lu.factorize (*this);
+
+    const size_type result = lu.rank ();
+
+    workspace.give_back_lu ();
+    return (result);
 }
 
 // ----------------------------------------------------------------------------
@@ -323,32 +319,25 @@ template<template<class T> class BASE, class TYPE>
 inline typename Matrix<BASE, TYPE>::value_type
 Matrix<BASE, TYPE>::determinant () const {
 
-    if (! is_square ())
-        throw NotSquare ();
-
-    Matrix       tmp (*this);
-    value_type   result (1.0);
+    return (determinant (MatrixWorkspace<Matrix>::local ()));
+}
 
-    for (size_type r = 0; r < BaseClass::rows (); ++r)  {
-        const size_type indx = tmp.ppivot_ (r);
+// ----------------------------------------------------------------------------
 
-        if (indx == BaseClass::_NOPOS)
-            return (value_type(0.0));
+template<template<class T> class BASE, class TYPE>
+inline typename Matrix<BASE, TYPE>::value_type
+Matrix<BASE, TYPE>::determinant (MatrixWorkspace<Matrix> &workspace) const {
 
-        if (indx != 0)
-            result = -result;
+    if (! is_square ())
+        throw NotSquare ();
 
-        const value_type    diag = tmp (r, r);
+    LUFactorization<Matrix> &lu = workspace.lu ();
 
-        result *= diag;
-        for (size_type rr = r + 1; rr < BaseClass::rows (); ++rr)  {
-            const value_type    piv = tmp (rr, r) / diag;
+    lu.factorize (*this);
 
-            for (size_type c = r + 1; c < BaseClass::columns (); ++c)
-                tmp (rr, c) -= piv * tmp (r, c);
-        }
-    }
+    const value_type    result = lu.determinant ();
 
+    workspace.give_back_lu ();
     return (result);
 }
 
@@ -410,46 +399,133 @@ inline Matrix<BASE, TYPE> &Matrix<BASE, TYPE>::adjoint (Matrix &that) const {
 
 // ----------------------------------------------------------------------------
 
+// result = alpha * ~X * X, for the rows X cols column-major X. The last
+// argument is result again. It picks the overload by the storage of
+// result.
+// The general form computes the lower triangle into a scratch square with
+// syrk() and copies it to both triangles of result. A dense result gets
+// the triangle in place. A packed symmetric result is computed a panel of
+// columns at a time with gemm(), so it never needs the square.
+//
+template<class MAT>
+inline void gram_matrix__ (std::size_t rows,
+                           std::size_t cols,
+                           typename MAT::value_type alpha,
+                           const typename MAT::value_type *x,
+                           MAT &result,
+                           const void *)  {
+
+    using value_type = typename MAT::value_type;
+
+    std::vector<value_type> gram (cols * cols);
+
+    syrk (false, true, cols, rows, alpha, x, rows, value_type(0),
+          gram.data (), cols);
+    result.resize (cols, cols);
+    for (std::size_t c = 0; c < cols; ++c)
+        for (std::size_t r = c; r < cols; ++r)
+            result (r, c) = result (c, r) = gram[r + c * cols];
+}
+
+template<class MAT, class TYPE, class S>
+inline void gram_matrix__ (std::size_t rows,
+                           std::size_t cols,
+                           TYPE alpha,
+                           const TYPE *x,
+                           MAT &result,
+                           const BasicDenseMatrixBase<TYPE, S> *)  {
+
+    result.resize (cols, cols);
+    if (cols == 0)  return;
+
+    TYPE    *gram = &(*result.col_begin ());
+
+    syrk (false, true, cols, rows, alpha, x, rows, TYPE(0), gram, cols);
+    for (std::size_t c = 0; c < cols; ++c)
+        for (std::size_t r = c + 1; r < cols; ++r)
+            gram[c + r * cols] = gram[r + c * cols];
+}
+
+template<class MAT, class TYPE, class S>
+inline void gram_matrix__ (std::size_t rows,
+                           std::size_t cols,
+                           TYPE alpha,
+                           const TYPE *x,
+                           MAT &result,
+                           const BasicSymmMatrixBase<TYPE, S> *)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<TYPE>::PACKED_PANEL;
+
+    result.resize (cols, cols);
+    if (cols == 0)  return;
+
+    TYPE                *ap = &(*result.col_begin ());
+    std::vector<TYPE>   panel (cols * std::min (NB, cols));
+
+   // Rows j ... cols - 1 of the columns j ... j + nb - 1. Only the part
+   // of the diagonal block above its diagonal is thrown away.
+   //
+    for (std::size_t j = 0; j < cols; j += NB)  {
+        const std::size_t   nb = std::min (NB, cols - j);
+        const std::size_t   m = cols - j;
+
+        gemm (true, false, m, nb, rows, alpha, x + j * rows, rows,
+              x + j * rows, rows, TYPE(0), panel.data (), m);
+        for (std::size_t k = 0; k < nb; ++k)
+            std::copy (panel.data () + k * m + k, panel.data () + (k + 1) * m,
+                       packed_column__ (ap, cols, j + k) + j + k);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 template<template<class T> class BASE, class TYPE>
 inline Matrix<BASE, TYPE>
 Matrix<BASE, TYPE>::covariance (bool is_unbiased) const {
 
-    const value_type    denom =
-        is_unbiased ? BaseClass::rows () - 1 : BaseClass::rows ();
+    Matrix  sol;
+
+    return (covariance (sol, is_unbiased));
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<template<class T> class BASE2>
+inline Matrix<BASE2, TYPE> &
+Matrix<BASE, TYPE>::
+covariance (Matrix<BASE2, TYPE> &result, bool is_unbiased) const {
+
+    const size_type     rows = BaseClass::rows ();
+    const size_type     cols = BaseClass::columns ();
+    const value_type    denom = is_unbiased ? rows - 1 : rows;
 
     if (denom <= value_type(0.0))
         throw NotSolvable ();
 
-    Matrix                              sol (BaseClass::columns (),
-                                             BaseClass::columns ());
-    typename BaseClass::row_iterator    sol_iter = sol.row_begin ();
-
-   // I don't know how I can take advantage of the fact this is a
-   // symmetric matrix by definition
+   // Center the columns once, into a column-major array
    //
-    for (size_type c = 0; c < BaseClass::columns (); ++c)  {
+    ScratchVector   centered (std::size_t(rows) * cols);
+
+    for (size_type c = 0; c < cols; ++c)  {
+        value_type  *col = centered.data () + std::size_t(c) * rows;
         value_type  col_mean (0.0);
         size_type   counter = 0;
 
         for (typename BaseClass::col_const_iterator cciter =
-                 BaseClass::col_begin () + c * BaseClass::rows ();
-             counter != BaseClass::rows (); ++cciter, ++counter)
+                 BaseClass::col_begin () + c * rows;
+             counter != rows; ++cciter, ++counter)  {
+            col[counter] = *cciter;
             col_mean += *cciter;
-
-        col_mean /= value_type(BaseClass::rows ());
-
-        for (size_type cc = 0; cc < BaseClass::columns (); ++cc)  {
-            value_type  var (0.0);
-
-            for (size_type r = 0; r < BaseClass::rows (); ++r)
-                var += (BaseClass::at (r, c) - col_mean) *
-                       (BaseClass::at (r, cc) - col_mean);
-
-            *sol_iter++ = var / denom;
         }
+        col_mean /= value_type(rows);
+        for (size_type r = 0; r < rows; ++r)
+            col[r] -= col_mean;
     }
 
-    return (sol);
+    gram_matrix__ (rows, cols, value_type(1) / denom, centered.data (),
+                   result, &result);
+    return (result);
 }
 
 // ----------------------------------------------------------------------------
@@ -480,36 +556,59 @@ template<template<class T> class BASE, class TYPE>
 inline Matrix<BASE, TYPE>
 Matrix<BASE, TYPE>::solve_se (const Matrix &rhs) const {
 
+    Matrix  sol = rhs;
+
+    return (solve_se_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+inline Matrix<BASE, TYPE> &
+Matrix<BASE, TYPE>::solve_se_in_place (Matrix &rhs) const {
+
     if (! is_square () || BaseClass::columns () != rhs.rows ())
         throw NotSolvable ();
 
-    Matrix  tmp (BaseClass::rows (), BaseClass::columns () + rhs.columns ());
+    const LUFactorization<Matrix>   lu (*this);
 
-    for (size_type r = 0; r < BaseClass::rows (); ++r)  {
-        for (size_type c = 0; c < BaseClass::columns (); ++c)
-            tmp (r, c) = BaseClass::at (r, c);
-        for (size_type c = 0; c < rhs.columns (); ++c)
-            tmp (r, BaseClass::columns () + c) = rhs (r, c);
-    }
+    return (lu.solve_in_place (rhs));
+}
 
-    size_type   rank;
+// ----------------------------------------------------------------------------
 
-    tmp.rref (rank);
+template<template<class T> class BASE, class TYPE>
+inline Matrix<BASE, TYPE>
+Matrix<BASE, TYPE>::cholesky_solve (const Matrix &rhs) const {
 
-    if (rank != BaseClass::rows ())
-        throw Singular ();
+    Matrix  sol = rhs;
 
-    Matrix  sol (rhs.rows (), rhs.columns ());
+    return (cholesky_solve_in_place (sol));
+}
 
-    for (size_type rhsc = 0; rhsc < rhs.columns (); ++rhsc)
-        for (int r = static_cast<int>(BaseClass::rows ()) - 1; r >= 0; --r)  {
-            sol (r, rhsc) = tmp (r, BaseClass::columns () + rhsc);
+// ----------------------------------------------------------------------------
 
-            for (size_type c = r + 1; c < BaseClass::columns (); ++c)
-                sol (r, rhsc) -= tmp (r, c) * sol (c, rhsc);
-        }
+template<template<class T> class BASE, class TYPE>
+inline Matrix<BASE, TYPE> &
+Matrix<BASE, TYPE>::cholesky_solve_in_place (Matrix &rhs) const {
 
-    return (sol);
+    if (! is_square () || BaseClass::columns () != rhs.rows ())
+        throw NotSolvable ();
+
+    const CholeskyFactorization<Matrix> chol (*this);
+
+    return (chol.cholesky_solve_in_place (rhs));
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+inline Matrix<BASE, TYPE> &
+Matrix<BASE, TYPE>::cholesky_inverse (Matrix &that) const {
+
+    const CholeskyFactorization<Matrix> chol (*this);
+
+    return (chol.cholesky_inverse (that));
 }
 
 // ----------------------------------------------------------------------------
@@ -621,38 +720,102 @@ Matrix<BASE, TYPE>::trace () const {
 
 // ----------------------------------------------------------------------------
 
+// Copies a symmetric matrix into a (square) matrix of another kind.
+// RFP storage is copied by whole columns.
+//
+template<class MAT, class SRC>
+inline void copy_symmetric__ (MAT &dst, const SRC &src)  {
+
+    for (typename SRC::size_type r = 0; r < src.rows (); ++r)
+        for (typename SRC::size_type c = 0; c < src.columns (); ++c)
+            dst (r, c) = src (r, c);
+}
+
+template<class TYPE>
+inline void copy_symmetric__ (Matrix<DenseMatrixBase, TYPE> &dst,
+                              const Matrix<SymmRFPMatrixBase, TYPE> &src)  {
+
+    src.unpack (&(*dst.col_begin ()), dst.rows ());
+}
+
+// ----------------------------------------------------------------------------
+
 template<template<class T> class BASE, class TYPE>
 template<class MAT>
 inline void Matrix<BASE, TYPE>::
 eigen_space (MAT &eigenvalues, MAT &eigenvectors, bool sort_values) const {
 
+    eigen_space (eigenvalues, eigenvectors, MatrixWorkspace<MAT>::local (),
+                 sort_values);
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+eigen_space (MAT &eigenvalues,
+             MAT &eigenvectors,
+             MatrixWorkspace<MAT> &workspace,
+             bool sort_values) const {
+
+    static_assert(is_dense_matrix__<MAT>::value,
+                  "eigen_space() needs a dense column-major MAT");
+
     if (! is_square () || BaseClass::columns () < 2)
         throw NotSolvable ();
 
-    MAT tmp_evecs (BaseClass::rows (), BaseClass::columns ());
-    MAT tmp_evals (1, BaseClass::columns ());
-    MAT imagi (1, BaseClass::columns ()); // Imaginary part
+    MAT tmp_evecs;
+    MAT tmp_evals;
+    MAT imagi; // Imaginary part
+
+    workspace.take (0, tmp_evecs, BaseClass::rows (), BaseClass::columns ());
+    workspace.take (1, tmp_evals, 1, BaseClass::columns ());
+    workspace.take (2, imagi, 1, BaseClass::columns ());
 
     if (is_symmetric ())  {
-        for (size_type r = 0; r < BaseClass::rows (); ++r)
+        copy_symmetric__ (tmp_evecs, *this);
+        if (BaseClass::columns () < GEMMBlocking<value_type>::STEDC_MIN)  {
             for (size_type c = 0; c < BaseClass::columns (); ++c)
-                tmp_evecs (r, c) = BaseClass::at (r, c);
-
-        for (size_type c = 0; c < BaseClass::columns (); ++c)
-            tmp_evals (0, c) = BaseClass::at (BaseClass::rows () - 1, c);
+                tmp_evals (0, c) = BaseClass::at (BaseClass::rows () - 1, c);
 
-        tridiagonalize_ (tmp_evecs, tmp_evals, imagi);
-        diagonalize_ (tmp_evecs, tmp_evals, imagi);
+            tridiagonalize_ (tmp_evecs, tmp_evals, imagi, true);
+            diagonalize_ (tmp_evecs, tmp_evals, imagi);
+        }
+        else  {
+           // Blocked reduction and divide-and-conquer on the tridiagonal
+           // form. Then the reflectors are applied to its eigenvectors.
+           // Eigenvector matrices are dense and column-major.
+           //
+            const size_type                         n = BaseClass::columns ();
+            typename MatrixWorkspace<MAT>::Vector   z_vecs;
+            typename MatrixWorkspace<MAT>::Vector   tau;
+
+            workspace.take (0, z_vecs, n * n);
+            workspace.take (1, tau, n);
+            sytrd (n, &(tmp_evecs (0, 0)), n,
+                   &(tmp_evals (0, 0)), &(imagi (0, 1)), tau.data ());
+            stedc (n, &(tmp_evals (0, 0)), &(imagi (0, 1)),
+                   z_vecs.data (), n);
+            ormtr (n, n, &(tmp_evecs (0, 0)), n, tau.data (),
+                   z_vecs.data (), n);
+            std::copy (z_vecs.begin (), z_vecs.end (), &(tmp_evecs (0, 0)));
+            workspace.give_back (0, z_vecs);
+            workspace.give_back (1, tau);
+        }
     }
     else  {
-        MAT hess_form (BaseClass::rows (), BaseClass::columns ());
+        MAT hess_form;
+
+        workspace.take (3, hess_form,
+                        BaseClass::rows (), BaseClass::columns ());
 
         for (size_type r = 0; r < BaseClass::rows (); ++r)
             for (size_type c = 0; c < BaseClass::columns (); ++c)
                 hess_form (r, c) = BaseClass::at (r, c);
 
-        red_to_hessenberg_ (tmp_evecs, hess_form);
-        hessenberg_to_schur_ (tmp_evecs, tmp_evals, imagi, hess_form);
+        red_to_hessenberg_ (tmp_evecs, hess_form, true);
+        hessenberg_to_schur_ (tmp_evecs, tmp_evals, imagi, hess_form, true);
     }
 
     if (sort_values)  {
@@ -678,13 +841,184 @@ eigen_space (MAT &eigenvalues, MAT &eigenvectors, bool sort_values) const {
         }
     }
 
-    eigenvalues.swap (tmp_evals);
-    eigenvectors.swap (tmp_evecs);
+    eigenvalues = tmp_evals;
+    eigenvectors = tmp_evecs;
+
+    workspace.give_back (0, tmp_evecs);
+    workspace.give_back (1, tmp_evals);
+    workspace.give_back (2, imagi);
     return;
 }
 
 // ----------------------------------------------------------------------------
 
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+eigenvalues (MAT &values, bool sort_values) const {
+
+    eigenvalues (values, MatrixWorkspace<MAT>::local (), sort_values);
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+eigenvalues (MAT &values,
+             MatrixWorkspace<MAT> &workspace,
+             bool sort_values) const {
+
+    static_assert(is_dense_matrix__<MAT>::value,
+                  "eigenvalues() needs a dense column-major MAT");
+
+    if (! is_square () || BaseClass::columns () < 2)
+        throw NotSolvable ();
+
+    MAT work;
+    MAT tmp_evals;
+    MAT imagi; // Imaginary part
+
+    workspace.take (0, work, BaseClass::rows (), BaseClass::columns ());
+    workspace.take (1, tmp_evals, 1, BaseClass::columns ());
+    workspace.take (2, imagi, 1, BaseClass::columns ());
+
+    if (is_symmetric ())  {
+        copy_symmetric__ (work, *this);
+        if (BaseClass::columns () < GEMMBlocking<value_type>::STEDC_MIN)  {
+            for (size_type c = 0; c < BaseClass::columns (); ++c)
+                tmp_evals (0, c) = BaseClass::at (BaseClass::rows () - 1, c);
+            tridiagonalize_ (work, tmp_evals, imagi, false);
+        }
+        else  {
+            typename MatrixWorkspace<MAT>::Vector   tau;
+
+            workspace.take (1, tau, BaseClass::columns ());
+            sytrd (BaseClass::columns (), &(work (0, 0)), work.rows (),
+                   &(tmp_evals (0, 0)), &(imagi (0, 1)), tau.data ());
+            workspace.give_back (1, tau);
+        }
+
+       // The rational QL leaves the values in ascending order
+       //
+        tridiagonal_values_ (tmp_evals, imagi);
+        sort_values = false;
+    }
+    else  {
+        MAT no_vecs;
+
+        for (size_type r = 0; r < BaseClass::rows (); ++r)
+            for (size_type c = 0; c < BaseClass::columns (); ++c)
+                work (r, c) = BaseClass::at (r, c);
+
+        red_to_hessenberg_ (no_vecs, work, false);
+        hessenberg_to_schur_ (no_vecs, tmp_evals, imagi, work, false);
+    }
+
+    if (sort_values)
+        std::sort (&(tmp_evals (0, 0)),
+                   &(tmp_evals (0, 0)) + BaseClass::columns ());
+
+    values = tmp_evals;
+
+    workspace.give_back (0, work);
+    workspace.give_back (1, tmp_evals);
+    workspace.give_back (2, imagi);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// y = A * x for the symmetric A and the dense n X b x and y. The general
+// form goes element by element. Dense and packed matrices are handed to
+// the kernels, which read only one triangle.
+//
+template<class MAT, class SRC>
+inline void symmetric_product__ (const SRC &a, const MAT &x, MAT &y)  {
+
+    for (typename MAT::size_type c = 0; c < x.columns (); ++c)
+        for (typename MAT::size_type r = 0; r < a.rows (); ++r)  {
+            typename MAT::value_type    sum (0);
+
+            for (typename MAT::size_type i = 0; i < a.columns (); ++i)
+                sum += a (r, i) * x (i, c);
+            y (r, c) = sum;
+        }
+}
+
+template<class TYPE>
+inline void
+symmetric_product__ (const Matrix<DenseMatrixBase, TYPE> &a,
+                     const Matrix<DenseMatrixBase, TYPE> &x,
+                     Matrix<DenseMatrixBase, TYPE> &y)  {
+
+    const std::size_t   n = a.rows ();
+
+    if (x.columns () == 1)
+        symv (n, &(*a.col_begin ()), n,
+              &(*x.col_begin ()), &(*y.col_begin ()));
+    else
+        symm (false, n, x.columns (), TYPE(1), &(*a.col_begin ()), n,
+              &(*x.col_begin ()), n, TYPE(0), &(*y.col_begin ()), n);
+}
+
+template<class TYPE>
+inline void
+symmetric_product__ (const Matrix<SymmMatrixBase, TYPE> &a,
+                     const Matrix<DenseMatrixBase, TYPE> &x,
+                     Matrix<DenseMatrixBase, TYPE> &y)  {
+
+    const std::size_t   n = a.rows ();
+
+    packed_symm__ (&(*a.col_begin ()), n, x.columns (),
+                   &(*x.col_begin ()), n, &(*y.col_begin ()), n);
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+partial_eigen_space (size_type k,
+                     MAT &eigenvalues,
+                     MAT &eigenvectors,
+                     eigen_part which) const  {
+
+    if (! is_square () || ! is_symmetric ())
+        throw NotSolvable ();
+
+    LanczosEigenSolver<MAT> solver (k, which);
+
+    solver.solve ([this](const MAT &x, MAT &y)  {
+                      symmetric_product__ (*this, x, y);
+                  },
+                  BaseClass::rows (), eigenvalues, eigenvectors);
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+partial_eigen_space (size_type k,
+                     MAT &eigenvalues,
+                     MAT &eigenvectors,
+                     const MAT &warm_start,
+                     eigen_part which) const  {
+
+    if (! is_square () || ! is_symmetric ())
+        throw NotSolvable ();
+
+    LanczosEigenSolver<MAT> solver (k, which);
+
+    solver.solve ([this](const MAT &x, MAT &y)  {
+                      symmetric_product__ (*this, x, y);
+                  },
+                  BaseClass::rows (), eigenvalues, eigenvectors, warm_start);
+}
+
+// ----------------------------------------------------------------------------
+
 template<template<class T> class BASE, class TYPE>
 inline Matrix<BASE, TYPE> &
 Matrix<BASE, TYPE>::power (Matrix &result, value_type n, bool is_diag) const {
@@ -728,24 +1062,47 @@ template<template<class T> class BASE, class TYPE>
 inline void Matrix<BASE, TYPE>::
 svd (Matrix &U, Matrix &S, Matrix &V, bool full_size_S) const {
 
+    svd (U, S, V, MatrixWorkspace<Matrix>::local (), full_size_S);
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+inline void Matrix<BASE, TYPE>::
+svd (Matrix &U,
+     Matrix &S,
+     Matrix &V,
+     MatrixWorkspace<Matrix> &workspace,
+     bool full_size_S) const {
+
+    using Vector = typename MatrixWorkspace<Matrix>::Vector;
+
     const size_type min_dem =
         std::min (BaseClass::rows (), BaseClass::columns ());
 
     if (min_dem < 3)
         throw NotSolvable ();
 
-    Matrix                  self_tmp = *this;
-    Matrix                  u_tmp (BaseClass::rows (), min_dem);
-    std::vector<value_type> s_tmp (std::min (BaseClass::rows () + 1,
-                                             BaseClass::columns ()));
-    Matrix                  v_tmp (BaseClass::columns(), BaseClass::columns());
-    Matrix                  imagi (1, BaseClass::columns ()); // Imaginary part
-    std::vector<value_type> sandbox (BaseClass::rows ());
+    Matrix                  self_tmp;
+    Matrix                  u_tmp;
+    Vector                  s_tmp;
+    Matrix                  v_tmp;
+    Matrix                  imagi; // Imaginary part
+    Vector                  sandbox;
     const size_type         min_col_cnt =
         std::min (BaseClass::rows () - 1, BaseClass::columns ());
     const size_type         max_row_cnt =
         std::max(0U, std::min(BaseClass::columns () - 2, BaseClass::rows ()));
 
+    workspace.take (0, self_tmp);
+    self_tmp = *this;
+    workspace.take (1, u_tmp, BaseClass::rows (), min_dem);
+    workspace.take (0, s_tmp, std::min (BaseClass::rows () + 1,
+                                        BaseClass::columns ()));
+    workspace.take (2, v_tmp, BaseClass::columns (), BaseClass::columns ());
+    workspace.take (3, imagi, 1, BaseClass::columns ());
+    workspace.take (1, sandbox, BaseClass::rows ());
+
    // Reduce A to bidiagonal form, storing the diagonal elements
    // in s and the super-diagonal elements in e.
    //
@@ -1160,7 +1517,7 @@ svd (Matrix &U, Matrix &S, Matrix &V, bool full_size_S) const {
         }
     }
 
-    U.swap (u_tmp);
+    U = u_tmp;
 
     S.resize (s_tmp.size (), full_size_S ? s_tmp.size () : 1);
 
@@ -1169,18 +1526,153 @@ svd (Matrix &U, Matrix &S, Matrix &V, bool full_size_S) const {
     for (auto citer = s_tmp.begin(); citer != s_tmp.end(); ++citer, ++row_count)
         S (row_count, full_size_S ? row_count : 0) = *citer;
 
-    V.swap (v_tmp);
+    V = v_tmp;
+
+    workspace.give_back (0, self_tmp);
+    workspace.give_back (1, u_tmp);
+    workspace.give_back (0, s_tmp);
+    workspace.give_back (2, v_tmp);
+    workspace.give_back (3, imagi);
+    workspace.give_back (1, sandbox);
 
     return;
 }
 
 // ----------------------------------------------------------------------------
 
+// y = op(A) * x for the dense x and y, where op(A) is A or ~A. The general
+// form goes element by element. Dense matrices are handed to gemm().
+//
+template<class MAT, class SRC>
+inline void
+general_product__ (bool trans, const SRC &a, const MAT &x, MAT &y)  {
+
+    const typename MAT::size_type   inner = x.rows ();
+
+    for (typename MAT::size_type c = 0; c < x.columns (); ++c)
+        for (typename MAT::size_type r = 0; r < y.rows (); ++r)  {
+            typename MAT::value_type    sum (0);
+
+            for (typename MAT::size_type i = 0; i < inner; ++i)
+                sum += (trans ? a (i, r) : a (r, i)) * x (i, c);
+            y (r, c) = sum;
+        }
+}
+
+template<class TYPE>
+inline void
+general_product__ (bool trans,
+                   const Matrix<DenseMatrixBase, TYPE> &a,
+                   const Matrix<DenseMatrixBase, TYPE> &x,
+                   Matrix<DenseMatrixBase, TYPE> &y)  {
+
+    gemm (trans, false, y.rows (), y.columns (), x.rows (),
+          TYPE(1), &(*a.col_begin ()), a.rows (),
+          &(*x.col_begin ()), x.rows (),
+          TYPE(0), &(*y.col_begin ()), y.rows ());
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+randomized_svd (size_type k,
+                MAT &U,
+                MAT &S,
+                MAT &V,
+                size_type oversample,
+                size_type n_iter) const  {
+
+    static_assert(is_dense_matrix__<MAT>::value,
+                  "randomized_svd() needs dense column-major U, S and V");
+
+    using value_t = typename MAT::value_type;
+
+    const size_type m = BaseClass::rows ();
+    const size_type n = BaseClass::columns ();
+    const size_type min_dem = std::min (m, n);
+
+    if (k == 0 || k > min_dem)
+        throw NotSolvable ();
+
+    const size_type l = k + std::min (oversample, min_dem - k);
+    MAT             y (m, l);
+    MAT             z (n, l);
+    std::vector<value_t>            tau (l);
+    std::mt19937                    gen;
+    std::normal_distribution<value_t>   dist;
+
+   // Range of M, sampled by a Gaussian nXl matrix and refined by subspace
+   // iteration. The basis is orthonormalized after every product, so
+   // the small singular values don't drown in round off.
+   //
+    for (size_type c = 0; c < l; ++c)
+        for (size_type r = 0; r < n; ++r)
+            z (r, c) = dist (gen);
+    general_product__ (false, *this, z, y);
+    geqrf (m, l, &(*y.col_begin ()), m, tau.data ());
+    orgqr (m, l, &(*y.col_begin ()), m, tau.data ());
+    for (size_type i = 0; i < n_iter; ++i)  {
+        general_product__ (true, *this, y, z);
+        geqrf (n, l, &(*z.col_begin ()), n, tau.data ());
+        orgqr (n, l, &(*z.col_begin ()), n, tau.data ());
+        general_product__ (false, *this, z, y);
+        geqrf (m, l, &(*y.col_begin ()), m, tau.data ());
+        orgqr (m, l, &(*y.col_begin ()), m, tau.data ());
+    }
+
+   // With Q the basis in y, ~B = ~M * Q is nXl. Its QR ~B = Qb * R and
+   // the SVD of the lXl R = Ur * Σ * ~Vr give
+   //     M ≈ Q * B = (Q * Vr) * Σ * ~(Qb * Ur)
+   //
+    MAT                     r (l, l, value_t(0));
+    MAT                     vr (l, l);
+    std::vector<value_t>    sigma (l);
+
+    general_product__ (true, *this, y, z);
+    geqrf (n, l, &(*z.col_begin ()), n, tau.data ());
+    for (size_type c = 0; c < l; ++c)
+        for (size_type row = 0; row <= c; ++row)
+            r (row, c) = z (row, c);
+    orgqr (n, l, &(*z.col_begin ()), n, tau.data ());
+    if (! gesvj (l, l, &(*r.col_begin ()), l, sigma.data (),
+                 &(*vr.col_begin ()), l))
+        throw NotSolvable ();
+
+    U.resize (m, k);
+    gemm (false, false, m, k, l, value_t(1), &(*y.col_begin ()), m,
+          &(*vr.col_begin ()), l, value_t(0), &(*U.col_begin ()), m);
+    S.resize (k, 1);
+    for (size_type i = 0; i < k; ++i)
+        S (i, 0) = sigma[i];
+    V.resize (n, k);
+    gemm (false, false, n, k, l, value_t(1), &(*z.col_begin ()), n,
+          &(*r.col_begin ()), l, value_t(0), &(*V.col_begin ()), n);
+}
+
+// ----------------------------------------------------------------------------
+
 template<template<class T> class BASE, class TYPE>
 inline void Matrix<BASE, TYPE>::qrd (Matrix &Q, Matrix &R) const noexcept  {
 
-    std::vector<value_type> r_diag (BaseClass::columns ());
-    Matrix                  self_tmp = *this;
+    qrd (Q, R, MatrixWorkspace<Matrix>::local ());
+}
+
+// ----------------------------------------------------------------------------
+
+template<template<class T> class BASE, class TYPE>
+inline void Matrix<BASE, TYPE>::
+qrd (Matrix &Q, Matrix &R, MatrixWorkspace<Matrix> &workspace) const noexcept {
+
+    using Vector = typename MatrixWorkspace<Matrix>::Vector;
+
+    Vector  r_diag;
+    Matrix  self_tmp;
+
+    workspace.take (0, r_diag, BaseClass::columns ());
+    workspace.take (0, self_tmp);
+    self_tmp = *this;
 
     for (size_type c = 0; c < BaseClass::columns (); ++c)  {
         value_type  nrm (0.0);
@@ -1219,9 +1711,17 @@ inline void Matrix<BASE, TYPE>::qrd (Matrix &Q, Matrix &R) const noexcept  {
         r_diag [c] = -nrm;
     }
 
-    Matrix   q_tmp (BaseClass::rows (), BaseClass::columns ());
+    Matrix  q_tmp;
+
+    workspace.take (1, q_tmp, BaseClass::rows (), BaseClass::columns ());
+
+   // If there are more columns than rows, there are only rows Householder
+   // vectors. The other columns of Q and rows of R are zeros.
+   //
+    const size_type min_dem =
+        std::min (BaseClass::rows (), BaseClass::columns ());
 
-    for (int c = static_cast<int>(BaseClass::columns ()) - 1; c >= 0; --c)  {
+    for (int c = static_cast<int>(min_dem) - 1; c >= 0; --c)  {
         q_tmp (c, c) = value_type(1.0);
 
         for (size_type cc = c; cc < BaseClass::columns (); ++cc)
@@ -1237,17 +1737,24 @@ inline void Matrix<BASE, TYPE>::qrd (Matrix &Q, Matrix &R) const noexcept  {
             }
     }
 
-    Matrix   r_tmp (BaseClass::columns (), BaseClass::columns ());
+    Matrix  r_tmp;
 
-    for (size_type c = 0; c < BaseClass::columns (); ++c)
+    workspace.take (2, r_tmp, BaseClass::columns (), BaseClass::columns ());
+
+    for (size_type c = 0; c < min_dem; ++c)
         for (size_type r = 0; r < r_tmp.rows (); ++r)
             if (c < r)
                 r_tmp (c, r) = self_tmp (c, r);
             else if (c == r)
                 r_tmp (c, r) = r_diag [c];
 
-    Q.swap (q_tmp);
-    R.swap (r_tmp);
+    Q = q_tmp;
+    R = r_tmp;
+
+    workspace.give_back (0, r_diag);
+    workspace.give_back (0, self_tmp);
+    workspace.give_back (1, q_tmp);
+    workspace.give_back (2, r_tmp);
 
     return;
 }
@@ -1257,56 +1764,24 @@ inline void Matrix<BASE, TYPE>::qrd (Matrix &Q, Matrix &R) const noexcept  {
 template<template<class T> class BASE, class TYPE>
 inline void Matrix<BASE, TYPE>::lud (Matrix &L, Matrix &U) const {
 
-    if (! is_square ())
-        throw NotSquare ();
-
-    Matrix  self_tmp = *this;
-
-    for (size_type c = 0; c < BaseClass::columns (); ++c)  {
-       // Find pivot.
-       //
-        size_type   p = c;
-
-        for (size_type r = c + 1; r < BaseClass::rows (); ++r)
-            if (abs__ (self_tmp (r, c)) > abs__ (self_tmp (p, c)))
-                p = r;
-
-       // Exchange if necessary.
-       //
-        if (p != c)
-            for (size_type cc = 0; cc < BaseClass::columns (); ++cc)
-                std::swap (self_tmp (p, cc), self_tmp (c, cc));
-
-       // Compute multipliers and eliminate c-th column.
-       //
-        if (self_tmp (c, c) != value_type(0.0))
-            for (size_type r = c + 1; r < BaseClass::rows (); ++r)  {
-                self_tmp (r, c) /= self_tmp (c, c);
-
-                for (size_type cc = c + 1; cc < BaseClass::columns (); ++cc)
-                    self_tmp (r, cc) -= self_tmp (r, c) * self_tmp (c, cc);
-            }
-    }
-
-    Matrix  l_tmp (BaseClass::rows (), BaseClass::columns ());
+    lud (L, U, MatrixWorkspace<Matrix>::local ());
+}
 
-    for (size_type r = 0; r < BaseClass::rows (); ++r)
-        for (size_type c = 0; c < BaseClass::columns (); ++c)
-            if (r > c)
-                l_tmp (r, c) = self_tmp (r, c);
-            else if (r == c)
-                l_tmp (r, c) = value_type(1.0);
+// ----------------------------------------------------------------------------
 
-    Matrix  u_tmp (BaseClass::columns (), BaseClass::columns ());
+template<template<class T> class BASE, class TYPE>
+inline void Matrix<BASE, TYPE>::
+lud (Matrix &L, Matrix &U, MatrixWorkspace<Matrix> &workspace) const {
 
-    for (size_type c = 0; c < BaseClass::columns (); ++c)
-        for (size_type r = 0; r < u_tmp.rows (); ++r)
-            if (c <= r)
-                u_tmp (c,  r) = self_tmp (c, r);
+    if (! is_square ())
+        throw NotSquare ();
 
-    L.swap (l_tmp);
-    U.swap (u_tmp);
+    LUFactorization<Matrix> &lu = workspace.lu ();
 
+    lu.factorize (*this);
+    lu.get_lower (L);
+    lu.get_upper (U);
+    workspace.give_back_lu ();
     return;
 }
 
@@ -1316,42 +1791,12 @@ template<template<class T> class BASE, class TYPE>
 template<class MAT>
 inline void Matrix<BASE, TYPE>::chod (MAT &R, bool right) const {
 
-    if (! is_square ())
-        throw NotSolvable ();
-
-    MAT r_tmp (BaseClass::rows (), BaseClass::columns ());
-
-    for (size_type c = 0; c < BaseClass::columns (); ++c)  {
-        value_type  d (0.0);
-
-        for (size_type r = 0; r < c; ++r)  {
-            value_type  s =  right ? BaseClass::at (r, c) : value_type(0.0);
-
-            for (size_type rr = 0; rr < r; ++rr)
-                if (right)
-                    s -= r_tmp (rr, r) * r_tmp (rr, c);
-                else
-                    s += r_tmp (r, rr) * r_tmp (c, rr);
-
-            if (right)
-                r_tmp (r, c) = s /= r_tmp (r, r);
-            else
-                r_tmp (c, r) = s = (BaseClass::at (c, r) - s) / r_tmp (r, r);
-            d += s * s;
-
-            if (BaseClass::at (r, c) != BaseClass::at (c, r)) // Not symmetric
-                throw NotSolvable ();
-        }
-
-        d = BaseClass::at (c, c) - d;
+    const CholeskyFactorization<Matrix> chol (*this);
 
-        if (d <= value_type(0.0)) // Not positive definite
-            throw NotSolvable ();
-
-        r_tmp (c, c) = sqrt__ (std::max (d, value_type(0.0)));
-    }
-
-    R.swap (r_tmp);
+    if (right)
+        chol.get_upper (R);
+    else
+        chol.get_lower (R);
     return;
 }
 
@@ -1368,7 +1813,12 @@ inline bool Matrix<BASE, TYPE>::is_square () const noexcept  {
 template<template<class T> class BASE, class TYPE>
 inline bool Matrix<BASE, TYPE>::is_singular () const noexcept  {
 
-    return (is_square () && determinant () == value_type(0.0));
+    if (! is_square ())
+        return (false);
+
+    const LUFactorization<Matrix>   lu (*this);
+
+    return (lu.is_singular ());
 }
 
 // ----------------------------------------------------------------------------
@@ -1570,7 +2020,10 @@ Matrix<BASE, TYPE>::ppivot_ (size_type the_row) noexcept  {
 template<template<class T> class BASE, class TYPE>
 template<class MAT>
 inline void Matrix<BASE, TYPE>::
-tridiagonalize_ (MAT &e_vecs, MAT &e_vals, MAT &imagi) noexcept  {
+tridiagonalize_ (MAT &e_vecs,
+                 MAT &e_vals,
+                 MAT &imagi,
+                 bool with_vectors) noexcept  {
 
     for (size_type r = e_vecs.rows () - 1; r > 0; --r)  {
        // Scale to avoid under/overflow.
@@ -1649,6 +2102,15 @@ tridiagonalize_ (MAT &e_vecs, MAT &e_vals, MAT &imagi) noexcept  {
         e_vals (0, r) = h;
     }
 
+   // The diagonal is left on the diagonal of e_vecs
+   //
+    if (! with_vectors)  {
+        for (size_type c = 0; c < e_vecs.columns (); ++c)
+            e_vals (0, c) = e_vecs (c, c);
+        imagi (0, 0) = value_type(0.0);
+        return;
+    }
+
    // Accumulate transformations.
    //
     for (size_type r = 0; r < e_vecs.rows () - 1; ++r)  {
@@ -1799,16 +2261,124 @@ diagonalize_ (MAT &e_vecs, MAT &e_vals, MAT &imagi) noexcept  {
 template<template<class T> class BASE, class TYPE>
 template<class MAT>
 inline void Matrix<BASE, TYPE>::
-red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form) noexcept  {
+tridiagonal_values_ (MAT &e_vals, MAT &imagi)  {
+
+    const int   n = static_cast<int>(e_vals.columns ());
+
+   // Squares of the subdiagonal, shifted down so e2(0, i) couples i and i+1
+   //
+    for (int c = 1; c < n; ++c)
+        imagi (0, c - 1) = imagi (0, c) * imagi (0, c);
+    imagi (0, n - 1) = value_type(0.0);
+
+    value_type  f (0.0);
+    value_type  t (0.0);
+    value_type  b (0.0);
+    value_type  c2 (0.0);
+
+    for (int l = 0; l < n; ++l)  {
+        const value_type    h0 = abs__ (e_vals (0, l)) + sqrt__ (imagi (0, l));
+
+        if (t < h0)  {
+            t = h0;
+            b = EPSILON_ * t;
+            c2 = b * b;
+        }
+
+       // Look for small squared subdiagonal element. imagi (0, n - 1) is
+       // always zero, so there is no exit through the bottom of the loop.
+       //
+        int m = l;
+
+        while (imagi (0, m) > c2)
+            m += 1;
+
+        if (m > l)  {
+            int iter = 0;
+
+            do  {
+                if (++iter > 30)
+                    throw NotSolvable ();
+
+               // Form shift
+               //
+                value_type  s = sqrt__ (imagi (0, l));
+                value_type  g = e_vals (0, l);
+                value_type  p =
+                    (e_vals (0, l + 1) - g) / (value_type(2.0) * s);
+                value_type  r = hypot__ (p, value_type(1.0));
+
+                e_vals (0, l) = s / (p < value_type(0.0) ? p - r : p + r);
+
+                value_type  h = g - e_vals (0, l);
+
+                for (int i = l + 1; i < n; ++i)
+                    e_vals (0, i) -= h;
+                f += h;
+
+               // Rational QL transformation, no square roots needed
+               //
+                g = e_vals (0, m);
+                if (g == value_type(0.0))
+                    g = b;
+                h = g;
+                s = value_type(0.0);
+                for (int i = m - 1; i >= l; --i)  {
+                    p = g * h;
+                    r = p + imagi (0, i);
+                    imagi (0, i + 1) = s * r;
+                    s = imagi (0, i) / r;
+                    e_vals (0, i + 1) = h + s * (h + e_vals (0, i));
+                    g = e_vals (0, i) - imagi (0, i) / g;
+                    if (g == value_type(0.0))
+                        g = b;
+                    h = g * p / r;
+                }
+                imagi (0, l) = s * g;
+                e_vals (0, l) = h;
+
+               // Guard against underflow in convergence test
+               //
+                if (h == value_type(0.0) ||
+                    abs__ (imagi (0, l)) <= abs__ (c2 / h))
+                    break;
+                imagi (0, l) *= h;
+            }  while (imagi (0, l) != value_type(0.0));
+        }
+
+       // Insert the converged value among the ones already found
+       //
+        const value_type    p = e_vals (0, l) + f;
+        int                 i = l;
+
+        for ( ; i > 0 && p < e_vals (0, i - 1); --i)
+            e_vals (0, i) = e_vals (0, i - 1);
+        e_vals (0, i) = p;
+    }
+
+    for (int c = 0; c < n; ++c)
+        imagi (0, c) = value_type(0.0);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Static
+//
+template<template<class T> class BASE, class TYPE>
+template<class MAT>
+inline void Matrix<BASE, TYPE>::
+red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form, bool with_vectors) noexcept  {
 
-    MAT ortho (1, e_vecs.columns ());
+    MAT ortho (1, hess_form.columns ());
 
-    for (size_type c = 1; c <= e_vecs.columns () - 2; ++c)  {
+    for (size_type c = 1; c <= hess_form.columns () - 2; ++c)  {
         value_type  scale (0.0);
 
        // Scale column.
        //
-        for (size_type r = c; r <= e_vecs.rows () - 1; ++r)
+        for (size_type r = c; r <= hess_form.rows () - 1; ++r)
             scale += abs__ (hess_form (r, c - 1));
 
         if (scale != value_type(0.0))  {
@@ -1816,7 +2386,7 @@ red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form) noexcept  {
 
            // Compute Householder transformation.
            //
-            for (size_type cc = e_vecs.columns () - 1; cc >= c; --cc)  {
+            for (size_type cc = hess_form.columns () - 1; cc >= c; --cc)  {
                 ortho (0, cc) = hess_form (cc, c - 1) / scale;
                 h += ortho (0, cc) * ortho (0, cc);
             }
@@ -1830,25 +2400,25 @@ red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form) noexcept  {
            // Apply Householder similarity transformation
            // H = (I - u * u' / h) * H * (I - u * u') / h)
            //
-            for (size_type cc = c; cc < e_vecs.columns (); ++cc)  {
+            for (size_type cc = c; cc < hess_form.columns (); ++cc)  {
                 value_type  f (0.0);
 
-                for (size_type r = e_vecs.rows () - 1; r >= c; --r)
+                for (size_type r = hess_form.rows () - 1; r >= c; --r)
                     f += ortho (0, r) * hess_form (r, cc);
                 f /= h;
 
-                for (size_type r = c; r <= e_vecs.rows () - 1; ++r)
+                for (size_type r = c; r <= hess_form.rows () - 1; ++r)
                     hess_form (r, cc) -= f * ortho (0, r);
             }
 
-            for (size_type r = 0; r <= e_vecs.rows () - 1; ++r)  {
+            for (size_type r = 0; r <= hess_form.rows () - 1; ++r)  {
                 value_type  f (0.0);
 
-                for (size_type cc = e_vecs.columns () - 1; cc >= c; --cc)
+                for (size_type cc = hess_form.columns () - 1; cc >= c; --cc)
                     f += ortho (0, cc) * hess_form (r, cc);
                 f /= h;
 
-                for (size_type cc = c; cc <= e_vecs.columns () - 1; ++cc)
+                for (size_type cc = c; cc <= hess_form.columns () - 1; ++cc)
                     hess_form (r, cc) -= f * ortho (0, cc);
             }
 
@@ -1857,27 +2427,30 @@ red_to_hessenberg_ (MAT &e_vecs, MAT &hess_form) noexcept  {
         }
     }
 
+    if (! with_vectors)
+        return;
+
    // Accumulate transformations (Algol's ortran).
    //
-    for (size_type r = 0; r < e_vecs.rows (); ++r)
-        for (size_type c = 0; c < e_vecs.columns (); ++c)
+    for (size_type r = 0; r < hess_form.rows (); ++r)
+        for (size_type c = 0; c < hess_form.columns (); ++c)
             e_vecs (r, c) = r == c ? value_type(1.0) : value_type(0.0);
 
-    for (size_type c = e_vecs.columns () - 2; c >= 1; --c)
+    for (size_type c = hess_form.columns () - 2; c >= 1; --c)
         if (hess_form (c, c - 1) != value_type(0.0))  {
-            for (size_type r = c + 1; r <= e_vecs.rows () - 1; ++r)
+            for (size_type r = c + 1; r <= hess_form.rows () - 1; ++r)
                 ortho (0, r) = hess_form (r, c - 1);
 
-            for (size_type cc = c; cc <= e_vecs.columns () - 1; ++cc)  {
+            for (size_type cc = c; cc <= hess_form.columns () - 1; ++cc)  {
                 value_type  g (0.0);
 
-                for (size_type r = c; r <= e_vecs.rows () - 1; ++r)
+                for (size_type r = c; r <= hess_form.rows () - 1; ++r)
                     g += ortho (0, r) * e_vecs (r, cc);
 
                // Double division avoids possible underflow
                //
                 g = (g / ortho (0, c)) / hess_form (c, c - 1);
-                for (size_type r = c; r <= e_vecs.rows () - 1; ++r)
+                for (size_type r = c; r <= hess_form.rows () - 1; ++r)
                     e_vecs (r, cc) += g * ortho (0, r);
             }
         }
@@ -1895,18 +2468,19 @@ inline void Matrix<BASE, TYPE>::
 hessenberg_to_schur_ (MAT &e_vecs,
                       MAT &e_vals,
                       MAT &imagi,
-                      MAT &hess_form) noexcept  {
+                      MAT &hess_form,
+                      bool with_vectors) noexcept  {
 
    // Store roots isolated by balanc and compute matrix norm
    //
     value_type  norm (0.0);
 
-    for (size_type r = 0; r < e_vecs.rows (); ++r)
-        for (size_type c = r; c < e_vecs.columns (); ++c)
+    for (size_type r = 0; r < hess_form.rows (); ++r)
+        for (size_type c = r; c < hess_form.columns (); ++c)
             norm += abs__ (hess_form (r, c));
 
     size_type   iter = 0;
-    int         n = static_cast<int>(e_vecs.columns () - 1);
+    int         n = static_cast<int>(hess_form.columns () - 1);
     value_type  exshift (0.0);
     value_type  p;
     value_type  q;
@@ -1973,9 +2547,15 @@ hessenberg_to_schur_ (MAT &e_vecs,
                 p /= oo;
                 q /= oo;
 
+               // Without the vectors only the active block is transformed
+               //
+                const size_type last_c =
+                    with_vectors ? hess_form.columns () - 1 : n;
+                const size_type first_r = with_vectors ? 0 : l;
+
                // Row modification
                //
-                for (size_type c = n - 1; c < e_vecs.columns (); ++c)  {
+                for (size_type c = n - 1; c <= last_c; ++c)  {
                     const value_type    &cref = hess_form (n - 1, c);
 
                     hess_form (n - 1, c) = q * cref + p * hess_form (n, c);
@@ -1984,7 +2564,7 @@ hessenberg_to_schur_ (MAT &e_vecs,
 
                // Column modification
                //
-                for (size_type r = 0; r <= n; ++r)  {
+                for (size_type r = first_r; r <= n; ++r)  {
                     const value_type    &cref = hess_form (r, n - 1);
 
                     hess_form (r, n - 1) = q * cref + p * hess_form (r, n);
@@ -1993,7 +2573,8 @@ hessenberg_to_schur_ (MAT &e_vecs,
 
                // Accumulate transformations
                //
-                for (size_type r = 0; r <= e_vecs.rows () - 1; ++r)  {
+                for (size_type r = 0;
+                     with_vectors && r <= hess_form.rows () - 1; ++r)  {
                     const value_type    &cref = e_vecs (r, n - 1);
 
                     e_vecs (r, n - 1) = q * cref + p * e_vecs (r, n);
@@ -2131,9 +2712,16 @@ hessenberg_to_schur_ (MAT &e_vecs,
                     q /= p;
                     oo /= p;
 
+                   // Without the vectors only the active block is
+                   // transformed
+                   //
+                    const size_type last_c =
+                        with_vectors ? hess_form.columns () - 1 : n;
+                    const size_type first_r = with_vectors ? 0 : l;
+
                    // Row modification
                    //
-                    for (size_type c = k; c < e_vecs.columns (); ++c)  {
+                    for (size_type c = k; c <= last_c; ++c)  {
                         p = hess_form (k, c) + q * hess_form (k + 1, c);
 
                         if (notlast)  {
@@ -2147,7 +2735,7 @@ hessenberg_to_schur_ (MAT &e_vecs,
 
                    // Column modification
                    //
-                    for (size_type r = 0;
+                    for (size_type r = first_r;
                          r <= std::min (n, static_cast<int>(k + 3)); ++r)  {
                         p = x * hess_form (r, k) + y * hess_form (r, k + 1);
 
@@ -2162,7 +2750,8 @@ hessenberg_to_schur_ (MAT &e_vecs,
 
                    // Accumulate transformations
                    //
-                    for (size_type r = 0; r <= e_vecs.rows () - 1; ++r)  {
+                    for (size_type r = 0;
+                         with_vectors && r <= hess_form.rows () - 1; ++r)  {
                         p = x * e_vecs (r, k) + y * e_vecs (r, k + 1);
 
                         if (notlast)  {
@@ -2178,12 +2767,12 @@ hessenberg_to_schur_ (MAT &e_vecs,
         }
     }
 
-    if (norm == value_type(0.0))
+    if (! with_vectors || norm == value_type(0.0))
         return;
 
    // Backsubstitute to find vectors of upper triangular form
    //
-    for (int c = static_cast<int>(e_vecs.columns () - 1); c >= 0; --c)  {
+    for (int c = static_cast<int>(hess_form.columns () - 1); c >= 0; --c)  {
         p = e_vals (0, c);
         q = imagi (0, c);
 
@@ -2352,12 +2941,12 @@ hessenberg_to_schur_ (MAT &e_vecs,
 
    // Back transformation to get eigenvectors of original matrix
    //
-    for (int c = static_cast<int>(e_vecs.columns () - 1); c >= 0; --c)
-        for (size_type r = 0; r <= e_vecs.rows () - 1; ++r)  {
+    for (int c = static_cast<int>(hess_form.columns () - 1); c >= 0; --c)
+        for (size_type r = 0; r <= hess_form.rows () - 1; ++r)  {
             z = value_type(0.0);
 
             for (size_type k = 0;
-                 k <= std::min (c, static_cast<int>(e_vecs.columns() - 1));
+                 k <= std::min (c, static_cast<int>(hess_form.columns () - 1));
                  ++k)
                 z += e_vecs (r, k) * hess_form (k, c);
 
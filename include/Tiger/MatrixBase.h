@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 // ----------------------------------------------------------------------------
@@ -48,6 +50,60 @@ enum class io_format : unsigned char  {
     binary = 2
 };
 
+// How the data vector of a matrix is laid out. It is recorded in binary
+// files, so a file is only read back into the same kind of matrix.
+//
+enum class matrix_layout : unsigned char  {
+    dense = 1,      // DenseMatrixBase, column-major
+    symmetric = 2,  // SymmMatrixBase, packed upper triangle by rows
+    rfp = 3         // SymmRFPMatrixBase, Rectangular Full Packed
+};
+
+// The header of io_format::binary files. It is followed, at data_offset,
+// by the raw data vector of the matrix in the byte order of the machine
+// that wrote it. byte_order tells what that was. If it doesn't read back
+// as ORDER_MARK, every field and element is byte-swapped on reading.
+//
+struct  BinaryMatrixHeader  {
+
+    static constexpr std::uint32_t  ORDER_MARK = 0x01020304;
+    static constexpr std::uint16_t  VERSION = 1;
+
+    char            magic[8];     // "TIGERMAT"
+    std::uint32_t   byte_order;
+    std::uint16_t   version;
+    std::uint8_t    elem_type;    // See binary_type_code__()
+    std::uint8_t    elem_size;    // sizeof(value_type)
+    std::uint8_t    layout;       // matrix_layout
+    std::uint8_t    reserved[7];
+    std::uint64_t   rows;
+    std::uint64_t   columns;
+    std::uint64_t   data_size;    // Number of elements
+    std::uint64_t   data_offset;  // In bytes, from the start of the file
+    std::uint64_t   padding;      // Keeps the data 64 bytes aligned
+};
+
+static_assert(sizeof(BinaryMatrixHeader) == 64,
+              "BinaryMatrixHeader must be 64 bytes");
+
+// -------------------------------------
+
+// File-backed data vector (see MMapVector.h)
+//
+template<class T>
+class   MMapVector;
+
+// -------------------------------------
+
+// Vector type for the temporaries of the algorithms on a matrix with data
+// vector S. It allocates like S, but it is always in memory.
+//
+template<class S>
+struct  ScratchVectorOf  { using type = S; };
+
+template<class T>
+struct  ScratchVectorOf<MMapVector<T> >  { using type = std::vector<T>; };
+
 // -------------------------------------
 
 template<class T>
@@ -79,6 +135,7 @@ protected:
     using const_pointer = typename BaseClass::const_pointer;
 
     using DataVector = S;
+    using ScratchVector = typename ScratchVectorOf<S>::type;
 
     static const size_type  _NOPOS = static_cast<size_type>(-1);
 
@@ -91,6 +148,13 @@ protected:
                   bool set_all_to_def = true,
                   const_reference def_value = value_type ());
 
+   // Each kind of matrix passes its own layout
+   //
+    template<typename STRM>
+    bool _write (STRM &stream, io_format iof, matrix_layout layout) const;
+    bool _read (const char *file_name, io_format iof, matrix_layout layout);
+    void _attach_file (const char *file_name, matrix_layout layout);
+
     inline DenseMatrixStorage (
         size_type row,
         size_type col,
@@ -111,12 +175,56 @@ public:
     inline size_type rows () const noexcept  { return (rows_); }
     inline size_type columns () const noexcept  { return (cols_); }
 
+   // csv is text, CSV_BLOCK_SIZE elements per '|' separated block, with
+   // 12 significant digits. Blocks are formatted and parsed in parallel.
+   // binary is a BinaryMatrixHeader followed by the raw data vector. It is
+   // read through a memory mapping of the file (on POSIX systems), straight
+   // into the data vector with no parsing.
+   // Reading a binary file throws std::runtime_error, if it cannot be
+   // opened or it was not written by the same kind of matrix of the same
+   // value_type.
+   //
+    static constexpr size_type  CSV_BLOCK_SIZE = 2048;
+
+   // Number of CSV blocks formatted into one buffer, which becomes a
+   // single write on the stream (about 300KB of text for doubles)
+   //
+    static constexpr size_type  CSV_TASK_BLOCKS = 8;
+
     template<typename STRM>
-    bool write (STRM &stream, io_format iof = io_format::csv) const;
-    bool read (const char *file_name, io_format iof = io_format::csv);
+    inline bool write (STRM &stream, io_format iof = io_format::csv) const  {
+
+        return (_write (stream, iof, matrix_layout::dense));
+    }
+    inline bool read (const char *file_name, io_format iof = io_format::csv)  {
+
+        return (_read (file_name, iof, matrix_layout::dense));
+    }
+
+   // Only for file-backed storage (S is MMapVector).
+   // The matrix moves into file_name, an io_format::binary file, and from
+   // then on the OS writes every change through to it. If the file
+   // exists, the matrix takes its dimensions and data. Otherwise the file
+   // is created with the current matrix.
+   // Reading a binary file into a file-backed matrix maps the file
+   // copy-on-write. It is usable right away and the file never changes.
+   //
+    inline void attach_file (const char *file_name)  {
+
+        _attach_file (file_name, matrix_layout::dense);
+    }
 
 private:
 
+    void read_binary_ (const char *file_name, matrix_layout layout);
+    void read_binary_ (const char *file_name,
+                       matrix_layout layout,
+                       std::false_type);
+    void read_binary_ (const char *file_name,
+                       matrix_layout layout,
+                       std::true_type);
+    void read_csv_ (const char *file_name, matrix_layout layout);
+
     size_type   rows_ { 0 };
     size_type   cols_ { 0 };
     DataVector  data_ { };
@@ -28,12 +28,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <Tiger/MatrixBase.h>
+#include <Tiger/ThreadPool.h>
 
 #include <iomanip>
+#include <limits>
 #include <stdexcept>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
 #include <cstdlib>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#  if __has_include(<charconv>)
+#    include <charconv>
+#  endif
+#endif
+
+#ifndef WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // WIN32
 
 // ----------------------------------------------------------------------------
 
@@ -114,6 +136,480 @@ _str_to_num_<long double>(const char *str) noexcept  {
 
 // ----------------------------------------------------------------------------
 
+// The element type of binary files. Types that are not listed here are 0
+// and they are only checked by their size.
+//
+template<typename T>
+inline std::uint8_t binary_type_code__ () noexcept  { return (0); }
+
+template<>
+inline std::uint8_t binary_type_code__<int> () noexcept  { return (1); }
+template<>
+inline std::uint8_t
+binary_type_code__<unsigned int> () noexcept  { return (2); }
+template<>
+inline std::uint8_t binary_type_code__<long int> () noexcept  { return (3); }
+template<>
+inline std::uint8_t
+binary_type_code__<unsigned long int> () noexcept  { return (4); }
+template<>
+inline std::uint8_t
+binary_type_code__<long long int> () noexcept  { return (5); }
+template<>
+inline std::uint8_t
+binary_type_code__<unsigned long long int> () noexcept  { return (6); }
+template<>
+inline std::uint8_t binary_type_code__<float> () noexcept  { return (7); }
+template<>
+inline std::uint8_t binary_type_code__<double> () noexcept  { return (8); }
+template<>
+inline std::uint8_t
+binary_type_code__<long double> () noexcept  { return (9); }
+
+// ----------------------------------------------------------------------------
+
+// Reverse the bytes of each of the count items of size bytes
+//
+inline void
+byte_swap__ (void *items, std::size_t size, std::size_t count) noexcept  {
+
+    unsigned char   *bytes = static_cast<unsigned char *>(items);
+
+    for (std::size_t i = 0; i < count; ++i, bytes += size)
+        std::reverse (bytes, bytes + size);
+}
+
+// ----------------------------------------------------------------------------
+
+// Converts the text in [first, last) through _str_to_num_(), which needs
+// a null terminated string.
+//
+template<typename T>
+inline T c_str_to_num__ (const char *first, const char *last)  {
+
+    const std::size_t   len = last - first;
+    char                buffer[64];
+
+    if (len < sizeof(buffer))  {
+        std::memcpy (buffer, first, len);
+        buffer[len] = 0;
+        return (_str_to_num_<T>(buffer));
+    }
+    return (_str_to_num_<T>(std::string (first, last).c_str ()));
+}
+
+// ----------------------------------------------------------------------------
+
+// Clinger's fast path: a decimal with at most 15 significant digits, scaled
+// by a power of ten no larger than 10^22, converts exactly with a single
+// multiply or divide, because both operands are exact doubles. That covers
+// everything write() produces. It returns false for anything else.
+//
+inline bool
+fast_decimal__ (const char *first, const char *last, double &value) noexcept  {
+
+#if FLT_EVAL_METHOD == 0
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    bool            negative = false;
+    std::uint64_t   mantissa = 0;
+    int             digits = 0;
+    int             exponent = 0;
+    bool            any_digit = false;
+
+    if (first != last && (*first == '-' || *first == '+'))
+        negative = *first++ == '-';
+    for (; first != last && *first >= '0' && *first <= '9'; ++first)  {
+        any_digit = true;
+        if (mantissa != 0 || *first != '0')  {
+            if (++digits > 15)  return (false);
+            mantissa = mantissa * 10 + (*first - '0');
+        }
+    }
+    if (first != last && *first == '.')  {
+        for (++first; first != last && *first >= '0' && *first <= '9';
+             ++first)  {
+            any_digit = true;
+            exponent -= 1;
+            if (mantissa != 0 || *first != '0')  {
+                if (++digits > 15)  return (false);
+                mantissa = mantissa * 10 + (*first - '0');
+            }
+        }
+    }
+    if (! any_digit)  return (false);
+    if (first != last && (*first == 'e' || *first == 'E'))  {
+        bool    exp_negative = false;
+        int     exp_value = 0;
+
+        if (++first != last && (*first == '-' || *first == '+'))
+            exp_negative = *first++ == '-';
+        if (first == last)  return (false);
+        for (; first != last && *first >= '0' && *first <= '9'; ++first)
+            if ((exp_value = exp_value * 10 + (*first - '0')) > 1000)
+                return (false);
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+    if (first != last)  return (false);
+
+    if (mantissa == 0)
+        value = 0;
+    else if (exponent >= 0 && exponent <= 22)
+        value = double(mantissa) * powers[exponent];
+    else if (exponent < 0 && exponent >= -22)
+        value = double(mantissa) / powers[-exponent];
+    else
+        return (false);
+    if (negative)  value = -value;
+    return (true);
+#else
+    return (false);
+#endif // FLT_EVAL_METHOD
+}
+
+// ----------------------------------------------------------------------------
+
+// Converts the number in [first, last). Unlike _str_to_num_() it needs no
+// null terminator, so it can parse straight out of a file image. Integers
+// keep the strtol() rules (e.g. hex) of _str_to_num_().
+//
+template<typename T>
+inline T parse_num__ (const char *first, const char *last)  {
+
+    return (c_str_to_num__<T>(first, last));
+}
+
+template<>
+inline double parse_num__<double> (const char *first, const char *last)  {
+
+    double  value;
+
+    if (fast_decimal__ (first, last, value))  return (value);
+#ifdef __cpp_lib_to_chars
+    if (*first != '+' && std::from_chars (first, last, value).ptr == last)
+        return (value);
+#endif // __cpp_lib_to_chars
+    return (c_str_to_num__<double>(first, last));
+}
+
+#ifdef __cpp_lib_to_chars
+template<>
+inline float parse_num__<float> (const char *first, const char *last)  {
+
+    float   value;
+
+    if (*first != '+' && std::from_chars (first, last, value).ptr == last)
+        return (value);
+    return (c_str_to_num__<float>(first, last));
+}
+#endif // __cpp_lib_to_chars
+
+// ----------------------------------------------------------------------------
+
+// Calls func(first, last) for every ',' separated token of [first, last).
+// Blank tokens are skipped and white spaces around tokens are trimmed.
+//
+template<typename F>
+inline void
+for_each_token__ (const char *first, const char *last, F &&func)  {
+
+    const auto  is_space = [](char c) -> bool  {
+        return (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    };
+
+    while (first < last)  {
+        const char  *comma =
+            static_cast<const char *>(std::memchr (first, ',', last - first));
+        const char  *end = comma ? comma : last;
+        const char  *tok_end = end;
+
+        while (first < tok_end && is_space (*first))  ++first;
+        while (tok_end > first && is_space (*(tok_end - 1)))  --tok_end;
+        if (first < tok_end)
+            func (first, tok_end);
+        first = end + 1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Appends value to out the same way as
+//     stream << std::setprecision(12) << value
+// Arithmetic types are formatted without a stream. Other types go through
+// one.
+//
+template<typename T>
+inline void append_num__ (std::string &out, const T &value)  {
+
+    std::ostringstream  stream;
+
+    stream << std::setprecision(12) << value;
+    out += stream.str ();
+}
+
+template<typename T>
+inline void append_integer__ (std::string &out, T value)  {
+
+    char    buffer[32];
+    char    *first = buffer + sizeof(buffer);
+    using unsigned_type = typename std::make_unsigned<T>::type;
+
+    unsigned_type   magnitude = static_cast<unsigned_type>(value);
+
+    if (value < 0)  magnitude = 0 - magnitude;
+
+    do  {
+        *--first = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)  *--first = '-';
+    out.append (first, buffer + sizeof(buffer));
+}
+
+inline void append_num__ (std::string &out, int value)  {
+
+    append_integer__ (out, value);
+}
+inline void append_num__ (std::string &out, unsigned int value)  {
+
+    append_integer__ (out, value);
+}
+inline void append_num__ (std::string &out, long int value)  {
+
+    append_integer__ (out, value);
+}
+inline void append_num__ (std::string &out, unsigned long int value)  {
+
+    append_integer__ (out, value);
+}
+inline void append_num__ (std::string &out, long long int value)  {
+
+    append_integer__ (out, value);
+}
+inline void append_num__ (std::string &out, unsigned long long int value)  {
+
+    append_integer__ (out, value);
+}
+
+// With 12 digits of precision the stream does "%.12g". snprintf() uses
+// the decimal point of the C locale, which a stream doesn't, so it is put
+// back to '.'.
+//
+inline void append_num__ (std::string &out, double value)  {
+
+    char    buffer[64];
+
+#ifdef __cpp_lib_to_chars
+    const auto  result =
+        std::to_chars (buffer, buffer + sizeof(buffer), value,
+                       std::chars_format::general, 12);
+
+    out.append (buffer, result.ptr);
+#else
+    const int   len = std::snprintf (buffer, sizeof(buffer), "%.12g", value);
+
+    std::replace (buffer, buffer + len, ',', '.');
+    out.append (buffer, len);
+#endif // __cpp_lib_to_chars
+}
+inline void append_num__ (std::string &out, float value)  {
+
+    append_num__ (out, double(value));
+}
+inline void append_num__ (std::string &out, long double value)  {
+
+    char        buffer[64];
+    const int   len = std::snprintf (buffer, sizeof(buffer), "%.12Lg", value);
+
+    std::replace (buffer, buffer + len, ',', '.');
+    out.append (buffer, len);
+}
+
+// ----------------------------------------------------------------------------
+
+// Checks the dimensions and data size found in a file header against the
+// layout. A dense matrix holds rows * columns elements. A symmetric or RFP
+// matrix is square and holds n(n + 1) / 2 elements. It returns the error
+// message, or nullptr if they are consistent.
+//
+template<class T>
+inline const char *check_dimensions__ (std::uint64_t rows,
+                                       std::uint64_t columns,
+                                       std::uint64_t data_size,
+                                       matrix_layout layout) noexcept  {
+
+    using size_type = typename MatrixBase<T>::size_type;
+
+    const std::uint64_t max_size = std::numeric_limits<size_type>::max ();
+
+    if (rows > max_size || columns > max_size || data_size > max_size)
+        return ("Matrix is too big");
+    if (layout == matrix_layout::dense
+            ? data_size != rows * columns
+            : rows != columns || data_size != columns * (columns + 1) / 2)
+        return ("Data size does not match the dimensions");
+    return (nullptr);
+}
+
+// ----------------------------------------------------------------------------
+
+// Validates the header of an io_format::binary file of T elements and the
+// given layout. If the file is in the other byte order, header is swapped
+// to the native order and it returns true. Otherwise it returns false.
+// It throws std::runtime_error, if the file doesn't match. caller starts
+// the message.
+//
+template<class T>
+inline bool check_binary_header__ (BinaryMatrixHeader &header,
+                                   std::uint64_t file_size,
+                                   matrix_layout layout,
+                                   const char *caller)  {
+
+    const bool  swapped =
+        header.byte_order != BinaryMatrixHeader::ORDER_MARK;
+
+    if (swapped)  {
+        byte_swap__ (&header.byte_order, sizeof(header.byte_order), 1);
+        byte_swap__ (&header.version, sizeof(header.version), 1);
+        byte_swap__ (&header.rows, sizeof(std::uint64_t), 5);
+    }
+
+    const char  *error = nullptr;
+
+    if (file_size < sizeof(header) ||
+        std::memcmp (header.magic, "TIGERMAT", sizeof(header.magic)) ||
+        header.byte_order != BinaryMatrixHeader::ORDER_MARK)
+        error = "Not a Tiger binary matrix file";
+    else if (header.version != BinaryMatrixHeader::VERSION)
+        error = "Unsupported binary file version";
+    else if (header.elem_size != sizeof(T) ||
+             header.elem_type != binary_type_code__<T> ())
+        error = "Element type does not match";
+    else if (header.layout != static_cast<std::uint8_t>(layout))
+        error = "Matrix layout (dense/symmetric) does not match";
+    else if (header.data_offset < sizeof(header) ||
+             header.data_offset > file_size ||
+             (file_size - header.data_offset) / sizeof(T) <
+                 header.data_size)
+        error = "File is truncated";
+    else
+        error = check_dimensions__<T> (header.rows, header.columns,
+                                       header.data_size, layout);
+
+    if (error != nullptr)
+        throw std::runtime_error (std::string (caller) + ": " + error);
+    return (swapped);
+}
+
+// ----------------------------------------------------------------------------
+
+// A file-backed data vector carries the dimensions of the matrix in its
+// file header. Other storages have nothing to keep up to date.
+//
+template<class V>
+inline void
+set_file_dimensions__ (V &, std::uint64_t, std::uint64_t) noexcept  {   }
+
+template<class T>
+inline void set_file_dimensions__ (MMapVector<T> &data,
+                                   std::uint64_t rows,
+                                   std::uint64_t columns) noexcept  {
+
+    BinaryMatrixHeader  *header = data.header ();
+
+    if (header != nullptr)  {
+        header->rows = rows;
+        header->columns = columns;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Read-only image of a whole file. On POSIX systems it is a private memory
+// mapping. Elsewhere the file is read into a buffer.
+//
+class   FileImage__  {
+
+public:
+
+    explicit FileImage__ (const char *file_name)  {
+
+#ifdef WIN32
+        std::ifstream   file (file_name, std::ios::in | std::ios::binary);
+
+        if (! file)
+            throw std::runtime_error ("DenseMatrixStorage::read(): Cannot "
+                                      "open file");
+        file.seekg (0, std::ios::end);
+        buffer_.resize (static_cast<std::size_t>(file.tellg ()));
+        file.seekg (0, std::ios::beg);
+        if (! buffer_.empty ())
+            file.read (buffer_.data (), buffer_.size ());
+        data_ = buffer_.data ();
+        size_ = buffer_.size ();
+#else
+        const int   fd = ::open (file_name, O_RDONLY);
+        struct stat st;
+
+        if (fd < 0 || ::fstat (fd, &st) != 0)  {
+            if (fd >= 0)  ::close (fd);
+            throw std::runtime_error ("DenseMatrixStorage::read(): Cannot "
+                                      "open file");
+        }
+        size_ = st.st_size;
+        if (size_ != 0)  {
+            void    *map =
+                ::mmap (nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map == MAP_FAILED)  {
+                ::close (fd);
+                throw std::runtime_error ("DenseMatrixStorage::read(): "
+                                          "Cannot map file");
+            }
+            ::madvise (map, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char *>(map);
+        }
+        ::close (fd);  // The mapping stays valid
+#endif // WIN32
+    }
+    ~FileImage__ ()  {
+
+#ifndef WIN32
+        if (data_ != nullptr)
+            ::munmap (const_cast<char *>(data_), size_);
+#endif // WIN32
+    }
+
+    FileImage__ (const FileImage__ &) = delete;
+    FileImage__ &operator = (const FileImage__ &) = delete;
+
+    inline const char *data () const noexcept  { return (data_); }
+    inline std::size_t size () const noexcept  { return (size_); }
+
+private:
+
+    const char  *data_ { nullptr };
+    std::size_t size_ { 0 };
+#ifdef WIN32
+    std::vector<char>   buffer_ { };
+#endif // WIN32
+};
+
+// ----------------------------------------------------------------------------
+
+template<class T, class S>
+constexpr typename DenseMatrixStorage<T, S>::size_type
+DenseMatrixStorage<T, S>::CSV_BLOCK_SIZE;
+
+template<class T, class S>
+constexpr typename DenseMatrixStorage<T, S>::size_type
+DenseMatrixStorage<T, S>::CSV_TASK_BLOCKS;
+
+// ----------------------------------------------------------------------------
+
 template<class T, class S>
 void DenseMatrixStorage<T, S>::
 _resize (size_type in_row,
@@ -129,6 +625,7 @@ _resize (size_type in_row,
 
     rows_ = in_row;
     cols_ = in_col;
+    set_file_dimensions__ (data_, in_row, in_col);
     return;
 }
 
@@ -160,64 +657,285 @@ swap (DenseMatrixStorage &rhs) noexcept  {
 
 template<class T, class S>
 template<typename STRM>
-bool DenseMatrixStorage<T, S>::write (STRM &stream, io_format iof) const  {
-
+bool DenseMatrixStorage<T, S>::
+_write (STRM &stream, io_format iof, matrix_layout layout) const  {
+
+    if (iof == io_format::binary)  {
+        BinaryMatrixHeader  header;
+
+        std::memset (&header, 0, sizeof(header));
+        std::memcpy (header.magic, "TIGERMAT", sizeof(header.magic));
+        header.byte_order = BinaryMatrixHeader::ORDER_MARK;
+        header.version = BinaryMatrixHeader::VERSION;
+        header.elem_type = binary_type_code__<value_type> ();
+        header.elem_size = sizeof(value_type);
+        header.layout = static_cast<std::uint8_t>(layout);
+        header.rows = rows ();
+        header.columns = columns ();
+        header.data_size = data_.size ();
+        header.data_offset = sizeof(header);
+
+        stream.write (reinterpret_cast<const char *>(&header), sizeof(header));
+        if (! data_.empty ())
+            stream.write (reinterpret_cast<const char *>(&(data_[0])),
+                          data_.size () * sizeof(value_type));
+        stream.flush ();
+        return (true);
+    }
     if (iof != io_format::csv)
-        throw std::runtime_error ("DenseMatrixStorage::write(): Currently, "
-                                  "only csv I/O format is supported");
+        throw std::runtime_error ("DenseMatrixStorage::write(): Unknown "
+                                  "I/O format");
 
     // Number of rows X number of columns X actual data vector size
     // In case of symmetric matrices the actual data vector size is smaller.
     stream << rows() << 'X' << columns() << 'X' << data_.size() << '\n';
 
-    size_type   counter = 0;
-
-    for (const auto &citer : data_)  {
-        stream << std::setprecision(12) << citer << ',';
-        if (++counter == 2048)  {
-            stream << '|';
-            counter = 0;
-        }
+   // The values are formatted into large buffers, CSV_TASK_BLOCKS blocks
+   // each. A wave of a few buffers per thread is formatted in parallel and
+   // then written in order. So there is one stream write per buffer and
+   // the memory used is bounded.
+   //
+    constexpr std::size_t   BLOCK = CSV_BLOCK_SIZE;
+    const std::size_t       size = data_.size ();
+    const std::size_t       task_size = CSV_TASK_BLOCKS * BLOCK;
+    const std::size_t       tasks = (size + task_size - 1) / task_size;
+    ThreadPool              &pool = ThreadPool::instance ();
+    const std::size_t       wave =
+        std::min<std::size_t> (tasks, pool.thread_count () * 2);
+    std::vector<std::string>    texts (wave);
+
+    for (std::size_t t0 = 0; t0 < tasks; t0 += wave)  {
+        const std::size_t   count = std::min (wave, tasks - t0);
+        const auto          format = [&](std::size_t i)  {
+            std::string         &text = texts[i];
+            const std::size_t   first = (t0 + i) * task_size;
+            const std::size_t   last = std::min (size, first + task_size);
+
+            text.clear ();
+            text.reserve ((last - first) * 20);
+            for (std::size_t j = first; j < last; ++j)  {
+                append_num__ (text, data_[j]);
+                text += ',';
+                if ((j + 1) % BLOCK == 0 || j + 1 == size)
+                    text += '|';
+            }
+        };
+
+        if (count > 1)
+            pool.parallel_for (count, format);
+        else
+            format (0);
+        for (std::size_t i = 0; i < count; ++i)
+            stream.write (texts[i].data (), texts[i].size ());
     }
-    if (counter != 0)  stream << '|';
-    stream << std::flush;
+    stream.flush ();
     return (true);
 }
 
 // ----------------------------------------------------------------------------
 
 template<class T, class S>
-bool DenseMatrixStorage<T, S>::read (const char *file_name, io_format iof)  {
+bool DenseMatrixStorage<T, S>::
+_read (const char *file_name, io_format iof, matrix_layout layout)  {
 
+    if (iof == io_format::binary)  {
+        read_binary_ (file_name, layout);
+        return (true);
+    }
     if (iof != io_format::csv)
-        throw std::runtime_error ("DenseMatrixStorage::read(): Currently, "
-                                  "only csv I/O format is supported");
+        throw std::runtime_error ("DenseMatrixStorage::read(): Unknown "
+                                  "I/O format");
 
-    std::ifstream   file;
+    read_csv_ (file_name, layout);
+    return (true);
+}
 
-    file.open(file_name, std::ios::in);  // Open for reading
+// ----------------------------------------------------------------------------
 
-    char    buffer[65536];
+template<class T, class S>
+void DenseMatrixStorage<T, S>::
+read_binary_ (const char *file_name, matrix_layout layout)  {
 
-    file.getline(buffer, sizeof(buffer));
+    read_binary_ (file_name, layout,
+                  typename std::is_same<S, MMapVector<T>>::type ());
+    return;
+}
 
-    char            *marker = ::strtok(buffer, "X");
-    const long int  num_rows = _str_to_num_<long int>(marker);
-    const long int  num_cols = _str_to_num_<long int>(::strtok(nullptr, "X"));
-    const long int  data_size = _str_to_num_<long int>(::strtok(nullptr, "X"));
-    long int        counter = 0;
+// ----------------------------------------------------------------------------
 
-    _resize(num_rows, num_cols, data_size);
-    while (file.getline(buffer, sizeof(buffer), '|'))  {
-        marker = ::strtok(buffer, ",");
-        while (marker != nullptr)  {
-            data_[counter++] = _str_to_num_<T>(marker);
-            marker = ::strtok(nullptr, ",");
-        }
+// A file-backed matrix maps the file copy-on-write, instead of copying it
+//
+template<class T, class S>
+void DenseMatrixStorage<T, S>::
+read_binary_ (const char *file_name, matrix_layout layout, std::true_type)  {
+
+    data_.map_file (
+        file_name, false,
+        [layout](BinaryMatrixHeader &header, std::uint64_t file_size)  {
+            return (check_binary_header__<T> (header, file_size, layout,
+                                              "DenseMatrixStorage::read()"));
+        });
+    rows_ = static_cast<size_type>(data_.header ()->rows);
+    cols_ = static_cast<size_type>(data_.header ()->columns);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T, class S>
+void DenseMatrixStorage<T, S>::
+read_binary_ (const char *file_name, matrix_layout layout, std::false_type)  {
+
+    const FileImage__   file (file_name);
+    BinaryMatrixHeader  header;
+
+    std::memset (&header, 0, sizeof(header));
+    std::memcpy (&header, file.data (),
+                 std::min (file.size (), sizeof(header)));
+
+    const bool  swapped =
+        check_binary_header__<T> (header, file.size (), layout,
+                                  "DenseMatrixStorage::read()");
+
+    _resize (header.rows, header.columns, header.data_size, false);
+    if (! data_.empty ())  {
+        std::memcpy (&(data_[0]), file.data () + header.data_offset,
+                     data_.size () * sizeof(value_type));
+        if (swapped)
+            byte_swap__ (&(data_[0]), sizeof(value_type), data_.size ());
     }
+    return;
+}
 
-    file.close();
-    return (true);
+// ----------------------------------------------------------------------------
+
+template<class T, class S>
+void DenseMatrixStorage<T, S>::
+_attach_file (const char *file_name, matrix_layout layout)  {
+
+    static_assert(std::is_same<S, MMapVector<T>>::value,
+                  "attach_file() needs a file-backed matrix (MMapVector)");
+
+    if (std::ifstream (file_name).good ())  {
+        data_.map_file (
+            file_name, true,
+            [layout](BinaryMatrixHeader &header, std::uint64_t file_size)  {
+                return (check_binary_header__<T> (
+                            header, file_size, layout,
+                            "DenseMatrixStorage::attach_file()"));
+            });
+        rows_ = static_cast<size_type>(data_.header ()->rows);
+        cols_ = static_cast<size_type>(data_.header ()->columns);
+    }
+    else  {
+        data_.move_to_file (file_name);
+        data_.header ()->rows = rows_;
+        data_.header ()->columns = cols_;
+        data_.header ()->layout = static_cast<std::uint8_t>(layout);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T, class S>
+void DenseMatrixStorage<T, S>::
+read_csv_ (const char *file_name, matrix_layout layout)  {
+
+    const FileImage__   file (file_name);
+    const char *const   file_end = file.data () + file.size ();
+    const char          *body = file.size () != 0
+        ? static_cast<const char *>(std::memchr (file.data (), '\n',
+                                                 file.size ()))
+        : nullptr;
+
+    if (body == nullptr)
+        throw std::runtime_error ("DenseMatrixStorage::read(): No CSV "
+                                  "header line");
+
+   // Number of rows X number of columns X actual data vector size
+   //
+    const std::string   header (file.data (), body++);
+    const char          *hdr = header.c_str ();
+    char                *next = nullptr;
+    long int            dims[3];
+
+    for (int i = 0; i < 3; ++i)  {
+        dims[i] = ::strtol (hdr, &next, 10);
+        if (next == hdr || dims[i] < 0 || (i < 2 && *next != 'X'))
+            throw std::runtime_error ("DenseMatrixStorage::read(): Bad CSV "
+                                      "header line");
+        hdr = next + 1;
+    }
+
+    const char  *error = check_dimensions__<T> (dims[0], dims[1], dims[2],
+                                                 layout);
+
+    if (error != nullptr)
+        throw std::runtime_error (
+            std::string ("DenseMatrixStorage::read(): ") + error);
+
+   // The '|' separated blocks are found first. Then, in parallel, their
+   // values are counted, which gives every block its offset in the data
+   // vector. Then the blocks are parsed in parallel straight into place.
+   //
+    std::vector<std::pair<const char *, const char *>>  block_ranges;
+
+    for (const char *b = body; b < file_end; )  {
+        const char  *bar = static_cast<const char *>(
+            std::memchr (b, '|', file_end - b));
+        const char  *e = bar ? bar : file_end;
+
+        block_ranges.emplace_back (b, e);
+        b = e + 1;
+    }
+
+    const std::size_t           blocks = block_ranges.size ();
+    std::vector<std::size_t>    offsets (blocks + 1, 0);
+
+    constexpr std::size_t   BLOCKS_PER_TASK = 8;
+    const std::size_t       tasks =
+        (blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK;
+    const auto              run =
+        [tasks, blocks](const std::function<void(std::size_t)> &func)  {
+            const auto  task = [blocks, &func](std::size_t t)  {
+                const std::size_t   last =
+                    std::min (blocks, (t + 1) * BLOCKS_PER_TASK);
+
+                for (std::size_t blk = t * BLOCKS_PER_TASK; blk < last; ++blk)
+                    func (blk);
+            };
+
+            if (tasks > 1)
+                ThreadPool::instance ().parallel_for (tasks, task);
+            else
+                for (std::size_t t = 0; t < tasks; ++t)  task (t);
+        };
+
+    run ([&](std::size_t blk)  {
+        std::size_t count = 0;
+
+        for_each_token__ (block_ranges[blk].first, block_ranges[blk].second,
+                          [&count](const char *, const char *)  { ++count; });
+        offsets[blk + 1] = count;
+    });
+    for (std::size_t blk = 0; blk < blocks; ++blk)
+        offsets[blk + 1] += offsets[blk];
+    if (offsets[blocks] > static_cast<std::size_t>(dims[2]))
+        throw std::runtime_error ("DenseMatrixStorage::read(): More values "
+                                  "than the data size in CSV header");
+
+    _resize (dims[0], dims[1], dims[2], false);
+    std::fill (data_.begin () + offsets[blocks], data_.end (), value_type ());
+    run ([&](std::size_t blk)  {
+        auto    iter = data_.begin () + offsets[blk];
+
+        for_each_token__ (block_ranges[blk].first, block_ranges[blk].second,
+                          [&iter](const char *first, const char *last)  {
+                              *iter++ = parse_num__<value_type>(first, last);
+                          });
+    });
+    return;
 }
 
 } // namespace hmma
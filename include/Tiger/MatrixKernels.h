@@ -0,0 +1,470 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <Tiger/ThreadPool.h>
+
+#include <cstddef>
+
+// ----------------------------------------------------------------------------
+
+//
+// Dense column-major kernels
+//
+// These work on raw column-major arrays with a leading dimension, the same
+// way the data of DenseMatrixBase is laid out. The leading dimension is the
+// distance between two consecutive columns (i.e. number of rows of the
+// underlying storage).
+//
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Blocking parameters for the general matrix multiply.
+//
+// MR X NR is the size of the register tile computed by the micro-kernel.
+// KC is the depth of a packed panel (a KC X NR sliver of B should stay
+// in L1), MC X KC is the packed block of A (should stay in L2) and
+// KC X NC is the packed block of B (should stay in L3).
+//
+template<class T>
+struct  GEMMBlocking  {
+
+    static constexpr std::size_t    MR = 8;
+    static constexpr std::size_t    NR = 4;
+    static constexpr std::size_t    MC = 128;
+    static constexpr std::size_t    KC = 256;
+    static constexpr std::size_t    NC = 4096;
+
+   // Products with fewer multiply-adds than this don't pay for packing
+   //
+    static constexpr std::size_t    SMALL_FLOPS = 32 * 32 * 32;
+
+   // Products with fewer multiply-adds than this stay on the calling
+   // thread. Below it waking up the pool costs more than it saves.
+   //
+    static constexpr std::size_t    PARALLEL_FLOPS = 96 * 96 * 96;
+
+   // Bounds on the edge of the C tiles handed to the threads
+   //
+    static constexpr std::size_t    MIN_TILE = 64;
+    static constexpr std::size_t    MAX_TILE = 256;
+
+   // Size of the diagonal blocks of the triangular solve. The off diagonal
+   // blocks are done by gemm().
+   //
+    static constexpr std::size_t    TRSM_BLOCK = 64;
+
+   // Width of the diagonal blocks of the Cholesky factorization
+   //
+    static constexpr std::size_t    POTRF_BLOCK = 128;
+
+   // Edge of the blocks that the transpose kernels move in one go. The
+   // source and the destination block should both stay in L1.
+   //
+    static constexpr std::size_t    TRANSPOSE_BLOCK = 32;
+
+   // Rectangular matrices with fewer elements than this are transposed in
+   // place through a scratch copy, which is several times faster than
+   // transpose_cycles(). Bigger ones follow the cycles, so their memory
+   // doesn't double.
+   //
+    static constexpr std::size_t    TRANSPOSE_SCRATCH = 1 << 20;
+
+   // Width of the panels of the tridiagonal reduction and of the blocks
+   // of reflectors that are applied together
+   //
+    static constexpr std::size_t    SYTRD_BLOCK = 32;
+
+   // Tridiagonal eigenproblems of this size or smaller are solved by the
+   // QL iteration. stedc() splits bigger ones in halves.
+   //
+    static constexpr std::size_t    STEDC_LEAF = 32;
+
+   // Symmetric matrices of this size or bigger are reduced by sytrd() and
+   // get their eigenvectors from stedc(), instead of the unblocked
+   // reduction and the QL iteration (see eigen_space()).
+   //
+    static constexpr std::size_t    STEDC_MIN = 128;
+
+   // Width of the panels of the QR factorization
+   //
+    static constexpr std::size_t    QR_BLOCK = 32;
+
+   // Width of the column panels computed by gemm() and then stored into
+   // a packed symmetric result (e.g. covariance() into a SymmMatrixBase)
+   //
+    static constexpr std::size_t    PACKED_PANEL = 128;
+};
+
+// ----------------------------------------------------------------------------
+
+// General matrix multiply:
+//     C = alpha * op(A) * op(B) + beta * C
+//
+// op(X) is X or its transpose depending on trans_a/trans_b.
+// op(A) is m X k, op(B) is k X n and C is m X n.
+// If beta is zero, C is not read (so it can be uninitialized).
+//
+// It packs panels of A and B into contiguous buffers, blocks for
+// L1/L2/L3 caches and computes MR X NR tiles of C in registers.
+// Large products are split into 2D tiles of C across the threads of
+// ThreadPool::instance() (see set_num_threads()).
+//
+template<class T>
+void gemm (bool trans_a,
+           bool trans_b,
+           std::size_t m,
+           std::size_t n,
+           std::size_t k,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           const T *b,
+           std::size_t ldb,
+           T beta,
+           T *c,
+           std::size_t ldc);
+
+// ----------------------------------------------------------------------------
+
+// Symmetric rank-k update:
+//     C = alpha * op(A) * ~op(A) + beta * C
+//
+// op(A) is A or its transpose depending on trans_a. op(A) is n X k and C
+// is n X n. Only the upper or lower triangle of C (including the diagonal)
+// is computed and the other triangle is never touched. If beta is zero,
+// C is not read.
+//
+// It does half the work of gemm(). C is split into column blocks that are
+// done with gemm() and, if the update is large enough, spread across the
+// threads of ThreadPool::instance().
+//
+template<class T>
+void syrk (bool upper,
+           bool trans_a,
+           std::size_t n,
+           std::size_t k,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           T beta,
+           T *c,
+           std::size_t ldc);
+
+// ----------------------------------------------------------------------------
+
+// Symmetric rank-2k update:
+//     C = alpha * (op(A) * ~op(B) + op(B) * ~op(A)) + beta * C
+//
+// op(X) is X or its transpose depending on trans_a. op(A) and op(B) are
+// n X k and C is n X n. Like syrk(), only the upper or lower triangle of C
+// is computed and the other one is never touched.
+//
+template<class T>
+void syr2k (bool upper,
+            bool trans_a,
+            std::size_t n,
+            std::size_t k,
+            T alpha,
+            const T *a,
+            std::size_t lda,
+            const T *b,
+            std::size_t ldb,
+            T beta,
+            T *c,
+            std::size_t ldc);
+
+// ----------------------------------------------------------------------------
+
+// Triangular solve with many right-hand sides:
+//     op(A) * X = B
+//
+// A is an m X m upper or lower triangular matrix and op(A) is A or its
+// transpose depending on trans_a. B is m X n and it is overwritten by X.
+// If unit_diag is true, the diagonal of A is taken to be all ones and it
+// is not read. The other triangle of A is never read.
+//
+template<class T>
+void trsm (bool upper,
+           bool trans_a,
+           bool unit_diag,
+           std::size_t m,
+           std::size_t n,
+           const T *a,
+           std::size_t lda,
+           T *b,
+           std::size_t ldb);
+
+// ----------------------------------------------------------------------------
+
+// Same as above, but with the triangular matrix on the right:
+//     X * op(A) = B
+//
+// A is n X n and B is m X n. B is overwritten by X.
+//
+template<class T>
+void trsm_right (bool upper,
+                 bool trans_a,
+                 bool unit_diag,
+                 std::size_t m,
+                 std::size_t n,
+                 const T *a,
+                 std::size_t lda,
+                 T *b,
+                 std::size_t ldb);
+
+// ----------------------------------------------------------------------------
+
+// Cholesky factorization of the n X n symmetric positive-definite A:
+//     A = ~U * U    or    A = L * ~L
+//
+// Only the upper (or lower) triangle of A is read and it is overwritten by
+// U (or L). The other triangle is never touched.
+// It returns false, if A is not positive-definite. A is left partially
+// factored then.
+//
+// It is blocked. Most of the work is done by trsm() and syrk().
+//
+template<class T>
+bool potrf (bool upper, std::size_t n, T *a, std::size_t lda);
+
+// ----------------------------------------------------------------------------
+
+// Symmetric matrix multiply:
+//     C = alpha * A * B + beta * C
+//
+// A is an m X m symmetric matrix of which only the upper (or lower)
+// triangle is read. B and C are m X n. If beta is zero, C is not read.
+//
+// A is processed in square tiles. The tiles off the diagonal go to
+// gemm() as they are, or transposed if they are in the other triangle.
+// Only the tiles on the diagonal are expanded into a scratch buffer.
+//
+template<class T>
+void symm (bool upper,
+           std::size_t m,
+           std::size_t n,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           const T *b,
+           std::size_t ldb,
+           T beta,
+           T *c,
+           std::size_t ldc);
+
+// ----------------------------------------------------------------------------
+
+// Symmetric matrix-vector multiply:
+//     y = A * x
+//
+// A is an n X n symmetric matrix of which only the lower triangle is
+// read. It is bound by memory, so reading half of A makes it about twice
+// as fast as a general product. y is not read.
+//
+template<class T>
+void symv (std::size_t n, const T *a, std::size_t lda, const T *x, T *y);
+
+// ----------------------------------------------------------------------------
+
+// Out-of-place transpose:
+//     B = ~A
+//
+// A is m X n and B is n X m. They must not overlap.
+// It is cache-oblivious. The larger dimension is halved recursively until
+// the blocks fit in L1, so at every level of the memory hierarchy A and B
+// are accessed in runs of whole cache lines. Large matrices are split
+// into tiles across the threads of ThreadPool::instance().
+//
+template<class T>
+void transpose (std::size_t m,
+                std::size_t n,
+                const T *a,
+                std::size_t lda,
+                T *b,
+                std::size_t ldb);
+
+// ----------------------------------------------------------------------------
+
+// In-place transpose of the n X n matrix A.
+//
+// The blocks on the diagonal are transposed in place. The blocks below
+// the diagonal are swapped with their mirror images above it and
+// transposed on the way.
+//
+template<class T>
+void transpose_square (std::size_t n, T *a, std::size_t lda);
+
+// ----------------------------------------------------------------------------
+
+// In-place transpose of the m X n matrix A, stored contiguously (i.e. its
+// leading dimension is m). Afterwards A is the n X m transpose, stored
+// contiguously.
+//
+// The element at index i moves to index (i * n) mod (m * n - 1). Every
+// cycle of this permutation is followed once, with one bit per element to
+// mark the ones that are already in place. So the extra memory is
+// m * n / 8 bytes, instead of a copy of the matrix. The accesses are
+// scattered. If there is room for a copy, transpose() is faster.
+//
+template<class T>
+void transpose_cycles (std::size_t m, std::size_t n, T *a);
+
+// ----------------------------------------------------------------------------
+
+// Householder reduction of the n X n symmetric A to tridiagonal form:
+//     A = Q * T * ~Q
+//
+// Only the lower triangle of A is read. d gets the n diagonal and e the
+// n - 1 off diagonal elements of T. Q = H(0) * H(1) * ... * H(n - 2) is
+// kept in factored form: H(i) = I - tau[i] * v * ~v, where v is zero
+// above row i + 1, one at row i + 1 and the rest of it is stored below
+// the off diagonal of column i of A. tau has n - 1 elements.
+//
+// It is blocked: the reflectors of a panel are accumulated and the rest
+// of the matrix is updated with syr2k().
+//
+template<class T>
+void sytrd (std::size_t n, T *a, std::size_t lda, T *d, T *e, T *tau);
+
+// ----------------------------------------------------------------------------
+
+// Multiplies the n X ncols C by the Q of sytrd():
+//     C = Q * C
+//
+// a and tau are as sytrd() left them.
+//
+template<class T>
+void ormtr (std::size_t n,
+            std::size_t ncols,
+            const T *a,
+            std::size_t lda,
+            const T *tau,
+            T *c,
+            std::size_t ldc);
+
+// ----------------------------------------------------------------------------
+
+// Eigen decomposition of the n X n symmetric tridiagonal matrix T:
+//     T = Z * diag(d) * ~Z
+//
+// d holds the diagonal and e the n - 1 elements next to it (e[i] couples
+// rows i and i + 1). On return d holds the eigenvalues in ascending order
+// and the columns of the n X n Z the eigenvectors. e is not changed.
+//
+// It is divide-and-conquer (Cuppen's method with deflation). Most of the
+// work is in the products that merge the halves, done with gemm(). The
+// independent halves are solved in parallel.
+//
+template<class T>
+void stedc (std::size_t n, T *d, const T *e, T *z, std::size_t ldz);
+
+// ----------------------------------------------------------------------------
+
+// Householder QR factorization of the m X n A:
+//     A = Q * R
+//
+// R overwrites the upper triangle (trapezoid, if m < n) of A.
+// Q = H(0) * H(1) * ... * H(k - 1), where k = min(m, n), is kept in
+// factored form: H(i) = I - tau[i] * v * ~v, where v is zero above row i,
+// one at row i and the rest of it is stored below the diagonal of column i
+// of A. tau has k elements.
+//
+// It is blocked: the reflectors of a panel are applied to the rest of the
+// matrix with gemm().
+//
+template<class T>
+void geqrf (std::size_t m, std::size_t n, T *a, std::size_t lda, T *tau);
+
+// ----------------------------------------------------------------------------
+
+// Overwrites the m X n A, as geqrf() left it, by the first n columns of Q.
+// n must not be bigger than m. The columns of the result are orthonormal.
+//
+template<class T>
+void orgqr (std::size_t m,
+            std::size_t n,
+            T *a,
+            std::size_t lda,
+            const T *tau);
+
+// ----------------------------------------------------------------------------
+
+// Singular value decomposition of the m X n A, with m >= n, by one-sided
+// Jacobi rotations:
+//     A = U * diag(s) * ~V
+//
+// U (m X n) overwrites A, s gets the n singular values in descending order
+// and V is n X n. Columns of U that go with a zero singular value are
+// zero. It is meant for small matrices, or tall ones with few columns.
+// It returns false if it didn't converge.
+//
+template<class T>
+bool gesvj (std::size_t m,
+            std::size_t n,
+            T *a,
+            std::size_t lda,
+            T *s,
+            T *v,
+            std::size_t ldv);
+
+// ----------------------------------------------------------------------------
+
+// Elementwise sum and difference of two arrays of n elements:
+//     dst[i] = a[i] + b[i]    or    dst[i] = a[i] - b[i]
+//
+// dst may be the same array as a or b.
+// For float and double it uses AVX-512 or AVX2, if the CPU has them (it is
+// checked at run time). Other types and CPUs use a scalar loop.
+//
+template<class T>
+void vector_plus (std::size_t n, const T *a, const T *b, T *dst);
+
+template<class T>
+void vector_minus (std::size_t n, const T *a, const T *b, T *dst);
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/MatrixKernels.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
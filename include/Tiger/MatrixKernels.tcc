@@ -0,0 +1,2463 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define HMMA_X86_SIMD
+#  include <immintrin.h>
+#endif // HMMA_X86_SIMD
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T> constexpr std::size_t GEMMBlocking<T>::MR;
+template<class T> constexpr std::size_t GEMMBlocking<T>::NR;
+template<class T> constexpr std::size_t GEMMBlocking<T>::MC;
+template<class T> constexpr std::size_t GEMMBlocking<T>::KC;
+template<class T> constexpr std::size_t GEMMBlocking<T>::NC;
+template<class T> constexpr std::size_t GEMMBlocking<T>::SMALL_FLOPS;
+template<class T> constexpr std::size_t GEMMBlocking<T>::PARALLEL_FLOPS;
+template<class T> constexpr std::size_t GEMMBlocking<T>::MIN_TILE;
+template<class T> constexpr std::size_t GEMMBlocking<T>::MAX_TILE;
+template<class T> constexpr std::size_t GEMMBlocking<T>::TRSM_BLOCK;
+template<class T> constexpr std::size_t GEMMBlocking<T>::POTRF_BLOCK;
+template<class T> constexpr std::size_t GEMMBlocking<T>::TRANSPOSE_BLOCK;
+template<class T>
+constexpr std::size_t GEMMBlocking<T>::TRANSPOSE_SCRATCH;
+template<class T> constexpr std::size_t GEMMBlocking<T>::SYTRD_BLOCK;
+template<class T> constexpr std::size_t GEMMBlocking<T>::STEDC_LEAF;
+template<class T> constexpr std::size_t GEMMBlocking<T>::STEDC_MIN;
+template<class T> constexpr std::size_t GEMMBlocking<T>::QR_BLOCK;
+template<class T> constexpr std::size_t GEMMBlocking<T>::PACKED_PANEL;
+
+// ----------------------------------------------------------------------------
+
+// Element (r, c) of op(X)
+//
+template<class T>
+inline const T &
+op_at_ (const T *x, std::size_t ldx, bool trans,
+        std::size_t r, std::size_t c) noexcept  {
+
+    return (trans ? x[r * ldx + c] : x[c * ldx + r]);
+}
+
+// ----------------------------------------------------------------------------
+
+// Scale the m X n matrix C by beta. Zero beta means overwrite, so C may
+// contain garbage (even NaNs) on entry.
+//
+template<class T>
+inline void
+scale_c_ (std::size_t m, std::size_t n, T beta, T *c, std::size_t ldc)  {
+
+    if (beta == T(1))  return;
+
+    for (std::size_t j = 0; j < n; ++j)  {
+        T   *col = c + j * ldc;
+
+        if (beta == T(0))
+            std::fill (col, col + m, T(0));
+        else
+            for (std::size_t i = 0; i < m; ++i)
+                col[i] *= beta;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Straightforward column-oriented product for tiny matrices, where
+// packing costs more than it saves.
+//
+template<class T>
+inline void
+gemm_small_ (bool trans_a, bool trans_b,
+             std::size_t m, std::size_t n, std::size_t k,
+             T alpha, const T *a, std::size_t lda,
+             const T *b, std::size_t ldb,
+             T beta, T *c, std::size_t ldc)  {
+
+    scale_c_ (m, n, beta, c, ldc);
+    for (std::size_t j = 0; j < n; ++j)  {
+        T   *col = c + j * ldc;
+
+        for (std::size_t p = 0; p < k; ++p)  {
+            const T bpj = alpha * op_at_ (b, ldb, trans_b, p, j);
+
+            if (! trans_a)  {
+                const T *acol = a + p * lda;
+
+                for (std::size_t i = 0; i < m; ++i)
+                    col[i] += acol[i] * bpj;
+            }
+            else
+                for (std::size_t i = 0; i < m; ++i)
+                    col[i] += a[i * lda + p] * bpj;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Pack the mc X kc block of op(A) starting at (ic, pc) into MR-row slivers.
+// Each sliver is kc columns of MR contiguous values, zero padded at the
+// bottom edge.
+//
+template<class T>
+inline void
+gemm_pack_a_ (bool trans, std::size_t mc, std::size_t kc,
+              const T *a, std::size_t lda,
+              std::size_t ic, std::size_t pc, T *ap)  {
+
+    constexpr std::size_t   MR = GEMMBlocking<T>::MR;
+
+    for (std::size_t i0 = 0; i0 < mc; i0 += MR)  {
+        const std::size_t   mr = std::min (MR, mc - i0);
+
+        if (! trans)  {
+            const T *col = a + pc * lda + ic + i0;
+
+            for (std::size_t p = 0; p < kc; ++p, col += lda, ap += MR)  {
+                std::size_t i = 0;
+
+                for (; i < mr; ++i)  ap[i] = col[i];
+                for (; i < MR; ++i)  ap[i] = T(0);
+            }
+        }
+        else  {
+            for (std::size_t i = 0; i < MR; ++i)  {
+                if (i < mr)  {
+                    const T *row = a + (ic + i0 + i) * lda + pc;
+
+                    for (std::size_t p = 0; p < kc; ++p)
+                        ap[p * MR + i] = row[p];
+                }
+                else
+                    for (std::size_t p = 0; p < kc; ++p)
+                        ap[p * MR + i] = T(0);
+            }
+            ap += kc * MR;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Pack the kc X nc block of op(B) starting at (pc, jc) into NR-column
+// slivers. Each sliver is kc rows of NR contiguous values, zero padded at
+// the right edge.
+//
+template<class T>
+inline void
+gemm_pack_b_ (bool trans, std::size_t kc, std::size_t nc,
+              const T *b, std::size_t ldb,
+              std::size_t pc, std::size_t jc, T *bp)  {
+
+    constexpr std::size_t   NR = GEMMBlocking<T>::NR;
+
+    for (std::size_t j0 = 0; j0 < nc; j0 += NR)  {
+        const std::size_t   nr = std::min (NR, nc - j0);
+
+        if (! trans)  {
+            for (std::size_t j = 0; j < NR; ++j)  {
+                if (j < nr)  {
+                    const T *col = b + (jc + j0 + j) * ldb + pc;
+
+                    for (std::size_t p = 0; p < kc; ++p)
+                        bp[p * NR + j] = col[p];
+                }
+                else
+                    for (std::size_t p = 0; p < kc; ++p)
+                        bp[p * NR + j] = T(0);
+            }
+        }
+        else  {
+            const T *row = b + pc * ldb + jc + j0;
+
+            for (std::size_t p = 0; p < kc; ++p, row += ldb)  {
+                std::size_t j = 0;
+
+                for (; j < nr; ++j)  bp[p * NR + j] = row[j];
+                for (; j < NR; ++j)  bp[p * NR + j] = T(0);
+            }
+        }
+        bp += kc * NR;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The register micro-kernel. It computes the MR X NR product of an A
+// sliver and a B sliver. The accumulator array is small and fixed so the
+// compiler keeps it in vector registers.
+//
+template<class T>
+inline void
+gemm_micro_kernel_ (std::size_t kc,
+                    const T *__restrict ap,
+                    const T *__restrict bp,
+                    T *__restrict ab) noexcept  {
+
+    constexpr std::size_t   MR = GEMMBlocking<T>::MR;
+    constexpr std::size_t   NR = GEMMBlocking<T>::NR;
+
+    T   acc[MR * NR];
+
+    for (std::size_t i = 0; i < MR * NR; ++i)
+        acc[i] = T(0);
+
+    for (std::size_t p = 0; p < kc; ++p, ap += MR, bp += NR)
+        for (std::size_t j = 0; j < NR; ++j)  {
+            const T bj = bp[j];
+
+            for (std::size_t i = 0; i < MR; ++i)
+                acc[j * MR + i] += ap[i] * bj;
+        }
+
+    for (std::size_t i = 0; i < MR * NR; ++i)
+        ab[i] = acc[i];
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Multiply the packed mc X kc block of A by the packed kc X nc block of B
+// and fold the result into the corresponding mc X nc block of C.
+//
+template<class T>
+inline void
+gemm_macro_kernel_ (std::size_t mc, std::size_t nc, std::size_t kc,
+                    T alpha, const T *ap, const T *bp,
+                    T beta, T *c, std::size_t ldc)  {
+
+    constexpr std::size_t   MR = GEMMBlocking<T>::MR;
+    constexpr std::size_t   NR = GEMMBlocking<T>::NR;
+
+    T   ab[MR * NR];
+
+    for (std::size_t j0 = 0; j0 < nc; j0 += NR)  {
+        const std::size_t   nr = std::min (NR, nc - j0);
+
+        for (std::size_t i0 = 0; i0 < mc; i0 += MR)  {
+            const std::size_t   mr = std::min (MR, mc - i0);
+
+            gemm_micro_kernel_ (kc, ap + i0 * kc, bp + j0 * kc, ab);
+
+            T   *ctile = c + j0 * ldc + i0;
+
+            for (std::size_t j = 0; j < nr; ++j)  {
+                T       *col = ctile + j * ldc;
+                const T *abcol = ab + j * MR;
+
+                if (beta == T(0))
+                    for (std::size_t i = 0; i < mr; ++i)
+                        col[i] = alpha * abcol[i];
+                else if (beta == T(1))
+                    for (std::size_t i = 0; i < mr; ++i)
+                        col[i] += alpha * abcol[i];
+                else
+                    for (std::size_t i = 0; i < mr; ++i)
+                        col[i] = beta * col[i] + alpha * abcol[i];
+            }
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The blocked product on the calling thread
+//
+template<class T>
+inline void
+gemm_serial_ (bool trans_a, bool trans_b,
+              std::size_t m, std::size_t n, std::size_t k,
+              T alpha, const T *a, std::size_t lda,
+              const T *b, std::size_t ldb,
+              T beta, T *c, std::size_t ldc)  {
+
+    using Blocking = GEMMBlocking<T>;
+
+    const std::size_t   mc_max =
+        ((std::min (Blocking::MC, m) + Blocking::MR - 1) / Blocking::MR) *
+        Blocking::MR;
+    const std::size_t   nc_max =
+        ((std::min (Blocking::NC, n) + Blocking::NR - 1) / Blocking::NR) *
+        Blocking::NR;
+    const std::size_t   kc_max = std::min (Blocking::KC, k);
+    std::vector<T>      a_pack (mc_max * kc_max);
+    std::vector<T>      b_pack (kc_max * nc_max);
+
+    for (std::size_t jc = 0; jc < n; jc += Blocking::NC)  {
+        const std::size_t   nc = std::min (Blocking::NC, n - jc);
+
+        for (std::size_t pc = 0; pc < k; pc += Blocking::KC)  {
+            const std::size_t   kc = std::min (Blocking::KC, k - pc);
+            const T             beta_eff = pc == 0 ? beta : T(1);
+
+            gemm_pack_b_ (trans_b, kc, nc, b, ldb, pc, jc, b_pack.data ());
+            for (std::size_t ic = 0; ic < m; ic += Blocking::MC)  {
+                const std::size_t   mc = std::min (Blocking::MC, m - ic);
+
+                gemm_pack_a_ (trans_a, mc, kc, a, lda, ic, pc, a_pack.data ());
+                gemm_macro_kernel_ (mc, nc, kc, alpha,
+                                    a_pack.data (), b_pack.data (),
+                                    beta_eff, c + jc * ldc + ic, ldc);
+            }
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Split C into 2D tiles and run the blocked product of each tile on the
+// thread pool. Tiles don't overlap, so there is no synchronization other
+// than waiting for the whole job. Every tile packs its own panels.
+//
+template<class T>
+inline void
+gemm_parallel_ (ThreadPool &pool, bool trans_a, bool trans_b,
+                std::size_t m, std::size_t n, std::size_t k,
+                T alpha, const T *a, std::size_t lda,
+                const T *b, std::size_t ldb,
+                T beta, T *c, std::size_t ldc)  {
+
+    using Blocking = GEMMBlocking<T>;
+
+   // Aim for a few tiles per thread, so uneven tiles balance out
+   //
+    const std::size_t   threads = pool.thread_count ();
+    std::size_t         edge = static_cast<std::size_t>(
+        std::sqrt (double(m) * double(n) / double(threads * 4)));
+
+    edge = std::max (Blocking::MIN_TILE, std::min (Blocking::MAX_TILE, edge));
+
+    const std::size_t   tile_m =
+        ((std::min (edge, m) + Blocking::MR - 1) / Blocking::MR) *
+        Blocking::MR;
+    const std::size_t   tile_n =
+        ((std::min (edge, n) + Blocking::NR - 1) / Blocking::NR) *
+        Blocking::NR;
+    const std::size_t   row_tiles = (m + tile_m - 1) / tile_m;
+    const std::size_t   col_tiles = (n + tile_n - 1) / tile_n;
+
+    pool.parallel_for (
+        row_tiles * col_tiles,
+        [&](std::size_t tile)  {
+            const std::size_t   i0 = (tile % row_tiles) * tile_m;
+            const std::size_t   j0 = (tile / row_tiles) * tile_n;
+
+            gemm_serial_ (trans_a, trans_b,
+                          std::min (tile_m, m - i0),
+                          std::min (tile_n, n - j0),
+                          k,
+                          alpha,
+                          trans_a ? a + i0 * lda : a + i0, lda,
+                          trans_b ? b + j0 : b + j0 * ldb, ldb,
+                          beta,
+                          c + j0 * ldc + i0, ldc);
+        });
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void gemm (bool trans_a,
+           bool trans_b,
+           std::size_t m,
+           std::size_t n,
+           std::size_t k,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           const T *b,
+           std::size_t ldb,
+           T beta,
+           T *c,
+           std::size_t ldc)  {
+
+    using Blocking = GEMMBlocking<T>;
+
+    if (m == 0 || n == 0)  return;
+    if (k == 0 || alpha == T(0))  {
+        scale_c_ (m, n, beta, c, ldc);
+        return;
+    }
+
+    const std::size_t   flops = m * n * k;
+
+    if (flops < Blocking::SMALL_FLOPS)  {
+        gemm_small_ (trans_a, trans_b, m, n, k,
+                     alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    if (flops >= Blocking::PARALLEL_FLOPS && pool.thread_count () > 1)
+        gemm_parallel_ (pool, trans_a, trans_b, m, n, k,
+                        alpha, a, lda, b, ldb, beta, c, ldc);
+    else
+        gemm_serial_ (trans_a, trans_b, m, n, k,
+                      alpha, a, lda, b, ldb, beta, c, ldc);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void syrk (bool upper,
+           bool trans_a,
+           std::size_t n,
+           std::size_t k,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           T beta,
+           T *c,
+           std::size_t ldc)  {
+
+    using Blocking = GEMMBlocking<T>;
+
+    constexpr std::size_t   NB = Blocking::MIN_TILE;
+
+    if (n == 0)  return;
+
+   // Address of row r of op(A)
+   //
+    const auto  op_a = [a, lda, trans_a](std::size_t r)  {
+        return (trans_a ? a + r * lda : a + r);
+    };
+    const std::size_t   blocks = (n + NB - 1) / NB;
+    const auto          block_update = [&](std::size_t blk)  {
+        const std::size_t   j0 = blk * NB;
+        const std::size_t   jb = std::min (NB, n - j0);
+        T                   *c_jj = c + j0 + j0 * ldc;
+
+       // The diagonal block goes through a scratch buffer, so the other
+       // triangle of it is left alone
+       //
+        T   diag[NB * NB];
+
+        gemm (trans_a, ! trans_a, jb, jb, k,
+              alpha, op_a (j0), lda, op_a (j0), lda,
+              T(0), diag, jb);
+        for (std::size_t j = 0; j < jb; ++j)  {
+            const std::size_t   r0 = upper ? 0 : j;
+            const std::size_t   r1 = upper ? j + 1 : jb;
+
+            for (std::size_t r = r0; r < r1; ++r)
+                c_jj[r + j * ldc] = beta == T(0)
+                    ? diag[r + j * jb]
+                    : beta * c_jj[r + j * ldc] + diag[r + j * jb];
+        }
+
+       // The rectangle above (or below) the diagonal block
+       //
+        if (upper && j0 > 0)
+            gemm (trans_a, ! trans_a, j0, jb, k,
+                  alpha, op_a (0), lda, op_a (j0), lda,
+                  beta, c + j0 * ldc, ldc);
+        else if (! upper && j0 + jb < n)
+            gemm (trans_a, ! trans_a, n - j0 - jb, jb, k,
+                  alpha, op_a (j0 + jb), lda, op_a (j0), lda,
+                  beta, c_jj + jb, ldc);
+    };
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    if (blocks > 1 &&
+        n * n * k / 2 >= Blocking::PARALLEL_FLOPS &&
+        pool.thread_count () > 1)
+        pool.parallel_for (blocks, block_update);
+    else
+        for (std::size_t blk = 0; blk < blocks; ++blk)
+            block_update (blk);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void syr2k (bool upper,
+            bool trans_a,
+            std::size_t n,
+            std::size_t k,
+            T alpha,
+            const T *a,
+            std::size_t lda,
+            const T *b,
+            std::size_t ldb,
+            T beta,
+            T *c,
+            std::size_t ldc)  {
+
+    using Blocking = GEMMBlocking<T>;
+
+    constexpr std::size_t   NB = Blocking::MIN_TILE;
+
+    if (n == 0)  return;
+
+   // Address of row r of op(A) and op(B)
+   //
+    const auto  op_a = [a, lda, trans_a](std::size_t r)  {
+        return (trans_a ? a + r * lda : a + r);
+    };
+    const auto  op_b = [b, ldb, trans_a](std::size_t r)  {
+        return (trans_a ? b + r * ldb : b + r);
+    };
+    const std::size_t   blocks = (n + NB - 1) / NB;
+    const auto          block_update = [&](std::size_t blk)  {
+        const std::size_t   j0 = blk * NB;
+        const std::size_t   jb = std::min (NB, n - j0);
+        T                   *c_jj = c + j0 + j0 * ldc;
+
+       // The diagonal block goes through a scratch buffer, so the other
+       // triangle of it is left alone
+       //
+        T   diag[NB * NB];
+
+        gemm (trans_a, ! trans_a, jb, jb, k,
+              alpha, op_a (j0), lda, op_b (j0), ldb,
+              T(0), diag, jb);
+        gemm (trans_a, ! trans_a, jb, jb, k,
+              alpha, op_b (j0), ldb, op_a (j0), lda,
+              T(1), diag, jb);
+        for (std::size_t j = 0; j < jb; ++j)  {
+            const std::size_t   r0 = upper ? 0 : j;
+            const std::size_t   r1 = upper ? j + 1 : jb;
+
+            for (std::size_t r = r0; r < r1; ++r)
+                c_jj[r + j * ldc] = beta == T(0)
+                    ? diag[r + j * jb]
+                    : beta * c_jj[r + j * ldc] + diag[r + j * jb];
+        }
+
+       // The rectangle above (or below) the diagonal block
+       //
+        if (upper && j0 > 0)  {
+            gemm (trans_a, ! trans_a, j0, jb, k,
+                  alpha, op_a (0), lda, op_b (j0), ldb,
+                  beta, c + j0 * ldc, ldc);
+            gemm (trans_a, ! trans_a, j0, jb, k,
+                  alpha, op_b (0), ldb, op_a (j0), lda,
+                  T(1), c + j0 * ldc, ldc);
+        }
+        else if (! upper && j0 + jb < n)  {
+            gemm (trans_a, ! trans_a, n - j0 - jb, jb, k,
+                  alpha, op_a (j0 + jb), lda, op_b (j0), ldb,
+                  beta, c_jj + jb, ldc);
+            gemm (trans_a, ! trans_a, n - j0 - jb, jb, k,
+                  alpha, op_b (j0 + jb), ldb, op_a (j0), lda,
+                  T(1), c_jj + jb, ldc);
+        }
+    };
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    if (blocks > 1 &&
+        n * n * k >= Blocking::PARALLEL_FLOPS &&
+        pool.thread_count () > 1)
+        pool.parallel_for (blocks, block_update);
+    else
+        for (std::size_t blk = 0; blk < blocks; ++blk)
+            block_update (blk);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Unblocked triangular solve of op(A) * X = B. When op(A) is A, it works
+// down the columns of A (axpy form). When it is the transpose of A, it
+// works with dot products of the columns of A. Either way A is accessed
+// with unit stride.
+//
+template<class T>
+inline void
+trsm_unblocked_ (bool upper, bool trans_a, bool unit_diag,
+                 std::size_t m, std::size_t n,
+                 const T *a, std::size_t lda,
+                 T *b, std::size_t ldb)  {
+
+    const bool  forward = upper == trans_a;  // op(A) is lower triangular
+
+    for (std::size_t j = 0; j < n; ++j)  {
+        T   *x = b + j * ldb;
+
+        if (! trans_a)  {
+            if (forward)
+                for (std::size_t k = 0; k < m; ++k)  {
+                    const T *acol = a + k * lda;
+
+                    if (! unit_diag)
+                        x[k] /= acol[k];
+
+                    const T xk = x[k];
+
+                    for (std::size_t i = k + 1; i < m; ++i)
+                        x[i] -= acol[i] * xk;
+                }
+            else
+                for (std::size_t k = m; k-- > 0; )  {
+                    const T *acol = a + k * lda;
+
+                    if (! unit_diag)
+                        x[k] /= acol[k];
+
+                    const T xk = x[k];
+
+                    for (std::size_t i = 0; i < k; ++i)
+                        x[i] -= acol[i] * xk;
+                }
+        }
+        else  {
+            if (forward)
+                for (std::size_t i = 0; i < m; ++i)  {
+                    const T *acol = a + i * lda;
+                    T       sum = x[i];
+
+                    for (std::size_t k = 0; k < i; ++k)
+                        sum -= acol[k] * x[k];
+                    x[i] = unit_diag ? sum : sum / acol[i];
+                }
+            else
+                for (std::size_t i = m; i-- > 0; )  {
+                    const T *acol = a + i * lda;
+                    T       sum = x[i];
+
+                    for (std::size_t k = i + 1; k < m; ++k)
+                        sum -= acol[k] * x[k];
+                    x[i] = unit_diag ? sum : sum / acol[i];
+                }
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void trsm (bool upper,
+           bool trans_a,
+           bool unit_diag,
+           std::size_t m,
+           std::size_t n,
+           const T *a,
+           std::size_t lda,
+           T *b,
+           std::size_t ldb)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::TRSM_BLOCK;
+
+    if (m == 0 || n == 0)  return;
+    if (m <= NB)  {
+        trsm_unblocked_ (upper, trans_a, unit_diag, m, n, a, lda, b, ldb);
+        return;
+    }
+
+   // Address of element (r, c) of op(A)
+   //
+    const auto  op_a = [a, lda, trans_a](std::size_t r, std::size_t c)  {
+        return (trans_a ? a + c + r * lda : a + r + c * lda);
+    };
+
+    if (upper == trans_a)  {  // op(A) is lower triangular, go forward
+        for (std::size_t i0 = 0; i0 < m; i0 += NB)  {
+            const std::size_t   ib = std::min (NB, m - i0);
+
+            trsm_unblocked_ (upper, trans_a, unit_diag, ib, n,
+                             a + i0 + i0 * lda, lda, b + i0, ldb);
+            if (i0 + ib < m)
+                gemm (trans_a, false, m - i0 - ib, n, ib,
+                      T(-1), op_a (i0 + ib, i0), lda,
+                      b + i0, ldb,
+                      T(1), b + i0 + ib, ldb);
+        }
+    }
+    else  {  // op(A) is upper triangular, go backward
+        for (std::size_t i1 = m; i1 > 0; )  {
+            const std::size_t   ib = std::min (NB, i1);
+            const std::size_t   i0 = i1 - ib;
+
+            trsm_unblocked_ (upper, trans_a, unit_diag, ib, n,
+                             a + i0 + i0 * lda, lda, b + i0, ldb);
+            if (i0 > 0)
+                gemm (trans_a, false, i0, n, ib,
+                      T(-1), op_a (0, i0), lda,
+                      b + i0, ldb,
+                      T(1), b, ldb);
+            i1 = i0;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Unblocked X * op(A) = B. Column j of X is column j of B minus a
+// combination of the columns of X that are already known, all with unit
+// stride.
+//
+template<class T>
+inline void
+trsm_right_unblocked_ (bool upper, bool trans_a, bool unit_diag,
+                       std::size_t m, std::size_t n,
+                       const T *a, std::size_t lda,
+                       T *b, std::size_t ldb)  {
+
+    const bool  forward = upper != trans_a;  // op(A) is upper triangular
+    const auto  op_a = [a, lda, trans_a](std::size_t r, std::size_t c)  {
+        return (trans_a ? a[c + r * lda] : a[r + c * lda]);
+    };
+    const auto  solve_column = [&](std::size_t j, std::size_t k0,
+                                   std::size_t k1)  {
+        T   *xj = b + j * ldb;
+
+        for (std::size_t k = k0; k < k1; ++k)  {
+            const T     akj = op_a (k, j);
+            const T     *xk = b + k * ldb;
+
+            if (akj != T(0))
+                for (std::size_t i = 0; i < m; ++i)
+                    xj[i] -= akj * xk[i];
+        }
+        if (! unit_diag)  {
+            const T ajj = op_a (j, j);
+
+            for (std::size_t i = 0; i < m; ++i)
+                xj[i] /= ajj;
+        }
+    };
+
+    if (forward)
+        for (std::size_t j = 0; j < n; ++j)
+            solve_column (j, 0, j);
+    else
+        for (std::size_t j = n; j-- > 0; )
+            solve_column (j, j + 1, n);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void trsm_right (bool upper,
+                 bool trans_a,
+                 bool unit_diag,
+                 std::size_t m,
+                 std::size_t n,
+                 const T *a,
+                 std::size_t lda,
+                 T *b,
+                 std::size_t ldb)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::TRSM_BLOCK;
+
+    if (m == 0 || n == 0)  return;
+    if (n <= NB)  {
+        trsm_right_unblocked_ (upper, trans_a, unit_diag,
+                               m, n, a, lda, b, ldb);
+        return;
+    }
+
+   // Address of element (r, c) of op(A)
+   //
+    const auto  op_a = [a, lda, trans_a](std::size_t r, std::size_t c)  {
+        return (trans_a ? a + c + r * lda : a + r + c * lda);
+    };
+
+    if (upper != trans_a)  {  // op(A) is upper triangular, go forward
+        for (std::size_t j0 = 0; j0 < n; j0 += NB)  {
+            const std::size_t   jb = std::min (NB, n - j0);
+
+            trsm_right_unblocked_ (upper, trans_a, unit_diag, m, jb,
+                                   a + j0 + j0 * lda, lda,
+                                   b + j0 * ldb, ldb);
+            if (j0 + jb < n)
+                gemm (false, trans_a, m, n - j0 - jb, jb,
+                      T(-1), b + j0 * ldb, ldb,
+                      op_a (j0, j0 + jb), lda,
+                      T(1), b + (j0 + jb) * ldb, ldb);
+        }
+    }
+    else  {  // op(A) is lower triangular, go backward
+        for (std::size_t j1 = n; j1 > 0; )  {
+            const std::size_t   jb = std::min (NB, j1);
+            const std::size_t   j0 = j1 - jb;
+
+            trsm_right_unblocked_ (upper, trans_a, unit_diag, m, jb,
+                                   a + j0 + j0 * lda, lda,
+                                   b + j0 * ldb, ldb);
+            if (j0 > 0)
+                gemm (false, trans_a, m, j0, jb,
+                      T(-1), b + j0 * ldb, ldb,
+                      op_a (j0, 0), lda,
+                      T(1), b, ldb);
+            j1 = j0;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Unblocked Cholesky of a diagonal block. Column j of the factor is found
+// from the columns to its left, with unit stride:
+//  -- upper: by dot products down the columns of U
+//  -- lower: by axpys down the columns of L
+//
+template<class T>
+inline bool potf2_ (bool upper, std::size_t n, T *a, std::size_t lda)  {
+
+    for (std::size_t j = 0; j < n; ++j)  {
+        T   *aj = a + j * lda;
+
+        if (upper)  {
+            T   d = aj[j];
+
+            for (std::size_t i = 0; i < j; ++i)  {
+                const T *ai = a + i * lda;
+                T       s = aj[i];
+
+                for (std::size_t k = 0; k < i; ++k)
+                    s -= ai[k] * aj[k];
+                aj[i] = s /= ai[i];
+                d -= s * s;
+            }
+            if (! (d > T(0)))  return (false);
+            aj[j] = std::sqrt (d);
+        }
+        else  {
+            for (std::size_t k = 0; k < j; ++k)  {
+                const T *ak = a + k * lda;
+                const T ljk = ak[j];
+
+                for (std::size_t i = j; i < n; ++i)
+                    aj[i] -= ak[i] * ljk;
+            }
+            if (! (aj[j] > T(0)))  return (false);
+
+            const T d = std::sqrt (aj[j]);
+
+            aj[j] = d;
+            for (std::size_t i = j + 1; i < n; ++i)
+                aj[i] /= d;
+        }
+    }
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+// Right-looking: factor a diagonal block, solve for the block row (or
+// column) next to it and update the trailing matrix.
+//
+template<class T>
+bool potrf (bool upper, std::size_t n, T *a, std::size_t lda)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::POTRF_BLOCK;
+
+    for (std::size_t j = 0; j < n; j += NB)  {
+        const std::size_t   jb = std::min (NB, n - j);
+        T                   *a_jj = a + j + j * lda;
+
+        if (! potf2_ (upper, jb, a_jj, lda))
+            return (false);
+        if (j + jb < n)  {
+            const std::size_t   nr = n - j - jb;
+            T                   *a_22 = a_jj + jb + jb * lda;
+
+            if (upper)  {
+                T   *a_12 = a_jj + jb * lda;
+
+               // U12 = Inverse(~U11) * A12 and A22 = A22 - ~U12 * U12
+               //
+                trsm (true, true, false, jb, nr, a_jj, lda, a_12, lda);
+                syrk (true, true, nr, jb, T(-1), a_12, lda, T(1), a_22, lda);
+            }
+            else  {
+                T   *a_21 = a_jj + jb;
+
+               // L21 = A21 * Inverse(~L11) and A22 = A22 - L21 * ~L21
+               //
+                trsm_right (false, true, false, nr, jb, a_jj, lda, a_21, lda);
+                syrk (false, false, nr, jb, T(-1), a_21, lda,
+                      T(1), a_22, lda);
+            }
+        }
+    }
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void symm (bool upper,
+           std::size_t m,
+           std::size_t n,
+           T alpha,
+           const T *a,
+           std::size_t lda,
+           const T *b,
+           std::size_t ldb,
+           T beta,
+           T *c,
+           std::size_t ldc)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::KC;
+
+    if (m == 0 || n == 0)  return;
+    scale_c_ (m, n, beta, c, ldc);
+    if (alpha == T(0))  return;
+
+    std::vector<T>  diag (std::min (NB, m) * std::min (NB, m));
+
+    for (std::size_t i0 = 0; i0 < m; i0 += NB)  {
+        const std::size_t   ib = std::min (NB, m - i0);
+
+        for (std::size_t j0 = 0; j0 < m; j0 += NB)  {
+            const std::size_t   jb = std::min (NB, m - j0);
+
+            if (i0 == j0)  {
+                const T *a_ii = a + i0 + i0 * lda;
+
+                for (std::size_t cc = 0; cc < ib; ++cc)
+                    for (std::size_t r = 0; r < ib; ++r)
+                        diag[r + cc * ib] = (upper ? r <= cc : r >= cc)
+                            ? a_ii[r + cc * lda] : a_ii[cc + r * lda];
+                gemm (false, false, ib, n, ib,
+                      alpha, diag.data (), ib, b + i0, ldb,
+                      T(1), c + i0, ldc);
+            }
+            else if (upper ? i0 < j0 : i0 > j0)  // A(I, J) is stored
+                gemm (false, false, ib, n, jb,
+                      alpha, a + i0 + j0 * lda, lda, b + j0, ldb,
+                      T(1), c + i0, ldc);
+            else  // A(J, I) is stored
+                gemm (true, false, ib, n, jb,
+                      alpha, a + j0 + i0 * lda, lda, b + j0, ldb,
+                      T(1), c + i0, ldc);
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Recursive halving of the larger dimension, down to blocks that fit in L1
+//
+template<class T>
+void transpose_recursive_ (std::size_t m, std::size_t n,
+                           const T *a, std::size_t lda,
+                           T *b, std::size_t ldb) noexcept  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::TRANSPOSE_BLOCK;
+
+    if (m <= NB && n <= NB)  {
+        for (std::size_t c = 0; c < n; ++c)  {
+            const T *a_col = a + c * lda;
+
+            for (std::size_t r = 0; r < m; ++r)
+                b[c + r * ldb] = a_col[r];
+        }
+    }
+    else if (m >= n)  {
+        const std::size_t   half = m / 2;
+
+        transpose_recursive_ (half, n, a, lda, b, ldb);
+        transpose_recursive_ (m - half, n, a + half, lda, b + half * ldb, ldb);
+    }
+    else  {
+        const std::size_t   half = n / 2;
+
+        transpose_recursive_ (m, half, a, lda, b, ldb);
+        transpose_recursive_ (m, n - half, a + half * lda, lda, b + half, ldb);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void transpose (std::size_t m,
+                std::size_t n,
+                const T *a,
+                std::size_t lda,
+                T *b,
+                std::size_t ldb)  {
+
+    constexpr std::size_t   TILE = GEMMBlocking<T>::MAX_TILE;
+
+    if (m == 0 || n == 0)  return;
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+   // It is bound by memory bandwidth. Only matrices that are many times
+   // the size of a tile are worth waking up the pool for.
+   //
+    if (m * n >= 16 * TILE * TILE && pool.thread_count () > 1)  {
+        const std::size_t   row_tiles = (m + TILE - 1) / TILE;
+        const std::size_t   col_tiles = (n + TILE - 1) / TILE;
+
+        pool.parallel_for (
+            row_tiles * col_tiles,
+            [&](std::size_t tile)  {
+                const std::size_t   i0 = (tile % row_tiles) * TILE;
+                const std::size_t   j0 = (tile / row_tiles) * TILE;
+
+                transpose_recursive_ (std::min (TILE, m - i0),
+                                      std::min (TILE, n - j0),
+                                      a + i0 + j0 * lda, lda,
+                                      b + j0 + i0 * ldb, ldb);
+            });
+    }
+    else
+        transpose_recursive_ (m, n, a, lda, b, ldb);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void transpose_square (std::size_t n, T *a, std::size_t lda)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::TRANSPOSE_BLOCK;
+    constexpr std::size_t   TILE = GEMMBlocking<T>::MAX_TILE;
+
+    if (n < 2)  return;
+
+   // Each task owns a column of blocks on and below the diagonal, and the
+   // mirror images of them. So tasks never touch the same element.
+   //
+    const std::size_t   blocks = (n + NB - 1) / NB;
+    const auto          block_column = [&](std::size_t blk)  {
+        const std::size_t   j0 = blk * NB;
+        const std::size_t   j1 = std::min (j0 + NB, n);
+
+        for (std::size_t j = j0; j < j1; ++j)
+            for (std::size_t i = j + 1; i < j1; ++i)
+                std::swap (a[i + j * lda], a[j + i * lda]);
+
+        for (std::size_t i0 = j1; i0 < n; i0 += NB)  {
+            const std::size_t   i1 = std::min (i0 + NB, n);
+
+            for (std::size_t j = j0; j < j1; ++j)
+                for (std::size_t i = i0; i < i1; ++i)
+                    std::swap (a[i + j * lda], a[j + i * lda]);
+        }
+    };
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    if (n * n >= 16 * TILE * TILE && pool.thread_count () > 1)
+        pool.parallel_for (blocks, block_column);
+    else
+        for (std::size_t blk = 0; blk < blocks; ++blk)
+            block_column (blk);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void transpose_cycles (std::size_t m, std::size_t n, T *a)  {
+
+    if (m < 2 || n < 2)  return;
+    if (m == n)  {
+        transpose_square (n, a, n);
+        return;
+    }
+
+   // The first and the last elements never move
+   //
+    const std::size_t   last = m * n - 1;
+    std::vector<bool>   done (last + 1, false);
+
+    for (std::size_t start = 1; start < last; ++start)  {
+        if (done[start])  continue;
+
+        std::size_t idx = start;
+        T           carried = a[start];
+
+       // Move the carried element to its destination and pick up the one
+       // that was there, until the cycle closes
+       //
+        do  {
+            const std::size_t   dest =
+                static_cast<std::size_t>(
+                    (static_cast<unsigned long long>(idx) * n) % last);
+
+            std::swap (carried, a[dest]);
+            done[dest] = true;
+            idx = dest;
+        } while (idx != start);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Implicit QL with shifts (tql2) on a leaf of stedc(). z is set to the
+// identity and ends up holding the eigenvectors, in ascending order of the
+// eigenvalues. e[i] couples i and i + 1. e[n - 1] is not read, because
+// it couples the leaf to its neighbor.
+//
+template<class T>
+inline void
+stedc_leaf_ (std::size_t n, T *d, const T *e, T *z, std::size_t ldz)  {
+
+    const T         eps = std::numeric_limits<T>::epsilon ();
+    std::vector<T>  ee (n, T(0));
+
+    for (std::size_t i = 0; i + 1 < n; ++i)
+        ee[i] = e[i];
+    for (std::size_t c = 0; c < n; ++c)  {
+        T   *zc = z + c * ldz;
+
+        std::fill (zc, zc + n, T(0));
+        zc[c] = T(1);
+    }
+
+    T   f (0);
+    T   tst1 (0);
+
+    for (std::size_t l = 0; l < n; ++l)  {
+        tst1 = std::max (tst1, std::fabs (d[l]) + std::fabs (ee[l]));
+
+        std::size_t m = l;
+
+        while (std::fabs (ee[m]) > eps * tst1)
+            m += 1;
+
+        while (m > l && std::fabs (ee[l]) > eps * tst1)  {
+            T   g = d[l];
+            T   p = (d[l + 1] - g) / (T(2) * ee[l]);
+            T   r = std::hypot (p, T(1));
+
+            if (p < T(0))  r = -r;
+            d[l] = ee[l] / (p + r);
+            d[l + 1] = ee[l] * (p + r);
+
+            const T dl1 = d[l + 1];
+            T       h = g - d[l];
+
+            for (std::size_t i = l + 2; i < n; ++i)
+                d[i] -= h;
+            f += h;
+
+            p = d[m];
+
+            T       c (1);
+            T       c2 (1);
+            T       c3 (1);
+            T       s (0);
+            T       s2 (0);
+            const T el1 = ee[l + 1];
+
+            for (std::size_t i = m; i-- > l; )  {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                g = c * ee[i];
+                h = c * p;
+                r = std::hypot (p, ee[i]);
+                ee[i + 1] = s * r;
+                s = ee[i] / r;
+                c = p / r;
+                p = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+
+                T   *zi = z + i * ldz;
+                T   *zi1 = zi + ldz;
+
+                for (std::size_t k = 0; k < n; ++k)  {
+                    h = zi1[k];
+                    zi1[k] = s * zi[k] + c * h;
+                    zi[k] = c * zi[k] - s * h;
+                }
+            }
+            p = -s * s2 * c3 * el1 * ee[l] / dl1;
+            ee[l] = s * p;
+            d[l] = c * p;
+        }
+        d[l] += f;
+        ee[l] = T(0);
+    }
+
+    for (std::size_t i = 0; i + 1 < n; ++i)  {
+        std::size_t k = i;
+
+        for (std::size_t j = i + 1; j < n; ++j)
+            if (d[j] < d[k])  k = j;
+        if (k != i)  {
+            std::swap (d[i], d[k]);
+            std::swap_ranges (z + i * ldz, z + i * ldz + n, z + k * ldz);
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The i-th root of the secular equation
+//     1 / rho + sum(z[j]^2 / (d[j] - lambda)) = 0
+// d is strictly ascending, rho > 0 and the root lies in (d[i], d[i + 1]),
+// or in (d[k - 1], d[k - 1] + rho * |z|^2) for the last one.
+//
+// The root is found as an offset from the nearer of the two poles, so
+// delta[j] = d[j] - lambda (returned for all j) is accurate even when
+// lambda is very close to d[i] or d[i + 1]. Each step solves a model with
+// the two poles that bracket the root, which converges quadratically.
+// Steps that leave the bracket fall back to bisection.
+//
+template<class T>
+inline T stedc_secular_ (std::size_t k,
+                         std::size_t i,
+                         const T *d,
+                         const T *z,
+                         T rho,
+                         T *delta)  {
+
+    const T     eps = std::numeric_limits<T>::epsilon ();
+    const bool  last = i + 1 == k;
+    std::size_t org = i;
+    T           lo (0);
+    T           hi;
+
+    if (last)  {
+        T   zz (0);
+
+        for (std::size_t j = 0; j < k; ++j)
+            zz += z[j] * z[j];
+        hi = rho * zz;
+    }
+    else  {
+        const T gap = d[i + 1] - d[i];
+        const T mid = gap / T(2);
+        T       f = T(1) / rho;
+
+        for (std::size_t j = 0; j < k; ++j)
+            f += z[j] * z[j] / ((d[j] - d[i]) - mid);
+
+        if (f >= T(0))
+            hi = mid;
+        else  {
+            org = i + 1;
+            lo = mid - gap;
+            hi = T(0);
+        }
+    }
+
+    const T base = d[org];
+    T       tau = (lo + hi) / T(2);
+    bool    done = false;
+
+    for (int iter = 0; ; ++iter)  {
+        T   psi (0);
+        T   dpsi (0);
+        T   phi (0);
+        T   dphi (0);
+        T   err (0);
+
+        for (std::size_t j = 0; j < k; ++j)  {
+            delta[j] = (d[j] - base) - tau;
+
+            const T t = z[j] / delta[j];
+
+            if (j <= i)  {
+                psi += z[j] * t;
+                dpsi += t * t;
+            }
+            else  {
+                phi += z[j] * t;
+                dphi += t * t;
+            }
+            err += std::fabs (z[j] * t);
+        }
+
+        const T f = T(1) / rho + psi + phi;
+
+        if (done || iter == 100 ||
+            std::fabs (f) <= T(8) * eps * (T(1) / rho + err))
+            break;
+        if (f < T(0))
+            lo = tau;
+        else
+            hi = tau;
+
+       // Model: const + a / (delta[i] - eta) + b / (delta[i + 1] - eta)
+       //
+        const T di = delta[i];
+        T       eta = hi - lo;  // Anything outside the bracket
+
+        if (last)  {
+            const T c = f - dpsi * di;
+
+            if (c > T(0))
+                eta = di + dpsi * di * di / c;
+        }
+        else  {
+            const T di1 = delta[i + 1];
+            const T c = f - dpsi * di - dphi * di1;
+            const T b = c * (di + di1) + dpsi * di * di + dphi * di1 * di1;
+            const T cc = di * di1 * f;
+
+            if (c == T(0))
+                eta = cc / b;
+            else  {
+                const T q = (b + std::copysign (std::sqrt (std::max (
+                                 b * b - T(4) * c * cc, T(0))), b)) / T(2);
+                const T r1 = q / c;
+
+                eta = r1 > di && r1 < di1 ? r1 : cc / q;
+            }
+        }
+
+        T   next = tau + eta;
+
+        if (! (next > lo && (next < hi || (last && next <= hi))))
+            next = (lo + hi) / T(2);
+        done = std::fabs (next - tau) <= T(2) * eps * std::fabs (next) ||
+               hi - lo <= T(4) * eps * std::max (std::fabs (lo),
+                                                 std::fabs (hi));
+        tau = next;
+    }
+    return (base + tau);
+}
+
+// ----------------------------------------------------------------------------
+
+// Merges the eigen decompositions of the two halves of an n X n block of
+// stedc() (Cuppen). The first n1 values of d and the top-left n1 X n1
+// block of q are the eigen decomposition of the first half, the rest of
+// the second. beta couples the halves. On return d and q hold the eigen
+// decomposition of the whole block in ascending order.
+//
+// The rank-one update rho * z * ~z is deflated first: components of z
+// that are negligible, and pairs of close values (after a Givens
+// rotation), give eigenpairs as they are. The rest come from the secular
+// equation and their vectors from the Loewner formula (Gu and Eisenstat),
+// so they are orthogonal. The vectors are multiplied into q with gemm().
+// Columns of q that are zero in the bottom (or top) half are grouped,
+// so the zero blocks are not multiplied.
+//
+template<class T>
+inline void stedc_merge_ (std::size_t n,
+                          std::size_t n1,
+                          T beta,
+                          T *d,
+                          T *q,
+                          std::size_t ldq)  {
+
+    const T     eps = std::numeric_limits<T>::epsilon ();
+    const T     sgn = beta < T(0) ? T(-1) : T(1);
+    const T     rt2 = T(1) / std::sqrt (T(2));
+    std::size_t j;
+
+   // q = diag(Q1, Q2) and z = ~q * (e(n1 - 1) + sgn * e(n1)) / sqrt(2)
+   //
+    std::vector<T>  z (n);
+
+    for (j = 0; j < n1; ++j)  {
+        std::fill (q + j * ldq + n1, q + j * ldq + n, T(0));
+        z[j] = q[n1 - 1 + j * ldq] * rt2;
+    }
+    for (; j < n; ++j)  {
+        std::fill (q + j * ldq, q + j * ldq + n1, T(0));
+        z[j] = sgn * q[n1 + j * ldq] * rt2;
+    }
+
+    const T rho = T(2) * std::fabs (beta);
+
+    std::vector<std::size_t>    perm (n);
+
+    for (j = 0; j < n; ++j)
+        perm[j] = j;
+    std::stable_sort (perm.begin (), perm.end (),
+                      [d](std::size_t a, std::size_t b) -> bool  {
+                          return (d[a] < d[b]);
+                      });
+
+    T   dmax (0);
+    T   zmax (0);
+
+    for (j = 0; j < n; ++j)  {
+        dmax = std::max (dmax, std::fabs (d[j]));
+        zmax = std::max (zmax, std::fabs (z[j]));
+    }
+
+    const T tol = T(8) * eps * std::max (dmax, zmax);
+
+   // 1: only in the top half, 2: in both, 3: only in the bottom half
+   //
+    std::vector<unsigned char>  type (n);
+    std::vector<std::size_t>    kept;
+    std::vector<std::size_t>    defl;
+    std::size_t                 pj = n;
+
+    for (j = 0; j < n; ++j)
+        type[j] = j < n1 ? 1 : 3;
+    kept.reserve (n);
+    defl.reserve (n);
+    for (const std::size_t nj : perm)  {
+        if (rho * std::fabs (z[nj]) <= tol)  {
+            defl.push_back (nj);
+            continue;
+        }
+        if (pj == n)  {
+            pj = nj;
+            continue;
+        }
+
+        const T tau = std::hypot (z[nj], z[pj]);
+        const T c = z[nj] / tau;
+        const T s = -z[pj] / tau;
+
+        if (std::fabs ((d[nj] - d[pj]) * c * s) <= tol)  {
+            T   *qp = q + pj * ldq;
+            T   *qn = q + nj * ldq;
+
+            z[nj] = tau;
+            z[pj] = T(0);
+            for (std::size_t r = 0; r < n; ++r)  {
+                const T x = qp[r];
+
+                qp[r] = c * x + s * qn[r];
+                qn[r] = c * qn[r] - s * x;
+            }
+            if (type[pj] != type[nj])
+                type[nj] = 2;
+
+            const T dp = d[pj] * c * c + d[nj] * s * s;
+
+            d[nj] = d[pj] * s * s + d[nj] * c * c;
+            d[pj] = dp;
+            defl.push_back (pj);
+        }
+        else
+            kept.push_back (pj);
+        pj = nj;
+    }
+    if (pj != n)
+        kept.push_back (pj);
+
+    const std::size_t   k = kept.size ();
+    const std::size_t   nd = defl.size ();
+    std::vector<T>      dl (k);
+    std::vector<T>      zl (k);
+    std::vector<T>      lambda (k);
+    std::vector<T>      s (k * k);
+
+    for (j = 0; j < k; ++j)  {
+        dl[j] = d[kept[j]];
+        zl[j] = z[kept[j]];
+    }
+    for (j = 0; j < k; ++j)
+        lambda[j] =
+            stedc_secular_ (k, j, dl.data (), zl.data (), rho, &s[j * k]);
+
+   // Loewner: the z for which the computed roots are exact. Then
+   // s(:, i) = z / (dl - lambda[i]), normalized.
+   //
+    for (j = 0; j < k; ++j)  {
+        T   w = s[j + j * k];
+
+        for (std::size_t i = 0; i < k; ++i)
+            if (i != j)
+                w *= s[j + i * k] / (dl[j] - dl[i]);
+        zl[j] = std::copysign (std::sqrt (std::max (-w, T(0))), zl[j]);
+    }
+    for (std::size_t i = 0; i < k; ++i)  {
+        T   *si = &s[i * k];
+        T   norm (0);
+
+        for (j = 0; j < k; ++j)  {
+            si[j] = zl[j] / si[j];
+            norm += si[j] * si[j];
+        }
+        norm = std::sqrt (norm);
+        for (j = 0; j < k; ++j)
+            si[j] /= norm;
+    }
+
+   // Kept columns grouped by type, then the deflated ones, sorted
+   //
+    std::vector<std::size_t>    order;
+    std::size_t                 count[4] = { 0, 0, 0, 0 };
+
+    order.reserve (k);
+    for (unsigned char t = 1; t <= 3; ++t)
+        for (j = 0; j < k; ++j)
+            if (type[kept[j]] == t)  {
+                order.push_back (j);
+                count[t] += 1;
+            }
+    std::sort (defl.begin (), defl.end (),
+               [d](std::size_t a, std::size_t b) -> bool  {
+                   return (d[a] < d[b]);
+               });
+
+    std::vector<T>  cols (n * n);
+    std::vector<T>  sp (k * k);
+    std::vector<T>  w (n * k);
+    std::vector<T>  dv (nd);
+
+    for (j = 0; j < k; ++j)  {
+        const T *src = q + kept[order[j]] * ldq;
+
+        std::copy (src, src + n, &cols[j * n]);
+        for (std::size_t i = 0; i < k; ++i)
+            sp[j + i * k] = s[order[j] + i * k];
+    }
+    for (j = 0; j < nd; ++j)  {
+        const T *src = q + defl[j] * ldq;
+
+        std::copy (src, src + n, &cols[(k + j) * n]);
+        dv[j] = d[defl[j]];
+    }
+
+   // Top rows from types 1 and 2, bottom rows from types 2 and 3
+   //
+    const std::size_t   top = count[1] + count[2];
+    const std::size_t   bot = count[2] + count[3];
+
+    if (k > 0)  {
+        if (top > 0)
+            gemm (false, false, n1, k, top, T(1), cols.data (), n,
+                  sp.data (), k, T(0), w.data (), n);
+        else
+            for (j = 0; j < k; ++j)
+                std::fill (&w[j * n], &w[j * n] + n1, T(0));
+        if (bot > 0)
+            gemm (false, false, n - n1, k, bot, T(1),
+                  &cols[n1 + count[1] * n], n, &sp[count[1]], k,
+                  T(0), &w[n1], n);
+        else
+            for (j = 0; j < k; ++j)
+                std::fill (&w[j * n + n1], &w[j * n + n], T(0));
+    }
+
+   // Both the roots and the deflated values are ascending. Merge them.
+   //
+    std::size_t a = 0;
+    std::size_t b = 0;
+
+    for (j = 0; j < n; ++j)  {
+        const T *src;
+
+        if (b == nd || (a < k && lambda[a] <= dv[b]))  {
+            d[j] = lambda[a];
+            src = &w[a++ * n];
+        }
+        else  {
+            d[j] = dv[b];
+            src = &cols[(k + b++) * n];
+        }
+        std::copy (src, src + n, q + j * ldq);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The tridiagonal is split in halves recursively down to leaves of
+// STEDC_LEAF. Each split subtracts |e| from the two diagonal elements next
+// to it, so the halves are independent. The leaves are solved and then
+// the halves merged bottom up. The leaves, and the merges on the same
+// level of the tree, are spread across the threads of the pool. A level
+// with a single merge leaves the pool to gemm().
+//
+template<class T>
+void stedc (std::size_t n, T *d, const T *e, T *z, std::size_t ldz)  {
+
+    constexpr std::size_t   LEAF = GEMMBlocking<T>::STEDC_LEAF;
+
+    struct  Node  {
+
+        std::size_t lo;
+        std::size_t mid;
+        std::size_t hi;
+        T           beta;
+    };
+
+    if (n == 0)  return;
+
+    using Range = std::array<std::size_t, 3>;  // lo, hi, depth
+
+    std::vector<std::vector<Node>>  levels;
+    std::vector<Range>              leaves;
+    std::vector<Range>              stack (1, Range { { 0, n, 0 } });
+
+    while (! stack.empty ())  {
+        const Range         range = stack.back ();
+        const std::size_t   lo = range[0];
+        const std::size_t   hi = range[1];
+        const std::size_t   depth = range[2];
+
+        stack.pop_back ();
+        if (hi - lo <= LEAF)  {
+            leaves.push_back (range);
+            continue;
+        }
+
+        const std::size_t   mid = lo + (hi - lo) / 2;
+        const T             beta = e[mid - 1];
+
+        if (levels.size () <= depth)
+            levels.resize (depth + 1);
+        levels[depth].push_back ({ lo, mid, hi, beta });
+        d[mid - 1] -= std::fabs (beta);
+        d[mid] -= std::fabs (beta);
+        stack.push_back (Range { { lo, mid, depth + 1 } });
+        stack.push_back (Range { { mid, hi, depth + 1 } });
+    }
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    pool.parallel_for (
+        leaves.size (),
+        [&](std::size_t i)  {
+            const std::size_t   lo = leaves[i][0];
+
+            stedc_leaf_ (leaves[i][1] - lo, d + lo, e + lo,
+                         z + lo + lo * ldz, ldz);
+        });
+    for (std::size_t depth = levels.size (); depth-- > 0; )  {
+        const std::vector<Node> &nodes = levels[depth];
+
+        pool.parallel_for (
+            nodes.size (),
+            [&](std::size_t i)  {
+                const Node  &node = nodes[i];
+
+                stedc_merge_ (node.hi - node.lo, node.mid - node.lo,
+                              node.beta, d + node.lo,
+                              z + node.lo + node.lo * ldz, ldz);
+            });
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Householder reflector (larfg). It finds beta and tau so that
+//     (I - tau * v * ~v) * [alpha; x] = [beta; 0]
+// where v = [1; x / (alpha - beta)]. alpha is overwritten by beta and x
+// by the tail of v. x has n elements. If x is zero, tau is zero.
+//
+template<class T>
+inline T larfg_ (std::size_t n, T &alpha, T *x)  {
+
+    T   xnorm (0);
+
+    for (std::size_t i = 0; i < n; ++i)
+        xnorm += x[i] * x[i];
+    if (xnorm == T(0))  return (T(0));
+
+    const T beta = -std::copysign (std::hypot (alpha, std::sqrt (xnorm)),
+                                   alpha);
+    const T scale = T(1) / (alpha - beta);
+    const T tau = (beta - alpha) / beta;
+
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] *= scale;
+    alpha = beta;
+    return (tau);
+}
+
+// ----------------------------------------------------------------------------
+
+// Copies a block of nb reflectors out of the matrix that holds them below
+// its diagonal. a points to where the unit element of the first one would
+// be. v gets the m X nb unit lower trapezoidal V that larft_() takes.
+//
+template<class T>
+inline void reflector_block_ (std::size_t m,
+                              std::size_t nb,
+                              const T *a,
+                              std::size_t lda,
+                              T *v)  {
+
+    for (std::size_t j = 0; j < nb; ++j)  {
+        const T *src = a + j * lda;
+        T       *vj = v + j * m;
+
+        std::fill (vj, vj + j, T(0));
+        vj[j] = T(1);
+        std::copy (src + j + 1, src + m, vj + j + 1);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Triangular factor of a block of reflectors (larft). V is the m X nb unit
+// lower trapezoidal matrix of the vectors (its leading dimension is m) and
+// tau their scalars. It computes the nb X nb upper triangular T such that
+//     H(0) * H(1) * ... * H(nb - 1) = I - V * T * ~V
+// tmp has nb elements.
+//
+template<class T>
+inline void larft_ (std::size_t m,
+                    std::size_t nb,
+                    const T *v,
+                    const T *tau,
+                    T *t,
+                    std::size_t ldt,
+                    T *tmp)  {
+
+    for (std::size_t j = 0; j < nb; ++j)  {
+        const T *vj = v + j * m;
+
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *vp = v + p * m;
+            T       dot (0);
+
+            for (std::size_t r = j; r < m; ++r)
+                dot += vp[r] * vj[r];
+            tmp[p] = -tau[j] * dot;
+        }
+        for (std::size_t p = 0; p < j; ++p)  {
+            T   sum (0);
+
+            for (std::size_t q = p; q < j; ++q)
+                sum += t[p + q * ldt] * tmp[q];
+            t[p + j * ldt] = sum;
+        }
+        t[j + j * ldt] = tau[j];
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Applies a block of reflectors from the left (larfb):
+//     C = (I - V * T * ~V) * C    or    C = (I - V * ~T * ~V) * C
+// depending on trans. V and T are as larft_() made them and C is m X ncols.
+// w is nb X ncols scratch.
+//
+template<class T>
+inline void larfb_ (bool trans,
+                    std::size_t m,
+                    std::size_t ncols,
+                    std::size_t nb,
+                    const T *v,
+                    const T *t,
+                    std::size_t ldt,
+                    T *c,
+                    std::size_t ldc,
+                    T *w)  {
+
+    gemm (true, false, nb, ncols, m, T(1), v, m, c, ldc, T(0), w, nb);
+    for (std::size_t col = 0; col < ncols; ++col)  {
+        T   *wc = w + col * nb;
+
+        if (trans)
+            for (std::size_t p = nb; p-- > 0; )  {
+                T   sum (0);
+
+                for (std::size_t q = 0; q <= p; ++q)
+                    sum += t[q + p * ldt] * wc[q];
+                wc[p] = sum;
+            }
+        else
+            for (std::size_t p = 0; p < nb; ++p)  {
+                T   sum (0);
+
+                for (std::size_t q = p; q < nb; ++q)
+                    sum += t[p + q * ldt] * wc[q];
+                wc[p] = sum;
+            }
+    }
+    gemm (false, false, m, ncols, nb, T(-1), v, m, w, nb, T(1), c, ldc);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// y = A * x, for the n X n symmetric A of which only the lower triangle is
+// read. It is bound by memory. Four columns are done in one pass down the
+// rows, so y and x are loaded once per four columns of A and the four dot
+// products don't wait on each other.
+//
+template<class T>
+inline void
+symv_lower_ (std::size_t n, const T *a, std::size_t lda, const T *x, T *y)  {
+
+    std::size_t c = 0;
+
+    std::fill (y, y + n, T(0));
+    for ( ; c + 4 <= n; c += 4)  {
+        const T *a0 = a + c * lda;
+        const T *a1 = a0 + lda;
+        const T *a2 = a1 + lda;
+        const T *a3 = a2 + lda;
+        const T x0 = x[c];
+        const T x1 = x[c + 1];
+        const T x2 = x[c + 2];
+        const T x3 = x[c + 3];
+        T       d0 = a0[c] * x0 + a0[c + 1] * x1 + a0[c + 2] * x2 +
+                     a0[c + 3] * x3;
+        T       d1 = a0[c + 1] * x0 + a1[c + 1] * x1 + a1[c + 2] * x2 +
+                     a1[c + 3] * x3;
+        T       d2 = a0[c + 2] * x0 + a1[c + 2] * x1 + a2[c + 2] * x2 +
+                     a2[c + 3] * x3;
+        T       d3 = a0[c + 3] * x0 + a1[c + 3] * x1 + a2[c + 3] * x2 +
+                     a3[c + 3] * x3;
+
+        for (std::size_t r = c + 4; r < n; ++r)  {
+            const T xr = x[r];
+
+            y[r] += a0[r] * x0 + a1[r] * x1 + a2[r] * x2 + a3[r] * x3;
+            d0 += a0[r] * xr;
+            d1 += a1[r] * xr;
+            d2 += a2[r] * xr;
+            d3 += a3[r] * xr;
+        }
+        y[c] += d0;
+        y[c + 1] += d1;
+        y[c + 2] += d2;
+        y[c + 3] += d3;
+    }
+    for ( ; c < n; ++c)  {
+        const T *ac = a + c * lda;
+        const T xc = x[c];
+        T       dot (0);
+
+        y[c] += ac[c] * xc;
+        for (std::size_t r = c + 1; r < n; ++r)  {
+            y[r] += ac[r] * xc;
+            dot += ac[r] * x[r];
+        }
+        y[c] += dot;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void symv (std::size_t n, const T *a, std::size_t lda, const T *x, T *y)  {
+
+    symv_lower_ (n, a, lda, x, y);
+}
+
+// ----------------------------------------------------------------------------
+
+// Reduces the nb columns of the panel that starts at column i (latrd).
+// The trailing matrix is not updated. Instead w gets the n X nb matrix W
+// (rows i and above are not used), so the trailing matrix is updated
+// later with
+//     A = A - V * ~W - W * ~V
+// V is the panel below the diagonal, with the unit elements of the
+// reflectors in place of the off diagonal elements (those are in e).
+//
+template<class T>
+inline void sytrd_panel_ (std::size_t n,
+                          std::size_t i,
+                          std::size_t nb,
+                          T *a,
+                          std::size_t lda,
+                          T *e,
+                          T *tau,
+                          T *w,
+                          std::size_t ldw)  {
+
+    std::vector<T>  t (nb);
+
+    for (std::size_t j = 0; j < nb; ++j)  {
+        const std::size_t   c = i + j;
+        T                   *ac = a + c * lda;
+
+       // Apply the earlier reflectors of the panel to this column
+       //
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *ap = a + (i + p) * lda;
+            const T *wp = w + p * ldw;
+            const T wc = wp[c];
+            const T acp = ap[c];
+
+            for (std::size_t r = c; r < n; ++r)
+                ac[r] -= ap[r] * wc + wp[r] * acp;
+        }
+        if (c + 1 == n)  break;
+
+        const std::size_t   m = n - c - 1;
+        T                   *v = ac + c + 1;
+        T                   *wj = w + j * ldw + c + 1;
+
+        tau[c] = larfg_ (m - 1, v[0], v + 1);
+        e[c] = v[0];
+        v[0] = T(1);
+
+       // w = tau * (A - V * ~W - W * ~V) * v on the trailing rows
+       //
+        symv_lower_ (m, a + (c + 1) * (lda + 1), lda, v, wj);
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *wp = w + p * ldw + c + 1;
+            T       dot (0);
+
+            for (std::size_t r = 0; r < m; ++r)
+                dot += wp[r] * v[r];
+            t[p] = dot;
+        }
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *ap = a + (i + p) * lda + c + 1;
+
+            for (std::size_t r = 0; r < m; ++r)
+                wj[r] -= ap[r] * t[p];
+        }
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *ap = a + (i + p) * lda + c + 1;
+            T       dot (0);
+
+            for (std::size_t r = 0; r < m; ++r)
+                dot += ap[r] * v[r];
+            t[p] = dot;
+        }
+        for (std::size_t p = 0; p < j; ++p)  {
+            const T *wp = w + p * ldw + c + 1;
+
+            for (std::size_t r = 0; r < m; ++r)
+                wj[r] -= wp[r] * t[p];
+        }
+
+        T   dot (0);
+
+        for (std::size_t r = 0; r < m; ++r)  {
+            wj[r] *= tau[c];
+            dot += wj[r] * v[r];
+        }
+
+        const T alpha = -tau[c] * dot / T(2);
+
+        for (std::size_t r = 0; r < m; ++r)
+            wj[r] += alpha * v[r];
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Left-looking within a panel of SYTRD_BLOCK columns and right-looking
+// across them: each panel is reduced by sytrd_panel_() and the trailing
+// matrix is updated once with syr2k(). So half of the flops (the syr2k
+// updates) are matrix-matrix operations. The other half are the symmetric
+// matrix-vector products of the panels, which are bound by memory.
+//
+template<class T>
+void sytrd (std::size_t n, T *a, std::size_t lda, T *d, T *e, T *tau)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::SYTRD_BLOCK;
+
+    if (n == 0)  return;
+
+    std::vector<T>  w (n * NB);
+    std::size_t     i = 0;
+
+    for ( ; n - i > NB; i += NB)  {
+        sytrd_panel_ (n, i, NB, a, lda, e, tau, w.data (), n);
+
+        const std::size_t   r = i + NB;
+
+        syr2k (false, false, n - r, NB,
+               T(-1), a + r + i * lda, lda, w.data () + r, n,
+               T(1), a + r * (lda + 1), lda);
+        for (std::size_t c = i; c < r; ++c)
+            a[c + 1 + c * lda] = e[c];
+    }
+    sytrd_panel_ (n, i, n - i, a, lda, e, tau, w.data (), n);
+    for (std::size_t c = i; c + 1 < n; ++c)
+        a[c + 1 + c * lda] = e[c];
+    for (std::size_t c = 0; c < n; ++c)
+        d[c] = a[c * (lda + 1)];
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The reflectors are applied a block at a time, last block first. Each
+// block of nb reflectors is I - V * T * ~V in the compact WY form (larft),
+// so it takes two gemm() calls and a small triangular product.
+//
+template<class T>
+void ormtr (std::size_t n,
+            std::size_t ncols,
+            const T *a,
+            std::size_t lda,
+            const T *tau,
+            T *c,
+            std::size_t ldc)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::SYTRD_BLOCK;
+
+    if (n < 2 || ncols == 0)  return;
+
+    const std::size_t   refs = n - 1;
+    std::vector<T>      v ((n - 1) * NB);
+    std::vector<T>      t (NB * NB);
+    std::vector<T>      w (NB * ncols);
+    std::vector<T>      tmp (NB);
+
+    for (std::size_t k = (refs - 1) / NB * NB; ; k -= NB)  {
+        const std::size_t   nb = std::min (NB, refs - k);
+        const std::size_t   m = n - k - 1;
+        T                   *c_sub = c + k + 1;
+
+       // H(k) * ... * H(k + nb - 1) = I - V * T * ~V
+       //
+        reflector_block_ (m, nb, a + k * lda + k + 1, lda, v.data ());
+        larft_ (m, nb, v.data (), tau + k, t.data (), NB, tmp.data ());
+        larfb_ (false, m, ncols, nb, v.data (), t.data (), NB,
+                c_sub, ldc, w.data ());
+        if (k == 0)  break;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// The panel of QR_BLOCK columns is factored one column at a time. Its
+// reflectors are then applied together to the columns on the right.
+//
+template<class T>
+void geqrf (std::size_t m, std::size_t n, T *a, std::size_t lda, T *tau)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::QR_BLOCK;
+    const std::size_t       refs = std::min (m, n);
+
+    if (refs == 0)  return;
+
+    std::vector<T>  v (m * NB);
+    std::vector<T>  t (NB * NB);
+    std::vector<T>  w (NB * n);
+    std::vector<T>  tmp (NB);
+
+    for (std::size_t k = 0; k < refs; k += NB)  {
+        const std::size_t   nb = std::min (NB, refs - k);
+        const std::size_t   rows = m - k;
+
+        for (std::size_t j = k; j < k + nb; ++j)  {
+            T   *aj = a + j * lda;
+
+            tau[j] = larfg_ (m - j - 1, aj[j], aj + j + 1);
+            if (tau[j] == T(0))  continue;
+
+           // The rest of the panel, one reflector at a time
+           //
+            for (std::size_t c = j + 1; c < k + nb; ++c)  {
+                T   *ac = a + c * lda;
+                T   dot = ac[j];
+
+                for (std::size_t r = j + 1; r < m; ++r)
+                    dot += aj[r] * ac[r];
+                dot *= tau[j];
+                ac[j] -= dot;
+                for (std::size_t r = j + 1; r < m; ++r)
+                    ac[r] -= dot * aj[r];
+            }
+        }
+
+        if (k + nb < n)  {
+            reflector_block_ (rows, nb, a + k * lda + k, lda, v.data ());
+            larft_ (rows, nb, v.data (), tau + k, t.data (), NB, tmp.data ());
+            larfb_ (true, rows, n - k - nb, nb, v.data (), t.data (), NB,
+                    a + (k + nb) * lda + k, lda, w.data ());
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Q is built backwards, a block of reflectors at a time. Before a block is
+// applied its own columns are set to those of the identity. The columns on
+// its right already hold the product of the later blocks.
+//
+template<class T>
+void orgqr (std::size_t m,
+            std::size_t n,
+            T *a,
+            std::size_t lda,
+            const T *tau)  {
+
+    constexpr std::size_t   NB = GEMMBlocking<T>::QR_BLOCK;
+
+    if (n == 0)  return;
+
+    std::vector<T>  v (m * NB);
+    std::vector<T>  t (NB * NB);
+    std::vector<T>  w (NB * n);
+    std::vector<T>  tmp (NB);
+
+    for (std::size_t k = (n - 1) / NB * NB; ; k -= NB)  {
+        const std::size_t   nb = std::min (NB, n - k);
+        const std::size_t   rows = m - k;
+
+        reflector_block_ (rows, nb, a + k * lda + k, lda, v.data ());
+        larft_ (rows, nb, v.data (), tau + k, t.data (), NB, tmp.data ());
+        for (std::size_t j = k; j < k + nb; ++j)  {
+            T   *aj = a + j * lda;
+
+            std::fill (aj, aj + m, T(0));
+            aj[j] = T(1);
+        }
+        larfb_ (false, rows, n - k, nb, v.data (), t.data (), NB,
+                a + k * lda + k, lda, w.data ());
+        if (k == 0)  break;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Each sweep rotates every pair of columns of A (and V) so that they become
+// orthogonal. It stops when a whole sweep finds every pair orthogonal to
+// working precision.
+//
+template<class T>
+bool gesvj (std::size_t m,
+            std::size_t n,
+            T *a,
+            std::size_t lda,
+            T *s,
+            T *v,
+            std::size_t ldv)  {
+
+    constexpr std::size_t   MAX_SWEEPS = 64;
+    const T                 tol =
+        std::numeric_limits<T>::epsilon () * T(std::max<std::size_t> (m, 1));
+    bool                    converged = false;
+
+    for (std::size_t c = 0; c < n; ++c)  {
+        std::fill (v + c * ldv, v + c * ldv + n, T(0));
+        v[c * ldv + c] = T(1);
+    }
+
+    for (std::size_t sweep = 0; sweep < MAX_SWEEPS && ! converged; ++sweep)  {
+        converged = true;
+        for (std::size_t p = 0; p + 1 < n; ++p)
+            for (std::size_t q = p + 1; q < n; ++q)  {
+                T   *ap = a + p * lda;
+                T   *aq = a + q * lda;
+                T   alpha (0);
+                T   beta (0);
+                T   gamma (0);
+
+                for (std::size_t r = 0; r < m; ++r)  {
+                    alpha += ap[r] * ap[r];
+                    beta += aq[r] * aq[r];
+                    gamma += ap[r] * aq[r];
+                }
+                if (std::fabs (gamma) <=
+                        tol * std::sqrt (alpha) * std::sqrt (beta))
+                    continue;
+                converged = false;
+
+               // The rotation that zeroes the off diagonal of the 2 X 2
+               // [alpha gamma; gamma beta]
+               //
+                const T zeta = (beta - alpha) / (T(2) * gamma);
+                const T tan =
+                    std::copysign (T(1), zeta) /
+                    (std::fabs (zeta) + std::sqrt (T(1) + zeta * zeta));
+                const T cs = T(1) / std::sqrt (T(1) + tan * tan);
+                const T sn = cs * tan;
+
+                for (std::size_t r = 0; r < m; ++r)  {
+                    const T x = ap[r];
+
+                    ap[r] = cs * x - sn * aq[r];
+                    aq[r] = sn * x + cs * aq[r];
+                }
+
+                T   *vp = v + p * ldv;
+                T   *vq = v + q * ldv;
+
+                for (std::size_t r = 0; r < n; ++r)  {
+                    const T x = vp[r];
+
+                    vp[r] = cs * x - sn * vq[r];
+                    vq[r] = sn * x + cs * vq[r];
+                }
+            }
+    }
+
+    for (std::size_t c = 0; c < n; ++c)  {
+        T   *ac = a + c * lda;
+        T   norm (0);
+
+        for (std::size_t r = 0; r < m; ++r)
+            norm += ac[r] * ac[r];
+        s[c] = std::sqrt (norm);
+        if (s[c] > T(0))
+            for (std::size_t r = 0; r < m; ++r)
+                ac[r] /= s[c];
+    }
+
+   // Descending order
+   //
+    for (std::size_t c = 0; c + 1 < n; ++c)  {
+        const std::size_t   big = std::max_element (s + c, s + n) - s;
+
+        if (big != c)  {
+            std::swap (s[c], s[big]);
+            std::swap_ranges (a + c * lda, a + c * lda + m, a + big * lda);
+            std::swap_ranges (v + c * ldv, v + c * ldv + n, v + big * ldv);
+        }
+    }
+    return (converged);
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS, class T>
+inline void
+vector_op_scalar_ (std::size_t n, const T *a, const T *b, T *dst) noexcept  {
+
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = MINUS ? a[i] - b[i] : a[i] + b[i];
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Types without a vectorized version
+//
+template<bool MINUS, class T>
+inline void
+vector_op_ (std::size_t n, const T *a, const T *b, T *dst)  {
+
+    vector_op_scalar_<MINUS> (n, a, b, dst);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+#ifdef HMMA_X86_SIMD
+
+enum class  SIMDLevel : unsigned char  {
+    scalar = 0,
+    avx2 = 1,
+    avx512 = 2
+};
+
+// The best instruction set of this CPU, checked only once
+//
+inline SIMDLevel simd_level_ () noexcept  {
+
+    static const SIMDLevel  level = [] ()  {
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+            return (SIMDLevel::avx512);
+        if (__builtin_cpu_supports ("avx2"))
+            return (SIMDLevel::avx2);
+        return (SIMDLevel::scalar);
+    } ();
+
+    return (level);
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+__attribute__ ((target ("avx512f"))) inline void
+vector_op_avx512_ (std::size_t n,
+                   const double *a,
+                   const double *b,
+                   double *dst) noexcept  {
+
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)  {
+        const __m512d   va = _mm512_loadu_pd (a + i);
+        const __m512d   vb = _mm512_loadu_pd (b + i);
+
+        _mm512_storeu_pd (dst + i,
+                          MINUS ? _mm512_sub_pd (va, vb)
+                                : _mm512_add_pd (va, vb));
+    }
+    vector_op_scalar_<MINUS> (n - i, a + i, b + i, dst + i);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+__attribute__ ((target ("avx512f"))) inline void
+vector_op_avx512_ (std::size_t n,
+                   const float *a,
+                   const float *b,
+                   float *dst) noexcept  {
+
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)  {
+        const __m512   va = _mm512_loadu_ps (a + i);
+        const __m512   vb = _mm512_loadu_ps (b + i);
+
+        _mm512_storeu_ps (dst + i,
+                          MINUS ? _mm512_sub_ps (va, vb)
+                                : _mm512_add_ps (va, vb));
+    }
+    vector_op_scalar_<MINUS> (n - i, a + i, b + i, dst + i);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+__attribute__ ((target ("avx2"))) inline void
+vector_op_avx2_ (std::size_t n,
+                 const double *a,
+                 const double *b,
+                 double *dst) noexcept  {
+
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)  {
+        const __m256d   va = _mm256_loadu_pd (a + i);
+        const __m256d   vb = _mm256_loadu_pd (b + i);
+
+        _mm256_storeu_pd (dst + i,
+                          MINUS ? _mm256_sub_pd (va, vb)
+                                : _mm256_add_pd (va, vb));
+    }
+    vector_op_scalar_<MINUS> (n - i, a + i, b + i, dst + i);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+__attribute__ ((target ("avx2"))) inline void
+vector_op_avx2_ (std::size_t n,
+                 const float *a,
+                 const float *b,
+                 float *dst) noexcept  {
+
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)  {
+        const __m256   va = _mm256_loadu_ps (a + i);
+        const __m256   vb = _mm256_loadu_ps (b + i);
+
+        _mm256_storeu_ps (dst + i,
+                          MINUS ? _mm256_sub_ps (va, vb)
+                                : _mm256_add_ps (va, vb));
+    }
+    vector_op_scalar_<MINUS> (n - i, a + i, b + i, dst + i);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+inline void
+vector_op_ (std::size_t n, const double *a, const double *b, double *dst)  {
+
+    switch (simd_level_ ())  {
+        case SIMDLevel::avx512:
+            vector_op_avx512_<MINUS> (n, a, b, dst);
+            break;
+        case SIMDLevel::avx2:
+            vector_op_avx2_<MINUS> (n, a, b, dst);
+            break;
+        default:
+            vector_op_scalar_<MINUS> (n, a, b, dst);
+            break;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<bool MINUS>
+inline void
+vector_op_ (std::size_t n, const float *a, const float *b, float *dst)  {
+
+    switch (simd_level_ ())  {
+        case SIMDLevel::avx512:
+            vector_op_avx512_<MINUS> (n, a, b, dst);
+            break;
+        case SIMDLevel::avx2:
+            vector_op_avx2_<MINUS> (n, a, b, dst);
+            break;
+        default:
+            vector_op_scalar_<MINUS> (n, a, b, dst);
+            break;
+    }
+    return;
+}
+
+#endif // HMMA_X86_SIMD
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void vector_plus (std::size_t n, const T *a, const T *b, T *dst)  {
+
+    vector_op_<false> (n, a, b, dst);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void vector_minus (std::size_t n, const T *a, const T *b, T *dst)  {
+
+    vector_op_<true> (n, a, b, dst);
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
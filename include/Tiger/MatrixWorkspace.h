@@ -0,0 +1,149 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/LUFactorization.h>
+#include <Tiger/Matrix.h>
+
+#include <cstddef>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Scratch space of the decompositions of MAT matrices (e.g. svd(), qrd(),
+// lud(), determinant(), rank() and eigen_space()).
+//
+// The buffers are reused. So a loop of decompositions of the same (or
+// smaller) size stops allocating after the first one. The results are
+// copied into the matrices the caller passes. If they already have the
+// right size, nothing is allocated at all.
+//
+// A buffer is only kept, if it is not bigger than get_keep_bytes()
+// (KEEP_BYTES, 16 MB, by default). Bigger ones are freed when they are
+// given back, so a thread that once decomposed a huge matrix doesn't
+// hold its scratch until it exits. Above the limit reuse saves little
+// anyway, since take() zero-fills the buffer and the decomposition costs
+// far more than the allocation.
+//
+// Each thread has a default workspace (see local()). A workspace can also
+// be passed explicitly. It must not be used by two threads at the same
+// time.
+//
+template<class MAT>
+class   MatrixWorkspace  {
+
+public:
+
+    using MatrixType = MAT;
+    using size_type = typename MatrixType::size_type;
+    using value_type = typename MatrixType::value_type;
+    using Vector = std::vector<value_type>;
+
+    static constexpr size_type      MATRIX_SLOTS = 4;
+    static constexpr size_type      VECTOR_SLOTS = 2;
+    static constexpr std::size_t    KEEP_BYTES = std::size_t(16) << 20;
+
+    MatrixWorkspace () = default;
+    MatrixWorkspace (const MatrixWorkspace &) = delete;
+    MatrixWorkspace &operator = (const MatrixWorkspace &) = delete;
+
+   // The workspace of the calling thread. It outlives any MemoryArena, so
+   // its buffers are always on the global heap.
+   //
+    static MatrixWorkspace &local ();
+
+   // These move the buffer of a slot into mat (or vec), resized and set
+   // to all zeros, and give_back() moves it back. So the decompositions
+   // work on local objects, which compilers optimize better than
+   // references into the workspace.
+   //
+    inline void take (size_type slot,
+                      MatrixType &mat,
+                      size_type rows,
+                      size_type cols);
+    inline void take (size_type slot, Vector &vec, size_type size);
+
+   // It leaves the contents as they were (e.g. to be assigned over)
+   //
+    inline void take (size_type slot, MatrixType &mat) noexcept;
+
+    inline void give_back (size_type slot, MatrixType &mat) noexcept;
+    inline void give_back (size_type slot, Vector &vec) noexcept;
+
+    inline LUFactorization<MatrixType> &lu () noexcept  { return (lu_); }
+
+   // To be called when the caller of lu() is done with it. It frees the
+   // factors, if they are above the limit.
+   //
+    inline void give_back_lu () noexcept;
+
+   // Gives the memory back. Later buffers come from the global heap.
+   //
+    void clear ();
+
+   // Buffers bigger than this many bytes are not kept. Setting it doesn't
+   // free what is kept already (see clear()).
+   //
+    inline std::size_t
+    get_keep_bytes () const noexcept  { return (keep_bytes_); }
+    inline void
+    set_keep_bytes (std::size_t bytes) noexcept  { keep_bytes_ = bytes; }
+
+   // Bytes held in the buffers that are given back
+   //
+    std::size_t held_bytes () const noexcept;
+
+private:
+
+    MatrixType                  matrices_[MATRIX_SLOTS] { };
+    Vector                      vectors_[VECTOR_SLOTS] { };
+    LUFactorization<MatrixType> lu_ { };
+    std::size_t                 keep_bytes_ { KEEP_BYTES };
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/MatrixWorkspace.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,170 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/MatrixWorkspace.h>
+#include <Tiger/MemoryArena.h>
+
+#include <memory>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class MAT>
+constexpr typename MatrixWorkspace<MAT>::size_type
+MatrixWorkspace<MAT>::MATRIX_SLOTS;
+
+template<class MAT>
+constexpr typename MatrixWorkspace<MAT>::size_type
+MatrixWorkspace<MAT>::VECTOR_SLOTS;
+
+template<class MAT>
+constexpr std::size_t   MatrixWorkspace<MAT>::KEEP_BYTES;
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+MatrixWorkspace<MAT> &MatrixWorkspace<MAT>::local ()  {
+
+    static thread_local std::unique_ptr<MatrixWorkspace>    workspace;
+
+    if (! workspace)  {
+        const ScopedArena   heap (nullptr);
+
+        workspace.reset (new MatrixWorkspace);
+    }
+    return (*workspace);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void MatrixWorkspace<MAT>::take (size_type slot,
+                                        MatrixType &mat,
+                                        size_type rows,
+                                        size_type cols)  {
+
+    mat.swap (matrices_[slot]);
+    mat.resize (rows, cols);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+MatrixWorkspace<MAT>::take (size_type slot, Vector &vec, size_type size)  {
+
+    vec.swap (vectors_[slot]);
+    vec.assign (size, value_type(0));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+MatrixWorkspace<MAT>::take (size_type slot, MatrixType &mat) noexcept  {
+
+    mat.swap (matrices_[slot]);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+MatrixWorkspace<MAT>::give_back (size_type slot, MatrixType &mat) noexcept  {
+
+    matrices_[slot].swap (mat);
+    if (std::size_t(matrices_[slot].rows ()) * matrices_[slot].columns () *
+            sizeof(value_type) > keep_bytes_)
+        MatrixType ().swap (matrices_[slot]);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void
+MatrixWorkspace<MAT>::give_back (size_type slot, Vector &vec) noexcept  {
+
+    vectors_[slot].swap (vec);
+    if (vectors_[slot].capacity () * sizeof(value_type) > keep_bytes_)
+        Vector ().swap (vectors_[slot]);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+inline void MatrixWorkspace<MAT>::give_back_lu () noexcept  {
+
+    if (std::size_t(lu_.rows ()) * lu_.columns () * sizeof(value_type) >
+            keep_bytes_)
+        lu_ = LUFactorization<MatrixType> ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+void MatrixWorkspace<MAT>::clear ()  {
+
+    const ScopedArena   heap (nullptr);
+
+    for (auto &mat : matrices_)
+        MatrixType ().swap (mat);
+    for (auto &vec : vectors_)
+        Vector ().swap (vec);
+    lu_ = LUFactorization<MatrixType> ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class MAT>
+std::size_t MatrixWorkspace<MAT>::held_bytes () const noexcept  {
+
+    std::size_t bytes =
+        (std::size_t(lu_.rows ()) * lu_.columns () * sizeof(value_type)) +
+        lu_.get_pivots ().capacity () * sizeof(size_type);
+
+    for (const auto &mat : matrices_)
+        bytes += std::size_t(mat.rows ()) * mat.columns () *
+                 sizeof(value_type);
+    for (const auto &vec : vectors_)
+        bytes += vec.capacity () * sizeof(value_type);
+    return (bytes);
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
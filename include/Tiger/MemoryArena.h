@@ -0,0 +1,228 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+//
+// Arena allocation of matrix data
+//
+// A MemoryArena hands out memory from big chunks by bumping a pointer and
+// gives it all back at once with release(). It is meant for short-lived
+// work (e.g. one request of a service): every matrix and temporary made
+// during the work comes from the arena, so the threads stop contending on
+// the global heap, and the cleanup is a single release().
+//
+// ScopedArena makes an arena the current one of the calling thread.
+// ArenaAllocator, and so the data of ArenaDenseMatrixBase and
+// ArenaSymmMatrixBase matrices, picks the current arena of the thread at
+// construction. Without a current arena it uses the global heap.
+//
+// A matrix must not outlive the arena its data came from. Note that swap()
+// and move assignment hand the arena over with the data.
+//
+// An arena is not thread-safe. Each thread should have its own.
+//
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+class   MemoryArena  {
+
+public:
+
+    using size_type = std::size_t;
+
+    explicit MemoryArena (size_type chunk_size = size_type(1) << 20);
+    ~MemoryArena ();
+
+    MemoryArena (const MemoryArena &) = delete;
+    MemoryArena &operator = (const MemoryArena &) = delete;
+
+    void *allocate (size_type bytes,
+                    size_type alignment = alignof(std::max_align_t));
+
+   // Only the latest allocation is given back to the arena (e.g. a vector
+   // that grows). Everything else waits for release().
+   //
+    void deallocate (void *ptr, size_type bytes) noexcept;
+
+   // Gives back everything. It keeps the largest chunk, so a reused arena
+   // does not go back to the heap.
+   //
+    void release () noexcept;
+
+   // Bytes handed out since the last release()
+   //
+    inline size_type allocated () const noexcept  { return (allocated_); }
+
+   // Bytes taken from the heap
+   //
+    inline size_type reserved () const noexcept  { return (reserved_); }
+
+   // The current arena of the calling thread or nullptr
+   //
+    static inline MemoryArena *current () noexcept  { return (current_ ()); }
+
+private:
+
+    friend class    ScopedArena;
+
+    struct  Chunk_  {
+
+        Chunk_      *next;
+        size_type   size;  // Including this header
+    };
+
+    void new_chunk_ (size_type min_bytes);
+
+    static MemoryArena *&current_ () noexcept;
+
+    Chunk_      *chunks_ { nullptr };  // The latest chunk first
+    char        *ptr_ { nullptr };
+    char        *end_ { nullptr };
+    size_type   chunk_size_;
+    size_type   allocated_ { 0 };
+    size_type   reserved_ { 0 };
+};
+
+// ----------------------------------------------------------------------------
+
+// Makes arena the current arena of the calling thread for its lifetime.
+// Scopes can be nested.
+//
+class   ScopedArena  {
+
+public:
+
+    explicit ScopedArena (MemoryArena &arena) noexcept
+        : previous_ (MemoryArena::current_ ())  {
+
+        MemoryArena::current_ () = &arena;
+    }
+
+   // nullptr means the global heap
+   //
+    explicit ScopedArena (MemoryArena *arena) noexcept
+        : previous_ (MemoryArena::current_ ())  {
+
+        MemoryArena::current_ () = arena;
+    }
+    ~ScopedArena ()  { MemoryArena::current_ () = previous_; }
+
+    ScopedArena (const ScopedArena &) = delete;
+    ScopedArena &operator = (const ScopedArena &) = delete;
+
+private:
+
+    MemoryArena *previous_;
+};
+
+// ----------------------------------------------------------------------------
+
+// A standard allocator on a MemoryArena, or on the global heap if the
+// arena is nullptr. By default it is on the current arena of the thread.
+// Copies of a container get the current arena too, not the arena of the
+// original.
+//
+template<class T>
+class   ArenaAllocator  {
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator () noexcept : arena_ (MemoryArena::current ())  {   }
+    explicit ArenaAllocator (MemoryArena *arena) noexcept
+        : arena_ (arena)  {   }
+    template<class U>
+    ArenaAllocator (const ArenaAllocator<U> &that) noexcept
+        : arena_ (that.arena ())  {   }
+
+    inline T *allocate (size_type n);
+    inline void deallocate (T *ptr, size_type n) noexcept;
+
+    inline ArenaAllocator
+    select_on_container_copy_construction () const noexcept  {
+
+        return (ArenaAllocator ());
+    }
+
+    inline MemoryArena *arena () const noexcept  { return (arena_); }
+
+private:
+
+    MemoryArena *arena_;
+};
+
+template<class T, class U>
+inline bool operator == (const ArenaAllocator<T> &lhs,
+                         const ArenaAllocator<U> &rhs) noexcept  {
+
+    return (lhs.arena () == rhs.arena ());
+}
+
+template<class T, class U>
+inline bool operator != (const ArenaAllocator<T> &lhs,
+                         const ArenaAllocator<U> &rhs) noexcept  {
+
+    return (lhs.arena () != rhs.arena ());
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/MemoryArena.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,165 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/MemoryArena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+inline MemoryArena::MemoryArena (size_type chunk_size)
+    : chunk_size_ (std::max (chunk_size, size_type(4096)))  {   }
+
+// ----------------------------------------------------------------------------
+
+inline MemoryArena::~MemoryArena ()  {
+
+    release ();
+    std::free (chunks_);
+}
+
+// ----------------------------------------------------------------------------
+
+inline void *MemoryArena::allocate (size_type bytes, size_type alignment)  {
+
+    const auto  aligned = [alignment](char *ptr) -> char *  {
+        const std::uintptr_t    p = reinterpret_cast<std::uintptr_t>(ptr);
+
+        return (ptr + (alignment - p % alignment) % alignment);
+    };
+    char        *ptr = ptr_ ? aligned (ptr_) : nullptr;
+
+    if (ptr == nullptr || size_type(end_ - ptr) < bytes)  {
+        new_chunk_ (bytes + alignment);
+        ptr = aligned (ptr_);
+    }
+    ptr_ = ptr + bytes;
+    allocated_ += bytes;
+    return (ptr);
+}
+
+// ----------------------------------------------------------------------------
+
+inline void MemoryArena::deallocate (void *ptr, size_type bytes) noexcept  {
+
+    if (static_cast<char *>(ptr) + bytes == ptr_)
+        ptr_ = static_cast<char *>(ptr);
+}
+
+// ----------------------------------------------------------------------------
+
+inline void MemoryArena::release () noexcept  {
+
+    if (chunks_ == nullptr)  return;
+
+   // The chunks only grow. So the latest one is the largest.
+   //
+    Chunk_  *chunk = chunks_->next;
+
+    while (chunk != nullptr)  {
+        Chunk_  *next = chunk->next;
+
+        reserved_ -= chunk->size;
+        std::free (chunk);
+        chunk = next;
+    }
+    chunks_->next = nullptr;
+    ptr_ = reinterpret_cast<char *>(chunks_ + 1);
+    end_ = reinterpret_cast<char *>(chunks_) + chunks_->size;
+    allocated_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+inline void MemoryArena::new_chunk_ (size_type min_bytes)  {
+
+    size_type   size = chunk_size_;
+
+    if (chunks_ != nullptr)
+        size = std::max (size, chunks_->size * 2);
+    size = std::max (size, min_bytes + sizeof(Chunk_));
+
+    Chunk_  *chunk = static_cast<Chunk_ *>(std::malloc (size));
+
+    if (chunk == nullptr)  throw std::bad_alloc ();
+
+    chunk->next = chunks_;
+    chunk->size = size;
+    chunks_ = chunk;
+    ptr_ = reinterpret_cast<char *>(chunk + 1);
+    end_ = reinterpret_cast<char *>(chunk) + size;
+    reserved_ += size;
+}
+
+// ----------------------------------------------------------------------------
+
+inline MemoryArena *&MemoryArena::current_ () noexcept  {
+
+    static thread_local MemoryArena *arena = nullptr;
+
+    return (arena);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline T *ArenaAllocator<T>::allocate (size_type n)  {
+
+    if (arena_ == nullptr)
+        return (static_cast<T *>(::operator new (n * sizeof(T))));
+    return (static_cast<T *>(arena_->allocate (n * sizeof(T), alignof(T))));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline void ArenaAllocator<T>::deallocate (T *ptr, size_type n) noexcept  {
+
+    if (arena_ == nullptr)
+        ::operator delete (ptr);
+    else
+        arena_->deallocate (ptr, n * sizeof(T));
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,290 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/MatrixBase.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+//
+// Out-of-core (tiled) algorithms
+//
+// These work on matrices that are kept in io_format::binary files (see
+// DenseMatrixStorage::write()) and may be much larger than RAM. A matrix
+// is split into square tiles of OutOfCoreParams::tile_size. Tiles are read
+// and written with pread()/pwrite() and only a bounded number of them is
+// kept in memory at any time. The arithmetic on each tile is done by the
+// in-core kernels (see MatrixKernels.h).
+//
+// While a tile is being computed, the tiles needed next are read ahead by
+// a few I/O threads, so the disk and the CPUs work at the same time.
+//
+// They need POSIX I/O. There is no WIN32 implementation.
+//
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+struct  OutOfCoreParams  {
+
+    std::size_t     memory_budget { std::size_t(1) << 30 };  // Bytes
+    std::size_t     tile_size { 1024 };         // Rows/columns of a tile
+    unsigned int    read_ahead_threads { 2 };   // 0 means no read-ahead
+    std::size_t     read_ahead_depth { 4 };     // Steps read ahead
+};
+
+struct  OutOfCoreStats  {
+
+    std::size_t     tile_reads { 0 };   // Tiles read from files
+    std::size_t     tile_writes { 0 };  // Tiles written to files
+    std::size_t     cache_hits { 0 };   // Tiles found in memory
+    std::size_t     peak_bytes { 0 };   // Most tile memory in use at once
+};
+
+// ----------------------------------------------------------------------------
+
+// A dense matrix in an io_format::binary file, seen as a grid of tiles.
+// Tiles at the bottom and right edges may be smaller than tile_size.
+// A tile is column-major with a leading dimension of tile_rows().
+//
+template<class T>
+class   TiledFile  {
+
+public:
+
+    using size_type = std::size_t;
+    using value_type = T;
+
+   // Opens an existing file. It must be in the native byte order.
+   //
+    TiledFile (const char *file_name, size_type tile_size);
+
+   // Creates (or truncates) a file for a rows X cols matrix. The elements
+   // are all zeros until tiles are written.
+   //
+    TiledFile (const char *file_name,
+               size_type rows,
+               size_type cols,
+               size_type tile_size);
+
+    TiledFile (const TiledFile &) = delete;
+    TiledFile &operator = (const TiledFile &) = delete;
+    ~TiledFile ();
+
+    inline size_type rows () const noexcept  { return (rows_); }
+    inline size_type columns () const noexcept  { return (cols_); }
+    inline size_type tile_size () const noexcept  { return (tile_); }
+
+    inline size_type row_tiles () const noexcept  {
+
+        return ((rows_ + tile_ - 1) / tile_);
+    }
+    inline size_type col_tiles () const noexcept  {
+
+        return ((cols_ + tile_ - 1) / tile_);
+    }
+    inline size_type tile_rows (size_type ti) const noexcept  {
+
+        return (rows_ - ti * tile_ < tile_ ? rows_ - ti * tile_ : tile_);
+    }
+    inline size_type tile_cols (size_type tj) const noexcept  {
+
+        return (cols_ - tj * tile_ < tile_ ? cols_ - tj * tile_ : tile_);
+    }
+
+   // Both are thread-safe. They throw std::runtime_error on I/O errors.
+   //
+    void read_tile (size_type ti, size_type tj, value_type *tile) const;
+    void write_tile (size_type ti, size_type tj, const value_type *tile);
+
+private:
+
+    std::uint64_t element_offset_ (size_type r, size_type c) const noexcept;
+
+    int             fd_ { -1 };
+    size_type       rows_ { 0 };
+    size_type       cols_ { 0 };
+    size_type       tile_ { 0 };
+    std::uint64_t   data_offset_ { 0 };
+};
+
+// ----------------------------------------------------------------------------
+
+// A fixed number of tile buffers shared by one or more TiledFiles.
+// A tile that is acquired stays pinned in memory until it is released.
+// Unpinned tiles are evicted in least-recently-used order. Tiles are only
+// written through put(), so an evicted tile never needs to be written.
+//
+// acquire(), release() and put() are meant to be called by one thread.
+// prefetch() hands tiles to the read-ahead threads.
+//
+template<class T>
+class   TileCache  {
+
+public:
+
+    using size_type = std::size_t;
+    using value_type = T;
+
+    TileCache (size_type slots,
+               size_type tile_size,
+               unsigned int read_ahead_threads);
+    TileCache (const TileCache &) = delete;
+    TileCache &operator = (const TileCache &) = delete;
+    ~TileCache ();
+
+   // It waits for the tile, if it is being read ahead. Otherwise it reads
+   // it on the calling thread. It throws std::runtime_error, if all the
+   // buffers are pinned.
+   //
+    const value_type *acquire (const TiledFile<T> &file,
+                               size_type ti,
+                               size_type tj);
+    void release (const TiledFile<T> &file, size_type ti, size_type tj);
+
+   // Queues a tile for the read-ahead threads. A tile that cannot get a
+   // buffer without evicting a tile that was read ahead, is skipped.
+   //
+    void prefetch (const TiledFile<T> &file, size_type ti, size_type tj);
+
+   // Writes the tile to the file and keeps a copy, if there is room
+   //
+    void put (TiledFile<T> &file,
+              size_type ti,
+              size_type tj,
+              const value_type *tile);
+
+   // A snapshot of the counts. The read-ahead threads may still add to
+   // them.
+   //
+    OutOfCoreStats stats () const;
+
+   // Stops and joins the read-ahead threads and returns the final counts.
+   // Afterwards prefetch() does nothing and every tile is read by
+   // acquire().
+   //
+    OutOfCoreStats finish ();
+
+private:
+
+    using Key_ = std::tuple<const TiledFile<T> *, size_type, size_type>;
+
+    struct  Entry_  {
+
+        size_type       slot { 0 };
+        size_type       pins { 0 };
+        std::size_t     last_use { 0 };
+        bool            ready { false };
+        bool            failed { false };
+        bool            fresh { false };  // Read ahead and not used yet
+    };
+
+    using EntryMap_ = std::map<Key_, Entry_>;
+
+   // Returns a free buffer or evicts an unpinned tile. Fresh tiles are
+   // only evicted, if take_fresh is true. Returns false if there is none.
+   //
+    bool take_slot_ (size_type &slot, bool take_fresh);
+    value_type *slot_data_ (size_type slot);
+    void load_ (typename EntryMap_::iterator iter,
+                std::unique_lock<std::mutex> &lock);
+    void read_ahead_ ();
+
+    const size_type                     tile_elems_;
+    std::vector<std::vector<value_type>> slots_;
+    std::vector<size_type>              free_slots_;
+    size_type                           used_slots_ { 0 };
+    EntryMap_                           entries_;
+    std::deque<Key_>                    queue_;
+    std::size_t                         clock_ { 0 };
+    bool                                stop_ { false };
+    OutOfCoreStats                      stats_;
+    mutable std::mutex                  mutex_;
+    std::condition_variable             loaded_cv_;
+    std::condition_variable             queue_cv_;
+    std::vector<std::thread>            threads_;
+};
+
+// ----------------------------------------------------------------------------
+
+// C = A * B, where A, B and C are io_format::binary files of dense
+// matrices. C is created (or truncated). A and B are only read.
+// It throws NotSolvable, if the dimensions do not match, and
+// std::runtime_error on I/O errors or if the memory budget is smaller
+// than three tiles.
+//
+template<class T>
+OutOfCoreStats
+out_of_core_multiply (const char *a_file,
+                      const char *b_file,
+                      const char *c_file,
+                      const OutOfCoreParams &params = OutOfCoreParams ());
+
+// In-place Cholesky factorization A = L * ~L of the symmetric
+// positive-definite matrix in the io_format::binary file. Only the lower
+// triangle is read and it is overwritten by L. The strict upper triangle
+// is never touched.
+// It throws NotSquare, if A is not square, NotSolvable, if it is not
+// positive-definite (the file is then partially factored), and
+// std::runtime_error like above.
+//
+template<class T>
+OutOfCoreStats
+out_of_core_cholesky (const char *file,
+                      const OutOfCoreParams &params = OutOfCoreParams ());
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/OutOfCore.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,759 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/OutOfCore.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// pread()/pwrite() may do less than asked. These keep at it until all of
+// it is done. caller starts the error message.
+//
+inline void
+pread_all__ (int fd, void *buf, std::size_t bytes, std::uint64_t offset,
+             const char *caller)  {
+
+    char    *ptr = static_cast<char *>(buf);
+
+    while (bytes > 0)  {
+        const ssize_t   n = ::pread (fd, ptr, bytes, off_t(offset));
+
+        if (n < 0 && errno == EINTR)  continue;
+        if (n <= 0)
+            throw std::runtime_error (
+                std::string (caller) + ": " +
+                (n < 0 ? std::strerror (errno) : "Unexpected end of file"));
+        ptr += n;
+        bytes -= std::size_t(n);
+        offset += std::uint64_t(n);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+inline void
+pwrite_all__ (int fd, const void *buf, std::size_t bytes,
+              std::uint64_t offset, const char *caller)  {
+
+    const char  *ptr = static_cast<const char *>(buf);
+
+    while (bytes > 0)  {
+        const ssize_t   n = ::pwrite (fd, ptr, bytes, off_t(offset));
+
+        if (n < 0 && errno == EINTR)  continue;
+        if (n < 0)
+            throw std::runtime_error (std::string (caller) + ": " +
+                                      std::strerror (errno));
+        ptr += n;
+        bytes -= std::size_t(n);
+        offset += std::uint64_t(n);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+TiledFile<T>::TiledFile (const char *file_name, size_type tile_size)
+    : tile_ (tile_size)  {
+
+    if (tile_ == 0)
+        throw std::runtime_error ("TiledFile(): tile_size is zero");
+
+   // A file that is only read, may be read-only
+   //
+    fd_ = ::open (file_name, O_RDWR);
+    if (fd_ < 0)  fd_ = ::open (file_name, O_RDONLY);
+    if (fd_ < 0)
+        throw std::runtime_error (std::string ("TiledFile(): ") +
+                                  file_name + ": " + std::strerror (errno));
+
+    try  {
+        BinaryMatrixHeader  header;
+        struct stat         st;
+
+        std::memset (&header, 0, sizeof(header));
+        if (::fstat (fd_, &st) != 0)
+            throw std::runtime_error (std::string ("TiledFile(): ") +
+                                      std::strerror (errno));
+        if (std::uint64_t(st.st_size) >= sizeof(header))
+            pread_all__ (fd_, &header, sizeof(header), 0, "TiledFile()");
+        if (check_binary_header__<T> (header, std::uint64_t(st.st_size),
+                                      matrix_layout::dense, "TiledFile()"))
+            throw std::runtime_error (
+                "TiledFile(): File is not in the native byte order");
+        if (header.data_size != header.rows * header.columns)
+            throw std::runtime_error ("TiledFile(): File is truncated");
+
+        rows_ = size_type(header.rows);
+        cols_ = size_type(header.columns);
+        data_offset_ = header.data_offset;
+    }
+    catch (...)  {
+        ::close (fd_);
+        throw;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+TiledFile<T>::TiledFile (const char *file_name,
+                         size_type rows,
+                         size_type cols,
+                         size_type tile_size)
+    : rows_ (rows),
+      cols_ (cols),
+      tile_ (tile_size),
+      data_offset_ (sizeof(BinaryMatrixHeader))  {
+
+    if (tile_ == 0)
+        throw std::runtime_error ("TiledFile(): tile_size is zero");
+
+    fd_ = ::open (file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw std::runtime_error (std::string ("TiledFile(): ") +
+                                  file_name + ": " + std::strerror (errno));
+
+    BinaryMatrixHeader  header;
+
+    std::memset (&header, 0, sizeof(header));
+    std::memcpy (header.magic, "TIGERMAT", sizeof(header.magic));
+    header.byte_order = BinaryMatrixHeader::ORDER_MARK;
+    header.version = BinaryMatrixHeader::VERSION;
+    header.elem_type = binary_type_code__<value_type> ();
+    header.elem_size = sizeof(value_type);
+    header.layout = static_cast<std::uint8_t>(matrix_layout::dense);
+    header.rows = rows_;
+    header.columns = cols_;
+    header.data_size = std::uint64_t(rows_) * cols_;
+    header.data_offset = data_offset_;
+
+    try  {
+        pwrite_all__ (fd_, &header, sizeof(header), 0, "TiledFile()");
+        if (::ftruncate (fd_, off_t(data_offset_ +
+                                    header.data_size * sizeof(value_type))))
+            throw std::runtime_error (std::string ("TiledFile(): ") +
+                                      std::strerror (errno));
+    }
+    catch (...)  {
+        ::close (fd_);
+        throw;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+TiledFile<T>::~TiledFile ()  { ::close (fd_); }
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline std::uint64_t TiledFile<T>::
+element_offset_ (size_type r, size_type c) const noexcept  {
+
+    return (data_offset_ +
+            (std::uint64_t(c) * rows_ + r) * sizeof(value_type));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TiledFile<T>::
+read_tile (size_type ti, size_type tj, value_type *tile) const  {
+
+    const size_type tr = tile_rows (ti);
+    const size_type tc = tile_cols (tj);
+
+   // Each column of a tile is contiguous in the file
+   //
+    for (size_type c = 0; c < tc; ++c)
+        pread_all__ (fd_, tile + c * tr, tr * sizeof(value_type),
+                     element_offset_ (ti * tile_, tj * tile_ + c),
+                     "TiledFile::read_tile()");
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TiledFile<T>::
+write_tile (size_type ti, size_type tj, const value_type *tile)  {
+
+    const size_type tr = tile_rows (ti);
+    const size_type tc = tile_cols (tj);
+
+    for (size_type c = 0; c < tc; ++c)
+        pwrite_all__ (fd_, tile + c * tr, tr * sizeof(value_type),
+                      element_offset_ (ti * tile_, tj * tile_ + c),
+                      "TiledFile::write_tile()");
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+TileCache<T>::TileCache (size_type slots,
+                         size_type tile_size,
+                         unsigned int read_ahead_threads)
+    : tile_elems_ (tile_size * tile_size), slots_ (slots)  {
+
+   // Buffers are allocated as they are first used
+   //
+    free_slots_.reserve (slots);
+    for (size_type s = slots; s > 0; --s)
+        free_slots_.push_back (s - 1);
+
+    threads_.reserve (read_ahead_threads);
+    for (unsigned int t = 0; t < read_ahead_threads; ++t)
+        threads_.emplace_back (&TileCache::read_ahead_, this);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+TileCache<T>::~TileCache ()  {
+
+    finish ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+OutOfCoreStats TileCache<T>::stats () const  {
+
+    const std::lock_guard<std::mutex>   guard (mutex_);
+
+    return (stats_);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+OutOfCoreStats TileCache<T>::finish ()  {
+
+    {
+        const std::lock_guard<std::mutex>   guard (mutex_);
+
+        stop_ = true;
+    }
+    queue_cv_.notify_all ();
+    for (auto &thr : threads_)
+        thr.join ();
+    threads_.clear ();
+    return (stats ());
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+typename TileCache<T>::value_type *
+TileCache<T>::slot_data_ (size_type slot)  {
+
+    std::vector<value_type> &buffer = slots_[slot];
+
+    if (buffer.empty ())  {
+        buffer.resize (tile_elems_);
+        used_slots_ += 1;
+        stats_.peak_bytes = used_slots_ * tile_elems_ * sizeof(value_type);
+    }
+    return (buffer.data ());
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+bool TileCache<T>::take_slot_ (size_type &slot, bool take_fresh)  {
+
+    if (! free_slots_.empty ())  {
+        slot = free_slots_.back ();
+        free_slots_.pop_back ();
+        return (true);
+    }
+
+    auto    victim = entries_.end ();
+
+    for (auto iter = entries_.begin (); iter != entries_.end (); ++iter)  {
+        const Entry_    &entry = iter->second;
+
+        if (entry.pins == 0 &&
+            (entry.failed ||
+             (entry.ready && (take_fresh || ! entry.fresh))) &&
+            (victim == entries_.end () ||
+             entry.last_use < victim->second.last_use))
+            victim = iter;
+    }
+    if (victim == entries_.end ())  return (false);
+
+    slot = victim->second.slot;
+    entries_.erase (victim);
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TileCache<T>::load_ (typename EntryMap_::iterator iter,
+                          std::unique_lock<std::mutex> &lock)  {
+
+    Entry_          &entry = iter->second;
+    value_type      *data = slot_data_ (entry.slot);
+    const Key_      key = iter->first;
+
+   // The entry is not ready, so nobody else touches it or evicts it while
+   // the mutex is unlocked.
+   //
+    lock.unlock ();
+    try  {
+        std::get<0>(key)->read_tile (std::get<1>(key), std::get<2>(key),
+                                     data);
+    }
+    catch (...)  {
+        lock.lock ();
+        entry.failed = true;
+        loaded_cv_.notify_all ();
+        throw;
+    }
+    lock.lock ();
+    entry.ready = true;
+    entry.last_use = ++clock_;
+    stats_.tile_reads += 1;
+    loaded_cv_.notify_all ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+const typename TileCache<T>::value_type *
+TileCache<T>::acquire (const TiledFile<T> &file, size_type ti, size_type tj) {
+
+    std::unique_lock<std::mutex>    lock (mutex_);
+    const Key_                      key (&file, ti, tj);
+
+    while (true)  {
+        auto    iter = entries_.find (key);
+
+        if (iter != entries_.end ())  {
+            Entry_  &entry = iter->second;
+
+            if (! entry.ready && ! entry.failed)  {
+                entry.pins += 1;
+                loaded_cv_.wait (lock, [&entry]() -> bool {
+                    return (entry.ready || entry.failed);
+                });
+                entry.pins -= 1;
+            }
+            if (entry.failed)  {
+               // Read it again on this thread to get the error
+               //
+                free_slots_.push_back (entry.slot);
+                entries_.erase (iter);
+                continue;
+            }
+            entry.pins += 1;
+            entry.fresh = false;
+            entry.last_use = ++clock_;
+            stats_.cache_hits += 1;
+            return (slots_[entry.slot].data ());
+        }
+
+        size_type   slot;
+
+        if (! take_slot_ (slot, true))  {
+            const bool  in_flight =
+                std::any_of (entries_.begin (), entries_.end (),
+                             [](const typename EntryMap_::value_type &e)  {
+                                 return (! e.second.ready &&
+                                         ! e.second.failed);
+                             });
+
+            if (! in_flight)
+                throw std::runtime_error (
+                    "TileCache::acquire(): All tile buffers are pinned");
+            loaded_cv_.wait (lock);
+            continue;
+        }
+
+        iter = entries_.emplace (key, Entry_ ()).first;
+        iter->second.slot = slot;
+        iter->second.pins = 1;
+        try  {
+            load_ (iter, lock);
+        }
+        catch (...)  {
+            free_slots_.push_back (slot);
+            entries_.erase (iter);
+            throw;
+        }
+        return (slots_[slot].data ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TileCache<T>::
+release (const TiledFile<T> &file, size_type ti, size_type tj)  {
+
+    const std::lock_guard<std::mutex>   guard (mutex_);
+    auto                                iter =
+        entries_.find (Key_ (&file, ti, tj));
+
+    if (iter != entries_.end () && iter->second.pins > 0)  {
+        iter->second.pins -= 1;
+        iter->second.last_use = ++clock_;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TileCache<T>::
+prefetch (const TiledFile<T> &file, size_type ti, size_type tj)  {
+
+    if (threads_.empty ())  return;
+
+    {
+        const std::lock_guard<std::mutex>   guard (mutex_);
+        const Key_                          key (&file, ti, tj);
+
+        if (entries_.find (key) != entries_.end ())  return;
+        queue_.push_back (key);
+    }
+    queue_cv_.notify_one ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TileCache<T>::put (TiledFile<T> &file,
+                        size_type ti,
+                        size_type tj,
+                        const value_type *tile)  {
+
+    file.write_tile (ti, tj, tile);
+
+    std::unique_lock<std::mutex>    lock (mutex_);
+    const Key_                      key (&file, ti, tj);
+    auto                            iter = entries_.find (key);
+    const std::size_t               bytes =
+        file.tile_rows (ti) * file.tile_cols (tj) * sizeof(value_type);
+
+    stats_.tile_writes += 1;
+    if (iter != entries_.end ())  {
+        Entry_  &entry = iter->second;
+
+       // A read-ahead of the old tile may be in flight
+       //
+        entry.pins += 1;
+        loaded_cv_.wait (lock, [&entry]() -> bool {
+            return (entry.ready || entry.failed);
+        });
+        entry.pins -= 1;
+        if (! entry.failed)  {
+            std::memcpy (slots_[entry.slot].data (), tile, bytes);
+            entry.fresh = false;
+            entry.last_use = ++clock_;
+            return;
+        }
+        free_slots_.push_back (entry.slot);
+        entries_.erase (iter);
+    }
+
+    size_type   slot;
+
+    if (take_slot_ (slot, false))  {
+        Entry_  &entry = entries_[key];
+
+        std::memcpy (slot_data_ (slot), tile, bytes);
+        entry.slot = slot;
+        entry.ready = true;
+        entry.last_use = ++clock_;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void TileCache<T>::read_ahead_ ()  {
+
+    std::unique_lock<std::mutex>    lock (mutex_);
+
+    while (true)  {
+        queue_cv_.wait (lock, [this]() -> bool {
+            return (stop_ || ! queue_.empty ());
+        });
+        if (stop_)  return;
+
+        const Key_  key = queue_.front ();
+        size_type   slot;
+
+        queue_.pop_front ();
+        if (entries_.find (key) != entries_.end () ||
+            ! take_slot_ (slot, false))
+            continue;
+
+        auto    iter = entries_.emplace (key, Entry_ ()).first;
+
+        iter->second.slot = slot;
+        iter->second.fresh = true;
+        try  {
+            load_ (iter, lock);
+        }
+        catch (...)  {
+           // acquire() reads it again and reports the error
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Number of tile buffers that fit in the budget. It throws, if there are
+// not enough of them for the working set.
+//
+template<class T>
+inline std::size_t
+out_of_core_tiles__ (const OutOfCoreParams &params, const char *caller)  {
+
+    if (params.tile_size == 0)
+        throw std::runtime_error (std::string (caller) +
+                                  ": tile_size is zero");
+
+    const std::size_t   tiles =
+        params.memory_budget /
+        (params.tile_size * params.tile_size * sizeof(T));
+
+    if (tiles < 3)
+        throw std::runtime_error (
+            std::string (caller) +
+            ": memory_budget is smaller than three tiles");
+    return (tiles);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+OutOfCoreStats
+out_of_core_multiply (const char *a_file,
+                      const char *b_file,
+                      const char *c_file,
+                      const OutOfCoreParams &params)  {
+
+    using size_type = std::size_t;
+
+    const size_type     tiles =
+        out_of_core_tiles__<T> (params, "out_of_core_multiply()");
+    const TiledFile<T>  a (a_file, params.tile_size);
+    const TiledFile<T>  b (b_file, params.tile_size);
+
+    if (a.columns () != b.rows ())  throw NotSolvable ();
+
+    TiledFile<T>        c (c_file, a.rows (), b.columns (), params.tile_size);
+
+   // One buffer is the tile of C being computed. The cache gets the rest.
+   // Every step pins a tile of A and a tile of B, and it reads ahead two
+   // tiles for each step ahead.
+   //
+    const size_type     slots = tiles - 1;
+    const size_type     depth =
+        std::min (params.read_ahead_depth, (slots - 2) / 2);
+    TileCache<T>        cache (slots, params.tile_size,
+                               depth > 0 ? params.read_ahead_threads : 0);
+    std::vector<T>      c_tile (params.tile_size * params.tile_size);
+    const size_type     rt = a.row_tiles ();
+    const size_type     ct = b.col_tiles ();
+    const size_type     pt = a.col_tiles ();
+    const size_type     steps = rt * ct * pt;
+
+   // Step s is C(i, j) += A(i, p) * B(p, j) with p running fastest, then
+   // i, then j. That keeps the column of tiles of B in the cache, while
+   // the row of tiles of A streams through.
+   //
+    const auto  prefetch = [&](size_type s) -> void  {
+        if (s < steps)  {
+            const size_type j = s / (rt * pt);
+            const size_type i = (s / pt) % rt;
+            const size_type p = s % pt;
+
+            cache.prefetch (a, i, p);
+            cache.prefetch (b, p, j);
+        }
+    };
+    size_type   writes = 0;
+
+    for (size_type s = 1; s <= depth; ++s)
+        prefetch (s);
+    for (size_type s = 0; s < steps; ++s)  {
+        const size_type j = s / (rt * pt);
+        const size_type i = (s / pt) % rt;
+        const size_type p = s % pt;
+        const size_type tr = a.tile_rows (i);
+        const size_type tc = b.tile_cols (j);
+        const size_type tk = a.tile_cols (p);
+
+        if (depth > 0)  prefetch (s + depth);
+
+        const T *a_tile = cache.acquire (a, i, p);
+        const T *b_tile = cache.acquire (b, p, j);
+
+        gemm<T> (false, false, tr, tc, tk, T(1), a_tile, tr, b_tile, tk,
+                 p == 0 ? T(0) : T(1), c_tile.data (), tr);
+        cache.release (a, i, p);
+        cache.release (b, p, j);
+        if (p + 1 == pt)  {
+            c.write_tile (i, j, c_tile.data ());
+            writes += 1;
+        }
+    }
+
+    OutOfCoreStats  stats = cache.finish ();
+
+    stats.tile_writes += writes;
+    stats.peak_bytes += c_tile.size () * sizeof(T);
+    return (stats);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+OutOfCoreStats
+out_of_core_cholesky (const char *file, const OutOfCoreParams &params)  {
+
+    using size_type = std::size_t;
+
+    const size_type tiles =
+        out_of_core_tiles__<T> (params, "out_of_core_cholesky()");
+    TiledFile<T>    a (file, params.tile_size);
+
+    if (a.rows () != a.columns ())  throw NotSquare ();
+
+   // One buffer is the tile being computed. The cache gets the rest.
+   //
+    const size_type slots = tiles - 1;
+    const size_type depth =
+        std::min (params.read_ahead_depth, (slots - 2) / 2);
+    TileCache<T>    cache (slots, params.tile_size,
+                           depth > 0 ? params.read_ahead_threads : 0);
+    std::vector<T>  w (params.tile_size * params.tile_size);
+    const size_type nt = a.row_tiles ();
+
+   // It is left-looking. Column of tiles j is done after all the columns
+   // to its left and tile (i, j) is:
+   //     W = A(i, j) - sum(L(i, k) * ~L(j, k)),  k < j
+   //     L(j, j) = chol(W)  or  L(i, j) = W * ~L(j, j)^-1
+   //
+    for (size_type j = 0; j < nt; ++j)  {
+        const size_type tn = a.tile_rows (j);
+
+        for (size_type i = j; i < nt; ++i)  {
+            const size_type tm = a.tile_rows (i);
+
+            if (depth > 0)  {
+                const size_type ni = i + 1 < nt ? i + 1 : j + 1;
+                const size_type nj = i + 1 < nt ? j : j + 1;
+
+                if (ni < nt)  {
+                    cache.prefetch (a, ni, nj);
+                    for (size_type k = 0; k < std::min (nj, depth); ++k)  {
+                        cache.prefetch (a, ni, k);
+                        cache.prefetch (a, nj, k);
+                    }
+                }
+            }
+
+            const T *a_tile = cache.acquire (a, i, j);
+
+            std::copy (a_tile, a_tile + tm * tn, w.data ());
+            cache.release (a, i, j);
+
+            for (size_type k = 0; k < j; ++k)  {
+                const size_type tk = a.tile_cols (k);
+
+                if (depth > 0 && k + depth < j)  {
+                    cache.prefetch (a, i, k + depth);
+                    cache.prefetch (a, j, k + depth);
+                }
+
+                const T *ljk = cache.acquire (a, j, k);
+
+                if (i == j)
+                    syrk<T> (false, false, tn, tk, T(-1), ljk, tn,
+                             T(1), w.data (), tn);
+                else  {
+                    const T *lik = cache.acquire (a, i, k);
+
+                    gemm<T> (false, true, tm, tn, tk, T(-1), lik, tm,
+                             ljk, tn, T(1), w.data (), tm);
+                    cache.release (a, i, k);
+                }
+                cache.release (a, j, k);
+            }
+
+            if (i == j)  {
+                if (! potrf<T> (false, tn, w.data (), tn))
+                    throw NotSolvable ();
+            }
+            else  {
+                const T *ljj = cache.acquire (a, j, j);
+
+                trsm_right<T> (false, true, false, tm, tn, ljj, tn,
+                               w.data (), tm);
+                cache.release (a, j, j);
+            }
+            cache.put (a, i, j, w.data ());
+        }
+    }
+
+    OutOfCoreStats  stats = cache.finish ();
+
+    stats.peak_bytes += w.size () * sizeof(T);
+    return (stats);
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,333 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/Matrix.h>
+
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+//
+// Factorizations of symmetric matrices in packed storage
+//
+// SymmMatrixBase keeps only the upper triangle, row by row, in
+// n * (n + 1) / 2 elements. Read by columns, that is the lower triangle
+// in column-major order, so column j of the lower triangle (rows j ... n-1)
+// is contiguous. The routines below work directly on that packed array,
+// one column at a time with unit stride, and leave the factors in it.
+// Nothing is ever expanded into a full n X n matrix.
+//
+// SymmRFPMatrixBase keeps the same number of elements as three ordinary
+// column-major blocks. RFPCholeskyFactorization hands those blocks to the
+// blocked dense kernels instead.
+//
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Cholesky factorization of a symmetric positive-definite matrix in packed
+// storage:
+//     A = ~R * R
+//
+// where R is upper triangular. It is the same factor chod() returns.
+// After factorization, element (r, c) of the packed matrix with r <= c is
+// R(r, c). The symmetric view of the packed factor (i.e. operator() with
+// r > c) doesn't mean anything.
+//
+// It is a left-looking factorization by blocks of columns. All the
+// updates from the already factored columns are applied to a whole block
+// at once, so they are read once per block instead of once per column.
+// The update is split by rows across the threads of ThreadPool::instance()
+// when it is large enough.
+//
+// If the matrix is moved into the constructor, it is factored in place
+// and no other memory is used.
+//
+template<class T>
+class   PackedCholeskyFactorization  {
+
+public:
+
+    using value_type = T;
+    using SymmMatrix = Matrix<SymmMatrixBase, value_type>;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+    using size_type = typename SymmMatrix::size_type;
+
+    PackedCholeskyFactorization () = default;
+    explicit PackedCholeskyFactorization (const SymmMatrix &mat);
+    explicit PackedCholeskyFactorization (SymmMatrix &&mat);
+
+   // They throw NotSolvable if mat is not positive-definite
+   //
+    void factorize (const SymmMatrix &mat); // throw (NotSolvable)
+    void factorize (SymmMatrix &&mat); // throw (NotSolvable)
+
+    inline size_type rows () const noexcept  { return (factor_.rows ()); }
+    inline size_type
+    columns () const noexcept  { return (factor_.columns ()); }
+
+    inline const SymmMatrix &
+    get_packed_factor () const noexcept  { return (factor_); }
+
+   // Move the packed factor out. This object is empty afterwards.
+   //
+    inline SymmMatrix release_packed_factor () noexcept;
+
+   // A = ~U * U = L * ~L, in full matrices
+   //
+    template<class MAT2>
+    inline void get_upper (MAT2 &U) const;
+    template<class MAT2>
+    inline void get_lower (MAT2 &L) const;
+
+    inline value_type determinant () const noexcept;
+
+   // Solve A * X = rhs and return X. rhs can have any number of columns.
+   //
+    template<class MAT2>
+    inline MAT2
+    cholesky_solve (const MAT2 &rhs) const; // throw (NotSolvable)
+
+   // Same as above, but X overwrites rhs. If rhs is a dense matrix,
+   // nothing is allocated.
+   //
+    template<class MAT2>
+    inline MAT2 &
+    cholesky_solve_in_place (MAT2 &rhs) const; // throw (NotSolvable)
+
+   // Inverse of A, also in packed storage. It is computed in the memory
+   // of that, as Inverse(R) * ~Inverse(R).
+   //
+    inline SymmMatrix &cholesky_inverse (SymmMatrix &that) const;
+
+private:
+
+   // Width of the blocks of columns
+   //
+    static constexpr size_type  BLOCK_ = 64;
+
+    static inline void pptrf_ (size_type n, value_type *ap);
+    static inline void pptri_ (size_type n, value_type *ap) noexcept;
+
+    template<class MAT2>
+    inline void solve_in_place_ (MAT2 &rhs) const;
+    inline void solve_in_place_ (DenseMatrix &rhs) const;
+
+    SymmMatrix  factor_ { };
+};
+
+// ----------------------------------------------------------------------------
+
+// Bunch-Kaufman factorization of a symmetric, possibly indefinite, matrix
+// in packed storage:
+//     P * A * ~P = L * D * ~L
+//
+// where P is a permutation matrix, L is unit lower triangular and D is
+// block diagonal with 1 X 1 and 2 X 2 blocks. The pivots are chosen so
+// that the elements of L stay bounded, which makes it stable without
+// requiring positive-definiteness.
+//
+// L and D overwrite the packed matrix, the same way LAPACK's SPTRF does
+// for a lower packed matrix. The pivots are kept in the LAPACK convention
+// (but 0 based):
+//  -- If pivots[k] >= 0, D(k, k) is a 1 X 1 block and rows and columns
+//     k and pivots[k] were interchanged.
+//  -- If pivots[k] = pivots[k + 1] < 0, D(k:k+1, k:k+1) is a 2 X 2 block
+//     and rows and columns k + 1 and -pivots[k] - 1 were interchanged.
+//
+// If the matrix is moved into the constructor, it is factored in place
+// and no other memory is used, besides the pivots.
+//
+template<class T>
+class   PackedLDLFactorization  {
+
+public:
+
+    using value_type = T;
+    using SymmMatrix = Matrix<SymmMatrixBase, value_type>;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+    using size_type = typename SymmMatrix::size_type;
+    using PivotVector = std::vector<long>;
+
+    PackedLDLFactorization () = default;
+    explicit PackedLDLFactorization (const SymmMatrix &mat);
+    explicit PackedLDLFactorization (SymmMatrix &&mat);
+
+    void factorize (const SymmMatrix &mat);
+    void factorize (SymmMatrix &&mat);
+
+    inline size_type rows () const noexcept  { return (factor_.rows ()); }
+    inline size_type
+    columns () const noexcept  { return (factor_.columns ()); }
+
+    inline const SymmMatrix &
+    get_packed_factor () const noexcept  { return (factor_); }
+    inline const PivotVector &
+    get_pivots () const noexcept  { return (pivots_); }
+
+   // Move the packed factor out. This object is empty afterwards.
+   //
+    inline SymmMatrix release_packed_factor () noexcept;
+
+   // At least one of the D blocks is singular
+   //
+    inline bool is_singular () const noexcept;
+
+    inline value_type determinant () const noexcept;
+
+   // Solve A * X = rhs and return X. rhs can have any number of columns.
+   //
+    template<class MAT2>
+    inline MAT2
+    solve (const MAT2 &rhs) const; // throw (NotSolvable, Singular)
+
+   // Same as above, but X overwrites rhs. If rhs is a dense matrix,
+   // nothing is allocated.
+   //
+    template<class MAT2>
+    inline MAT2 &
+    solve_in_place (MAT2 &rhs) const; // throw (NotSolvable, Singular)
+
+private:
+
+    static inline void
+    sptrf_ (size_type n, value_type *ap, long *pivots) noexcept;
+
+    template<class MAT2>
+    inline void solve_in_place_ (MAT2 &rhs) const;
+    inline void solve_in_place_ (DenseMatrix &rhs) const;
+
+    SymmMatrix  factor_ { };
+    PivotVector pivots_ { };
+};
+
+// ----------------------------------------------------------------------------
+
+// Cholesky factorization of a symmetric positive-definite matrix in
+// Rectangular Full Packed storage:
+//     A = L * ~L
+//
+// L overwrites the RFP array, the same way LAPACK's PFTRF does it. After
+// factorization, element (r, c) of the RFP matrix with r >= c is L(r, c).
+// The symmetric view of the factor (i.e. operator() with r < c) doesn't
+// mean anything.
+//
+// With the blocks of SymmRFPMatrixBase, it is
+//     L11 = chol(A11),  L21 = A21 * Inverse(~L11),
+//     L22 = chol(A22 - L21 * ~L21)
+// done by potrf(), trsm_right(), syrk() and potrf(). So it runs at the
+// speed of the blocked dense factorization in half the memory. The solves
+// are done by trsm() and gemm() too.
+//
+// If the matrix is moved into the constructor, it is factored in place
+// and no other memory is used.
+//
+template<class T>
+class   RFPCholeskyFactorization  {
+
+public:
+
+    using value_type = T;
+    using RFPMatrix = Matrix<SymmRFPMatrixBase, value_type>;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+    using size_type = typename RFPMatrix::size_type;
+
+    RFPCholeskyFactorization () = default;
+    explicit RFPCholeskyFactorization (const RFPMatrix &mat);
+    explicit RFPCholeskyFactorization (RFPMatrix &&mat);
+
+   // They throw NotSolvable if mat is not positive-definite
+   //
+    void factorize (const RFPMatrix &mat); // throw (NotSolvable)
+    void factorize (RFPMatrix &&mat); // throw (NotSolvable)
+
+    inline size_type rows () const noexcept  { return (factor_.rows ()); }
+    inline size_type
+    columns () const noexcept  { return (factor_.columns ()); }
+
+    inline const RFPMatrix &
+    get_rfp_factor () const noexcept  { return (factor_); }
+
+   // Move the RFP factor out. This object is empty afterwards.
+   //
+    inline RFPMatrix release_rfp_factor () noexcept;
+
+   // A = ~U * U = L * ~L, in full matrices
+   //
+    template<class MAT2>
+    inline void get_upper (MAT2 &U) const;
+    template<class MAT2>
+    inline void get_lower (MAT2 &L) const;
+
+    inline value_type determinant () const noexcept;
+
+   // Solve A * X = rhs and return X. rhs can have any number of columns.
+   //
+    template<class MAT2>
+    inline MAT2
+    cholesky_solve (const MAT2 &rhs) const; // throw (NotSolvable)
+
+   // Same as above, but X overwrites rhs. If rhs is a dense matrix,
+   // nothing is allocated.
+   //
+    template<class MAT2>
+    inline MAT2 &
+    cholesky_solve_in_place (MAT2 &rhs) const; // throw (NotSolvable)
+
+private:
+
+    static inline void pftrf_ (size_type n, value_type *a);
+
+    template<class MAT2>
+    inline void solve_in_place_ (MAT2 &rhs) const;
+    inline void solve_in_place_ (DenseMatrix &rhs) const;
+
+    RFPMatrix   factor_ { };
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/PackedFactorization.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,971 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/PackedFactorization.h>
+#include <Tiger/MatrixKernels.h>
+
+#include <algorithm>
+#include <utility>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+constexpr typename PackedCholeskyFactorization<T>::size_type
+PackedCholeskyFactorization<T>::BLOCK_;
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+PackedCholeskyFactorization<T>::
+PackedCholeskyFactorization (const SymmMatrix &mat)  {
+
+    factorize (mat);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+PackedCholeskyFactorization<T>::
+PackedCholeskyFactorization (SymmMatrix &&mat)  {
+
+    factorize (std::move (mat));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void PackedCholeskyFactorization<T>::factorize (const SymmMatrix &mat)  {
+
+    SymmMatrix  tmp = mat;
+
+    factorize (std::move (tmp));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void PackedCholeskyFactorization<T>::factorize (SymmMatrix &&mat)  {
+
+    if (! mat.empty ())
+        pptrf_ (mat.rows (), &(*mat.col_begin ()));
+    factor_.swap (mat);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename PackedCholeskyFactorization<T>::SymmMatrix
+PackedCholeskyFactorization<T>::release_packed_factor () noexcept  {
+
+    SymmMatrix  tmp;
+
+    tmp.swap (factor_);
+    return (tmp);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline void PackedCholeskyFactorization<T>::get_upper (MAT2 &U) const  {
+
+    const size_type n = factor_.rows ();
+
+    U.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = 0; r <= c; ++r)
+            U (r, c) = factor_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline void PackedCholeskyFactorization<T>::get_lower (MAT2 &L) const  {
+
+    const size_type n = factor_.rows ();
+
+    L.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = 0; r <= c; ++r)
+            L (c, r) = factor_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename PackedCholeskyFactorization<T>::value_type
+PackedCholeskyFactorization<T>::determinant () const noexcept  {
+
+    value_type  result (1.0);
+
+    for (size_type i = 0; i < factor_.rows (); ++i)
+        result *= factor_ (i, i) * factor_ (i, i);
+
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2
+PackedCholeskyFactorization<T>::cholesky_solve (const MAT2 &rhs) const  {
+
+    MAT2    sol = rhs;
+
+    return (cholesky_solve_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2 &
+PackedCholeskyFactorization<T>::cholesky_solve_in_place (MAT2 &rhs) const  {
+
+    if (rhs.rows () != factor_.rows ())
+        throw NotSolvable ();
+
+    solve_in_place_ (rhs);
+    return (rhs);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename PackedCholeskyFactorization<T>::SymmMatrix &
+PackedCholeskyFactorization<T>::cholesky_inverse (SymmMatrix &that) const  {
+
+    that = factor_;
+    if (! that.empty ())
+        pptri_ (that.rows (), &(*that.col_begin ()));
+    return (that);
+}
+
+// ----------------------------------------------------------------------------
+
+// Left-looking Cholesky of the packed lower triangle: A = L * ~L.
+// For every block of columns, first the updates from all the columns to
+// its left are applied, then the block itself is factored column by
+// column.
+//
+template<class T>
+inline void
+PackedCholeskyFactorization<T>::pptrf_ (size_type n, value_type *ap)  {
+
+    using Blocking = GEMMBlocking<value_type>;
+
+    ThreadPool  &pool = ThreadPool::instance ();
+
+    for (size_type j0 = 0; j0 < n; j0 += BLOCK_)  {
+        const size_type j1 = std::min (size_type(j0 + BLOCK_), n);
+
+       // A(j0:n, j0:j1) -= L(j0:n, 0:j0) * ~L(j0:j1, 0:j0)
+       //
+       // It is split into ranges of rows, so every thread reads its own
+       // part of the factored columns once.
+       //
+        const auto  update = [&](size_type i0, size_type i1)  {
+            size_type   k = 0;
+
+           // Four columns at a time, so each target element is loaded and
+           // stored once for eight flops
+           //
+            for ( ; k + 4 <= j0; k += 4)  {
+                const value_type    *l0 = packed_column__ (ap, n, k);
+                const value_type    *l1 = packed_column__ (ap, n, k + 1);
+                const value_type    *l2 = packed_column__ (ap, n, k + 2);
+                const value_type    *l3 = packed_column__ (ap, n, k + 3);
+
+                for (size_type j = j0; j < j1 && j < i1; ++j)  {
+                    const value_type    c0 = l0[j];
+                    const value_type    c1 = l1[j];
+                    const value_type    c2 = l2[j];
+                    const value_type    c3 = l3[j];
+                    value_type          *aj = packed_column__ (ap, n, j);
+
+                    for (size_type i = std::max (i0, j); i < i1; ++i)
+                        aj[i] -= l0[i] * c0 + l1[i] * c1 +
+                                 l2[i] * c2 + l3[i] * c3;
+                }
+            }
+            for ( ; k < j0; ++k)  {
+                const value_type    *lk = packed_column__ (ap, n, k);
+
+                for (size_type j = j0; j < j1 && j < i1; ++j)  {
+                    const value_type    ljk = lk[j];
+
+                    if (ljk == value_type(0.0))  continue;
+
+                    value_type  *aj = packed_column__ (ap, n, j);
+
+                    for (size_type i = std::max (i0, j); i < i1; ++i)
+                        aj[i] -= lk[i] * ljk;
+                }
+            }
+        };
+
+        if (j0 > 0)  {
+            const std::size_t   flops =
+                std::size_t(n - j0) * (j1 - j0) * j0;
+
+            if (flops >= Blocking::PARALLEL_FLOPS &&
+                pool.thread_count () > 1)  {
+                const size_type rows = n - j0;
+                const size_type chunk =
+                    std::max (size_type(Blocking::MIN_TILE),
+                              rows / (pool.thread_count () * 4) + 1);
+                const size_type chunks = (rows + chunk - 1) / chunk;
+
+                pool.parallel_for (
+                    chunks,
+                    [&](std::size_t c)  {
+                        const size_type i0 = j0 + size_type(c) * chunk;
+
+                        update (i0, std::min (n, size_type(i0 + chunk)));
+                    });
+            }
+            else
+                update (j0, n);
+        }
+
+       // Factor the block
+       //
+        for (size_type j = j0; j < j1; ++j)  {
+            value_type  *aj = packed_column__ (ap, n, j);
+
+            for (size_type k = j0; k < j; ++k)  {
+                const value_type    *lk = packed_column__ (ap, n, k);
+                const value_type    ljk = lk[j];
+
+                for (size_type i = j; i < n; ++i)
+                    aj[i] -= lk[i] * ljk;
+            }
+
+            if (! (aj[j] > value_type(0.0)))  // Not positive definite
+                throw NotSolvable ();
+
+            const value_type    d = sqrt__ (aj[j]);
+
+            aj[j] = d;
+            for (size_type i = j + 1; i < n; ++i)
+                aj[i] /= d;
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Inverse(A) = ~Inverse(L) * Inverse(L), in place of L
+//
+template<class T>
+inline void
+PackedCholeskyFactorization<T>::pptri_ (size_type n,
+                                        value_type *ap) noexcept  {
+
+   // Inverse(L), from the last column to the first. Column j is
+   // multiplied by the already inverted trailing triangle.
+   //
+    for (size_type j = n; j-- > 0; )  {
+        value_type  *aj = packed_column__ (ap, n, j);
+
+        aj[j] = value_type(1.0) / aj[j];
+
+        const value_type    ajj = -aj[j];
+
+        for (size_type c = n; c-- > j + 1; )  {
+            const value_type    *ac = packed_column__ (ap, n, c);
+            const value_type    temp = aj[c];
+
+            if (temp == value_type(0.0))  continue;
+
+            for (size_type i = c + 1; i < n; ++i)
+                aj[i] += temp * ac[i];
+            aj[c] = temp * ac[c];
+        }
+        for (size_type i = j + 1; i < n; ++i)
+            aj[i] *= ajj;
+    }
+
+   // ~Inverse(L) * Inverse(L), from the first column to the last. Column
+   // j is multiplied by the transpose of the trailing triangle, which is
+   // still Inverse(L).
+   //
+    for (size_type j = 0; j < n; ++j)  {
+        value_type  *aj = packed_column__ (ap, n, j);
+        value_type  ajj (0.0);
+
+        for (size_type i = j; i < n; ++i)
+            ajj += aj[i] * aj[i];
+        for (size_type c = j + 1; c < n; ++c)  {
+            const value_type    *ac = packed_column__ (ap, n, c);
+            value_type          temp = aj[c] * ac[c];
+
+            for (size_type i = c + 1; i < n; ++i)
+                temp += ac[i] * aj[i];
+            aj[c] = temp;
+        }
+        aj[j] = ajj;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Not a dense matrix, so it goes through a dense copy
+//
+template<class T>
+template<class MAT2>
+inline void PackedCholeskyFactorization<T>::solve_in_place_ (MAT2 &rhs) const {
+
+    DenseMatrix sol (rhs.rows (), rhs.columns ());
+
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            sol (r, c) = rhs (r, c);
+    solve_in_place_ (sol);
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            rhs (r, c) = sol (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// L * Y = rhs, then ~L * X = Y. The right-hand sides are done in groups,
+// so every column of L is read once per group.
+//
+template<class T>
+inline void
+PackedCholeskyFactorization<T>::solve_in_place_ (DenseMatrix &rhs) const  {
+
+    constexpr size_type GROUP = 32;
+
+    const size_type n = factor_.rows ();
+
+    if (n == 0 || rhs.columns () == 0)  return;
+
+    const value_type    *ap = &(*factor_.col_begin ());
+    value_type          *b = &(*rhs.col_begin ());
+
+    for (size_type g0 = 0; g0 < rhs.columns (); g0 += GROUP)  {
+        const size_type g1 = std::min (size_type(g0 + GROUP), rhs.columns ());
+
+        for (size_type j = 0; j < n; ++j)  {
+            const value_type    *lj = packed_column__ (ap, n, j);
+
+            for (size_type g = g0; g < g1; ++g)  {
+                value_type          *x = b + std::size_t(g) * n;
+                const value_type    xj = x[j] /= lj[j];
+
+                for (size_type i = j + 1; i < n; ++i)
+                    x[i] -= lj[i] * xj;
+            }
+        }
+        for (size_type j = n; j-- > 0; )  {
+            const value_type    *lj = packed_column__ (ap, n, j);
+
+            for (size_type g = g0; g < g1; ++g)  {
+                value_type  *x = b + std::size_t(g) * n;
+                value_type  s = x[j];
+
+                for (size_type i = j + 1; i < n; ++i)
+                    s -= lj[i] * x[i];
+                x[j] = s / lj[j];
+            }
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+PackedLDLFactorization<T>::PackedLDLFactorization (const SymmMatrix &mat)  {
+
+    factorize (mat);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+PackedLDLFactorization<T>::PackedLDLFactorization (SymmMatrix &&mat)  {
+
+    factorize (std::move (mat));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void PackedLDLFactorization<T>::factorize (const SymmMatrix &mat)  {
+
+    SymmMatrix  tmp = mat;
+
+    factorize (std::move (tmp));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void PackedLDLFactorization<T>::factorize (SymmMatrix &&mat)  {
+
+    pivots_.resize (mat.rows ());
+    if (! mat.empty ())
+        sptrf_ (mat.rows (), &(*mat.col_begin ()), pivots_.data ());
+    factor_.swap (mat);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename PackedLDLFactorization<T>::SymmMatrix
+PackedLDLFactorization<T>::release_packed_factor () noexcept  {
+
+    SymmMatrix  tmp;
+
+    tmp.swap (factor_);
+    pivots_.clear ();
+    return (tmp);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline bool PackedLDLFactorization<T>::is_singular () const noexcept  {
+
+    return (determinant () == value_type(0.0));
+}
+
+// ----------------------------------------------------------------------------
+
+// The interchanges are symmetric, so they don't change the sign. It is the
+// product of the determinants of the D blocks.
+//
+template<class T>
+inline typename PackedLDLFactorization<T>::value_type
+PackedLDLFactorization<T>::determinant () const noexcept  {
+
+    const size_type n = factor_.rows ();
+    value_type      result (1.0);
+
+    for (size_type k = 0; k < n; )  {
+        if (pivots_[k] >= 0)  {
+            result *= factor_ (k, k);
+            k += 1;
+        }
+        else  {
+            const value_type    b = factor_ (k, k + 1);
+
+            result *= factor_ (k, k) * factor_ (k + 1, k + 1) - b * b;
+            k += 2;
+        }
+    }
+
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2 PackedLDLFactorization<T>::solve (const MAT2 &rhs) const  {
+
+    MAT2    sol = rhs;
+
+    return (solve_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2 &PackedLDLFactorization<T>::solve_in_place (MAT2 &rhs) const  {
+
+    if (rhs.rows () != factor_.rows ())
+        throw NotSolvable ();
+    if (is_singular ())
+        throw Singular ();
+
+    solve_in_place_ (rhs);
+    return (rhs);
+}
+
+// ----------------------------------------------------------------------------
+
+// This is the lower triangle version of LAPACK's SPTRF (Bunch-Kaufman
+// diagonal pivoting). Each step eliminates one or two columns and does a
+// rank one or rank two update of the trailing triangle, one column at a
+// time.
+//
+template<class T>
+inline void
+PackedLDLFactorization<T>::sptrf_ (size_type n,
+                                   value_type *ap,
+                                   long *pivots) noexcept  {
+
+    const value_type    alpha =
+        (value_type(1.0) + sqrt__ (value_type(17.0))) / value_type(8.0);
+    const auto          column = [ap, n](size_type j)  {
+        return (packed_column__ (ap, n, j));
+    };
+
+    for (size_type k = 0; k < n; )  {
+        value_type          *ak = column (k);
+        const value_type    absakk = abs__ (ak[k]);
+        size_type           kstep = 1;
+        size_type           kp = k;
+        size_type           imax = k;
+        value_type          colmax (0.0);
+
+        for (size_type i = k + 1; i < n; ++i)
+            if (abs__ (ak[i]) > colmax)  {
+                colmax = abs__ (ak[i]);
+                imax = i;
+            }
+
+       // If the column is all zeros, D(k, k) is zero and there is nothing
+       // to eliminate
+       //
+        if (std::max (absakk, colmax) != value_type(0.0))  {
+            if (absakk < alpha * colmax)  {
+                const value_type    *aim = column (imax);
+                value_type          rowmax (0.0);
+
+                for (size_type j = k; j < imax; ++j)
+                    rowmax = std::max (rowmax, abs__ (column (j)[imax]));
+                for (size_type i = imax + 1; i < n; ++i)
+                    rowmax = std::max (rowmax, abs__ (aim[i]));
+
+                if (absakk >= alpha * colmax * (colmax / rowmax))
+                    kp = k;
+                else if (abs__ (aim[imax]) >= alpha * rowmax)
+                    kp = imax;
+                else  {
+                    kp = imax;
+                    kstep = 2;
+                }
+            }
+
+           // Interchange rows and columns kk and kp of the trailing
+           // triangle
+           //
+            const size_type kk = k + kstep - 1;
+
+            if (kp != kk)  {
+                value_type  *akk = column (kk);
+                value_type  *akp = column (kp);
+
+                for (size_type i = kp + 1; i < n; ++i)
+                    std::swap (akk[i], akp[i]);
+                for (size_type j = kk + 1; j < kp; ++j)
+                    std::swap (akk[j], column (j)[kp]);
+                std::swap (akk[kk], akp[kp]);
+                if (kstep == 2)
+                    std::swap (ak[k + 1], ak[kp]);
+            }
+
+            if (kstep == 1)  {
+               // A = A - ak * ~ak / D(k, k) and ak = ak / D(k, k)
+               //
+                const value_type    d11 = value_type(1.0) / ak[k];
+
+                for (size_type j = k + 1; j < n; ++j)  {
+                    value_type          *aj = column (j);
+                    const value_type    temp = -d11 * ak[j];
+
+                    for (size_type i = j; i < n; ++i)
+                        aj[i] += ak[i] * temp;
+                }
+                for (size_type i = k + 1; i < n; ++i)
+                    ak[i] *= d11;
+            }
+            else if (k + 2 < n)  {
+               // A = A - (ak ak1) * Inverse(D) * ~(ak ak1) and
+               // (ak ak1) = (ak ak1) * Inverse(D)
+               //
+                value_type          *ak1 = column (k + 1);
+                value_type          d21 = ak[k + 1];
+                const value_type    d11 = ak1[k + 1] / d21;
+                const value_type    d22 = ak[k] / d21;
+                const value_type    t =
+                    value_type(1.0) / (d11 * d22 - value_type(1.0));
+
+                d21 = t / d21;
+                for (size_type j = k + 2; j < n; ++j)  {
+                    value_type          *aj = column (j);
+                    const value_type    wk = d21 * (d11 * ak[j] - ak1[j]);
+                    const value_type    wkp1 = d21 * (d22 * ak1[j] - ak[j]);
+
+                    for (size_type i = j; i < n; ++i)
+                        aj[i] -= ak[i] * wk + ak1[i] * wkp1;
+                    ak[j] = wk;
+                    ak1[j] = wkp1;
+                }
+            }
+        }
+
+        if (kstep == 1)
+            pivots[k] = long(kp);
+        else
+            pivots[k] = pivots[k + 1] = -long(kp) - 1;
+        k += kstep;
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Not a dense matrix, so it goes through a dense copy
+//
+template<class T>
+template<class MAT2>
+inline void PackedLDLFactorization<T>::solve_in_place_ (MAT2 &rhs) const  {
+
+    DenseMatrix sol (rhs.rows (), rhs.columns ());
+
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            sol (r, c) = rhs (r, c);
+    solve_in_place_ (sol);
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            rhs (r, c) = sol (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// L * D * Y = P * rhs, then ~L * Z = Y and X = ~P * Z, one right-hand
+// side at a time. It is LAPACK's SPTRS for a lower packed factor.
+//
+template<class T>
+inline void
+PackedLDLFactorization<T>::solve_in_place_ (DenseMatrix &rhs) const  {
+
+    const size_type n = factor_.rows ();
+
+    if (n == 0 || rhs.columns () == 0)  return;
+
+    const value_type    *ap = &(*factor_.col_begin ());
+    const auto          column = [ap, n](size_type j)  {
+        return (packed_column__ (ap, n, j));
+    };
+
+    for (size_type g = 0; g < rhs.columns (); ++g)  {
+        value_type  *x = &(rhs (0, g));
+
+        for (size_type k = 0; k < n; )  {
+            const value_type    *ak = column (k);
+
+            if (pivots_[k] >= 0)  {
+                const size_type kp = size_type(pivots_[k]);
+
+                if (kp != k)
+                    std::swap (x[k], x[kp]);
+                for (size_type i = k + 1; i < n; ++i)
+                    x[i] -= ak[i] * x[k];
+                x[k] /= ak[k];
+                k += 1;
+            }
+            else  {
+                const size_type     kp = size_type(-pivots_[k] - 1);
+                const value_type    *ak1 = column (k + 1);
+
+                if (kp != k + 1)
+                    std::swap (x[k + 1], x[kp]);
+                for (size_type i = k + 2; i < n; ++i)
+                    x[i] -= ak[i] * x[k] + ak1[i] * x[k + 1];
+
+                const value_type    akm1k = ak[k + 1];
+                const value_type    akm1 = ak[k] / akm1k;
+                const value_type    akk = ak1[k + 1] / akm1k;
+                const value_type    denom = akm1 * akk - value_type(1.0);
+                const value_type    bkm1 = x[k] / akm1k;
+                const value_type    bk = x[k + 1] / akm1k;
+
+                x[k] = (akk * bkm1 - bk) / denom;
+                x[k + 1] = (akm1 * bk - bkm1) / denom;
+                k += 2;
+            }
+        }
+
+        for (size_type k = n; k > 0; )  {
+            const size_type     j = k - 1;
+            const value_type    *aj = column (j);
+
+            for (size_type i = j + 1; i < n; ++i)
+                x[j] -= aj[i] * x[i];
+            if (pivots_[j] >= 0)  {
+                const size_type kp = size_type(pivots_[j]);
+
+                if (kp != j)
+                    std::swap (x[j], x[kp]);
+                k -= 1;
+            }
+            else  {
+                const value_type    *aj1 = column (j - 1);
+                const size_type     kp = size_type(-pivots_[j] - 1);
+
+                for (size_type i = j + 1; i < n; ++i)
+                    x[j - 1] -= aj1[i] * x[i];
+                if (kp != j)
+                    std::swap (x[j], x[kp]);
+                k -= 2;
+            }
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+RFPCholeskyFactorization<T>::
+RFPCholeskyFactorization (const RFPMatrix &mat)  {
+
+    factorize (mat);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+RFPCholeskyFactorization<T>::RFPCholeskyFactorization (RFPMatrix &&mat)  {
+
+    factorize (std::move (mat));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void RFPCholeskyFactorization<T>::factorize (const RFPMatrix &mat)  {
+
+    RFPMatrix   tmp = mat;
+
+    factorize (std::move (tmp));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void RFPCholeskyFactorization<T>::factorize (RFPMatrix &&mat)  {
+
+    if (! mat.empty ())
+        pftrf_ (mat.rows (), mat.rfp_data ());
+    factor_.swap (mat);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename RFPCholeskyFactorization<T>::RFPMatrix
+RFPCholeskyFactorization<T>::release_rfp_factor () noexcept  {
+
+    RFPMatrix   tmp;
+
+    tmp.swap (factor_);
+    return (tmp);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline void RFPCholeskyFactorization<T>::get_upper (MAT2 &U) const  {
+
+    const size_type n = factor_.rows ();
+
+    U.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = c; r < n; ++r)
+            U (c, r) = factor_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline void RFPCholeskyFactorization<T>::get_lower (MAT2 &L) const  {
+
+    const size_type n = factor_.rows ();
+
+    L.resize (n, n);
+    for (size_type c = 0; c < n; ++c)
+        for (size_type r = c; r < n; ++r)
+            L (r, c) = factor_ (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename RFPCholeskyFactorization<T>::value_type
+RFPCholeskyFactorization<T>::determinant () const noexcept  {
+
+    value_type  result (1.0);
+
+    for (size_type i = 0; i < factor_.rows (); ++i)
+        result *= factor_ (i, i) * factor_ (i, i);
+
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2
+RFPCholeskyFactorization<T>::cholesky_solve (const MAT2 &rhs) const  {
+
+    MAT2    sol = rhs;
+
+    return (cholesky_solve_in_place (sol));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT2>
+inline MAT2 &
+RFPCholeskyFactorization<T>::cholesky_solve_in_place (MAT2 &rhs) const  {
+
+    if (rhs.rows () != factor_.rows ())
+        throw NotSolvable ();
+
+    solve_in_place_ (rhs);
+    return (rhs);
+}
+
+// ----------------------------------------------------------------------------
+
+// A22 is kept as its upper triangle. So its factor comes out as
+// U22 = ~L22.
+//
+template<class T>
+inline void RFPCholeskyFactorization<T>::pftrf_ (size_type n, value_type *a) {
+
+    using Layout = typename RFPMatrix::Layout;
+
+    const Layout        lay (n);
+    const std::size_t   ld = lay.ld;
+    value_type          *a11 = a + lay.a11;
+    value_type          *a21 = a + lay.a21;
+    value_type          *a22 = a + lay.a22;
+
+    if (! potrf (false, lay.n1, a11, ld))
+        throw NotSolvable ();
+    if (lay.n2 == 0)  return;
+    trsm_right (false, true, false, lay.n2, lay.n1, a11, ld, a21, ld);
+    syrk (true, false, lay.n2, lay.n1, value_type(-1), a21, ld,
+          value_type(1), a22, ld);
+    if (! potrf (true, lay.n2, a22, ld))
+        throw NotSolvable ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Not a dense matrix, so it goes through a dense copy
+//
+template<class T>
+template<class MAT2>
+inline void RFPCholeskyFactorization<T>::solve_in_place_ (MAT2 &rhs) const {
+
+    DenseMatrix sol (rhs.rows (), rhs.columns ());
+
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            sol (r, c) = rhs (r, c);
+    solve_in_place_ (sol);
+    for (size_type c = 0; c < rhs.columns (); ++c)
+        for (size_type r = 0; r < rhs.rows (); ++r)
+            rhs (r, c) = sol (r, c);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// L * Y = rhs, then ~L * X = Y, a block of rows at a time
+//
+template<class T>
+inline void
+RFPCholeskyFactorization<T>::solve_in_place_ (DenseMatrix &rhs) const  {
+
+    using Layout = typename RFPMatrix::Layout;
+
+    const size_type n = factor_.rows ();
+    const size_type m = rhs.columns ();
+
+    if (n == 0 || m == 0)  return;
+
+    const Layout        lay (n);
+    const std::size_t   ld = lay.ld;
+    const value_type    *a = factor_.rfp_data ();
+    const value_type    *l11 = a + lay.a11;
+    const value_type    *l21 = a + lay.a21;
+    const value_type    *u22 = a + lay.a22;
+    value_type          *b1 = &(*rhs.col_begin ());
+    value_type          *b2 = b1 + lay.n1;
+
+    trsm (false, false, false, lay.n1, m, l11, ld, b1, n);
+    if (lay.n2 != 0)  {
+        gemm (false, false, lay.n2, m, lay.n1,
+              value_type(-1), l21, ld, b1, n, value_type(1), b2, n);
+        trsm (true, true, false, lay.n2, m, u22, ld, b2, n);
+        trsm (true, false, false, lay.n2, m, u22, ld, b2, n);
+        gemm (true, false, lay.n1, m, lay.n2,
+              value_type(-1), l21, ld, b2, n, value_type(1), b1, n);
+    }
+    trsm (false, true, false, lay.n1, m, l11, ld, b1, n);
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,175 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include <Tiger/CovarianceAccumulator.h>
+
+#include <cstddef>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Covariance and correlation over a moving history of rows, updated in
+// O(n^2) per new row, n being the number of columns (i.e. dimension ()).
+// There are two modes:
+//
+//  -- window: Equally weighted over the last window_size rows, the same as
+//     calling Matrix::covariance() on them. The rows in the window are
+//     kept in a ring buffer. A new row is a rank-1 update and the row it
+//     evicts is a rank-1 downdate (see CovarianceAccumulator). Since
+//     downdates accumulate rounding errors, the state is recomputed from
+//     the ring buffer every recompute_every rows.
+//
+//  -- ewma: Exponentially weighted over all the rows. The row that arrived
+//     k rows ago has weight decay^k. Nothing but the mean and co-moment is
+//     kept:
+//         W = decay * W + 1,  delta = x - mean,  mean += delta / W,
+//         M = decay * M + (W - 1) / W * delta * ~delta
+//     The covariance is M / W, or M / (W - Sum(w^2) / W) if it is
+//     unbiased. With decay = 1 it is the same as the window mode with an
+//     infinite window.
+//
+template<class T>
+class   RollingCovariance  {
+
+public:
+
+    enum class mode : unsigned char  {
+        window = 1,
+        ewma = 2
+    };
+
+    using value_type = T;
+    using SymmMatrix = Matrix<SymmMatrixBase, value_type>;
+    using DenseMatrix = Matrix<DenseMatrixBase, value_type>;
+    using size_type = typename SymmMatrix::size_type;
+    using MeanVector = std::vector<value_type>;
+
+   // Window mode. If recompute_every is 0, it is window_size.
+   //
+    static RollingCovariance
+    window (size_type dimension,
+            size_type window_size,
+            size_type recompute_every = 0);
+
+   // EWMA mode. decay must be in (0, 1].
+   //
+    static RollingCovariance
+    ewma (size_type dimension, value_type decay); // throw (NotSolvable)
+
+    inline mode get_mode () const noexcept  { return (mode_); }
+    inline size_type dimension () const noexcept  { return (dimension_); }
+    inline size_type
+    window_size () const noexcept  { return (window_size_); }
+
+   // Rows in the window, or all rows seen in EWMA mode
+   //
+    inline std::size_t count () const noexcept;
+
+    inline const MeanVector &get_mean () const noexcept;
+
+   // Add one row. first must point to dimension () values.
+   // In window mode, once the window is full, the oldest row is evicted.
+   //
+    template<class ITER>
+    void push (ITER first);
+
+   // Add the given row of mat
+   //
+    template<class MAT>
+    void push_row (const MAT &mat, size_type row); // throw (NotSolvable)
+
+   // Rebuild the window mode state from the rows in the ring buffer.
+   // It is called automatically every recompute_every rows.
+   //
+    void recompute ();
+
+    SymmMatrix
+    covariance (bool is_unbiased = true) const; // throw (NotSolvable)
+    SymmMatrix correlation () const; // throw (NotSolvable)
+
+private:
+
+   // They are reached through window() and ewma(). Plain integer
+   // arguments, as in (3, 250), would be ambiguous between them.
+   //
+    RollingCovariance (size_type dimension,
+                       size_type window_size,
+                       size_type recompute_every);
+    RollingCovariance (size_type dimension, value_type decay);
+
+    template<class ITER>
+    inline void push_window_ (ITER first);
+    template<class ITER>
+    inline void push_ewma_ (ITER first);
+
+    mode        mode_;
+    size_type   dimension_;
+
+   // Window mode
+   //
+    size_type                           window_size_ { 0 };
+    size_type                           recompute_every_ { 0 };
+    size_type                           since_recompute_ { 0 };
+    std::vector<value_type>             ring_ { };  // Row-major
+    std::size_t                         oldest_ { 0 };
+    std::size_t                         filled_ { 0 };
+    CovarianceAccumulator<value_type>   acc_ { };
+
+   // EWMA mode
+   //
+    value_type  decay_ { 1 };
+    value_type  weight_sum_ { 0 };
+    value_type  weight_sq_sum_ { 0 };
+    std::size_t ewma_count_ { 0 };
+    MeanVector  mean_ { };
+    SymmMatrix  comoment_ { };
+    MeanVector  delta_ { };  // Scratch
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/RollingCovariance.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
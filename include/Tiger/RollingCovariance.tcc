@@ -0,0 +1,254 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <Tiger/RollingCovariance.h>
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+RollingCovariance<T>::RollingCovariance (size_type dimension,
+                                         size_type window_size,
+                                         size_type recompute_every)
+    : mode_ (mode::window),
+      dimension_ (dimension),
+      window_size_ (window_size),
+      recompute_every_ (recompute_every != 0 ? recompute_every
+                                             : window_size),
+      ring_ (std::size_t(window_size) * dimension),
+      acc_ (dimension)  {   }
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+RollingCovariance<T>
+RollingCovariance<T>::window (size_type dimension,
+                              size_type window_size,
+                              size_type recompute_every)  {
+
+    return (RollingCovariance (dimension, window_size, recompute_every));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+RollingCovariance<T>
+RollingCovariance<T>::ewma (size_type dimension, value_type decay)  {
+
+    return (RollingCovariance (dimension, decay));
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+RollingCovariance<T>::RollingCovariance (size_type dimension,
+                                         value_type decay)
+    : mode_ (mode::ewma),
+      dimension_ (dimension),
+      decay_ (decay),
+      mean_ (dimension, value_type(0)),
+      comoment_ (dimension, dimension),
+      delta_ (dimension)  {
+
+    if (! (decay > value_type(0) && decay <= value_type(1)))
+        throw NotSolvable ();
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline std::size_t RollingCovariance<T>::count () const noexcept  {
+
+    return (mode_ == mode::window ? filled_ : ewma_count_);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline const typename RollingCovariance<T>::MeanVector &
+RollingCovariance<T>::get_mean () const noexcept  {
+
+    return (mode_ == mode::window ? acc_.get_mean () : mean_);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class ITER>
+void RollingCovariance<T>::push (ITER first)  {
+
+    if (mode_ == mode::window)
+        push_window_ (first);
+    else
+        push_ewma_ (first);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class MAT>
+void RollingCovariance<T>::push_row (const MAT &mat, size_type row)  {
+
+    if (mat.columns () != dimension_ || row >= mat.rows ())
+        throw NotSolvable ();
+
+    std::vector<value_type> tmp (dimension_);
+
+    for (size_type c = 0; c < dimension_; ++c)
+        tmp[c] = mat (row, c);
+    push (tmp.data ());
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void RollingCovariance<T>::recompute ()  {
+
+    if (mode_ != mode::window)  return;
+
+    DenseMatrix batch (filled_, dimension_);
+
+    for (std::size_t r = 0; r < filled_; ++r)  {
+        const value_type    *src =
+            ring_.data () + ((oldest_ + r) % window_size_) * dimension_;
+
+        for (size_type c = 0; c < dimension_; ++c)
+            batch (r, c) = src[c];
+    }
+    acc_.reset (dimension_);
+    acc_.add_rows (batch);
+    since_recompute_ = 0;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+typename RollingCovariance<T>::SymmMatrix
+RollingCovariance<T>::covariance (bool is_unbiased) const  {
+
+    if (mode_ == mode::window)
+        return (acc_.covariance (is_unbiased));
+
+    const value_type    denom =
+        is_unbiased ? weight_sum_ - weight_sq_sum_ / weight_sum_
+                    : weight_sum_;
+
+    if (ewma_count_ == 0 || ! (denom > value_type(0)))
+        throw NotSolvable ();
+
+    SymmMatrix          result = comoment_;
+    const std::size_t   d = dimension_;
+
+    if (d != 0)  {
+        value_type  *ap = &(*result.col_begin ());
+
+        for (std::size_t i = 0; i < d * (d + 1) / 2; ++i)
+            ap[i] /= denom;
+    }
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+typename RollingCovariance<T>::SymmMatrix
+RollingCovariance<T>::correlation () const  {
+
+    SymmMatrix  result = covariance ();
+
+    covariance_to_correlation__ (result);
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class ITER>
+inline void RollingCovariance<T>::push_window_ (ITER first)  {
+
+    if (window_size_ == 0)  return;
+
+    std::size_t slot;
+
+    if (filled_ == window_size_)  {  // Evict the oldest row
+        slot = oldest_;
+        acc_.remove (ring_.data () + slot * dimension_);
+        oldest_ = (oldest_ + 1) % window_size_;
+    }
+    else
+        slot = (oldest_ + filled_++) % window_size_;
+
+    value_type  *dst = ring_.data () + slot * dimension_;
+
+    for (size_type c = 0; c < dimension_; ++c, ++first)
+        dst[c] = *first;
+    acc_.add (dst);
+    if (++since_recompute_ >= recompute_every_)
+        recompute ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+template<class ITER>
+inline void RollingCovariance<T>::push_ewma_ (ITER first)  {
+
+    const value_type    old_weight = decay_ * weight_sum_;
+
+    weight_sum_ = old_weight + value_type(1);
+    weight_sq_sum_ = decay_ * decay_ * weight_sq_sum_ + value_type(1);
+    ewma_count_ += 1;
+    for (size_type i = 0; i < dimension_; ++i, ++first)  {
+        delta_[i] = value_type(*first) - mean_[i];
+        mean_[i] += delta_[i] / weight_sum_;
+    }
+    if (dimension_ != 0)
+        packed_rank_one__ (&(*comoment_.col_begin ()), dimension_,
+                           decay_, old_weight / weight_sum_, delta_.data ());
+    return;
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -35,18 +35,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Tiger/StepVectorRange.h>
 
 #include <Tiger/MatrixBase.h>
+#include <Tiger/MemoryArena.h>
 
 // ----------------------------------------------------------------------------
 
 namespace hmma
 {
 
-template<class T>
-class   SymmMatrixBase : public DenseMatrixStorage<T>  {
+template<class T, class S>
+class   BasicSymmMatrixBase : public DenseMatrixStorage<T, S>  {
 
     public:
 
-        typedef DenseMatrixStorage<T>               BaseClass;
+        typedef DenseMatrixStorage<T, S>            BaseClass;
 
         typedef typename BaseClass::size_type       size_type;
         typedef typename BaseClass::value_type      value_type;
@@ -55,14 +56,14 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
         typedef typename BaseClass::pointer         pointer;
         typedef typename BaseClass::const_pointer   const_pointer;
 
-        typedef SymmMatrixBase<value_type>          SelfType;
+        typedef BasicSymmMatrixBase<value_type, S>  SelfType;
 
     protected:
 
-        inline SymmMatrixBase () noexcept  {   }
+        inline BasicSymmMatrixBase () noexcept  {   }
 
         inline
-        SymmMatrixBase (size_type row,
+        BasicSymmMatrixBase (size_type row,
                         size_type col,
                         const_reference def_value = value_type ())
             // throw (NotSquare)
@@ -74,6 +75,10 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
 
         static inline bool _is_symmetric_matrix () noexcept { return (true); }
 
+       // A symmetric matrix is its own transpose
+       //
+        inline void _transpose () noexcept  {   }
+
     public:
 
         void resize (size_type in_row,
@@ -85,31 +90,88 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
 
         std::ostream &dump (std::ostream &out_stream) const;
 
+       // See DenseMatrixStorage
+       //
+        template<typename STRM>
+        inline bool
+        write (STRM &stream, io_format iof = io_format::csv) const  {
+
+            return (BaseClass::_write (stream, iof,
+                                       matrix_layout::symmetric));
+        }
+        inline bool
+        read (const char *file_name, io_format iof = io_format::csv)  {
+
+            return (BaseClass::_read (file_name, iof,
+                                      matrix_layout::symmetric));
+        }
+        inline void attach_file (const char *file_name)  {
+
+            BaseClass::_attach_file (file_name, matrix_layout::symmetric);
+        }
+
     public:
 
+       // It goes through the matrix row-by-row (which is also
+       // column-by-column) starting at [0, 0]. Like the row iterators of
+       // DenseMatrixBase, it is a pointer plus the row and column it is
+       // on, so there is no divide or modulo per element.
+       //
         class   iterator  {
 
             public:
 
                 typedef std::random_access_iterator_tag iterator_category;
+                typedef typename SelfType::value_type   value_type;
+                typedef long                            difference_type;
+                typedef typename SelfType::pointer      pointer;
+                typedef typename SelfType::reference    reference;
 
             public:
 
                // NOTE: The constructor with no argument initializes
                //       the iterator to be an "undefined" iterator
                //
-                inline iterator () noexcept : matx_ (NULL), idx_ (0)  {   }
+                inline iterator () noexcept  {   }
 
                 inline iterator (SelfType *m, size_type idx = 0) noexcept
-                    : matx_ (m), idx_ (idx)  {   }
+                    : base_ (m->_get_data ().data ()),
+                      dim_ (m->columns ())  {
 
-                inline bool operator == (const iterator &rhs) const  {
+                    seek_ (idx);
+                }
 
-                    return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+               // The pointer alone doesn't tell the end from [0, 1]
+               //
+                inline bool
+                operator == (const iterator &rhs) const noexcept  {
+
+                    return (ptr_ == rhs.ptr_ && col_ == rhs.col_);
+                }
+                inline bool
+                operator != (const iterator &rhs) const noexcept  {
+
+                    return (ptr_ != rhs.ptr_ || col_ != rhs.col_);
+                }
+                inline bool
+                operator < (const iterator &rhs) const noexcept  {
+
+                    return (index_ () < rhs.index_ ());
                 }
-                inline bool operator != (const iterator &rhs) const  {
+                inline bool
+                operator > (const iterator &rhs) const noexcept  {
 
-                    return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+                    return (index_ () > rhs.index_ ());
+                }
+                inline bool
+                operator <= (const iterator &rhs) const noexcept  {
+
+                    return (index_ () <= rhs.index_ ());
+                }
+                inline bool
+                operator >= (const iterator &rhs) const noexcept  {
+
+                    return (index_ () >= rhs.index_ ());
                 }
 
                // Following STL style, this iterator appears as a pointer
@@ -117,169 +179,275 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
                //
                 inline pointer operator -> () const noexcept  {
 
-                    return (&(matx_->at (idx_ / matx_->columns (),
-                                         idx_ % matx_->columns ())));
+                    return (ptr_);
                 }
                 inline reference operator * () const noexcept  {
 
-                    return (matx_->at (idx_ / matx_->columns (),
-                                       idx_ % matx_->columns ()));
+                    return (*ptr_);
                 }
                 inline operator pointer () const noexcept  {
 
-                    return (&(matx_->at (idx_ / matx_->columns (),
-                                         idx_ % matx_->columns ())));
+                    return (ptr_);
+                }
+
+                inline reference operator [] (long i) const noexcept  {
+
+                    return (*(*this + i));
                 }
 
-               // We are following STL style iterator interface.
+               // Left of the diagonal, [r, c] is stored as [c, r] and the
+               // step to the next column shrinks by one every column. On
+               // and right of the diagonal the row is contiguous.
                //
                 inline iterator &operator ++ () noexcept  {    // ++Prefix
 
-                    idx_ += 1;
+                    if (++col_ == dim_)  {
+                        col_ = 0;
+                        ptr_ = base_ + ++row_;
+                    }
+                    else if (col_ <= row_)
+                        ptr_ += dim_ - col_;
+                    else
+                        ptr_ += 1;
                     return (*this);
                 }
                 inline iterator operator ++ (int) noexcept  {  // Postfix++
 
-                    const   size_type   ret_idx = idx_;
+                    const iterator  ret = *this;
 
-                    idx_ += 1;
-                    return (iterator (matx_, ret_idx));
+                    ++(*this);
+                    return (ret);
                 }
 
                 inline iterator &operator += (long i) noexcept  {
 
-                    idx_ += i;
+                    seek_ (index_ () + i);
                     return (*this);
                 }
 
                 inline iterator &operator -- () noexcept  {    // --Prefix
 
-                    idx_ -= 1;
+                    if (col_ == 0)  {
+                        col_ = dim_ - 1;
+                        row_ -= 1;
+                        ptr_ = base_ + offset_ (row_, col_);
+                    }
+                    else  {
+                        ptr_ -= col_ <= row_ ? dim_ - col_ : 1;
+                        col_ -= 1;
+                    }
                     return (*this);
                 }
                 inline iterator operator -- (int) noexcept  {  // Postfix--
 
-                    const   size_type   ret_idx = idx_;
+                    const iterator  ret = *this;
 
-                    idx_ -= 1;
-                    return (iterator (matx_, ret_idx));
+                    --(*this);
+                    return (ret);
                 }
 
                 inline iterator &operator -= (int i) noexcept  {
 
-                    idx_ -= i;
+                    seek_ (index_ () - i);
                     return (*this);
                 }
 
-                inline iterator operator + (int i) noexcept  {
+                inline iterator operator + (int i) const noexcept  {
+
+                    return (iterator (*this) += i);
+                }
+
+                inline iterator operator - (int i) const noexcept  {
 
-                    return (iterator (matx_, idx_ + i));
+                    return (iterator (*this) -= i);
                 }
 
-                inline iterator operator - (int i) noexcept  {
+                inline iterator operator + (long i) const noexcept  {
 
-                    return (iterator (matx_, idx_ - i));
+                    return (iterator (*this) += i);
                 }
 
-                inline iterator operator + (long i) noexcept  {
+                inline iterator operator - (long i) const noexcept  {
 
-                    return (iterator (matx_, idx_ + i));
+                    return (iterator (*this) += -i);
                 }
 
-                inline iterator operator - (long i) noexcept  {
+                inline difference_type
+                operator - (const iterator &rhs) const noexcept  {
 
-                    return (iterator (matx_, idx_ - i));
+                    return (index_ () - rhs.index_ ());
                 }
 
             private:
 
-                SelfType    *matx_;
-                size_type   idx_;
+                inline long index_ () const noexcept  {
+
+                    return (long(row_) * dim_ + col_);
+                }
+
+               // Offset of [r, c] in the packed upper triangle
+               //
+                inline std::size_t
+                offset_ (std::size_t r, std::size_t c) const noexcept  {
+
+                    if (r > c)
+                        std::swap (r, c);
+                    return (r * dim_ + c - ((r * (r + 1)) >> 1));
+                }
 
-                friend  class   SymmMatrixBase::const_iterator;
+               // Random access is the only place that divides. The two
+               // ends, which loops construct all the time (e.g. col_end()),
+               // don't.
+               //
+                inline void seek_ (long idx) noexcept  {
+
+                    if (idx == 0 || idx == long(dim_) * dim_)  {
+                        row_ = idx == 0 ? 0 : dim_;
+                        col_ = 0;
+                    }
+                    else  {
+                        row_ = size_type(idx / dim_);
+                        col_ = size_type(idx % dim_);
+                    }
+                    ptr_ = base_ + offset_ (row_, col_);
+                }
+
+                pointer     base_ { nullptr };
+                pointer     ptr_ { nullptr };
+                size_type   dim_ { 0 };
+                size_type   row_ { 0 };
+                size_type   col_ { 0 };
+
+                friend  class   BasicSymmMatrixBase::const_iterator;
         };
 
         class   const_iterator  {
 
             public:
 
-                typedef std::random_access_iterator_tag iterator_category;
+                typedef std::random_access_iterator_tag     iterator_category;
+                typedef typename SelfType::value_type       value_type;
+                typedef long                                difference_type;
+                typedef typename SelfType::const_pointer    pointer;
+                typedef typename SelfType::const_reference  reference;
 
             public:
 
                // NOTE: The constructor with no argument initializes
-               //       the const_iterator to be an "undefined"
-               //       const_iterator
+               //       the const_iterator to be an "undefined" const_iterator
                //
-                inline const_iterator () noexcept
-                    : matx_ (NULL), idx_ (0)  {   }
+                inline const_iterator () noexcept  {   }
 
-                inline const_iterator (const SelfType *m, 
+                inline const_iterator (const SelfType *m,
                                        size_type idx = 0) noexcept
-                    : matx_ (m), idx_ (idx)  {   }
+                    : base_ (m->_get_data ().data ()),
+                      dim_ (m->columns ())  {
+
+                    seek_ (idx);
+                }
 
                 inline const_iterator (
-                    const typename SelfType::iterator &that)  {
+                    const typename SelfType::iterator &that) noexcept  {
 
                     *this = that;
                 }
 
                 inline const_iterator &operator = (
-                    const typename SelfType::iterator &rhs)  {
+                    const typename SelfType::iterator &rhs) noexcept  {
 
-                    matx_ = rhs.matx_;
-                    idx_ = rhs.idx_;
+                    base_ = rhs.base_;
+                    ptr_ = rhs.ptr_;
+                    dim_ = rhs.dim_;
+                    row_ = rhs.row_;
+                    col_ = rhs.col_;
                     return (*this);
                 }
 
-                inline bool operator == (const const_iterator &rhs) const {
+               // The pointer alone doesn't tell the end from [0, 1]
+               //
+                inline bool
+                operator == (const const_iterator &rhs) const noexcept  {
+
+                    return (ptr_ == rhs.ptr_ && col_ == rhs.col_);
+                }
+                inline bool
+                operator != (const const_iterator &rhs) const noexcept  {
+
+                    return (ptr_ != rhs.ptr_ || col_ != rhs.col_);
+                }
+                inline bool
+                operator < (const const_iterator &rhs) const noexcept  {
 
-                    return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+                    return (index_ () < rhs.index_ ());
                 }
-                inline bool operator != (const const_iterator &rhs) const {
+                inline bool
+                operator > (const const_iterator &rhs) const noexcept  {
 
-                    return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+                    return (index_ () > rhs.index_ ());
+                }
+                inline bool
+                operator <= (const const_iterator &rhs) const noexcept  {
+
+                    return (index_ () <= rhs.index_ ());
+                }
+                inline bool
+                operator >= (const const_iterator &rhs) const noexcept  {
+
+                    return (index_ () >= rhs.index_ ());
                 }
 
                // Following STL style, this iterator appears as a pointer
                // to value_type.
                //
-                inline const_pointer operator -> () const noexcept  {
+                inline pointer operator -> () const noexcept  {
 
-                    return (&(matx_->at (idx_ / matx_->columns (),
-                                         idx_ % matx_->columns ())));
+                    return (ptr_);
                 }
-                inline const_reference operator * () const noexcept  {
+                inline reference operator * () const noexcept  {
 
-                    return (matx_->at (idx_ / matx_->columns (),
-                                       idx_ % matx_->columns ()));
+                    return (*ptr_);
                 }
-                inline operator const_pointer () const noexcept  {
+                inline operator pointer () const noexcept  {
 
-                    return (&(matx_->at (idx_ / matx_->columns (),
-                                         idx_ % matx_->columns ())));
+                    return (ptr_);
                 }
 
+                inline reference operator [] (long i) const noexcept  {
+
+                    return (*(*this + i));
+                }
+
+               // Left of the diagonal, [r, c] is stored as [c, r] and the
+               // step to the next column shrinks by one every column. On
+               // and right of the diagonal the row is contiguous.
+               //
                // ++Prefix
                //
                 inline const_iterator &operator ++ () noexcept  {
 
-                    idx_ += 1;
+                    if (++col_ == dim_)  {
+                        col_ = 0;
+                        ptr_ = base_ + ++row_;
+                    }
+                    else if (col_ <= row_)
+                        ptr_ += dim_ - col_;
+                    else
+                        ptr_ += 1;
                     return (*this);
                 }
-
                // Postfix++
                //
                 inline const_iterator operator ++ (int) noexcept  {
 
-                    const   size_type   ret_idx = idx_;
+                    const const_iterator    ret = *this;
 
-                    idx_ += 1;
-                    return (const_iterator (matx_, ret_idx));
+                    ++(*this);
+                    return (ret);
                 }
+
                 inline const_iterator &operator += (long i) noexcept  {
 
-                    idx_ += i;
+                    seek_ (index_ () + i);
                     return (*this);
                 }
 
@@ -287,50 +455,98 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
                //
                 inline const_iterator &operator -- () noexcept  {
 
-                    idx_ -= 1;
+                    if (col_ == 0)  {
+                        col_ = dim_ - 1;
+                        row_ -= 1;
+                        ptr_ = base_ + offset_ (row_, col_);
+                    }
+                    else  {
+                        ptr_ -= col_ <= row_ ? dim_ - col_ : 1;
+                        col_ -= 1;
+                    }
                     return (*this);
                 }
-
                // Postfix--
                //
                 inline const_iterator operator -- (int) noexcept  {
 
-                    const   size_type   ret_idx = idx_;
+                    const const_iterator    ret = *this;
 
-                    idx_ -= 1;
-                    return (const_iterator (matx_, ret_idx));
+                    --(*this);
+                    return (ret);
                 }
 
                 inline const_iterator &operator -= (int i) noexcept  {
 
-                    idx_ -= i;
+                    seek_ (index_ () - i);
                     return (*this);
                 }
 
-                inline const_iterator operator + (int i) noexcept  {
+                inline const_iterator operator + (int i) const noexcept  {
+
+                    return (const_iterator (*this) += i);
+                }
+
+                inline const_iterator operator - (int i) const noexcept  {
 
-                    return (const_iterator (matx_, idx_ + i));
+                    return (const_iterator (*this) -= i);
                 }
 
-                inline const_iterator operator - (int i) noexcept  {
+                inline const_iterator operator + (long i) const noexcept  {
 
-                    return (const_iterator (matx_, idx_ - i));
+                    return (const_iterator (*this) += i);
                 }
 
-                inline const_iterator operator + (long i) noexcept  {
+                inline const_iterator operator - (long i) const noexcept  {
 
-                    return (const_iterator (matx_, idx_ + i));
+                    return (const_iterator (*this) += -i);
                 }
 
-                inline const_iterator operator - (long i) noexcept  {
+                inline difference_type
+                operator - (const const_iterator &rhs) const noexcept  {
 
-                    return (const_iterator (matx_, idx_ - i));
+                    return (index_ () - rhs.index_ ());
                 }
 
             private:
 
-                const   SelfType    *matx_;
-                size_type           idx_;
+                inline long index_ () const noexcept  {
+
+                    return (long(row_) * dim_ + col_);
+                }
+
+               // Offset of [r, c] in the packed upper triangle
+               //
+                inline std::size_t
+                offset_ (std::size_t r, std::size_t c) const noexcept  {
+
+                    if (r > c)
+                        std::swap (r, c);
+                    return (r * dim_ + c - ((r * (r + 1)) >> 1));
+                }
+
+               // Random access is the only place that divides. The two
+               // ends, which loops construct all the time (e.g. col_end()),
+               // don't.
+               //
+                inline void seek_ (long idx) noexcept  {
+
+                    if (idx == 0 || idx == long(dim_) * dim_)  {
+                        row_ = idx == 0 ? 0 : dim_;
+                        col_ = 0;
+                    }
+                    else  {
+                        row_ = size_type(idx / dim_);
+                        col_ = size_type(idx % dim_);
+                    }
+                    ptr_ = base_ + offset_ (row_, col_);
+                }
+
+                pointer     base_ { nullptr };
+                pointer     ptr_ { nullptr };
+                size_type   dim_ { 0 };
+                size_type   row_ { 0 };
+                size_type   col_ { 0 };
         };
 
         typedef iterator        row_iterator;
@@ -379,6 +595,88 @@ class   SymmMatrixBase : public DenseMatrixStorage<T>  {
         }
 };
 
+// ----------------------------------------------------------------------------
+
+// The data vector is a std::vector
+//
+template<class T>
+using SymmMatrixBase = BasicSymmMatrixBase<T, std::vector<T> >;
+
+// The data vector is a memory-mapped file (see MMapVector.h)
+//
+template<class T>
+using MMapSymmMatrixBase = BasicSymmMatrixBase<T, MMapVector<T> >;
+
+// The data vector is on the current MemoryArena of the thread (see
+// MemoryArena.h)
+//
+template<class T>
+using ArenaSymmMatrixBase = BasicSymmMatrixBase<T, ArenaVector<T> >;
+
+// ----------------------------------------------------------------------------
+
+// The packed array of SymmMatrixBase, read by columns, is the lower
+// triangle in column-major order. This is column j of it for an n X n
+// matrix. The returned pointer is offset so that [i] is element (i, j),
+// i >= j, and rows j ... n-1 are contiguous.
+//
+template<class T>
+inline T *packed_column__ (T *ap, std::size_t n, std::size_t j) noexcept  {
+
+    return (ap + (j * n - (j * (j - 1)) / 2) - j);
+}
+
+// Symmetric rank-1 update of a packed n X n matrix:
+//     A = beta * A + alpha * x * ~x
+//
+template<class T>
+inline void packed_rank_one__ (T *ap, std::size_t n,
+                               T beta, T alpha, const T *x) noexcept  {
+
+    for (std::size_t j = 0; j < n; ++j)  {
+        T       *col = packed_column__ (ap, n, j);
+        const T axj = alpha * x[j];
+
+        if (beta != T(1))
+            for (std::size_t i = j; i < n; ++i)
+                col[i] = beta * col[i] + axj * x[i];
+        else if (axj != T(0))
+            for (std::size_t i = j; i < n; ++i)
+                col[i] += axj * x[i];
+    }
+}
+
+// Symmetric product with a packed n X n matrix:
+//     Y = A * X
+//
+// X and Y are n X nrhs and column-major. Each packed column is read once
+// per column of X, and used for both the row and the column it stands for.
+//
+template<class T>
+inline void packed_symm__ (const T *ap, std::size_t n, std::size_t nrhs,
+                           const T *x, std::size_t ldx,
+                           T *y, std::size_t ldy) noexcept  {
+
+    for (std::size_t g = 0; g < nrhs; ++g)  {
+        const T *xg = x + g * ldx;
+        T       *yg = y + g * ldy;
+
+        for (std::size_t i = 0; i < n; ++i)
+            yg[i] = T(0);
+        for (std::size_t j = 0; j < n; ++j)  {
+            const T *col = packed_column__ (ap, n, j);
+            const T xj = xg[j];
+            T       sum = col[j] * xj;
+
+            for (std::size_t i = j + 1; i < n; ++i)  {
+                yg[i] += col[i] * xj;
+                sum += col[i] * xg[i];
+            }
+            yg[j] += sum;
+        }
+    }
+}
+
 } // namespace hmma
 
 // ----------------------------------------------------------------------------
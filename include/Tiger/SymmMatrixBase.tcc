@@ -34,9 +34,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace hmma
 {
 
-template<class T>
-inline typename SymmMatrixBase<T>::reference
-SymmMatrixBase<T>::at (size_type r, size_type c) noexcept  {
+template<class T, class S>
+inline typename BasicSymmMatrixBase<T, S>::reference
+BasicSymmMatrixBase<T, S>::at (size_type r, size_type c) noexcept  {
 
     if (r > c)
         std::swap (r, c);
@@ -47,9 +47,9 @@ SymmMatrixBase<T>::at (size_type r, size_type c) noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-inline typename SymmMatrixBase<T>::const_reference
-SymmMatrixBase<T>::
+template<class T, class S>
+inline typename BasicSymmMatrixBase<T, S>::const_reference
+BasicSymmMatrixBase<T, S>::
 at (size_type r, size_type c) const noexcept  {
 
     if (r > c)
@@ -61,8 +61,8 @@ at (size_type r, size_type c) const noexcept  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-void SymmMatrixBase<T>::
+template<class T, class S>
+void BasicSymmMatrixBase<T, S>::
 resize (size_type in_row, size_type in_col, const_reference def_value)  {
 
     BaseClass::_resize (in_row,
@@ -75,8 +75,8 @@ resize (size_type in_row, size_type in_col, const_reference def_value)  {
 
 // ----------------------------------------------------------------------------
 
-template<class T>
-std::ostream &SymmMatrixBase<T>::
+template<class T, class S>
+std::ostream &BasicSymmMatrixBase<T, S>::
 dump (std::ostream &out_stream) const {
 
     // const   size_type           old_precision = out_stream.precision (2);
@@ -0,0 +1,503 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <iostream>
+
+#include <Tiger/VectorRange.h>
+#include <Tiger/StepVectorRange.h>
+
+#include <Tiger/MatrixBase.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// Symmetric matrix in Rectangular Full Packed (RFP) storage.
+//
+// Like SymmMatrixBase it keeps n * (n + 1) / 2 elements. But they are
+// arranged, the same way as LAPACK's RFP format (TRANSR = 'N',
+// UPLO = 'L'), into one column-major array with a fixed leading
+// dimension. With n1 = n - n / 2 and n2 = n / 2, the matrix is split into
+//
+//     | A11  ~A21 |
+//     | A21   A22 |
+//
+// where A11 is n1 X n1 and A22 is n2 X n2. Inside the array, with leading
+// dimension ld:
+//  -- the lower triangle of A11 is a regular column-major triangle,
+//  -- A21 is a regular n2 X n1 column-major matrix right below it,
+//  -- the upper triangle of A22 is a regular column-major triangle that
+//     sits in the unused upper part of the A11 columns.
+//
+// So everything can be handed to the dense (blocked) kernels as three
+// ordinary blocks, instead of being accessed one element at a time.
+// For n even, ld = n + 1 and A11 starts at the second row. For n odd,
+// ld = n and A22 starts at the second column.
+//
+template<class T>
+class   SymmRFPMatrixBase : public DenseMatrixStorage<T>  {
+
+    public:
+
+        typedef DenseMatrixStorage<T>               BaseClass;
+
+        typedef typename BaseClass::size_type       size_type;
+        typedef typename BaseClass::value_type      value_type;
+        typedef typename BaseClass::reference       reference;
+        typedef typename BaseClass::const_reference const_reference;
+        typedef typename BaseClass::pointer         pointer;
+        typedef typename BaseClass::const_pointer   const_pointer;
+
+        typedef SymmRFPMatrixBase<value_type>       SelfType;
+
+    protected:
+
+        inline SymmRFPMatrixBase () noexcept  {   }
+
+        inline
+        SymmRFPMatrixBase (size_type row,
+                           size_type col,
+                           const_reference def_value = value_type ())
+            // throw (NotSquare)
+            : BaseClass (row, col, (col * (col + 1)) / 2, def_value)  {
+
+            if (row != col)
+                throw NotSquare ();
+        }
+
+        static inline bool _is_symmetric_matrix () noexcept { return (true); }
+
+       // A symmetric matrix is its own transpose
+       //
+        inline void _transpose () noexcept  {   }
+
+    public:
+
+       // Where the three blocks are in the RFP array of an n X n matrix
+       //
+        struct  Layout  {
+
+            explicit Layout (size_type n) noexcept
+                : n1 (n - n / 2),
+                  n2 (n / 2),
+                  ld (n % 2 == 0 ? n + 1 : n),
+                  a11 (n % 2 == 0 ? 1 : 0),
+                  a21 (a11 + n1),
+                  a22 (n % 2 == 0 ? 0 : ld)  {   }
+
+            size_type   n1;
+            size_type   n2;
+            size_type   ld;
+            size_type   a11;  // Offset of A11 (lower triangle)
+            size_type   a21;  // Offset of A21
+            size_type   a22;  // Offset of A22 (upper triangle)
+        };
+
+        inline Layout
+        layout () const noexcept  { return (Layout (BaseClass::columns ())); }
+
+       // The RFP array. It is empty if the matrix is empty.
+       //
+        inline pointer
+        rfp_data () noexcept  { return (BaseClass::_get_data ().data ()); }
+        inline const_pointer rfp_data () const noexcept  {
+
+            return (BaseClass::_get_data ().data ());
+        }
+
+       // Copy the matrix into a full n X n column-major array
+       //
+        inline void unpack (pointer full, size_type ld_full) const noexcept  {
+
+            unpack_columns (rfp_data (), BaseClass::columns (),
+                            0, BaseClass::columns (), full, ld_full);
+        }
+
+       // The other way around. Only the lower triangle of full is read.
+       //
+        inline void pack (const_pointer full, size_type ld_full) noexcept  {
+
+            pack_columns (rfp_data (), BaseClass::columns (),
+                          0, BaseClass::columns (), full, ld_full);
+        }
+
+       // Same as above, but only for columns [col_begin, col_end) and
+       // straight on the RFP array of an n X n matrix. Column col_begin
+       // goes to (comes from) the first column of full. pack_columns()
+       // only reads the rows at or below the diagonal.
+       // The blocked kernels work a panel of columns at a time this way.
+       //
+        static void unpack_columns (const_pointer rfp,
+                                    size_type n,
+                                    size_type col_begin,
+                                    size_type col_end,
+                                    pointer full,
+                                    size_type ld_full) noexcept;
+        static void pack_columns (pointer rfp,
+                                  size_type n,
+                                  size_type col_begin,
+                                  size_type col_end,
+                                  const_pointer full,
+                                  size_type ld_full) noexcept;
+
+        void resize (size_type in_row,
+                     size_type in_col, 
+                     const_reference def_value = value_type ());
+
+        inline reference at (size_type r, size_type c) noexcept;
+        inline const_reference at (size_type r, size_type c) const noexcept;
+
+        std::ostream &dump (std::ostream &out_stream) const;
+
+       // See DenseMatrixStorage
+       //
+        template<typename STRM>
+        inline bool
+        write (STRM &stream, io_format iof = io_format::csv) const  {
+
+            return (BaseClass::_write (stream, iof, matrix_layout::rfp));
+        }
+        inline bool
+        read (const char *file_name, io_format iof = io_format::csv)  {
+
+            return (BaseClass::_read (file_name, iof, matrix_layout::rfp));
+        }
+
+    public:
+
+        class   iterator  {
+
+            public:
+
+                typedef std::random_access_iterator_tag iterator_category;
+
+            public:
+
+               // NOTE: The constructor with no argument initializes
+               //       the iterator to be an "undefined" iterator
+               //
+                inline iterator () noexcept : matx_ (NULL), idx_ (0)  {   }
+
+                inline iterator (SelfType *m, size_type idx = 0) noexcept
+                    : matx_ (m), idx_ (idx)  {   }
+
+                inline bool operator == (const iterator &rhs) const  {
+
+                    return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+                }
+                inline bool operator != (const iterator &rhs) const  {
+
+                    return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+                }
+
+               // Following STL style, this iterator appears as a pointer
+               // to value_type.
+               //
+                inline pointer operator -> () const noexcept  {
+
+                    return (&(matx_->at (idx_ / matx_->columns (),
+                                         idx_ % matx_->columns ())));
+                }
+                inline reference operator * () const noexcept  {
+
+                    return (matx_->at (idx_ / matx_->columns (),
+                                       idx_ % matx_->columns ()));
+                }
+                inline operator pointer () const noexcept  {
+
+                    return (&(matx_->at (idx_ / matx_->columns (),
+                                         idx_ % matx_->columns ())));
+                }
+
+               // We are following STL style iterator interface.
+               //
+                inline iterator &operator ++ () noexcept  {    // ++Prefix
+
+                    idx_ += 1;
+                    return (*this);
+                }
+                inline iterator operator ++ (int) noexcept  {  // Postfix++
+
+                    const   size_type   ret_idx = idx_;
+
+                    idx_ += 1;
+                    return (iterator (matx_, ret_idx));
+                }
+
+                inline iterator &operator += (long i) noexcept  {
+
+                    idx_ += i;
+                    return (*this);
+                }
+
+                inline iterator &operator -- () noexcept  {    // --Prefix
+
+                    idx_ -= 1;
+                    return (*this);
+                }
+                inline iterator operator -- (int) noexcept  {  // Postfix--
+
+                    const   size_type   ret_idx = idx_;
+
+                    idx_ -= 1;
+                    return (iterator (matx_, ret_idx));
+                }
+
+                inline iterator &operator -= (int i) noexcept  {
+
+                    idx_ -= i;
+                    return (*this);
+                }
+
+                inline iterator operator + (int i) noexcept  {
+
+                    return (iterator (matx_, idx_ + i));
+                }
+
+                inline iterator operator - (int i) noexcept  {
+
+                    return (iterator (matx_, idx_ - i));
+                }
+
+                inline iterator operator + (long i) noexcept  {
+
+                    return (iterator (matx_, idx_ + i));
+                }
+
+                inline iterator operator - (long i) noexcept  {
+
+                    return (iterator (matx_, idx_ - i));
+                }
+
+            private:
+
+                SelfType    *matx_;
+                size_type   idx_;
+
+                friend  class   SymmRFPMatrixBase::const_iterator;
+        };
+
+        class   const_iterator  {
+
+            public:
+
+                typedef std::random_access_iterator_tag iterator_category;
+
+            public:
+
+               // NOTE: The constructor with no argument initializes
+               //       the const_iterator to be an "undefined"
+               //       const_iterator
+               //
+                inline const_iterator () noexcept
+                    : matx_ (NULL), idx_ (0)  {   }
+
+                inline const_iterator (const SelfType *m, 
+                                       size_type idx = 0) noexcept
+                    : matx_ (m), idx_ (idx)  {   }
+
+                inline const_iterator (
+                    const typename SelfType::iterator &that)  {
+
+                    *this = that;
+                }
+
+                inline const_iterator &operator = (
+                    const typename SelfType::iterator &rhs)  {
+
+                    matx_ = rhs.matx_;
+                    idx_ = rhs.idx_;
+                    return (*this);
+                }
+
+                inline bool operator == (const const_iterator &rhs) const {
+
+                    return (matx_ == rhs.matx_ && idx_ == rhs.idx_);
+                }
+                inline bool operator != (const const_iterator &rhs) const {
+
+                    return (matx_ != rhs.matx_ || idx_ != rhs.idx_);
+                }
+
+               // Following STL style, this iterator appears as a pointer
+               // to value_type.
+               //
+                inline const_pointer operator -> () const noexcept  {
+
+                    return (&(matx_->at (idx_ / matx_->columns (),
+                                         idx_ % matx_->columns ())));
+                }
+                inline const_reference operator * () const noexcept  {
+
+                    return (matx_->at (idx_ / matx_->columns (),
+                                       idx_ % matx_->columns ()));
+                }
+                inline operator const_pointer () const noexcept  {
+
+                    return (&(matx_->at (idx_ / matx_->columns (),
+                                         idx_ % matx_->columns ())));
+                }
+
+               // ++Prefix
+               //
+                inline const_iterator &operator ++ () noexcept  {
+
+                    idx_ += 1;
+                    return (*this);
+                }
+
+               // Postfix++
+               //
+                inline const_iterator operator ++ (int) noexcept  {
+
+                    const   size_type   ret_idx = idx_;
+
+                    idx_ += 1;
+                    return (const_iterator (matx_, ret_idx));
+                }
+                inline const_iterator &operator += (long i) noexcept  {
+
+                    idx_ += i;
+                    return (*this);
+                }
+
+               // --Prefix
+               //
+                inline const_iterator &operator -- () noexcept  {
+
+                    idx_ -= 1;
+                    return (*this);
+                }
+
+               // Postfix--
+               //
+                inline const_iterator operator -- (int) noexcept  {
+
+                    const   size_type   ret_idx = idx_;
+
+                    idx_ -= 1;
+                    return (const_iterator (matx_, ret_idx));
+                }
+
+                inline const_iterator &operator -= (int i) noexcept  {
+
+                    idx_ -= i;
+                    return (*this);
+                }
+
+                inline const_iterator operator + (int i) noexcept  {
+
+                    return (const_iterator (matx_, idx_ + i));
+                }
+
+                inline const_iterator operator - (int i) noexcept  {
+
+                    return (const_iterator (matx_, idx_ - i));
+                }
+
+                inline const_iterator operator + (long i) noexcept  {
+
+                    return (const_iterator (matx_, idx_ + i));
+                }
+
+                inline const_iterator operator - (long i) noexcept  {
+
+                    return (const_iterator (matx_, idx_ - i));
+                }
+
+            private:
+
+                const   SelfType    *matx_;
+                size_type           idx_;
+        };
+
+        typedef iterator        row_iterator;
+        typedef iterator        col_iterator;
+        typedef const_iterator  row_const_iterator;
+        typedef const_iterator  col_const_iterator;
+
+        inline col_iterator col_begin () noexcept  {
+
+            return (col_iterator (this));
+        }
+        inline col_const_iterator col_begin () const noexcept  {
+
+            return (col_const_iterator (this));
+        }
+        inline col_iterator col_end () noexcept  {
+
+            return (col_iterator (this,
+                                  BaseClass::rows () * BaseClass::columns ()));
+        }
+        inline col_const_iterator col_end () const noexcept  {
+
+            return (col_const_iterator (
+                        this,
+                        BaseClass::rows () * BaseClass::columns ()));
+        }
+
+        inline row_iterator row_begin () noexcept  {
+
+            return (row_iterator (this));
+        }
+        inline row_const_iterator row_begin () const noexcept  {
+
+            return (row_const_iterator (this));
+        }
+        inline row_iterator row_end () noexcept  {
+
+            return (row_iterator (this,
+                                  BaseClass::rows () * BaseClass::columns ()));
+        }
+        inline row_const_iterator row_end () const noexcept  {
+
+            return (row_const_iterator (
+                        this,
+                        BaseClass::rows () * BaseClass::columns ()));
+        }
+};
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/SymmRFPMatrixBase.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
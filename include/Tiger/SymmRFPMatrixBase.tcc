@@ -0,0 +1,202 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Tiger/SymmRFPMatrixBase.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+template<class T>
+inline typename SymmRFPMatrixBase<T>::reference
+SymmRFPMatrixBase<T>::at (size_type r, size_type c) noexcept  {
+
+    if (r < c)
+        std::swap (r, c);
+
+    const size_type n = BaseClass::columns ();
+    const size_type n1 = n - (n >> 1);
+
+   // Lower triangle of A11 and all of A21 are stored by columns. A22 is
+   // stored as its upper triangle.
+   //
+    if (c < n1)
+        return (BaseClass::_get_data ()
+                    [(n & 1 ? 0 : 1) + r + c * (n | 1)]);
+    return (BaseClass::_get_data ()
+                [(n & 1 ? n : 0) + (c - n1) + (r - n1) * (n | 1)]);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+inline typename SymmRFPMatrixBase<T>::const_reference
+SymmRFPMatrixBase<T>::
+at (size_type r, size_type c) const noexcept  {
+
+    if (r < c)
+        std::swap (r, c);
+
+    const size_type n = BaseClass::columns ();
+    const size_type n1 = n - (n >> 1);
+
+   // Lower triangle of A11 and all of A21 are stored by columns. A22 is
+   // stored as its upper triangle.
+   //
+    if (c < n1)
+        return (BaseClass::_get_data ()
+                    [(n & 1 ? 0 : 1) + r + c * (n | 1)]);
+    return (BaseClass::_get_data ()
+                [(n & 1 ? n : 0) + (c - n1) + (r - n1) * (n | 1)]);
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void SymmRFPMatrixBase<T>::
+resize (size_type in_row, size_type in_col, const_reference def_value)  {
+
+    BaseClass::_resize (in_row,
+                        in_col,
+                        (in_col * (in_col + 1)) / 2,
+                        true,
+                        def_value);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void SymmRFPMatrixBase<T>::
+unpack_columns (const_pointer rfp,
+                size_type n,
+                size_type col_begin,
+                size_type col_end,
+                pointer full,
+                size_type ld_full) noexcept  {
+
+    const Layout        lay (n);
+    const std::size_t   ld = lay.ld;
+    const_pointer       a11 = rfp + lay.a11;
+    const_pointer       a22 = rfp + lay.a22;
+
+    for (std::size_t c = col_begin; c < col_end; ++c)  {
+        pointer full_c = full + (c - col_begin) * ld_full;
+
+        if (c < lay.n1)  {  // Column c of A11 and A21
+            for (std::size_t r = 0; r < c; ++r)
+                full_c[r] = a11[c + r * ld];
+            for (std::size_t r = c; r < n; ++r)
+                full_c[r] = a11[r + c * ld];
+        }
+        else  {  // Column c - n1 of ~A21 and A22
+            const std::size_t   cc = c - lay.n1;
+
+            for (std::size_t r = 0; r < lay.n1; ++r)
+                full_c[r] = a11[c + r * ld];
+            for (std::size_t rr = 0; rr <= cc; ++rr)
+                full_c[lay.n1 + rr] = a22[rr + cc * ld];
+            for (std::size_t rr = cc + 1; rr < lay.n2; ++rr)
+                full_c[lay.n1 + rr] = a22[cc + rr * ld];
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+void SymmRFPMatrixBase<T>::
+pack_columns (pointer rfp,
+              size_type n,
+              size_type col_begin,
+              size_type col_end,
+              const_pointer full,
+              size_type ld_full) noexcept  {
+
+    const Layout        lay (n);
+    const std::size_t   ld = lay.ld;
+    pointer             a11 = rfp + lay.a11;
+    pointer             a22 = rfp + lay.a22;
+
+    for (std::size_t c = col_begin; c < col_end; ++c)  {
+        const_pointer   full_c = full + (c - col_begin) * ld_full;
+
+        if (c < lay.n1)
+            for (std::size_t r = c; r < n; ++r)
+                a11[r + c * ld] = full_c[r];
+        else  {
+            const std::size_t   cc = c - lay.n1;
+
+            for (std::size_t rr = cc; rr < lay.n2; ++rr)
+                a22[cc + rr * ld] = full_c[lay.n1 + rr];
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<class T>
+std::ostream &SymmRFPMatrixBase<T>::
+dump (std::ostream &out_stream) const {
+
+    // const   size_type           old_precision = out_stream.precision (2);
+    const   size_type           old_width = out_stream.width (6);
+    const   std::ios::fmtflags  old_flags =
+        out_stream.setf (std::ios::fixed, std::ios::floatfield);
+
+    out_stream << "   ";
+
+    for (size_type r = 0 ; r < BaseClass::rows (); ++r)  {
+        for (size_type c = 0 ; c < BaseClass::columns (); ++c)
+            if (r == 0 && c == 0)
+                out_stream << at (r, c);
+            else
+                out_stream << "     " << at (r, c);
+
+        out_stream << std::endl;
+    }
+
+    out_stream.setf (old_flags);
+    out_stream.width (old_width);
+    // out_stream.precision (old_precision);
+    return (out_stream);
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,152 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+// A small persistent pool of worker threads used by the dense kernels.
+//
+// The threads are created the first time there is parallel work and then
+// sleep on a condition variable between jobs, so a job costs a wake-up
+// instead of a thread creation. The calling thread always takes part in
+// the work, so a pool of N threads has N - 1 workers.
+//
+// A job that is started from inside another job (or while another thread
+// owns the pool) runs serially on the calling thread.
+//
+class   ThreadPool  {
+
+public:
+
+    using size_type = unsigned int;
+
+    explicit ThreadPool (size_type thread_count);
+    ~ThreadPool ();
+
+    ThreadPool (const ThreadPool &) = delete;
+    ThreadPool &operator = (const ThreadPool &) = delete;
+
+    // Total number of threads that work on a job, including the caller
+    //
+    inline size_type thread_count () const noexcept  {
+
+        return (thread_count_.load (std::memory_order_relaxed));
+    }
+
+    // Zero means std::thread::hardware_concurrency()
+    //
+    void set_thread_count (size_type thread_count);
+
+    // Calls func(i) for every i in [0, task_count) and returns when all
+    // of them are done. Tasks are handed out dynamically, so they don't
+    // have to be of the same size.
+    //
+    void parallel_for (std::size_t task_count,
+                       const std::function<void(std::size_t)> &func);
+
+    // The pool used by the library
+    //
+    static ThreadPool &instance ();
+
+private:
+
+    void start_workers_ ();
+    void stop_workers_ ();
+    void worker_loop_ (unsigned long last_job_id);
+    void run_tasks_ ();
+
+    static size_type default_thread_count_ () noexcept;
+    static bool &in_worker_ () noexcept;
+
+    std::atomic<size_type>      thread_count_ { 1 };
+    std::vector<std::thread>    workers_ { };
+
+   // Only one job at a time. Also guards starting/stopping workers.
+   //
+    std::mutex                  job_mutex_ { };
+
+   // State of the current job, guarded by state_mutex_
+   //
+    std::mutex                  state_mutex_ { };
+    std::condition_variable     job_cv_ { };
+    std::condition_variable     done_cv_ { };
+    unsigned long               job_id_ { 0 };
+    size_type                   busy_workers_ { 0 };
+    bool                        stop_ { false };
+
+    const std::function<void(std::size_t)>  *func_ { nullptr };
+    std::size_t                             task_count_ { 0 };
+    std::atomic<std::size_t>                next_task_ { 0 };
+    std::exception_ptr                      error_ { };
+};
+
+// ----------------------------------------------------------------------------
+
+// Number of threads used by the parallel kernels (e.g. matrix multiply).
+// Zero resets it to the number of hardware threads. One turns off all
+// multithreading.
+//
+inline void set_num_threads (unsigned int n)  {
+
+    ThreadPool::instance ().set_thread_count (n);
+}
+
+inline unsigned int get_num_threads ()  {
+
+    return (ThreadPool::instance ().thread_count ());
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <Tiger/ThreadPool.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
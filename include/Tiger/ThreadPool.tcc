@@ -0,0 +1,239 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Tiger/ThreadPool.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmma
+{
+
+inline ThreadPool::ThreadPool (size_type thread_count)  {
+
+    set_thread_count (thread_count);
+}
+
+// ----------------------------------------------------------------------------
+
+inline ThreadPool::~ThreadPool ()  {
+
+    const std::lock_guard<std::mutex>   job_guard (job_mutex_);
+
+    stop_workers_ ();
+}
+
+// ----------------------------------------------------------------------------
+
+inline void ThreadPool::set_thread_count (size_type thread_count)  {
+
+    if (thread_count == 0)
+        thread_count = default_thread_count_ ();
+
+    const std::lock_guard<std::mutex>   job_guard (job_mutex_);
+
+    if (thread_count != thread_count_.load ())  {
+       // The workers are started again by the next job
+       //
+        stop_workers_ ();
+        thread_count_.store (thread_count);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+inline void
+ThreadPool::parallel_for (std::size_t task_count,
+                          const std::function<void(std::size_t)> &func)  {
+
+    if (task_count == 0)  return;
+
+    std::unique_lock<std::mutex>    job_lock (job_mutex_, std::defer_lock);
+
+    if (task_count == 1 || thread_count () < 2 || in_worker_ () ||
+        ! job_lock.try_lock ())  {
+        for (std::size_t i = 0; i < task_count; ++i)
+            func (i);
+        return;
+    }
+
+    if (workers_.size () + 1 != thread_count_.load ())  {
+        stop_workers_ ();
+        start_workers_ ();
+    }
+
+    {
+        const std::lock_guard<std::mutex>   state_guard (state_mutex_);
+
+        func_ = &func;
+        task_count_ = task_count;
+        next_task_.store (0);
+        error_ = nullptr;
+        busy_workers_ = static_cast<size_type>(workers_.size ());
+        ++job_id_;
+    }
+    job_cv_.notify_all ();
+
+    in_worker_ () = true;
+    run_tasks_ ();
+    in_worker_ () = false;
+
+    std::unique_lock<std::mutex>    state_lock (state_mutex_);
+
+    done_cv_.wait (state_lock, [this] { return (busy_workers_ == 0); });
+    func_ = nullptr;
+
+    std::exception_ptr  error = error_;
+
+    error_ = nullptr;
+    state_lock.unlock ();
+    if (error)
+        std::rethrow_exception (error);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+inline ThreadPool &ThreadPool::instance ()  {
+
+    static ThreadPool   pool (default_thread_count_ ());
+
+    return (pool);
+}
+
+// ----------------------------------------------------------------------------
+
+// Must be called with job_mutex_ locked and no job in flight
+//
+inline void ThreadPool::start_workers_ ()  {
+
+    const size_type n = thread_count_.load ();
+
+    workers_.reserve (n - 1);
+    for (size_type i = 1; i < n; ++i)
+        workers_.emplace_back (&ThreadPool::worker_loop_, this, job_id_);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Must be called with job_mutex_ locked and no job in flight
+//
+inline void ThreadPool::stop_workers_ ()  {
+
+    if (workers_.empty ())  return;
+
+    {
+        const std::lock_guard<std::mutex>   state_guard (state_mutex_);
+
+        stop_ = true;
+    }
+    job_cv_.notify_all ();
+    for (auto &worker : workers_)
+        worker.join ();
+    workers_.clear ();
+    stop_ = false;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+inline void ThreadPool::worker_loop_ (unsigned long last_job_id)  {
+
+    in_worker_ () = true;
+    while (true)  {
+        {
+            std::unique_lock<std::mutex>    state_lock (state_mutex_);
+
+            job_cv_.wait (state_lock, [this, last_job_id] {
+                return (stop_ || job_id_ != last_job_id);
+            });
+            if (stop_)  return;
+            last_job_id = job_id_;
+        }
+
+        run_tasks_ ();
+
+        const std::lock_guard<std::mutex>   state_guard (state_mutex_);
+
+        if (--busy_workers_ == 0)
+            done_cv_.notify_one ();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+inline void ThreadPool::run_tasks_ ()  {
+
+    for (std::size_t i = next_task_.fetch_add (1);
+         i < task_count_; i = next_task_.fetch_add (1))  {
+        try  {
+            (*func_) (i);
+        }
+        catch (...)  {
+            const std::lock_guard<std::mutex>   state_guard (state_mutex_);
+
+           // Keep the first one and skip whatever hasn't started yet
+           //
+            if (! error_)
+                error_ = std::current_exception ();
+            next_task_.store (task_count_);
+        }
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+inline ThreadPool::size_type
+ThreadPool::default_thread_count_ () noexcept  {
+
+    const size_type n = std::thread::hardware_concurrency ();
+
+    return (n > 0 ? n : 1);
+}
+
+// ----------------------------------------------------------------------------
+
+inline bool &ThreadPool::in_worker_ () noexcept  {
+
+    static thread_local bool    flag = false;
+
+    return (flag);
+}
+
+} // namespace hmma
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
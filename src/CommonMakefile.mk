@@ -15,12 +15,38 @@ SRCS =
 HEADERS = $(LOCAL_INCLUDE_DIR)/Tiger/MathOperators.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/SymmMatrixBase.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/SymmMatrixBase.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/SymmRFPMatrixBase.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/SymmRFPMatrixBase.tcc \
           $(LOCAL_INCLUDE_DIR)/Tiger/MatrixBase.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/MatrixBase.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MemoryArena.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MemoryArena.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MatrixKernels.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MatrixKernels.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MatrixWorkspace.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MatrixWorkspace.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MMapVector.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/MMapVector.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/OutOfCore.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/OutOfCore.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/ThreadPool.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/ThreadPool.tcc \
           $(LOCAL_INCLUDE_DIR)/Tiger/DenseMatrixBase.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/DenseMatrixBase.tcc \
           $(LOCAL_INCLUDE_DIR)/Tiger/Matrix.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/Matrix.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/LUFactorization.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/LUFactorization.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/CholeskyFactorization.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/CholeskyFactorization.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/PackedFactorization.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/PackedFactorization.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/CovarianceAccumulator.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/CovarianceAccumulator.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/RollingCovariance.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/RollingCovariance.tcc \
+          $(LOCAL_INCLUDE_DIR)/Tiger/LanczosEigenSolver.h \
+          $(LOCAL_INCLUDE_DIR)/Tiger/LanczosEigenSolver.tcc \
           $(LOCAL_INCLUDE_DIR)/Tiger/VectorRange.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/StepVectorRange.h \
           $(LOCAL_INCLUDE_DIR)/Tiger/BaseMathOperators.h
@@ -28,7 +54,8 @@ HEADERS = $(LOCAL_INCLUDE_DIR)/Tiger/MathOperators.h \
 LIB_NAME =
 TARGET_LIB =
 
-TARGETS += $(LOCAL_BIN_DIR)/matrix_tester
+TARGETS += $(LOCAL_BIN_DIR)/matrix_tester \
+           $(LOCAL_BIN_DIR)/matrix_benchmark
 
 INSTALL_TARGETS =
 
@@ -74,13 +101,17 @@ MATRIX_TESTER_OBJ = $(LOCAL_OBJ_DIR)/matrix_tester.o
 $(LOCAL_BIN_DIR)/matrix_tester: $(MATRIX_TESTER_OBJ)
 	$(CXX) -o $@ $(MATRIX_TESTER_OBJ) $(LIBS)
 
+MATRIX_BENCHMARK_OBJ = $(LOCAL_OBJ_DIR)/matrix_benchmark.o
+$(LOCAL_BIN_DIR)/matrix_benchmark: $(MATRIX_BENCHMARK_OBJ)
+	$(CXX) -o $@ $(MATRIX_BENCHMARK_OBJ) $(LIBS)
+
 # -----------------------------------------------------------------------------
 
 depend:
 	makedepend $(CXXFLAGS) -Y $(SRCS)
 
 clobber:
-	rm -f $(TARGETS) $(MATRIX_TESTER_OBJ)
+	rm -f $(TARGETS) $(MATRIX_TESTER_OBJ) $(MATRIX_BENCHMARK_OBJ)
 
 install_lib:
 	cp -pf $(TARGET_LIB) $(PROJECT_LIB_DIR)/.
@@ -0,0 +1,771 @@
+// Hossein Moein
+// February 11, 2018
+/*
+Copyright (c) 2019-2022, Hossein Moein
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Hossein Moein and/or the Tiger nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <Tiger/MathOperators.h>
+#include <Tiger/Matrix.h>
+#include <Tiger/MatrixKernels.h>
+#include <Tiger/PackedFactorization.h>
+#include <Tiger/RollingCovariance.h>
+
+using namespace hmma;
+
+// ----------------------------------------------------------------------------
+
+// Usage: matrix_benchmark [-t max_threads] [dimension ...]
+//
+// If no dimension is given, it runs a default set of square sizes. The
+// tridiagonal reduction, which is only blocked for big matrices, runs on
+// 500 to 4000 then. The SVDs run on tall matrices with 4 times as many
+// rows as the dimension.
+// Thread scaling runs on the largest dimension for 1 to max_threads
+// threads (default is the number of hardware threads).
+//
+
+// ----------------------------------------------------------------------------
+
+static double seconds_since (std::chrono::steady_clock::time_point start)  {
+
+    return (std::chrono::duration<double>(
+                std::chrono::steady_clock::now () - start).count ());
+}
+
+// ----------------------------------------------------------------------------
+
+static void fill_random (DDMatrix &mat)  {
+
+    for (auto iter = mat.col_begin (); iter != mat.col_end (); ++iter)
+        *iter = ::drand48 ();
+}
+
+// ----------------------------------------------------------------------------
+
+// This is how a product used to be evaluated: one dot product at a time
+// through the expression iterators.
+//
+template<class EXPR>
+static void expr_iterator_assign (DDMatrix &lhs, const EXPR &expr)  {
+
+    typename EXPR::const_iterator   rhs_citer = expr.begin ();
+
+    lhs.resize (expr.result_row_size (), expr.result_col_size ());
+    for (auto lhs_iter = lhs.col_begin ();
+         lhs_iter != lhs.col_end (); ++lhs_iter, ++rhs_citer)
+        *lhs_iter = *rhs_citer;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_multiply (DDMatrix::size_type dim)  {
+
+    DDMatrix    a (dim, dim);
+    DDMatrix    b (dim, dim);
+
+    fill_random (a);
+    fill_random (b);
+
+    const double    flops = 2.0 * dim * dim * dim;
+    DDMatrix        c_old;
+    DDMatrix        c_new;
+
+    auto    start = std::chrono::steady_clock::now ();
+
+    expr_iterator_assign (c_old, a * b);
+
+    const double    old_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    c_new = a * b;
+
+    const double    new_secs = seconds_since (start);
+
+    DDMatrix    c_self = a;
+
+    start = std::chrono::steady_clock::now ();
+    c_self *= b;
+
+    const double    self_secs = seconds_since (start);
+    double          max_diff = 0;
+
+    for (DDMatrix::size_type c = 0; c < dim; ++c)
+        for (DDMatrix::size_type r = 0; r < dim; ++r)
+            max_diff = std::max (max_diff,
+                                 std::abs (c_old (r, c) - c_new (r, c)));
+
+    std::cout << "  " << dim << " X " << dim
+              << ":  expression iterators: " << flops / old_secs / 1e9
+              << " GFLOP/s,  operator*: " << flops / new_secs / 1e9
+              << " GFLOP/s,  operator*=: " << flops / self_secs / 1e9
+              << " GFLOP/s,  max diff: " << max_diff << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_plus_minus (DDMatrix::size_type dim)  {
+
+    DDMatrix    a (dim, dim);
+    DDMatrix    b (dim, dim);
+    DDMatrix    c (dim, dim);
+
+    fill_random (a);
+    fill_random (b);
+    fill_random (c);
+
+    const int       reps = std::max (1U, 20000000U / (dim * dim));
+    const double    elements = double(dim) * dim * reps;
+    DDMatrix        d_old (dim, dim);
+    DDMatrix        d_new (dim, dim);
+
+    auto    start = std::chrono::steady_clock::now ();
+
+    for (int i = 0; i < reps; ++i)
+        expr_iterator_assign (d_old, a + b - c);
+
+    const double    old_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    for (int i = 0; i < reps; ++i)
+        d_new = a + b - c;
+
+    const double    new_secs = seconds_since (start);
+
+    std::cout << "  " << dim << " X " << dim
+              << ":  expression iterators: " << old_secs / elements * 1e9
+              << " ns/element,  vectorized: " << new_secs / elements * 1e9
+              << " ns/element,  speedup: " << old_secs / new_secs
+              << ",  equal: " << (d_old == d_new ? "yes" : "no")
+              << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+// This is how solve_se() used to work: rref of the augmented [A | B]
+// matrix followed by back substitution.
+//
+static DDMatrix augmented_solve (const DDMatrix &a, const DDMatrix &b)  {
+
+    const DDMatrix::size_type   n = a.rows ();
+    DDMatrix                    tmp (n, n + b.columns ());
+
+    for (DDMatrix::size_type r = 0; r < n; ++r)  {
+        for (DDMatrix::size_type c = 0; c < n; ++c)
+            tmp (r, c) = a (r, c);
+        for (DDMatrix::size_type c = 0; c < b.columns (); ++c)
+            tmp (r, n + c) = b (r, c);
+    }
+
+    DDMatrix::size_type rank;
+
+    tmp.rref (rank);
+
+    DDMatrix    sol (n, b.columns ());
+
+    for (DDMatrix::size_type bc = 0; bc < b.columns (); ++bc)
+        for (int r = static_cast<int>(n) - 1; r >= 0; --r)  {
+            sol (r, bc) = tmp (r, n + bc);
+            for (DDMatrix::size_type c = r + 1; c < n; ++c)
+                sol (r, bc) -= tmp (r, c) * sol (c, bc);
+        }
+
+    return (sol);
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_solve (DDMatrix::size_type dim)  {
+
+    DDMatrix    a (dim, dim);
+    DDMatrix    b (dim, dim);
+
+    fill_random (a);
+    fill_random (b);
+    for (DDMatrix::size_type i = 0; i < dim; ++i)
+        a (i, i) += double(dim);
+
+    double  old_secs = 0;
+    auto    start = std::chrono::steady_clock::now ();
+
+    if (dim <= 500)  {
+        const DDMatrix  x = augmented_solve (a, b);
+
+        old_secs = seconds_since (start);
+    }
+
+    start = std::chrono::steady_clock::now ();
+
+    const DDMatrix  x = a.solve_se (b);
+    const double    new_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    a.solve_se_in_place (b);
+
+    const double    in_place_secs = seconds_since (start);
+
+    std::cout << "  " << dim << " X " << dim << " with " << dim
+              << " right-hand sides:  augmented rref: ";
+    if (old_secs > 0)
+        std::cout << old_secs << " s";
+    else
+        std::cout << "skipped";
+    std::cout << ",  solve_se: " << new_secs
+              << " s,  solve_se_in_place: " << in_place_secs << " s"
+              << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+// This is how chod() used to work: unblocked, dot products through
+// operator().
+//
+static void unblocked_chod (const DDMatrix &a, DDMatrix &r_tmp)  {
+
+    r_tmp.resize (a.rows (), a.columns ());
+    for (DDMatrix::size_type c = 0; c < a.columns (); ++c)  {
+        double  d = 0;
+
+        for (DDMatrix::size_type r = 0; r < c; ++r)  {
+            double  s = a (r, c);
+
+            for (DDMatrix::size_type rr = 0; rr < r; ++rr)
+                s -= r_tmp (rr, r) * r_tmp (rr, c);
+            r_tmp (r, c) = s /= r_tmp (r, r);
+            d += s * s;
+        }
+        r_tmp (c, c) = std::sqrt (a (c, c) - d);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_cholesky (DDMatrix::size_type dim)  {
+
+    DDMatrix    a (dim, dim);
+    DDMatrix    b (dim, dim);
+
+    for (DDMatrix::size_type c = 0; c < dim; ++c)
+        for (DDMatrix::size_type r = 0; r <= c; ++r)
+            a (r, c) = a (c, r) = ::drand48 ();
+    for (DDMatrix::size_type i = 0; i < dim; ++i)
+        a (i, i) += double(dim);
+    fill_random (b);
+
+    const double    flops = double(dim) * dim * dim / 3.0;
+    DDMatrix        r;
+    auto            start = std::chrono::steady_clock::now ();
+
+    unblocked_chod (a, r);
+
+    const double    old_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    a.chod (r);
+
+    const double    new_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+
+    const DDMatrix  x1 = a.solve_se (b);
+    const double    lu_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+
+    const DDMatrix  x2 = a.cholesky_solve (b);
+    const double    chol_secs = seconds_since (start);
+
+    std::cout << "  " << dim << " X " << dim
+              << ":  unblocked chod: " << flops / old_secs / 1e9
+              << " GFLOP/s,  blocked chod: " << flops / new_secs / 1e9
+              << " GFLOP/s,  solve_se: " << lu_secs
+              << " s,  cholesky_solve: " << chol_secs << " s" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+// This is how the tridiagonal reduction of eigen_space() used to work (and
+// still does for small matrices): one Householder reflector at a time,
+// through operator(). The transformations are not accumulated.
+//
+static void
+unblocked_tridiagonal (DDMatrix &a, std::vector<double> &d,
+                       std::vector<double> &e)  {
+
+    const DDMatrix::size_type   n = a.rows ();
+
+    d.assign (n, 0);
+    e.assign (n, 0);
+    for (DDMatrix::size_type c = 0; c < n; ++c)
+        d[c] = a (n - 1, c);
+    for (DDMatrix::size_type r = n - 1; r > 0; --r)  {
+        double  scale = 0;
+        double  h = 0;
+
+        for (DDMatrix::size_type c = 0; c < r; ++c)
+            scale += std::fabs (d[c]);
+        if (scale == 0)  {
+            e[r] = d[r - 1];
+            for (DDMatrix::size_type c = 0; c < r; ++c)  {
+                d[c] = a (r - 1, c);
+                a (r, c) = a (c, r) = 0;
+            }
+            d[r] = 0;
+            continue;
+        }
+        for (DDMatrix::size_type c = 0; c < r; ++c)  {
+            d[c] /= scale;
+            h += d[c] * d[c];
+        }
+
+        const double    f = d[r - 1];
+        double          g = f > 0 ? -std::sqrt (h) : std::sqrt (h);
+
+        e[r] = scale * g;
+        h -= f * g;
+        d[r - 1] = f - g;
+        for (DDMatrix::size_type c = 0; c < r; ++c)
+            e[c] = 0;
+        for (DDMatrix::size_type c = 0; c < r; ++c)  {
+            a (c, r) = d[c];
+            g = e[c] + a (c, c) * d[c];
+            for (DDMatrix::size_type cc = c + 1; cc <= r - 1; ++cc)  {
+                g += a (cc, c) * d[cc];
+                e[cc] += a (cc, c) * d[c];
+            }
+            e[c] = g;
+        }
+
+        double  ff = 0;
+
+        for (DDMatrix::size_type c = 0; c < r; ++c)  {
+            e[c] /= h;
+            ff += e[c] * d[c];
+        }
+
+        const double    hh = ff / (h + h);
+
+        for (DDMatrix::size_type c = 0; c < r; ++c)
+            e[c] -= hh * d[c];
+        for (DDMatrix::size_type c = 0; c < r; ++c)  {
+            for (DDMatrix::size_type cc = c; cc <= r - 1; ++cc)
+                a (cc, c) -= d[c] * e[cc] + e[c] * d[cc];
+            d[c] = a (r - 1, c);
+            a (r, c) = 0;
+        }
+        d[r] = h;
+    }
+    for (DDMatrix::size_type c = 0; c < n; ++c)
+        d[c] = a (c, c);
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_tridiagonal (DDMatrix::size_type dim)  {
+
+    DDMatrix    a (dim, dim);
+
+    for (DDMatrix::size_type c = 0; c < dim; ++c)
+        for (DDMatrix::size_type r = 0; r <= c; ++r)
+            a (r, c) = a (c, r) = ::drand48 ();
+
+    const double        flops = 4.0 * double(dim) * dim * dim / 3.0;
+    DDMatrix            work = a;
+    std::vector<double> d;
+    std::vector<double> e;
+    auto                start = std::chrono::steady_clock::now ();
+
+    unblocked_tridiagonal (work, d, e);
+
+    const double    old_secs = seconds_since (start);
+
+    std::vector<double> tau (dim);
+
+    work = a;
+    start = std::chrono::steady_clock::now ();
+    sytrd (dim, &(work (0, 0)), dim, d.data (), e.data (), tau.data ());
+
+    const double    new_secs = seconds_since (start);
+
+    std::cout << "  " << dim << " X " << dim
+              << ":  unblocked: " << old_secs << " s ("
+              << flops / old_secs / 1e9 << " GFLOP/s),  blocked sytrd: "
+              << new_secs << " s (" << flops / new_secs / 1e9
+              << " GFLOP/s)" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_randomized_svd (DDMatrix::size_type dim)  {
+
+    const DDMatrix::size_type   rows = 4 * dim;
+    const DDMatrix::size_type   k = std::min<DDMatrix::size_type> (dim, 20);
+    DDMatrix                    a (rows, dim);
+
+    fill_random (a);
+
+    DDMatrix    u;
+    DDMatrix    s;
+    DDMatrix    v;
+    auto        start = std::chrono::steady_clock::now ();
+
+    a.svd (u, s, v, false);
+
+    const double    old_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    a.randomized_svd (k, u, s, v);
+
+    const double    new_secs = seconds_since (start);
+
+    std::cout << "  " << rows << " X " << dim << ", k = " << k
+              << ":  svd: " << old_secs << " s,  randomized_svd: "
+              << new_secs << " s (" << old_secs / new_secs << "x)"
+              << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_packed (DDMatrix::size_type dim)  {
+
+    SDMatrix    a (dim, dim);
+    RFPDMatrix  rfp (dim, dim);
+
+    for (DDMatrix::size_type c = 0; c < dim; ++c)
+        for (DDMatrix::size_type r = 0; r <= c; ++r)
+            rfp (r, c) = a (r, c) = ::drand48 ();
+    for (DDMatrix::size_type i = 0; i < dim; ++i)  {
+        a (i, i) += double(dim);
+        rfp (i, i) += double(dim);
+    }
+
+    const double    flops = double(dim) * dim * dim / 3.0;
+    DDMatrix        r;
+    auto            start = std::chrono::steady_clock::now ();
+
+    a.chod (r);
+
+    const double    dense_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+
+    const PackedCholeskyFactorization<double>   chol (std::move (a));
+    const double                                packed_secs =
+        seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+
+    const RFPCholeskyFactorization<double>  rfp_chol (std::move (rfp));
+    const double                            rfp_secs = seconds_since (start);
+
+    std::cout << "  " << dim << " X " << dim
+              << ":  chod() on SDMatrix: " << flops / dense_secs / 1e9
+              << " GFLOP/s,  packed in place: " << flops / packed_secs / 1e9
+              << " GFLOP/s,  RFP in place: " << flops / rfp_secs / 1e9
+              << " GFLOP/s,  factor memory: "
+              << double(dim) * dim * sizeof(double) / 1e6 << " MB vs "
+              << double(dim) * (dim + 1) / 2 * sizeof(double) / 1e6
+              << " MB" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+// This is how covariance() used to work: all the n^2 entries, with dot
+// products through operator().
+//
+static void triple_loop_covariance (const DDMatrix &a, DDMatrix &cov)  {
+
+    cov.resize (a.columns (), a.columns ());
+    for (DDMatrix::size_type c = 0; c < a.columns (); ++c)  {
+        double  col_mean = 0;
+
+        for (DDMatrix::size_type r = 0; r < a.rows (); ++r)
+            col_mean += a (r, c);
+        col_mean /= double(a.rows ());
+        for (DDMatrix::size_type cc = 0; cc < a.columns (); ++cc)  {
+            double  var = 0;
+
+            for (DDMatrix::size_type r = 0; r < a.rows (); ++r)
+                var += (a (r, c) - col_mean) * (a (r, cc) - col_mean);
+            cov (c, cc) = var / double(a.rows () - 1);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_covariance (DDMatrix::size_type dim)  {
+
+    constexpr DDMatrix::size_type   rows = 250;
+
+    DDMatrix    a (rows, dim);
+    DDMatrix    cov;
+    SDMatrix    symm_cov;
+
+    fill_random (a);
+
+    auto    start = std::chrono::steady_clock::now ();
+
+    triple_loop_covariance (a, cov);
+
+    const double    old_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    cov = a.covariance ();
+
+    const double    new_secs = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    a.covariance (symm_cov);
+
+    const double    symm_secs = seconds_since (start);
+
+    std::cout << "  " << rows << " X " << dim
+              << ":  triple loop: " << old_secs
+              << " s,  covariance(): " << new_secs
+              << " s,  into SDMatrix: " << symm_secs << " s" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_rolling (DDMatrix::size_type dim)  {
+
+    constexpr DDMatrix::size_type   window = 250;
+    constexpr DDMatrix::size_type   steps = 20;
+
+    DDMatrix                    history (window + steps, dim);
+    DDMatrix                    last (window, dim);
+    RollingCovariance<double>   rolling =
+        RollingCovariance<double>::window (dim, window);
+    SDMatrix                    cov;
+
+    fill_random (history);
+    for (DDMatrix::size_type r = 0; r < window; ++r)
+        rolling.push_row (history, r);
+
+    auto    start = std::chrono::steady_clock::now ();
+
+    for (DDMatrix::size_type t = window; t < window + steps; ++t)  {
+        for (DDMatrix::size_type r = 0; r < window; ++r)
+            for (DDMatrix::size_type c = 0; c < dim; ++c)
+                last (r, c) = history (t + 1 - window + r, c);
+        last.covariance (cov);
+    }
+
+    const double    full_secs = seconds_since (start) / steps;
+
+    start = std::chrono::steady_clock::now ();
+    for (DDMatrix::size_type t = window; t < window + steps; ++t)  {
+        rolling.push_row (history, t);
+        cov = rolling.covariance ();
+    }
+
+    const double    rolling_secs = seconds_since (start) / steps;
+
+    std::cout << "  " << window << " X " << dim
+              << " window, per step:  covariance(): " << full_secs
+              << " s,  RollingCovariance: " << rolling_secs << " s"
+              << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void bench_io (DDMatrix::size_type dim)  {
+
+    const char  *csv_file = "tiger_bench.csv";
+    const char  *bin_file = "tiger_bench.bin";
+    DDMatrix    mat (dim, dim);
+    DDMatrix    csv_mat;
+    DDMatrix    bin_mat;
+
+    fill_random (mat);
+
+    auto    start = std::chrono::steady_clock::now ();
+
+    {
+        std::ofstream   out (csv_file);
+
+        mat.write (out, io_format::csv);
+    }
+
+    const double    csv_write = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    {
+        std::ofstream   out (bin_file, std::ios::binary);
+
+        mat.write (out, io_format::binary);
+    }
+
+    const double    bin_write = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    csv_mat.read (csv_file, io_format::csv);
+
+    const double    csv_read = seconds_since (start);
+
+    start = std::chrono::steady_clock::now ();
+    bin_mat.read (bin_file, io_format::binary);
+
+    const double    bin_read = seconds_since (start);
+
+    std::remove (csv_file);
+    std::remove (bin_file);
+    std::cout << "  " << dim << " X " << dim << ":  write csv: " << csv_write
+              << " s,  binary: " << bin_write << " s,  read csv: " << csv_read
+              << " s,  binary: " << bin_read << " s" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+static void
+bench_threads (DDMatrix::size_type dim, unsigned int max_threads)  {
+
+    DDMatrix    a (dim, dim);
+    DDMatrix    b (dim, dim);
+    DDMatrix    c;
+
+    fill_random (a);
+    fill_random (b);
+
+    const double    flops = 2.0 * dim * dim * dim;
+    double          one_thread_secs = 0;
+
+    for (unsigned int t = 1; t <= max_threads; ++t)  {
+        set_num_threads (t);
+        c = a * b;  // Warm up the pool
+
+       // Best of three
+       //
+        double  secs = 0;
+
+        for (int i = 0; i < 3; ++i)  {
+            const auto  start = std::chrono::steady_clock::now ();
+
+            c = a * b;
+
+            const double    s = seconds_since (start);
+
+            secs = i == 0 ? s : std::min (secs, s);
+        }
+        if (t == 1)
+            one_thread_secs = secs;
+
+        std::cout << "  " << dim << " X " << dim << ",  " << t
+                  << " threads:  " << flops / secs / 1e9
+                  << " GFLOP/s,  speedup: " << one_thread_secs / secs
+                  << std::endl;
+    }
+    set_num_threads (0);
+}
+
+// ----------------------------------------------------------------------------
+
+int main (int argCnt, char *argVctr [])  {
+
+    std::vector<DDMatrix::size_type>   dims;
+    unsigned int                        max_threads =
+        std::max (1U, std::thread::hardware_concurrency ());
+
+    for (int i = 1; i < argCnt; ++i)
+        if (! ::strcmp (argVctr [i], "-t") && i + 1 < argCnt)
+            max_threads = std::max (1, ::atoi (argVctr [++i]));
+        else
+            dims.push_back (::atoi (argVctr [i]));
+
+    std::vector<DDMatrix::size_type>   tri_dims = dims;
+
+    if (dims.empty ())  {
+        dims = { 64, 128, 256, 500, 1000 };
+        tri_dims = { 500, 1000, 2000, 4000 };
+    }
+
+    std::cout.precision (4);
+
+    std::cout << "\nMatrix multiplication ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_multiply (dim);
+
+    std::cout << "\nA + B - C ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_plus_minus (dim);
+
+    std::cout << "\nA * X = B ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_solve (dim);
+
+    std::cout << "\nCholesky ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_cholesky (dim);
+
+    std::cout << "\nTridiagonal reduction ...\n" << std::endl;
+    for (const auto dim : tri_dims)
+        bench_tridiagonal (dim);
+
+    std::cout << "\nRandomized SVD ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_randomized_svd (dim);
+
+    std::cout << "\nPacked Cholesky ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_packed (dim);
+
+    std::cout << "\nCovariance ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_covariance (dim);
+
+    std::cout << "\nRolling covariance ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_rolling (dim);
+
+    std::cout << "\nMatrix I/O ...\n" << std::endl;
+    for (const auto dim : dims)
+        bench_io (dim);
+
+    std::cout << "\nMatrix multiplication thread scaling ...\n" << std::endl;
+    bench_threads (*std::max_element (dims.begin (), dims.end ()),
+                   max_threads);
+
+    return (EXIT_SUCCESS);
+}
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -27,18 +27,68 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <time.h>
+#include <vector>
 
 #include <Tiger/BaseMathOperators.h>
 #include <Tiger/MathOperators.h>
 #include <Tiger/Complex.h>
+#include <Tiger/CholeskyFactorization.h>
+#include <Tiger/CovarianceAccumulator.h>
+#include <Tiger/LUFactorization.h>
+#include <Tiger/LanczosEigenSolver.h>
 #include <Tiger/Matrix.h>
+#include <Tiger/MatrixWorkspace.h>
+#include <Tiger/PackedFactorization.h>
+#include <Tiger/RollingCovariance.h>
 
 using namespace hmma;
 
 // ----------------------------------------------------------------------------
 
+// Off-diagonal element (i, j) of the symmetric matrices the factorization
+// tests share. The tests put a large value on the diagonal to make them
+// positive-definite.
+//
+static double symm_test_value (std::size_t i, std::size_t j)  {
+
+    return (double((i * 7 + j * 11) % 13) / 13.0);
+}
+
+// ----------------------------------------------------------------------------
+
+// Fills the right-hand sides the solver tests share
+//
+static void fill_test_rhs (DDMatrix &rhs)  {
+
+    for (DDMatrix::size_type i = 0; i < rhs.rows (); ++i)
+        for (DDMatrix::size_type j = 0; j < rhs.columns (); ++j)
+            rhs (i, j) = double((i * 3 + j * 5) % 17) - 8.0;
+}
+
+// ----------------------------------------------------------------------------
+
+static double max_abs (const DDMatrix &m)  {
+
+    double  result = 0;
+
+    for (auto citer = m.col_begin (); citer != m.col_end (); ++citer)
+        result = std::max (result, std::fabs (*citer));
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
 int main (int argCnt, char *argVctr [])  {
 
     std::cout.precision (2);
@@ -1607,6 +1657,2427 @@ int main (int argCnt, char *argVctr [])  {
 
         std::cout.precision (pre);
     }
+    {
+        std::cout << "\nTesting blocked matrix multiplication ...\n"
+                  << std::endl;
+
+        DDMatrix dmat1 (70, 45);
+        DDMatrix dmat2 (45, 90);
+        DDMatrix dmat3 (90, 90);
+
+        for (DDMatrix::size_type i = 0; i < 70; ++i)
+            for (DDMatrix::size_type j = 0; j < 45; ++j)
+                dmat1 (i, j) = double(i * 3 + j) / 17.0;
+        for (DDMatrix::size_type i = 0; i < 45; ++i)
+            for (DDMatrix::size_type j = 0; j < 90; ++j)
+                dmat2 (i, j) = double(i) - double(j) / 7.0;
+        for (DDMatrix::size_type i = 0; i < 90; ++i)
+            for (DDMatrix::size_type j = 0; j < 90; ++j)
+                dmat3 (i, j) = i == j ? 2.0 : 1.0 / double(i + j + 1);
+
+        DDMatrix naive (70, 90);
+        DDMatrix naive2 (70, 90);
+
+        for (DDMatrix::size_type i = 0; i < 70; ++i)
+            for (DDMatrix::size_type j = 0; j < 90; ++j)
+                for (DDMatrix::size_type k = 0; k < 45; ++k)
+                    naive (i, j) += dmat1 (i, k) * dmat2 (k, j);
+        for (DDMatrix::size_type i = 0; i < 70; ++i)
+            for (DDMatrix::size_type j = 0; j < 90; ++j)
+                for (DDMatrix::size_type k = 0; k < 90; ++k)
+                    naive2 (i, j) += naive (i, k) * dmat3 (k, j);
+
+        const   DDMatrix product = dmat1 * dmat2;
+        const   DDMatrix product2 = dmat1 * dmat2 * dmat3;
+        const   DDMatrix tran_product = ~ dmat2 * ~ dmat1;
+        const   DDMatrix product3 = ~ tran_product * dmat3;
+        DDMatrix         self_product = dmat1;
+
+        self_product *= dmat2;
+        self_product *= dmat3;
+
+        double  max_diff = 0;
+
+        for (DDMatrix::size_type i = 0; i < 70; ++i)
+            for (DDMatrix::size_type j = 0; j < 90; ++j)  {
+                max_diff = std::max (max_diff,
+                                     std::fabs (product (i, j) -
+                                                naive (i, j)));
+                max_diff = std::max (max_diff,
+                                     std::fabs (product2 (i, j) -
+                                                naive2 (i, j)));
+                max_diff = std::max (max_diff,
+                                     std::fabs (product3 (i, j) -
+                                                naive2 (i, j)));
+                max_diff = std::max (max_diff,
+                                     std::fabs (self_product (i, j) -
+                                                naive2 (i, j)));
+            }
+
+        if (product.rows () != 70 || product.columns () != 90 ||
+            max_diff > 1e-9)  {
+            std::cout << "ERROR: Blocked multiplication doesn't agree with "
+                         "the naive product: " << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+       // The result may alias one of the operands
+       //
+        dmat3 = dmat3 * dmat3;
+        std::cout << "A = A * A, A(0, 0): " << dmat3 (0, 0) << std::endl;
+        std::cout << "Blocked multiplication agrees with the naive product"
+                  << std::endl;
+    }
+    {
+        std::cout << "\nTesting multithreaded matrix multiplication ...\n"
+                  << std::endl;
+
+        DDMatrix dmat1 (301, 203);
+        DDMatrix dmat2 (203, 257);
+
+        for (DDMatrix::size_type i = 0; i < 301; ++i)
+            for (DDMatrix::size_type j = 0; j < 203; ++j)
+                dmat1 (i, j) = double((i * 7 + j * 3) % 11) - 5.0;
+        for (DDMatrix::size_type i = 0; i < 203; ++i)
+            for (DDMatrix::size_type j = 0; j < 257; ++j)
+                dmat2 (i, j) = double((i + j * 5) % 13) / 4.0;
+
+        set_num_threads (1);
+
+        const DDMatrix  serial = dmat1 * dmat2;
+        const DDMatrix  serial_tran = ~dmat2 * ~dmat1;
+
+        set_num_threads (4);
+        std::cout << "Number of threads: " << get_num_threads () << std::endl;
+
+        const DDMatrix  parallel = dmat1 * dmat2;
+        const DDMatrix  parallel_tran = ~dmat2 * ~dmat1;
+        DDMatrix        self_product = dmat1;
+
+        self_product *= dmat2;
+
+        double  max_diff = 0;
+
+        for (DDMatrix::size_type i = 0; i < 301; ++i)
+            for (DDMatrix::size_type j = 0; j < 257; ++j)  {
+                max_diff = std::max (max_diff,
+                                     std::fabs (parallel (i, j) -
+                                                serial (i, j)));
+                max_diff = std::max (max_diff,
+                                     std::fabs (self_product (i, j) -
+                                                serial (i, j)));
+                max_diff = std::max (max_diff,
+                                     std::fabs (parallel_tran (j, i) -
+                                                serial_tran (j, i)));
+            }
+
+        if (max_diff != 0)  {
+            std::cout << "ERROR: Multithreaded multiplication doesn't agree "
+                         "with the serial one: " << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+       // Small products stay on the calling thread
+       //
+        DDMatrix    small (8, 8, 1.0);
+
+        small = small * small;
+        std::cout << "8 X 8 product, (7, 7): " << small (7, 7) << std::endl;
+
+       // A parallel loop started from inside another one runs serially
+       //
+        std::vector<std::size_t>    counts (16, 0);
+
+        ThreadPool::instance ().parallel_for (
+            4,
+            [&counts](std::size_t i)  {
+                ThreadPool::instance ().parallel_for (
+                    4,
+                    [&counts, i](std::size_t j) { counts [i * 4 + j] += 1; });
+            });
+        if (std::count (counts.begin (), counts.end (), 1) != 16)  {
+            std::cout << "ERROR: Nested parallel loop missed tasks"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        set_num_threads (0);
+        std::cout << "Multithreaded multiplication agrees with the serial one"
+                  << std::endl;
+    }
+    {
+        std::cout << "\nTesting vectorized addition and subtraction ...\n"
+                  << std::endl;
+
+        DDMatrix dmat1 (101, 53);
+        DDMatrix dmat2 (101, 53);
+        DDMatrix dmat3 (101, 53);
+        DDMatrix dmat4 (53, 53);
+
+        for (DDMatrix::size_type i = 0; i < 101; ++i)
+            for (DDMatrix::size_type j = 0; j < 53; ++j)  {
+                dmat1 (i, j) = double(i * 53 + j) / 3.0;
+                dmat2 (i, j) = double(i) - double(j) * 0.7;
+                dmat3 (i, j) = double((i * j) % 17) / 11.0;
+            }
+        for (DDMatrix::size_type i = 0; i < 53; ++i)
+            for (DDMatrix::size_type j = 0; j < 53; ++j)
+                dmat4 (i, j) = i == j ? 2.0 : 0.0;
+
+        const DDMatrix  chain = dmat1 + dmat2 - dmat3;
+        const DDMatrix  grouped = dmat1 - (dmat2 + dmat3);
+        const DDMatrix  mixed = dmat1 + dmat2 * dmat4 - dmat3;
+        DDMatrix        aliased = dmat1;
+        DDMatrix        in_place = dmat1;
+
+        aliased = aliased + dmat2;
+        in_place += dmat2;
+        in_place -= dmat3;
+
+        bool    ok = chain.rows () == 101 && chain.columns () == 53;
+
+        for (DDMatrix::size_type i = 0; i < 101; ++i)
+            for (DDMatrix::size_type j = 0; j < 53; ++j)  {
+                ok = ok &&
+                     chain (i, j) == dmat1 (i, j) + dmat2 (i, j) -
+                                     dmat3 (i, j) &&
+                     grouped (i, j) == dmat1 (i, j) -
+                                       (dmat2 (i, j) + dmat3 (i, j)) &&
+                     mixed (i, j) == dmat1 (i, j) + dmat2 (i, j) * 2.0 -
+                                     dmat3 (i, j) &&
+                     aliased (i, j) == dmat1 (i, j) + dmat2 (i, j) &&
+                     in_place (i, j) == dmat1 (i, j) + dmat2 (i, j) -
+                                        dmat3 (i, j);
+            }
+
+       // A size that is not a multiple of any vector width
+       //
+        Matrix<DenseMatrixBase, float>  fmat1 (7, 3, 1.5F);
+        Matrix<DenseMatrixBase, float>  fmat2 (7, 3, 0.25F);
+        Matrix<DenseMatrixBase, float>  fmat3;
+
+        fmat3 = fmat1 - fmat2 + fmat1;
+        for (auto citer = fmat3.col_begin (); citer != fmat3.col_end ();
+             ++citer)
+            ok = ok && *citer == 2.75F;
+
+        if (! ok)  {
+            std::cout << "ERROR: Vectorized addition/subtraction doesn't "
+                         "agree with the scalar one" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "(A + B - C)(100, 52): " << chain (100, 52) << std::endl;
+        std::cout << "Vectorized addition and subtraction agree with "
+                     "the scalar one" << std::endl;
+    }
+    {
+        std::cout << "\nTesting LUFactorization ...\n" << std::endl;
+
+       // Bigger than one panel, so the blocked path is exercised
+       //
+        const DDMatrix::size_type   n = 150;
+        DDMatrix                    dmat (n, n);
+        DDMatrix                    rhs (n, 7);
+
+        for (DDMatrix::size_type i = 0; i < n; ++i)  {
+            for (DDMatrix::size_type j = 0; j < n; ++j)
+                dmat (i, j) = double((i * 13 + j * 7) % 23) - 11.0;
+            dmat (i, i) += 30.0;
+            for (DDMatrix::size_type j = 0; j < 7; ++j)
+                rhs (i, j) = double(i + j) / 10.0;
+        }
+
+        const LUFactorization<DDMatrix> lu (dmat);
+        const DDMatrix                  sol = lu.solve (rhs);
+        const DDMatrix                  residual = dmat * sol - rhs;
+        DDMatrix                        inv;
+
+        lu.inverse (inv);
+
+        const DDMatrix  ident = inv * dmat;
+        double          max_err = 0;
+
+        for (auto citer = residual.col_begin ();
+             citer != residual.col_end (); ++citer)
+            max_err = std::max (max_err, std::fabs (*citer));
+        for (DDMatrix::size_type i = 0; i < n; ++i)
+            for (DDMatrix::size_type j = 0; j < n; ++j)
+                max_err = std::max (max_err,
+                                    std::fabs (ident (i, j) -
+                                               (i == j ? 1.0 : 0.0)));
+
+       // P * A = L * U
+       //
+        DDMatrix    L;
+        DDMatrix    U;
+        DDMatrix    pa = dmat;
+
+        lu.get_lower (L);
+        lu.get_upper (U);
+        for (DDMatrix::size_type i = 0; i < n; ++i)
+            for (DDMatrix::size_type c = 0; c < n; ++c)
+                std::swap (pa (i, c), pa (lu.get_pivots ()[i], c));
+
+        const DDMatrix  lu_prod = L * U;
+
+        for (DDMatrix::size_type i = 0; i < n; ++i)
+            for (DDMatrix::size_type j = 0; j < n; ++j)
+                max_err = std::max (max_err,
+                                    std::fabs (lu_prod (i, j) - pa (i, j)));
+
+        if (max_err > 1e-9 || lu.is_singular () || lu.rank () != n)  {
+            std::cout << "ERROR: LUFactorization is not accurate: "
+                      << max_err << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        DDMatrix    small (3, 3);
+
+        small (0, 0) = 2;  small (0, 1) = 3;  small (0, 2) = 2;
+        small (1, 0) = 3;  small (1, 1) = 2;  small (1, 2) = 3;
+        small (2, 0) = 4;  small (2, 1) = 2;  small (2, 2) = 2;
+
+        const LUFactorization<DDMatrix> small_lu (small);
+
+        std::cout << "Determinant: " << small_lu.determinant ()
+                  << ", from the matrix: " << small.determinant ()
+                  << std::endl;
+
+       // A rank deficient rectangular matrix
+       //
+        DDMatrix    deficient (3, 4);
+
+        for (DDMatrix::size_type j = 0; j < 4; ++j)  {
+            deficient (0, j) = 0;
+            deficient (1, j) = double(j + 1);
+            deficient (2, j) = double(2 * j + 2);
+        }
+        std::cout << "Rank of a 3 X 4 matrix with two dependent rows: "
+                  << deficient.rank () << std::endl;
+
+       // Columns without a pivot in the middle of U
+       //
+        DDMatrix    nilpotent (2, 2, 0.0);
+        DDMatrix    wide (2, 3, 0.0);
+        DDMatrix    shift (3, 3, 0.0);
+
+        nilpotent (0, 1) = 1;
+        wide (0, 1) = 1;
+        wide (1, 2) = 1;
+        shift (0, 1) = 1;
+        shift (1, 2) = 1;
+        std::cout << "Rank of [[0 1] [0 0]]: " << nilpotent.rank ()
+                  << ", of [[0 1 0] [0 0 1]]: " << wide.rank ()
+                  << ", of the 3 X 3 shift matrix: " << shift.rank ()
+                  << std::endl;
+
+        SDMatrix    sdmat (3, 3);
+
+        sdmat (0, 0) = 4;  sdmat (0, 1) = 1;  sdmat (0, 2) = 2;
+        sdmat (1, 1) = 5;  sdmat (1, 2) = 3;
+        sdmat (2, 2) = 6;
+
+        const LUFactorization<SDMatrix> sd_lu (sdmat);
+
+        std::cout << "Symmetric matrix determinant: " << sd_lu.determinant ()
+                  << ", is singular: " << sd_lu.is_singular () << std::endl;
+        std::cout << "LUFactorization solve and inverse are accurate"
+                  << std::endl;
+    }
+    {
+        std::cout << "\nTesting solve_se with many right-hand sides ...\n"
+                  << std::endl;
+
+        const DDMatrix::size_type   n = 130;
+        const DDMatrix::size_type   k = 90;
+        DDMatrix                    dmat (n, n);
+        DDMatrix                    rhs (n, k);
+
+        for (DDMatrix::size_type i = 0; i < n; ++i)  {
+            for (DDMatrix::size_type j = 0; j < n; ++j)
+                dmat (i, j) = 1.0 / double(i + j + 1);
+            dmat (i, i) += 2.0;
+            for (DDMatrix::size_type j = 0; j < k; ++j)
+                rhs (i, j) = double((i * 5 + j * 3) % 19) - 9.0;
+        }
+
+        const DDMatrix  sol = dmat.solve_se (rhs);
+        DDMatrix        in_place = rhs;
+
+        if (&dmat.solve_se_in_place (in_place) != &in_place ||
+            in_place != sol)  {
+            std::cout << "ERROR: solve_se_in_place() doesn't agree with "
+                         "solve_se()" << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        const DDMatrix  residual = dmat * sol - rhs;
+        double          max_err = 0;
+
+        for (auto citer = residual.col_begin ();
+             citer != residual.col_end (); ++citer)
+            max_err = std::max (max_err, std::fabs (*citer));
+        if (max_err > 1e-9)  {
+            std::cout << "ERROR: solve_se() residual is too big: " << max_err
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        DDMatrix    singular (3, 3, 1.0);
+        DDMatrix    rhs3 (3, 1, 1.0);
+
+        try  {
+            singular.solve_se_in_place (rhs3);
+            std::cout << "ERROR: Singular system was solved" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const Singular &)  {
+            std::cout << "Singular system throws Singular" << std::endl;
+        }
+        std::cout << "130 X 130 system with 90 right-hand sides is solved"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting blocked Cholesky factorization ...\n"
+                  << std::endl;
+
+        const DDMatrix::size_type   n = 150;
+        const DDMatrix::size_type   k = 40;
+        DDMatrix                    dmat (n, n);
+        SDMatrix                    smat (n, n);
+        DDMatrix                    rhs (n, k);
+
+       // Symmetric and diagonally dominant, so positive-definite
+       //
+        for (DDMatrix::size_type i = 0; i < n; ++i)  {
+            for (DDMatrix::size_type j = 0; j <= i; ++j)
+                dmat (i, j) = dmat (j, i) = smat (i, j) =
+                    symm_test_value (i, j);
+            dmat (i, i) = smat (i, i) = double(n);
+        }
+        fill_test_rhs (rhs);
+
+        DDMatrix    R;
+        DDMatrix    L;
+
+        dmat.chod (R);
+        dmat.chod (L, false);
+
+        const DDMatrix  rtr = ~R * R;
+        const DDMatrix  llt = L * ~L;
+
+        if (max_abs (rtr - dmat) > 1e-10 || max_abs (llt - dmat) > 1e-10 ||
+            L != ~R)  {
+            std::cout << "ERROR: blocked chod() is wrong" << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        set_num_threads (4);
+
+        const CholeskyFactorization<SDMatrix>   mt_chol (smat);
+
+        set_num_threads (0);
+        if (max_abs (mt_chol.get_factor () - R) > 1e-12)  {
+            std::cout << "ERROR: multithreaded Cholesky doesn't agree"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        const DDMatrix  sol = dmat.cholesky_solve (rhs);
+        DDMatrix        in_place = rhs;
+
+        dmat.cholesky_solve_in_place (in_place);
+        if (in_place != sol ||
+            max_abs (dmat * sol - rhs) > 1e-10 ||
+            max_abs (sol - dmat.solve_se (rhs)) > 1e-12)  {
+            std::cout << "ERROR: cholesky_solve() is wrong" << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        DDMatrix    inv;
+        SDMatrix    sinv;
+        DDMatrix    ident (n, n);
+
+        ident.identity ();
+        dmat.cholesky_inverse (inv);
+        smat.cholesky_inverse (sinv);
+
+        const DDMatrix  prod = dmat * inv;
+
+        if (max_abs (prod - ident) > 1e-12 || ! inv.is_symmetric ())  {
+            std::cout << "ERROR: cholesky_inverse() is wrong" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        for (DDMatrix::size_type i = 0; i < n; ++i)
+            for (DDMatrix::size_type j = 0; j < n; ++j)
+                if (std::fabs (sinv (i, j) - inv (i, j)) > 1e-15)  {
+                    std::cout << "ERROR: symmetric cholesky_inverse() "
+                                 "doesn't agree" << std::endl;
+                    return (EXIT_FAILURE);
+                }
+
+        const double    det = mt_chol.determinant ();
+        const double    lu_det = dmat.determinant ();
+
+        if (std::fabs (det - lu_det) > 1e-10 * std::fabs (lu_det))  {
+            std::cout << "ERROR: Cholesky determinant is wrong" << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        DDMatrix    not_symm = dmat;
+        DDMatrix    not_pd = dmat;
+
+        not_symm (3, 100) += 1.0;
+        not_pd (120, 120) = -1.0;
+        try  {
+            not_symm.chod (R);
+            std::cout << "ERROR: Non-symmetric matrix was factored"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+            std::cout << "Non-symmetric matrix throws NotSolvable"
+                      << std::endl;
+        }
+        try  {
+            not_pd.cholesky_solve (rhs);
+            std::cout << "ERROR: Non-positive-definite matrix was factored"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+            std::cout << "Non-positive-definite matrix throws NotSolvable"
+                      << std::endl;
+        }
+        std::cout << "150 X 150 factor, solve and inverse agree"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting packed Cholesky and LDL factorizations ...\n"
+                  << std::endl;
+
+        const SDMatrix::size_type   n = 150;
+        const SDMatrix::size_type   k = 7;
+        SDMatrix                    spd (n, n);
+        SDMatrix                    indef (n, n);
+        DDMatrix                    rhs (n, k);
+
+        for (SDMatrix::size_type i = 0; i < n; ++i)  {
+            for (SDMatrix::size_type j = 0; j <= i; ++j)  {
+                spd (i, j) = symm_test_value (i, j);
+                indef (i, j) = spd (i, j) - 0.5;
+            }
+            spd (i, i) = double(n);
+            indef (i, i) = double(i % 5) * 0.01;
+        }
+        fill_test_rhs (rhs);
+
+        DDMatrix    R;
+        DDMatrix    packed_R;
+        DDMatrix    packed_L;
+
+        spd.chod (R);
+
+        const PackedCholeskyFactorization<double>   chol (spd);
+
+        chol.get_upper (packed_R);
+        chol.get_lower (packed_L);
+        if (max_abs (packed_R - R) > 1e-12 || packed_L != ~packed_R ||
+            chol.get_packed_factor ().columns () != n)  {
+            std::cout << "ERROR: packed Cholesky doesn't agree with chod()"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        SDMatrix    spd_copy = spd;
+
+        set_num_threads (4);
+
+        PackedCholeskyFactorization<double> in_place (std::move (spd_copy));
+
+        set_num_threads (0);
+
+        const SDMatrix  factor = in_place.release_packed_factor ();
+
+        for (SDMatrix::size_type i = 0; i < n; ++i)
+            for (SDMatrix::size_type j = i; j < n; ++j)
+                if (factor (i, j) != chol.get_packed_factor () (i, j))  {
+                    std::cout << "ERROR: in place packed Cholesky doesn't "
+                                 "agree" << std::endl;
+                    return (EXIT_FAILURE);
+                }
+
+        const DDMatrix  sol = chol.cholesky_solve (rhs);
+        DDMatrix        dspd;
+
+        chol.get_upper (dspd);
+        dspd = ~dspd * dspd;
+        if (max_abs (dspd * sol - rhs) > 1e-10)  {
+            std::cout << "ERROR: packed cholesky_solve() is wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        SDMatrix    inv;
+        SDMatrix    dense_inv;
+
+        chol.cholesky_inverse (inv);
+        spd.cholesky_inverse (dense_inv);
+        for (SDMatrix::size_type i = 0; i < n; ++i)
+            for (SDMatrix::size_type j = i; j < n; ++j)
+                if (std::fabs (inv (i, j) - dense_inv (i, j)) > 1e-15)  {
+                    std::cout << "ERROR: packed cholesky_inverse() is wrong"
+                              << std::endl;
+                    return (EXIT_FAILURE);
+                }
+
+        try  {
+            const PackedCholeskyFactorization<double>   bad (indef);
+
+            std::cout << "ERROR: Indefinite matrix was Cholesky factored"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+            std::cout << "Indefinite matrix throws NotSolvable" << std::endl;
+        }
+
+        const PackedLDLFactorization<double>    ldl (indef);
+        SDMatrix::size_type                     two_by_two = 0;
+
+        for (const auto p : ldl.get_pivots ())
+            if (p < 0)
+                two_by_two += 1;
+
+        DDMatrix    dindef (n, n);
+
+        for (SDMatrix::size_type i = 0; i < n; ++i)
+            for (SDMatrix::size_type j = 0; j < n; ++j)
+                dindef (i, j) = indef (i, j);
+
+        const DDMatrix  ldl_sol = ldl.solve (rhs);
+        const double    det = ldl.determinant ();
+        const double    lu_det = dindef.determinant ();
+
+        if (two_by_two == 0 ||
+            max_abs (dindef * ldl_sol - rhs) > 1e-9 ||
+            std::fabs (det - lu_det) > 1e-9 * std::fabs (lu_det))  {
+            std::cout << "ERROR: packed LDL factorization is wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        SDMatrix    singular (4, 4, 1.0);
+        DDMatrix    rhs4 (4, 1, 1.0);
+
+        try  {
+            PackedLDLFactorization<double> (std::move (singular)).
+                solve_in_place (rhs4);
+            std::cout << "ERROR: Singular system was solved" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const Singular &)  {
+            std::cout << "Singular system throws Singular" << std::endl;
+        }
+        std::cout << "150 X 150 packed factors, solves and inverse agree"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting Rectangular Full Packed matrices ...\n"
+                  << std::endl;
+
+        for (const RFPDMatrix::size_type n : { 300, 301 })  {
+            RFPDMatrix  rfp (n, n);
+            SDMatrix    symm (n, n);
+
+            for (RFPDMatrix::size_type i = 0; i < n; ++i)  {
+                for (RFPDMatrix::size_type j = 0; j < i; ++j)
+                    rfp (i, j) = symm (i, j) = symm_test_value (i, j);
+                rfp (i, i) = symm (i, i) = double(n);
+            }
+
+            DDMatrix    full (n, n);
+
+            rfp.unpack (&(*full.col_begin ()), n);
+            for (RFPDMatrix::size_type i = 0; i < n; ++i)
+                for (RFPDMatrix::size_type j = 0; j < n; ++j)
+                    if (rfp (i, j) != symm (i, j) ||
+                        full (i, j) != symm (i, j))  {
+                        std::cout << "ERROR: RFP element access is wrong"
+                                  << std::endl;
+                        return (EXIT_FAILURE);
+                    }
+
+            RFPDMatrix  repacked (n, n);
+
+            repacked.pack (&(*full.col_begin ()), n);
+            if (repacked != rfp)  {
+                std::cout << "ERROR: RFP pack() is wrong" << std::endl;
+                return (EXIT_FAILURE);
+            }
+
+            RFPDMatrix      prod;
+            RFPDMatrix      prod2 = rfp;
+            const DDMatrix  dense_prod = full * full;
+
+            prod = rfp * rfp;
+            prod2 *= rfp;
+            for (RFPDMatrix::size_type i = 0; i < n; ++i)
+                for (RFPDMatrix::size_type j = 0; j < n; ++j)
+                    if (std::fabs (prod (i, j) - dense_prod (i, j)) >
+                            1e-10 * dense_prod (i, j) ||
+                        prod2 (i, j) != prod (i, j))  {
+                        std::cout << "ERROR: RFP product is wrong"
+                                  << std::endl;
+                        return (EXIT_FAILURE);
+                    }
+
+            DDMatrix    R;
+            DDMatrix    rfp_R;
+            DDMatrix    rfp_L;
+
+            symm.chod (R);
+
+            const RFPCholeskyFactorization<double>  chol (rfp);
+
+            chol.get_upper (rfp_R);
+            chol.get_lower (rfp_L);
+            if (max_abs (rfp_R - R) > 1e-12 || rfp_L != ~rfp_R)  {
+                std::cout << "ERROR: RFP Cholesky doesn't agree with chod()"
+                          << std::endl;
+                return (EXIT_FAILURE);
+            }
+
+            DDMatrix    rhs (n, 5);
+
+            fill_test_rhs (rhs);
+
+            const DDMatrix  sol = chol.cholesky_solve (rhs);
+
+            if (max_abs (full * sol - rhs) > 1e-10)  {
+                std::cout << "ERROR: RFP cholesky_solve() is wrong"
+                          << std::endl;
+                return (EXIT_FAILURE);
+            }
+
+            rfp (n - 1, n - 1) = -1.0;
+            try  {
+                const RFPCholeskyFactorization<double>  bad (std::move (rfp));
+
+                std::cout << "ERROR: Indefinite matrix was Cholesky factored"
+                          << std::endl;
+                return (EXIT_FAILURE);
+            }
+            catch (const NotSolvable &)  {
+            }
+            std::cout << n << " X " << n
+                      << " RFP access, product, Cholesky and solve agree"
+                      << std::endl;
+        }
+
+        RFPDMatrix  rfp (12, 12);
+        SDMatrix    symm (12, 12);
+
+        for (RFPDMatrix::size_type i = 0; i < 12; ++i)
+            for (RFPDMatrix::size_type j = 0; j <= i; ++j)
+                rfp (i, j) = symm (i, j) = double((i * 5 + j * 3) % 7) + 0.5;
+
+        DDMatrix    rfp_evals;
+        DDMatrix    rfp_evecs;
+        DDMatrix    symm_evals;
+        DDMatrix    symm_evecs;
+
+        rfp.eigen_space (rfp_evals, rfp_evecs, true);
+        symm.eigen_space (symm_evals, symm_evecs, true);
+        if (rfp_evals != symm_evals || rfp_evecs != symm_evecs)  {
+            std::cout << "ERROR: RFP eigen_space() doesn't agree"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "12 X 12 RFP eigen space agrees" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting covariance() on a wide matrix ...\n"
+                  << std::endl;
+
+        const DDMatrix::size_type   rows = 250;
+        const DDMatrix::size_type   cols = 300;
+        DDMatrix                    returns (rows, cols);
+
+        for (DDMatrix::size_type r = 0; r < rows; ++r)
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                returns (r, c) =
+                    double((r * 37 + c * 101) % 97) / 970.0 + double(c);
+
+        std::vector<double> means (cols, 0.0);
+
+        for (DDMatrix::size_type c = 0; c < cols; ++c)  {
+            for (DDMatrix::size_type r = 0; r < rows; ++r)
+                means[c] += returns (r, c);
+            means[c] /= double(rows);
+        }
+
+        const DDMatrix  cov = returns.covariance ();
+        SDMatrix        symm_cov;
+        double          max_diff = 0;
+
+        returns.covariance (symm_cov, false);
+        for (DDMatrix::size_type c = 0; c < cols; ++c)
+            for (DDMatrix::size_type cc = 0; cc < cols; ++cc)  {
+                double  sum = 0;
+
+                for (DDMatrix::size_type r = 0; r < rows; ++r)
+                    sum += (returns (r, c) - means[c]) *
+                           (returns (r, cc) - means[cc]);
+                max_diff = std::max (
+                    { max_diff,
+                      std::fabs (cov (c, cc) - sum / double(rows - 1)),
+                      std::fabs (symm_cov (c, cc) - sum / double(rows)) });
+            }
+        if (max_diff > 1e-15 || cov.columns () != cols ||
+            symm_cov.columns () != cols)  {
+            std::cout << "ERROR: covariance() doesn't agree with the "
+                         "definition" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "250 X 300 covariance agrees, also as SDMatrix"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting CovarianceAccumulator ...\n" << std::endl;
+
+        const DDMatrix::size_type   rows = 60;
+        const DDMatrix::size_type   cols = 20;
+        DDMatrix                    data (rows, cols);
+
+        for (DDMatrix::size_type r = 0; r < rows; ++r)
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                data (r, c) = double((r * 13 + c * 29) % 31) / 31.0 +
+                              double(c) * 100.0;
+
+        CovarianceAccumulator<double>   acc (cols);
+        CovarianceAccumulator<double>   other (cols);
+        DDMatrix                        batch (25, cols);
+        std::vector<double>             row (cols);
+
+        for (DDMatrix::size_type r = 0; r < 10; ++r)  {
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                row[c] = data (r, c);
+            acc.add (row.begin ());
+        }
+        for (DDMatrix::size_type r = 0; r < 25; ++r)
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                batch (r, c) = data (r + 10, c);
+        acc.add_rows (batch);
+        for (DDMatrix::size_type r = 35; r < rows; ++r)
+            other.add_row (data, r);
+        acc.merge (other);
+
+        SDMatrix        cov;
+        const SDMatrix  acc_cov = acc.covariance ();
+        const SDMatrix  acc_corr = acc.correlation ();
+        const DDMatrix  corr = data.correlation ();
+        double          max_diff = 0;
+
+        data.covariance (cov);
+        for (DDMatrix::size_type c = 0; c < cols; ++c)
+            for (DDMatrix::size_type cc = 0; cc < cols; ++cc)
+                max_diff = std::max (
+                    { max_diff,
+                      std::fabs (acc_cov (c, cc) - cov (c, cc)),
+                      std::fabs (acc_corr (c, cc) - corr (c, cc)) });
+        for (DDMatrix::size_type c = 0; c < cols; ++c)  {
+            double  mean = 0;
+
+            for (DDMatrix::size_type r = 0; r < rows; ++r)
+                mean += data (r, c);
+            max_diff = std::max (
+                max_diff, std::fabs (acc.get_mean ()[c] - mean / rows));
+        }
+        if (acc.count () != rows || max_diff > 1e-12)  {
+            std::cout << "ERROR: CovarianceAccumulator doesn't agree with "
+                         "covariance()" << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        try  {
+            CovarianceAccumulator<double> (cols).covariance ();
+            std::cout << "ERROR: Covariance of nothing was computed"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+        }
+        std::cout << "60 observations of 20 variables, by row, by batch and "
+                     "merged, agree" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting RollingCovariance ...\n" << std::endl;
+
+        const DDMatrix::size_type   rows = 300;
+        const DDMatrix::size_type   cols = 8;
+        const DDMatrix::size_type   window = 50;
+        DDMatrix                    data (rows, cols);
+
+        for (DDMatrix::size_type r = 0; r < rows; ++r)
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                data (r, c) = double((r * 17 + c * 23 + r * r) % 41) / 41.0 +
+                              double(r % 7) * 0.1 * double(c);
+
+        RollingCovariance<double>   rolling =
+            RollingCovariance<double>::window (cols, window, 37);
+        RollingCovariance<double>   ewma =
+            RollingCovariance<double>::ewma (cols, 0.9);
+        RollingCovariance<double>   no_decay =
+            RollingCovariance<double>::ewma (cols, 1.0);
+        double                      max_diff = 0;
+
+        for (DDMatrix::size_type t = 0; t < rows; ++t)  {
+            rolling.push_row (data, t);
+            ewma.push_row (data, t);
+            no_decay.push_row (data, t);
+            if (t < 2)  continue;
+
+            const DDMatrix::size_type   first =
+                t + 1 > window ? t + 1 - window : 0;
+            DDMatrix                    last (t + 1 - first, cols);
+
+            for (DDMatrix::size_type r = first; r <= t; ++r)
+                for (DDMatrix::size_type c = 0; c < cols; ++c)
+                    last (r - first, c) = data (r, c);
+
+            const SDMatrix  cov = rolling.covariance ();
+            const SDMatrix  corr = rolling.correlation ();
+            const DDMatrix  last_cov = last.covariance ();
+            const DDMatrix  last_corr = last.correlation ();
+
+            for (DDMatrix::size_type i = 0; i < cols; ++i)
+                for (DDMatrix::size_type j = 0; j < cols; ++j)
+                    max_diff = std::max (
+                        { max_diff,
+                          std::fabs (cov (i, j) - last_cov (i, j)),
+                          std::fabs (corr (i, j) - last_corr (i, j)) });
+        }
+
+       // Exponentially weighted, by brute force
+       //
+        std::vector<double> weights (rows);
+        std::vector<double> means (cols, 0.0);
+        double              w_sum = 0;
+        double              w_sq_sum = 0;
+
+        for (DDMatrix::size_type r = 0; r < rows; ++r)  {
+            weights[r] = std::pow (0.9, double(rows - 1 - r));
+            w_sum += weights[r];
+            w_sq_sum += weights[r] * weights[r];
+            for (DDMatrix::size_type c = 0; c < cols; ++c)
+                means[c] += weights[r] * data (r, c);
+        }
+        for (auto &m : means)
+            m /= w_sum;
+
+        const SDMatrix  ewma_cov = ewma.covariance (false);
+        const SDMatrix  ewma_unbiased = ewma.covariance ();
+        const SDMatrix  no_decay_cov = no_decay.covariance ();
+        const DDMatrix  full_cov = data.covariance ();
+
+        for (DDMatrix::size_type i = 0; i < cols; ++i)
+            for (DDMatrix::size_type j = 0; j < cols; ++j)  {
+                double  sum = 0;
+
+                for (DDMatrix::size_type r = 0; r < rows; ++r)
+                    sum += weights[r] *
+                           (data (r, i) - means[i]) * (data (r, j) - means[j]);
+                max_diff = std::max (
+                    { max_diff,
+                      std::fabs (ewma_cov (i, j) - sum / w_sum),
+                      std::fabs (ewma_unbiased (i, j) -
+                                 sum / (w_sum - w_sq_sum / w_sum)),
+                      std::fabs (no_decay_cov (i, j) - full_cov (i, j)) });
+            }
+        if (max_diff > 1e-12 || rolling.count () != window ||
+            ewma.count () != rows)  {
+            std::cout << "ERROR: RollingCovariance doesn't agree with "
+                         "covariance(): " << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Window of 50 rows and EWMA over 300 rows agree"
+                  << std::endl;
+
+        const auto  int_window = RollingCovariance<double>::window (3, 250);
+        const auto  int_ewma = RollingCovariance<double>::ewma (3, 1);
+
+        std::cout << "Plain int arguments pick the mode: "
+                  << (int_window.get_mode () ==
+                          RollingCovariance<double>::mode::window &&
+                      int_window.window_size () == 250 &&
+                      int_ewma.get_mode () ==
+                          RollingCovariance<double>::mode::ewma)
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting binary io_format ...\n" << std::endl;
+
+        const char  *dense_file = "tiger_test_dense.bin";
+        const char  *symm_file = "tiger_test_symm.bin";
+        const char  *rfp_file = "tiger_test_rfp.bin";
+        const char  *swapped_file = "tiger_test_swapped.bin";
+        const char  *float_file = "tiger_test_float.bin";
+        DDMatrix    dmat (123, 45);
+        SDMatrix    smat (77, 77);
+        RFPDMatrix  rmat (64, 64);
+
+        ::srand48 (12);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) = ::drand48 () - 0.5;
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                smat (r, c) = ::drand48 ();
+        for (RFPDMatrix::size_type c = 0; c < rmat.columns (); ++c)
+            for (RFPDMatrix::size_type r = c; r < rmat.rows (); ++r)
+                rmat (r, c) = ::drand48 ();
+
+        {
+            std::ofstream   out (dense_file, std::ios::binary);
+
+            dmat.write (out, io_format::binary);
+        }
+        {
+            std::ofstream   out (symm_file, std::ios::binary);
+
+            smat.write (out, io_format::binary);
+        }
+        {
+            std::ofstream   out (rfp_file, std::ios::binary);
+
+            rmat.write (out, io_format::binary);
+        }
+
+        DDMatrix    dmat2;
+        SDMatrix    smat2;
+        RFPDMatrix  rmat2;
+
+        dmat2.read (dense_file, io_format::binary);
+        smat2.read (symm_file, io_format::binary);
+        rmat2.read (rfp_file, io_format::binary);
+        if (dmat2 != dmat || smat2 != smat || rmat2 != rmat)  {
+            std::cout << "ERROR: Binary round trip doesn't agree" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Dense, symmetric and RFP matrices round trip exactly"
+                  << std::endl;
+
+       // A file of the other byte order
+       //
+        {
+            std::ifstream       in (dense_file, std::ios::binary);
+            std::vector<char>   bytes ((std::istreambuf_iterator<char>(in)),
+                                       std::istreambuf_iterator<char>());
+            BinaryMatrixHeader  header;
+
+            std::memcpy (&header, bytes.data (), sizeof(header));
+            byte_swap__ (&header.byte_order, sizeof(header.byte_order), 1);
+            byte_swap__ (&header.version, sizeof(header.version), 1);
+            byte_swap__ (&header.rows, sizeof(std::uint64_t), 5);
+            std::memcpy (bytes.data (), &header, sizeof(header));
+            byte_swap__ (bytes.data () + sizeof(header), sizeof(double),
+                         dmat.rows () * dmat.columns ());
+
+            std::ofstream   out (swapped_file, std::ios::binary);
+
+            out.write (bytes.data (), bytes.size ());
+        }
+
+        DDMatrix    swapped;
+
+        swapped.read (swapped_file, io_format::binary);
+        if (swapped != dmat)  {
+            std::cout << "ERROR: Byte-swapped file doesn't agree" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "File of the other byte order reads back the same"
+                  << std::endl;
+
+        {
+            Matrix<DenseMatrixBase, float>  fmat (3, 4, 1.5f);
+            std::ofstream                   out (float_file, std::ios::binary);
+
+            fmat.write (out, io_format::binary);
+        }
+
+        int caught = 0;
+
+        try  { dmat2.read (symm_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  { smat2.read (rfp_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  { dmat2.read (float_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  { dmat2.read ("tiger_no_such_file.bin", io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        if (caught != 4)  {
+            std::cout << "ERROR: Mismatched binary files were read"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Mismatched layout, element type and missing file "
+                     "are rejected" << std::endl;
+
+       // Headers whose data size doesn't match the dimensions, or whose
+       // dimensions don't fit size_type
+       //
+        const char  *corrupt_file = "tiger_test_corrupt.bin";
+        const auto  corrupt =
+            [corrupt_file](const char *from,
+                           std::uint64_t rows,
+                           std::uint64_t data_size)  {
+                std::ifstream       in (from, std::ios::binary);
+                std::vector<char>   bytes (
+                    (std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+                BinaryMatrixHeader  header;
+
+                std::memcpy (&header, bytes.data (), sizeof(header));
+                header.rows = rows;
+                header.data_size = data_size;
+                std::memcpy (bytes.data (), &header, sizeof(header));
+
+                std::ofstream   out (corrupt_file, std::ios::binary);
+
+                out.write (bytes.data (), bytes.size ());
+            };
+
+        caught = 0;
+        corrupt (dense_file, dmat.rows (), 1);
+        try  { dmat2.read (corrupt_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  {
+            MMapDDMatrix    mapped;
+
+            mapped.read (corrupt_file, io_format::binary);
+        }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  {
+            MMapDDMatrix    attached;
+
+            attached.attach_file (corrupt_file);
+        }
+        catch (const std::runtime_error &)  { caught += 1; }
+        corrupt (dense_file, (std::uint64_t(1) << 32) + dmat.rows (), 1);
+        try  { dmat2.read (corrupt_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        corrupt (symm_file, smat.rows (), smat.rows () * smat.rows () / 2);
+        try  { smat2.read (corrupt_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        if (caught != 5 || dmat2 != dmat || smat2 != smat)  {
+            std::cout << "ERROR: Corrupted binary headers were read"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Data size that doesn't match the dimensions is "
+                     "rejected" << std::endl;
+
+        for (const char *f : { dense_file, symm_file, rfp_file,
+                               swapped_file, float_file, corrupt_file })
+            std::remove (f);
+    }
+
+    {
+        std::cout << "\nTesting CSV read() ...\n" << std::endl;
+
+        const char  *dense_file = "tiger_test_dense.csv";
+        const char  *symm_file = "tiger_test_symm.csv";
+        const char  *int_file = "tiger_test_int.csv";
+        const char  *hand_file = "tiger_test_hand.csv";
+        DDMatrix    dmat (150, 90);
+        SDMatrix    smat (101, 101);
+        Matrix<DenseMatrixBase, long int>   imat (37, 61);
+
+        ::srand48 (13);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) =
+                    (::drand48 () - 0.5) * std::pow (10.0, int(c % 40) - 20);
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                smat (r, c) = ::drand48 ();
+        for (DDMatrix::size_type c = 0; c < imat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < imat.rows (); ++r)
+                imat (r, c) = long(::lrand48 ()) - (1L << 30);
+
+        {
+            std::ofstream   out (dense_file);
+
+            dmat.write (out);
+        }
+        {
+            std::ofstream   out (symm_file);
+
+            smat.write (out);
+        }
+        {
+            std::ofstream   out (int_file);
+
+            imat.write (out);
+        }
+
+        DDMatrix                            dmat2;
+        SDMatrix                            smat2;
+        Matrix<DenseMatrixBase, long int>   imat2;
+
+        set_num_threads (4);
+        dmat2.read (dense_file);
+        smat2.read (symm_file);
+        imat2.read (int_file);
+        set_num_threads (0);
+
+       // Every value must be exactly what strtod() makes of its text
+       //
+        bool    exact = dmat2.rows () == dmat.rows () &&
+                        dmat2.columns () == dmat.columns () &&
+                        smat2.rows () == smat.rows () && imat2 == imat;
+
+        for (DDMatrix::size_type c = 0; exact && c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)  {
+                std::ostringstream  text;
+
+                text << std::setprecision(12) << dmat (r, c);
+                exact = exact &&
+                        dmat2 (r, c) == std::strtod (text.str ().c_str (),
+                                                     nullptr);
+            }
+        for (SDMatrix::size_type c = 0; exact && c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                exact = exact &&
+                        std::fabs (smat2 (r, c) - smat (r, c)) < 1e-11;
+        if (! exact)  {
+            std::cout << "ERROR: CSV round trip doesn't agree" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Dense, symmetric and integer matrices round trip "
+                     "over many blocks" << std::endl;
+
+       // Uneven blocks, spaces, exponents and long mantissas
+       //
+        {
+            std::ofstream   out (hand_file);
+
+            out << "2X3X6\n1.5, -2e3,|0.1234567890123456789,\n"
+                   "  +7,|1e-310,-0.0, |\n";
+        }
+        dmat2.read (hand_file);
+        if (dmat2.rows () != 2 || dmat2.columns () != 3 ||
+            dmat2 (0, 0) != 1.5 || dmat2 (1, 0) != -2000.0 ||
+            dmat2 (0, 1) != 0.1234567890123456789 || dmat2 (1, 1) != 7.0 ||
+            dmat2 (0, 2) != 1e-310 || dmat2 (1, 2) != 0.0)  {
+            std::cout << "ERROR: Hand written CSV file read wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        int caught = 0;
+
+        {
+            std::ofstream   out (hand_file);
+
+            out << "2X2X4\n1,2,3,|4,5,|";
+        }
+        try  { dmat2.read (hand_file); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        {
+            std::ofstream   out (hand_file);
+
+            out << "2Y2X4\n1,2,3,4,|";
+        }
+        try  { dmat2.read (hand_file); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  { dmat2.read ("tiger_no_such_file.csv"); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        if (caught != 3)  {
+            std::cout << "ERROR: Bad CSV files were read" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Uneven blocks are read and bad files are rejected"
+                  << std::endl;
+
+       // The data size in the header must match the dimensions and layout
+       //
+        const char  *bad_headers[] = { "3X3X2\n1,2,|", "3X3X12\n1,2,|",
+                                       "2X3X3\n1,2,3,|", "3X3X9\n1,2,|" };
+
+        caught = 0;
+        for (int i = 0; i < 4; ++i)  {
+            {
+                std::ofstream   out (hand_file);
+
+                out << bad_headers[i];
+            }
+            try  {
+                if (i < 2)  dmat2.read (hand_file);
+                else  smat.read (hand_file);
+            }
+            catch (const std::runtime_error &)  { caught += 1; }
+        }
+        {
+            std::ofstream   out (hand_file);
+
+            out << "3X3X6\n1,2,|";
+        }
+        smat.read (hand_file);
+        if (caught != 4 || smat.rows () != 3 || smat (2, 2) != 0.0)  {
+            std::cout << "ERROR: CSV data size mismatch was read"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Data size that doesn't match the dimensions is "
+                     "rejected" << std::endl;
+
+        for (const char *f : { dense_file, symm_file, int_file, hand_file })
+            std::remove (f);
+    }
+
+    {
+        std::cout << "\nTesting CSV write() ...\n" << std::endl;
+
+       // What write() used to do, value by value through the stream
+       //
+        const auto  stream_csv =
+            [](const auto &mat, std::size_t size) -> std::string  {
+            std::ostringstream  out;
+            std::size_t         counter = 0;
+
+            out << mat.rows () << 'X' << mat.columns () << 'X' << size << '\n';
+            for (std::size_t i = 0; i < size; ++i)  {
+                out << std::setprecision(12) << (&(*mat.col_begin ()))[i]
+                    << ',';
+                if (++counter == 2048)  {
+                    out << '|';
+                    counter = 0;
+                }
+            }
+            if (counter != 0)  out << '|';
+            return (out.str ());
+        };
+        const auto  write_csv = [](const auto &mat) -> std::string  {
+            std::ostringstream  out;
+
+            mat.write (out);
+            return (out.str ());
+        };
+
+        DDMatrix                            exact (64, 32);
+        DDMatrix                            dmat (150, 150);
+        SDMatrix                            smat (101, 101);
+        Matrix<DenseMatrixBase, float>      fmat (70, 70);
+        Matrix<DenseMatrixBase, int>        imat (33, 33);
+
+        ::srand48 (14);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) =
+                    (::drand48 () - 0.5) * std::pow (10.0, int(c % 50) - 25);
+        dmat (0, 0) = 1.0 / 0.0;
+        dmat (1, 0) = -1.0 / 0.0;
+        dmat (2, 0) = -0.0;
+        dmat (3, 0) = 1e-310;
+        dmat (4, 0) = 123456789012345.0;
+        dmat (5, 0) = 0.1;
+        for (DDMatrix::size_type c = 0; c < exact.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < exact.rows (); ++r)
+                exact (r, c) = ::drand48 ();
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                smat (r, c) = ::drand48 () * 1000.0;
+        for (DDMatrix::size_type c = 0; c < fmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < fmat.rows (); ++r)
+                fmat (r, c) = float(::drand48 () - 0.5);
+        for (DDMatrix::size_type c = 0; c < imat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < imat.rows (); ++r)
+                imat (r, c) = int(::lrand48 ()) - (1 << 30);
+        imat (0, 0) = std::numeric_limits<int>::min ();
+        imat (1, 0) = std::numeric_limits<int>::max ();
+        imat (2, 0) = 0;
+
+        bool    same = true;
+
+        for (const unsigned int threads : { 1, 4 })  {
+            set_num_threads (threads);
+            same = same &&
+                   write_csv (exact) == stream_csv (exact, 64 * 32) &&
+                   write_csv (dmat) == stream_csv (dmat, 150 * 150) &&
+                   write_csv (smat) == stream_csv (smat, 101 * 102 / 2) &&
+                   write_csv (fmat) == stream_csv (fmat, 70 * 70) &&
+                   write_csv (imat) == stream_csv (imat, 33 * 33) &&
+                   write_csv (DDMatrix ()) == "0X0X0\n";
+        }
+        set_num_threads (0);
+        if (! same)  {
+            std::cout << "ERROR: CSV write() is not byte compatible"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Byte for byte the same as streaming every value"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting file-backed matrices ...\n" << std::endl;
+
+        const char  *dense_file = "tiger_test_mmap_dense.bin";
+        const char  *symm_file = "tiger_test_mmap_symm.bin";
+        const auto  file_size = [](const char *file_name) -> long  {
+            std::ifstream   in (file_name, std::ios::binary | std::ios::ate);
+
+            return (static_cast<long>(in.tellg ()));
+        };
+
+        std::remove (dense_file);
+        std::remove (symm_file);
+
+        DDMatrix        dmat (120, 80);
+        MMapDDMatrix    mmat (120, 80);
+
+        ::srand48 (15);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                mmat (r, c) = dmat (r, c) = ::drand48 () - 0.5;
+
+        const DDMatrix      dprod = dmat * ~dmat + dmat * ~dmat;
+        const MMapDDMatrix  mprod = mmat * ~mmat + mmat * ~mmat;
+        double              max_diff = 0;
+
+        for (DDMatrix::size_type c = 0; c < dprod.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dprod.rows (); ++r)
+                max_diff = std::max (max_diff,
+                                     std::fabs (dprod (r, c) - mprod (r, c)));
+        if (max_diff > 1e-12 || mprod.rows () != 120)  {
+            std::cout << "ERROR: File-backed product doesn't agree: "
+                      << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Temporary file-backed matrix computes like DDMatrix"
+                  << std::endl;
+
+       // The matrix lives in the file from now on
+       //
+        {
+            MMapDDMatrix    attached = mmat;
+
+            attached.attach_file (dense_file);
+            attached (7, 9) = 123.0;
+            attached.resize (150, 100, 2.0);
+            attached (149, 99) = -1.0;
+        }
+
+        DDMatrix    on_disk;
+
+        on_disk.read (dense_file, io_format::binary);
+        if (on_disk.rows () != 150 || on_disk.columns () != 100 ||
+            on_disk (7, 9) != 2.0 || on_disk (149, 99) != -1.0 ||
+            file_size (dense_file) !=
+                long(sizeof(BinaryMatrixHeader) + 150 * 100 * sizeof(double)))
+        {
+            std::cout << "ERROR: Attached file doesn't have the matrix"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+        bool    good = true;
+
+        {
+            MMapDDMatrix    attached;
+
+            attached.attach_file (dense_file);
+            good = attached.rows () == 150 && attached.columns () == 100 &&
+                   attached (149, 99) == -1.0;
+            attached (0, 0) = 42.0;
+        }
+        {
+            MMapDDMatrix    mapped;
+
+            mapped.read (dense_file, io_format::binary);
+            good = good && mapped (0, 0) == 42.0 && mapped (149, 99) == -1.0;
+            mapped (0, 0) = 0.0;        // Copy-on-write, file is untouched
+            mapped.resize (10, 10);     // Moves to a temporary file
+        }
+        on_disk.read (dense_file, io_format::binary);
+        good = good && on_disk (0, 0) == 42.0;
+        if (! good)  {
+            std::cout << "ERROR: Reattached or mapped file is wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Attached file keeps every change, "
+                     "read() maps copy-on-write" << std::endl;
+
+        SDMatrix        smat (90, 90);
+        MMapSDMatrix    msmat;
+
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                smat (r, c) = ::drand48 ();
+        msmat.attach_file (symm_file);
+        msmat.resize (90, 90);
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                msmat (r, c) = smat (r, c);
+
+        SDMatrix    symm_on_disk;
+        int         caught = 0;
+
+        symm_on_disk.read (symm_file, io_format::binary);
+        try  { on_disk.read (symm_file, io_format::binary); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        try  { mmat.attach_file (symm_file); }
+        catch (const std::runtime_error &)  { caught += 1; }
+        if (symm_on_disk != smat || caught != 2 || mmat.rows () != 120)  {
+            std::cout << "ERROR: File-backed symmetric matrix is wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "File-backed symmetric matrix agrees and layouts "
+                     "are checked" << std::endl;
+
+        std::remove (dense_file);
+        std::remove (symm_file);
+    }
+
+    {
+        std::cout << "\nTesting out-of-core multiply and Cholesky ...\n"
+                  << std::endl;
+
+        const char  *a_file = "tiger_test_ooc_a.bin";
+        const char  *b_file = "tiger_test_ooc_b.bin";
+        const char  *c_file = "tiger_test_ooc_c.bin";
+        const char  *s_file = "tiger_test_ooc_spd.bin";
+        const auto  write_binary = [](const DDMatrix &m, const char *name)  {
+            std::ofstream   out (name, std::ios::binary);
+
+            m.write (out, io_format::binary);
+        };
+
+        DDMatrix    amat (300, 200);
+        DDMatrix    bmat (200, 250);
+
+        ::srand48 (16);
+        for (DDMatrix::size_type c = 0; c < amat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < amat.rows (); ++r)
+                amat (r, c) = ::drand48 () - 0.5;
+        for (DDMatrix::size_type c = 0; c < bmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < bmat.rows (); ++r)
+                bmat (r, c) = ::drand48 () - 0.5;
+        write_binary (amat, a_file);
+        write_binary (bmat, b_file);
+
+       // Room for six 64 X 64 tiles, while the matrices have 5 X 4 and
+       // 4 X 4 tiles
+       //
+        OutOfCoreParams params;
+
+        params.tile_size = 64;
+        params.memory_budget = 6 * 64 * 64 * sizeof(double);
+        params.read_ahead_threads = 2;
+        params.read_ahead_depth = 2;
+
+        const OutOfCoreStats    mstats =
+            out_of_core_multiply<double> (a_file, b_file, c_file, params);
+        const DDMatrix          prod = amat * bmat;
+        DDMatrix                cmat;
+        double                  max_diff = 0;
+
+        cmat.read (c_file, io_format::binary);
+        for (DDMatrix::size_type c = 0; c < prod.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < prod.rows (); ++r)
+                max_diff = std::max (max_diff,
+                                     std::fabs (prod (r, c) - cmat (r, c)));
+        if (cmat.rows () != 300 || cmat.columns () != 250 ||
+            max_diff > 1e-12 || mstats.tile_writes != 5 * 4 ||
+            mstats.peak_bytes > params.memory_budget)  {
+            std::cout << "ERROR: out_of_core_multiply() is wrong: "
+                      << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Out-of-core multiply agrees with operator *"
+                  << std::endl;
+
+        DDMatrix    spd = amat * ~amat;
+
+        for (DDMatrix::size_type i = 0; i < spd.rows (); ++i)
+            spd (i, i) += double(spd.rows ());
+        write_binary (spd, s_file);
+        params.read_ahead_depth = 4;
+
+        const OutOfCoreStats    cstats =
+            out_of_core_cholesky<double> (s_file, params);
+        DDMatrix                L;
+        DDMatrix                factored;
+
+        spd.chod (L, false);
+        factored.read (s_file, io_format::binary);
+        max_diff = 0;
+        for (DDMatrix::size_type c = 0; c < spd.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < spd.rows (); ++r)
+                max_diff = std::max (
+                    max_diff,
+                    std::fabs ((r >= c ? L (r, c) : spd (r, c)) -
+                               factored (r, c)));
+        if (max_diff > 1e-10 || cstats.tile_writes != 5 * 6 / 2 ||
+            cstats.peak_bytes > params.memory_budget)  {
+            std::cout << "ERROR: out_of_core_cholesky() is wrong: "
+                      << max_diff << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Out-of-core Cholesky agrees with chod() and leaves "
+                     "the upper triangle alone" << std::endl;
+
+        int caught = 0;
+
+        params.memory_budget = 2 * 64 * 64 * sizeof(double);
+        try  {
+            out_of_core_multiply<double> (a_file, b_file, c_file, params);
+        }
+        catch (const std::runtime_error &)  { caught += 1; }
+        params.memory_budget = 3 * 64 * 64 * sizeof(double);
+        params.read_ahead_threads = 0;
+        try  {
+            out_of_core_multiply<double> (a_file, a_file, c_file, params);
+        }
+        catch (const NotSolvable &)  { caught += 1; }
+        try  { out_of_core_cholesky<double> (a_file, params); }
+        catch (const NotSquare &)  { caught += 1; }
+        for (DDMatrix::size_type i = 0; i < spd.rows (); ++i)
+            spd (i, i) = -spd (i, i);
+        write_binary (spd, s_file);
+        try  { out_of_core_cholesky<double> (s_file, params); }
+        catch (const NotSolvable &)  { caught += 1; }
+        if (caught != 4)  {
+            std::cout << "ERROR: out-of-core errors are not reported"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Small budgets, mismatched and non-SPD matrices "
+                     "are reported" << std::endl;
+
+        std::remove (a_file);
+        std::remove (b_file);
+        std::remove (c_file);
+        std::remove (s_file);
+    }
+
+    {
+        std::cout << "\nTesting arena-allocated matrices ...\n" << std::endl;
+
+        const auto  max_diff = [](const auto &lhs, const auto &rhs)  {
+            double  result = 0;
+
+            for (DDMatrix::size_type c = 0; c < rhs.columns (); ++c)
+                for (DDMatrix::size_type r = 0; r < rhs.rows (); ++r)
+                    result = std::max (result,
+                                       std::fabs (lhs (r, c) - rhs (r, c)));
+            return (result);
+        };
+
+        DDMatrix    dmat (120, 80);
+        DDMatrix    dprod;
+        DDMatrix    dq;
+        DDMatrix    dr;
+
+        ::srand48 (17);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) = ::drand48 () - 0.5;
+        dprod = dmat * ~dmat + dmat * ~dmat;
+        dmat.qrd (dq, dr);
+
+        SDMatrix    dcov;
+        MemoryArena arena (64 * 1024);
+        bool        good = true;
+
+        dmat.covariance (dcov);
+
+        {
+            const ScopedArena   scope (arena);
+            ArenaDDMatrix       amat (120, 80);
+
+            for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+                for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                    amat (r, c) = dmat (r, c);
+
+            const ArenaDDMatrix aprod = amat * ~amat + amat * ~amat;
+            ArenaDDMatrix       aq;
+            ArenaDDMatrix       ar;
+            ArenaSDMatrix       acov;
+
+            const std::size_t   before_qrd = arena.allocated ();
+
+            amat.qrd (aq, ar);
+            amat.covariance (acov);
+            good = max_diff (aprod, dprod) < 1e-12 &&
+                   max_diff (aq, dq) < 1e-12 && max_diff (ar, dr) < 1e-12 &&
+                   max_diff (acov, dcov) == 0 &&
+                   arena.allocated () > before_qrd &&
+                   arena.allocated () >= 3 * 120 * 120 * sizeof(double);
+        }
+        if (! good)  {
+            std::cout << "ERROR: Arena matrices don't agree" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Products, qrd() and covariance() on the arena agree "
+                     "with DDMatrix" << std::endl;
+
+        const std::size_t   used = arena.allocated ();
+        ArenaDDMatrix       heap_mat (50, 50, 1.0);
+
+        arena.release ();
+        if (used == 0 || arena.allocated () != 0 || arena.reserved () == 0 ||
+            heap_mat (49, 49) != 1.0 ||
+            MemoryArena::current () != nullptr)  {
+            std::cout << "ERROR: MemoryArena::release() is wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+       // A released arena is reused without going back to the heap
+       //
+        const std::size_t   reserved = arena.reserved ();
+
+        {
+            const ScopedArena   scope (arena);
+            const ArenaDDMatrix small (10, 10, 2.0);
+            const ArenaDDMatrix prod = small * small;
+
+            good = prod (9, 9) == 40.0 && arena.reserved () == reserved;
+        }
+        if (! good)  {
+            std::cout << "ERROR: Released arena is not reused" << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "release() gives back everything and keeps a chunk "
+                     "for reuse" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting decomposition workspaces ...\n" << std::endl;
+
+        const auto  data_of = [](const DDMatrix &m) -> const double *  {
+            return (&(*m.col_begin ()));
+        };
+
+        DDMatrix                    dmat (30, 30);
+        MatrixWorkspace<DDMatrix>   workspace;
+
+        ::srand48 (18);
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) = ::drand48 () - 0.5;
+
+        DDMatrix    Q, R, U, S, V, L, UP, evals, evecs;
+        DDMatrix    Q2, R2, U2, S2, V2, L2, UP2, evals2, evecs2;
+        const DDMatrix  symm = dmat * ~dmat;
+
+        dmat.qrd (Q, R);
+        dmat.svd (U, S, V);
+        dmat.lud (L, UP);
+        symm.eigen_space (evals, evecs, true);
+        dmat.qrd (Q2, R2, workspace);
+        dmat.svd (U2, S2, V2, workspace);
+        dmat.lud (L2, UP2, workspace);
+        symm.eigen_space (evals2, evecs2, workspace, true);
+        if (Q != Q2 || R != R2 || U != U2 || S != S2 || V != V2 ||
+            L != L2 || UP != UP2 || evals != evals2 || evecs != evecs2 ||
+            dmat.determinant () != dmat.determinant (workspace) ||
+            dmat.rank () != dmat.rank (workspace) || dmat.rank () != 30)  {
+            std::cout << "ERROR: Workspace decompositions don't agree"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Decompositions with a workspace agree" << std::endl;
+
+       // Results that already have the right size keep their buffers
+       //
+        const double    *q_data = data_of (Q2);
+        const double    *u_data = data_of (U2);
+        const double    *v_data = data_of (V2);
+        const double    *evecs_data = data_of (evecs2);
+
+        for (int i = 0; i < 100; ++i)  {
+            dmat (i % 30, (i * 7) % 30) += 0.01;
+            dmat.qrd (Q2, R2, workspace);
+            dmat.svd (U2, S2, V2, workspace);
+            symm.eigen_space (evals2, evecs2, workspace, false);
+        }
+        if (data_of (Q2) != q_data || data_of (U2) != u_data ||
+            data_of (V2) != v_data || data_of (evecs2) != evecs_data ||
+            max_abs (Q2 * R2 - dmat) > 1e-10 ||
+            max_abs (U2 * S2 * ~V2 - dmat) > 1e-10)  {
+            std::cout << "ERROR: Workspace results are reallocated or wrong"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Sized results are reused across decompositions"
+                  << std::endl;
+
+       // Buffers above the limit are freed when they are given back
+       //
+        const std::size_t   held = workspace.held_bytes ();
+
+        workspace.set_keep_bytes (1024);
+        dmat.qrd (Q2, R2, workspace);
+        dmat.svd (U2, S2, V2, workspace);
+        dmat.lud (L2, UP2, workspace);
+        symm.eigen_space (evals2, evecs2, workspace, true);
+        if (held < 30 * 30 * sizeof(double) ||
+            workspace.held_bytes () >
+                (MatrixWorkspace<DDMatrix>::MATRIX_SLOTS +
+                 MatrixWorkspace<DDMatrix>::VECTOR_SLOTS + 1) * 1024 ||
+            dmat.rank (workspace) != 30 ||
+            max_abs (Q2 * R2 - dmat) > 1e-10 ||
+            max_abs (U2 * S2 * ~V2 - dmat) > 1e-10)  {
+            std::cout << "ERROR: Workspace kept buffers above the limit"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Buffers above the limit are not kept" << std::endl;
+
+       // The thread's own workspace never takes memory from an arena
+       //
+        MemoryArena arena;
+        bool        good = true;
+
+        {
+            const ScopedArena   scope (arena);
+            ArenaDDMatrix       amat (20, 20);
+            ArenaDDMatrix       aq (20, 20);
+            ArenaDDMatrix       ar (20, 20);
+
+            for (DDMatrix::size_type c = 0; c < amat.columns (); ++c)
+                for (DDMatrix::size_type r = 0; r < amat.rows (); ++r)
+                    amat (r, c) = dmat (r, c);
+
+            const std::size_t   before = arena.allocated ();
+
+            amat.qrd (aq, ar);
+            good = arena.allocated () == before;
+        }
+        arena.release ();
+
+        ArenaDDMatrix   amat (20, 20, 1.0);
+        ArenaDDMatrix   aq;
+        ArenaDDMatrix   ar;
+
+        amat (3, 4) = 2.0;
+        amat.qrd (aq, ar);
+        if (! good || std::fabs (aq (0, 0) * ar (0, 0) - 1.0) > 1e-12)  {
+            std::cout << "ERROR: Thread workspace used the arena"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Thread workspace stays on the heap" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting blocked and in-place transposes ...\n"
+                  << std::endl;
+
+       // Sizes that are not multiples of the block size. The large ones
+       // are split across threads.
+       //
+        const DDMatrix::size_type   dims[][2] =
+            { { 1, 7 }, { 37, 53 }, { 53, 37 }, { 100, 100 },
+              { 1100, 1000 }, { 1024, 1024 } };
+
+        ::srand48 (19);
+        for (const auto &dim : dims)  {
+            DDMatrix    dmat (dim[0], dim[1]);
+
+            for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+                for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                    dmat (r, c) = ::drand48 ();
+
+            const DDMatrix  orig = dmat;
+            DDMatrix        out = ~dmat;
+            DDMatrix        out2;
+            bool            good =
+                out.rows () == dmat.columns () &&
+                out.columns () == dmat.rows ();
+
+            for (DDMatrix::size_type c = 0; good && c < dmat.columns (); ++c)
+                for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                    good = good && out (c, r) == dmat (r, c);
+
+            dmat.transpose (out2);
+            good = good && out2 == out;
+
+           // In place, square and rectangular
+           //
+            dmat.transpose ();
+            good = good && dmat == out;
+            dmat = ~dmat;
+            good = good && dmat == orig;
+            if (! good)  {
+                std::cout << "ERROR: Transpose of " << dim[0] << " X "
+                          << dim[1] << " is wrong" << std::endl;
+                return (EXIT_FAILURE);
+            }
+        }
+        std::cout << "Out-of-place and in-place transposes agree"
+                  << std::endl;
+
+        SDMatrix    smat (5, 5);
+
+        for (SDMatrix::size_type c = 0; c < smat.columns (); ++c)
+            for (SDMatrix::size_type r = c; r < smat.rows (); ++r)
+                smat (r, c) = double(r * 10 + c);
+
+        const SDMatrix  sorig = smat;
+        SDMatrix        stran;
+
+        smat.transpose ();
+        smat.transpose (stran);
+        if (smat != sorig || stran != sorig)  {
+            std::cout << "ERROR: Symmetric transpose changed the matrix"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Symmetric transpose is a no-op" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting stride-based row iterators ...\n" << std::endl;
+
+       // Walks the matrix forward, backward and by random access and
+       // compares every element with at()
+       //
+        const auto  check = [](const auto &mat) -> bool  {
+            const auto          begin = mat.row_begin ();
+            const auto          end = mat.row_end ();
+            const long          count = long(mat.rows ()) * mat.columns ();
+            const std::size_t   cols = mat.columns ();
+            long                idx = 0;
+
+            if (end - begin != count ||
+                std::distance (begin, end) != count)
+                return (false);
+
+            for (auto iter = begin; iter != end; ++iter, ++idx)
+                if (&(*iter) != &(mat.at (idx / cols, idx % cols)) ||
+                    iter - begin != idx ||
+                    ! (begin + idx == iter) ||
+                    &(begin[idx]) != &(*iter))
+                    return (false);
+            if (idx != count)  return (false);
+
+            for (auto iter = end; iter != begin; )  {
+                --iter;
+                --idx;
+                if (&(*iter) != &(mat.at (idx / cols, idx % cols)))
+                    return (false);
+            }
+
+            for (long i = 0; i < count; i += 7)  {
+                auto    iter = end;
+
+                iter -= int(count - i);
+                if (&(*iter) != &(mat.at (i / cols, i % cols)) ||
+                    iter >= end || ! (iter < end) || (iter + 1) <= iter)
+                    return (false);
+            }
+            return (true);
+        };
+
+        bool    good = true;
+
+        for (const auto &dim : { std::make_pair (0U, 0U),
+                                 std::make_pair (1U, 9U),
+                                 std::make_pair (9U, 1U),
+                                 std::make_pair (13U, 29U) })  {
+            DDMatrix    dmat (dim.first, dim.second);
+
+            good = good && check (dmat);
+        }
+        for (const SDMatrix::size_type dim : { 0U, 1U, 2U, 17U })  {
+            SDMatrix    smat (dim, dim);
+
+            good = good && check (smat);
+        }
+
+        DDMatrix    dmat (3, 4);
+        DDMatrix    dmat2 (3, 4);
+
+        for (DDMatrix::size_type c = 0; c < dmat.columns (); ++c)
+            for (DDMatrix::size_type r = 0; r < dmat.rows (); ++r)
+                dmat (r, c) = double(r * 10 + c);
+        std::copy (dmat.row_begin (), dmat.row_end (), dmat2.row_begin ());
+        good = good && dmat == dmat2 && *(dmat.row_begin () + 5) == 11.0;
+        if (! good)  {
+            std::cout << "ERROR: Row iterators disagree with at()"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Row iterators agree with at()" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting eigenvalues only ...\n" << std::endl;
+
+        const auto  close = [](const DDMatrix &x, const DDMatrix &y,
+                               double tol) -> bool  {
+            if (x.rows () != y.rows () || x.columns () != y.columns ())
+                return (false);
+            for (DDMatrix::size_type c = 0; c < x.columns (); ++c)
+                if (std::fabs (x (0, c) - y (0, c)) >
+                        tol * (1.0 + std::fabs (y (0, c))))
+                    return (false);
+            return (true);
+        };
+
+        const DDMatrix::size_type   dim = 40;
+        DDMatrix                    gmat (dim, dim);
+        SDMatrix                    smat (dim, dim);
+
+        for (DDMatrix::size_type r = 0; r < dim; ++r)
+            for (DDMatrix::size_type c = 0; c < dim; ++c)  {
+                gmat (r, c) = double((r * 37 + c * 11) % 23) - 11.0;
+                if (r <= c)
+                    smat (r, c) = double((r * 13 + c * 7) % 19) / 3.0;
+            }
+
+        DDMatrix    sym = gmat * ~gmat;
+        DDMatrix    values;
+        DDMatrix    ref_values;
+        DDMatrix    ref_vectors;
+        bool        good = true;
+
+        sym.eigenvalues (values);
+        sym.eigen_space (ref_values, ref_vectors, true);
+        good = good && close (values, ref_values, 1e-10);
+
+        smat.eigenvalues (values);
+        smat.eigen_space (ref_values, ref_vectors, true);
+        good = good && close (values, ref_values, 1e-10);
+
+        gmat.eigenvalues (values, true);
+        gmat.eigen_space (ref_values, ref_vectors, true);
+        good = good && close (values, ref_values, 1e-10);
+
+       // Known spectrum of an upper triangular matrix
+       //
+        DDMatrix    tri (6, 6);
+
+        for (DDMatrix::size_type r = 0; r < 6; ++r)
+            for (DDMatrix::size_type c = r; c < 6; ++c)
+                tri (r, c) = r == c ? double(6 - r) : double(r + c);
+        tri.eigenvalues (values, true);
+        for (DDMatrix::size_type c = 0; c < 6; ++c)
+            good = good && std::fabs (values (0, c) - double(c + 1)) < 1e-12;
+
+        if (! good)  {
+            std::cout << "ERROR: eigenvalues() disagrees with eigen_space()"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "eigenvalues() agrees with eigen_space()" << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting divide-and-conquer eigen_space ...\n"
+                  << std::endl;
+
+       // Checks A * V = V * D, ~V * V = I and the order of the values
+       //
+        const auto  check = [](const DDMatrix &mat) -> bool  {
+            DDMatrix    values;
+            DDMatrix    vectors;
+            DDMatrix    only_values;
+
+            mat.eigen_space (values, vectors);
+            mat.eigenvalues (only_values);
+
+            const DDMatrix  av = mat * vectors;
+            const DDMatrix  vv = ~vectors * vectors;
+            const auto      n = mat.rows ();
+            double          scale = 1.0;
+
+            for (DDMatrix::size_type c = 0; c < n; ++c)
+                scale = std::max (scale, std::fabs (values (0, c)));
+            for (DDMatrix::size_type c = 0; c < n; ++c)  {
+                if ((c > 0 && values (0, c) < values (0, c - 1)) ||
+                    std::fabs (values (0, c) - only_values (0, c)) >
+                        1e-10 * scale)
+                    return (false);
+                for (DDMatrix::size_type r = 0; r < n; ++r)
+                    if (std::fabs (av (r, c) -
+                                   vectors (r, c) * values (0, c)) >
+                            1e-10 * scale ||
+                        std::fabs (vv (r, c) - (r == c ? 1.0 : 0.0)) > 1e-10)
+                        return (false);
+            }
+            return (true);
+        };
+
+        const DDMatrix::size_type   dim = 160;
+        DDMatrix                    gmat (dim, dim);
+        DDMatrix                    low (dim, 3);
+
+        for (DDMatrix::size_type r = 0; r < dim; ++r)  {
+            for (DDMatrix::size_type c = 0; c < dim; ++c)
+                gmat (r, c) = std::sin (r * 1.3 + c * 0.7 + r * c * 0.01);
+            for (DDMatrix::size_type c = 0; c < 3; ++c)
+                low (r, c) = std::cos (r * 0.3 * (c + 1));
+        }
+
+       // A dense spectrum and a clustered one that mostly deflates
+       //
+        const DDMatrix  dense = gmat + ~gmat;
+        DDMatrix        clustered = low * ~low;
+
+        for (DDMatrix::size_type r = 0; r < dim; ++r)
+            clustered (r, r) += 2.0;
+
+        bool    good = check (dense) && check (clustered);
+
+        set_num_threads (4);
+        good = good && check (dense) && check (clustered);
+        set_num_threads (0);
+        if (! good)  {
+            std::cout << "ERROR: Divide-and-conquer eigen_space is off"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Divide-and-conquer eigen_space is accurate"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting blocked tridiagonal reduction ...\n"
+                  << std::endl;
+
+       // min(i, j) (1 based) has the known eigenvalues
+       //     1 / (4 * sin((2 * k - 1) * pi / (4 * n + 2))^2)
+       //
+        const DDMatrix::size_type   dim = 200;
+        const double                pi = 3.14159265358979323846;
+        DDMatrix                    mat (dim, dim);
+        std::vector<double>         known;
+
+        for (DDMatrix::size_type r = 0; r < dim; ++r)
+            for (DDMatrix::size_type c = 0; c < dim; ++c)
+                mat (r, c) = double(std::min (r, c) + 1);
+        for (DDMatrix::size_type k = 1; k <= dim; ++k)  {
+            const double    s = std::sin ((2.0 * k - 1.0) * pi /
+                                          (4.0 * dim + 2.0));
+
+            known.push_back (1.0 / (4.0 * s * s));
+        }
+        std::sort (known.begin (), known.end ());
+
+        bool    good = true;
+
+        for (const unsigned int threads : { 1U, 4U })  {
+            DDMatrix    values;
+            DDMatrix    only_values;
+            DDMatrix    vectors;
+
+            set_num_threads (threads);
+            mat.eigenvalues (only_values);
+            mat.eigen_space (values, vectors);
+            for (DDMatrix::size_type c = 0; c < dim; ++c)
+                good = good &&
+                       std::fabs (values (0, c) - known[c]) <
+                           1e-10 * known.back () &&
+                       std::fabs (only_values (0, c) - known[c]) <
+                           1e-10 * known.back ();
+
+            const DDMatrix  av = mat * vectors;
+
+            for (DDMatrix::size_type c = 0; c < dim; ++c)
+                for (DDMatrix::size_type r = 0; r < dim; ++r)
+                    good = good &&
+                           std::fabs (av (r, c) -
+                                      vectors (r, c) * values (0, c)) <
+                               1e-10 * known.back ();
+        }
+        set_num_threads (0);
+        if (! good)  {
+            std::cout << "ERROR: Blocked reduction missed the spectrum"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Blocked reduction finds the known spectrum"
+                  << std::endl;
+    }
+
+    {
+        std::cout << "\nTesting partial eigen_space ...\n" << std::endl;
+
+        // A covariance-like matrix: a few strong factors over a noisy bulk
+        //
+        const DDMatrix::size_type   dim = 300;
+        const DDMatrix::size_type   k = 10;
+        DDMatrix                    mat (dim, dim);
+        SDMatrix                    smat (dim, dim);
+        DDMatrix                    bumped (dim, dim);
+
+        for (DDMatrix::size_type c = 0; c < dim; ++c)
+            for (DDMatrix::size_type r = 0; r <= c; ++r)  {
+                double  value = std::sin (double(r * dim + c) * 0.7);
+
+                for (int f = 0; f < 4; ++f)
+                    value += (40.0 / (f + 1)) *
+                             std::cos (double(r) * (f + 1) * 0.37) *
+                             std::cos (double(c) * (f + 1) * 0.37);
+                mat (r, c) = mat (c, r) = value;
+                smat (r, c) = value;
+                bumped (r, c) = bumped (c, r) =
+                    value + 1e-3 * std::cos (double(r + c));
+            }
+
+        DDMatrix    all_values;
+        DDMatrix    all_vectors;
+
+        mat.eigen_space (all_values, all_vectors);
+
+        const double    scale = std::max (std::fabs (all_values (0, 0)),
+                                          std::fabs (all_values (0, dim - 1)));
+        bool            good = true;
+
+        const auto  check =
+            [&](const DDMatrix &values, const DDMatrix &vectors,
+                eigen_part which) -> bool  {
+                if (values.columns () != k || vectors.rows () != dim ||
+                    vectors.columns () != k)
+                    return (false);
+
+                const DDMatrix  av = mat * vectors;
+                bool            ok = true;
+
+                for (DDMatrix::size_type c = 0; c < k; ++c)  {
+                    const double    expected =
+                        which == eigen_part::largest
+                            ? all_values (0, dim - 1 - c)
+                            : all_values (0, c);
+
+                    ok = ok &&
+                         std::fabs (values (0, c) - expected) < 1e-8 * scale;
+                    for (DDMatrix::size_type r = 0; r < dim; ++r)
+                        ok = ok &&
+                             std::fabs (av (r, c) -
+                                        vectors (r, c) * values (0, c)) <
+                                 1e-8 * scale;
+                }
+                return (ok);
+            };
+
+        for (const eigen_part which :
+                 { eigen_part::largest, eigen_part::smallest })  {
+            DDMatrix    values;
+            DDMatrix    vectors;
+
+            mat.partial_eigen_space (k, values, vectors, which);
+            good = good && check (values, vectors, which);
+            smat.partial_eigen_space (k, values, vectors, which);
+            good = good && check (values, vectors, which);
+        }
+        if (! good)  {
+            std::cout << "ERROR: Partial eigen_space missed the spectrum"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        std::cout << "Largest and smallest agree with eigen_space()"
+                  << std::endl;
+
+        // The solver only sees the matrix through the operator
+        //
+        LanczosEigenSolver<DDMatrix>    solver (k);
+        DDMatrix                        values;
+        DDMatrix                        vectors;
+
+        solver.solve ([&mat](const DDMatrix &x, DDMatrix &y)  {
+                          y = mat * x;
+                      },
+                      dim, values, vectors);
+        std::cout << "User-supplied operator: "
+                  << check (values, vectors, eigen_part::largest)
+                  << std::endl;
+
+        const DDMatrix::size_type   cold_products = solver.get_products ();
+        DDMatrix                    warm_values;
+        DDMatrix                    warm_vectors;
+
+        solver.solve ([&mat](const DDMatrix &x, DDMatrix &y)  {
+                          y = mat * x;
+                      },
+                      dim, warm_values, warm_vectors, vectors);
+        std::cout << "Warm start on the same matrix takes one block product: "
+                  << (solver.get_products () == k &&
+                      check (warm_values, warm_vectors,
+                             eigen_part::largest))
+                  << std::endl;
+
+        DDMatrix    bumped_values;
+        DDMatrix    bumped_vectors;
+
+        solver.solve ([&bumped](const DDMatrix &x, DDMatrix &y)  {
+                          y = bumped * x;
+                      },
+                      dim, bumped_values, bumped_vectors);
+
+        solver.solve ([&bumped](const DDMatrix &x, DDMatrix &y)  {
+                          y = bumped * x;
+                      },
+                      dim, warm_values, warm_vectors, vectors);
+        good = true;
+        for (DDMatrix::size_type c = 0; c < k; ++c)
+            good = good &&
+                   std::fabs (warm_values (0, c) - bumped_values (0, c)) <
+                       1e-8 * scale;
+        std::cout << "Warm start on a changed matrix agrees with cold start: "
+                  << good << std::endl;
+        std::cout << "Cold start products below dimension: "
+                  << (cold_products < dim) << std::endl;
+
+        try  {
+            DDMatrix    not_symm (dim, dim, 1.0);
+
+            not_symm (0, 1) = 2.0;
+            not_symm.partial_eigen_space (k, values, vectors);
+            std::cout << "ERROR: Non-symmetric matrix wasn't rejected"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+            std::cout << "Non-symmetric matrix is rejected" << std::endl;
+        }
+    }
+
+    {
+        std::cout << "\nTesting randomized_svd ...\n" << std::endl;
+
+        // Rank 12, so 8 values plus the oversampling capture all of it
+        //
+        const DDMatrix::size_type   rows = 400;
+        const DDMatrix::size_type   cols = 120;
+        const DDMatrix::size_type   k = 8;
+        DDMatrix                    mat (rows, cols, 0.0);
+
+        for (DDMatrix::size_type c = 0; c < cols; ++c)
+            for (DDMatrix::size_type r = 0; r < rows; ++r)
+                for (int f = 0; f < 12; ++f)
+                    mat (r, c) += (100.0 / ((f + 1) * (f + 1))) *
+                                  std::cos (double(r) * (f + 1) * 0.13 + f) *
+                                  std::sin (double(c) * (f + 2) * 0.29 + f);
+
+        DDMatrix    full_u;
+        DDMatrix    full_s;
+        DDMatrix    full_v;
+
+        mat.svd (full_u, full_s, full_v, false);
+
+        const double    scale = full_s (0, 0);
+
+        const auto  check =
+            [&](const DDMatrix &m, const DDMatrix &u,
+                const DDMatrix &s, const DDMatrix &v) -> bool  {
+                if (u.rows () != m.rows () || u.columns () != k ||
+                    s.rows () != k || s.columns () != 1 ||
+                    v.rows () != m.columns () || v.columns () != k)
+                    return (false);
+
+                const DDMatrix  mv = m * v;
+                const DDMatrix  utu = ~u * u;
+                const DDMatrix  vtv = ~v * v;
+                bool            ok = true;
+
+                for (DDMatrix::size_type c = 0; c < k; ++c)  {
+                    ok = ok &&
+                         std::fabs (s (c, 0) - full_s (c, 0)) < 1e-10 * scale;
+                    for (DDMatrix::size_type r = 0; r < m.rows (); ++r)
+                        ok = ok &&
+                             std::fabs (mv (r, c) - u (r, c) * s (c, 0)) <
+                                 1e-10 * scale;
+                    for (DDMatrix::size_type r = 0; r < k; ++r)
+                        ok = ok &&
+                             std::fabs (utu (r, c) - (r == c)) < 1e-12 &&
+                             std::fabs (vtv (r, c) - (r == c)) < 1e-12;
+                }
+                return (ok);
+            };
+
+        DDMatrix    u;
+        DDMatrix    s;
+        DDMatrix    v;
+
+        mat.randomized_svd (k, u, s, v);
+        std::cout << "Tall low-rank matrix agrees with svd(): "
+                  << check (mat, u, s, v) << std::endl;
+
+        const DDMatrix  wide = ~mat;
+
+        wide.randomized_svd (k, u, s, v, 5, 0);
+        std::cout << "Wide matrix without power iterations: "
+                  << check (wide, u, s, v) << std::endl;
+
+        // Symmetric, so the singular values are the absolute eigenvalues
+        //
+        const DDMatrix  gram = ~mat * mat;
+        SDMatrix        packed (cols, cols);
+        DDMatrix        dense_s;
+
+        for (DDMatrix::size_type c = 0; c < cols; ++c)
+            for (DDMatrix::size_type r = 0; r <= c; ++r)
+                packed (r, c) = gram (r, c);
+        gram.randomized_svd (k, u, dense_s, v);
+        packed.randomized_svd (k, u, s, v);
+
+        bool    good = true;
+
+        for (DDMatrix::size_type c = 0; c < k; ++c)
+            good = good &&
+                   std::fabs (s (c, 0) - dense_s (c, 0)) <
+                       1e-10 * dense_s (0, 0) &&
+                   std::fabs (s (c, 0) - full_s (c, 0) * full_s (c, 0)) <
+                       1e-10 * dense_s (0, 0);
+        std::cout << "Packed matrix agrees with dense: " << good << std::endl;
+
+        // svd() needs at least 3 rows and columns
+        //
+        DDMatrix    narrow (50, 2);
+
+        for (DDMatrix::size_type r = 0; r < 50; ++r)  {
+            narrow (r, 0) = 3.0 * std::cos (double(r));
+            narrow (r, 1) = std::sin (double(r) * 0.5);
+        }
+        narrow.randomized_svd (2, u, s, v);
+
+        good = true;
+        for (DDMatrix::size_type c = 0; c < 2; ++c)
+            for (DDMatrix::size_type r = 0; r < 50; ++r)  {
+                const double    back = u (r, 0) * s (0, 0) * v (c, 0) +
+                                       u (r, 1) * s (1, 0) * v (c, 1);
+
+                good = good && std::fabs (back - narrow (r, c)) < 1e-12;
+            }
+        std::cout << "Two columns are reconstructed: " << good << std::endl;
+
+        try  {
+            mat.randomized_svd (cols + 1, u, s, v);
+            std::cout << "ERROR: k above min(rows, columns) wasn't rejected"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        catch (const NotSolvable &)  {
+            std::cout << "k above min(rows, columns) is rejected" << std::endl;
+        }
+    }
+
     /*
     {
         std::cout << "\nTesting Eigen performace ...\n" << std::endl;